@@ -35,6 +35,8 @@ void board_init(void)
 }
 
 #ifdef MODULE_MTD
+static uint32_t mtd0_erase_count[MTD_SECTOR_NUM];
+
 static mtd_native_dev_t mtd0_dev = {
     .dev = {
         .driver = &native_flash_driver,
@@ -43,6 +45,9 @@ static mtd_native_dev_t mtd0_dev = {
         .page_size = MTD_PAGE_SIZE,
     },
     .fname = MTD_NATIVE_FILENAME,
+    .page_program_us = MTD_NATIVE_PAGE_PROGRAM_US,
+    .sector_erase_us = MTD_NATIVE_SECTOR_ERASE_US,
+    .erase_count = mtd0_erase_count,
 };
 
 mtd_dev_t *mtd0 = (mtd_dev_t *)&mtd0_dev;
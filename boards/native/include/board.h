@@ -71,6 +71,12 @@ void _native_LED_RED_TOGGLE(void);
 #ifndef MTD_NATIVE_FILENAME
 #define MTD_NATIVE_FILENAME     "MEMORY.bin"
 #endif
+#ifndef MTD_NATIVE_PAGE_PROGRAM_US
+#define MTD_NATIVE_PAGE_PROGRAM_US  (0)     /**< emulated page program time */
+#endif
+#ifndef MTD_NATIVE_SECTOR_ERASE_US
+#define MTD_NATIVE_SECTOR_ERASE_US  (0)     /**< emulated sector erase time */
+#endif
 /** @} */
 
 /** Default MTD device */
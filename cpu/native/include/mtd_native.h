@@ -26,10 +26,25 @@ extern "C" {
 
 #include "mtd.h"
 
-/** mtd native descriptor */
+/**
+ * @brief   mtd native descriptor
+ *
+ * The file is mapped into memory on init, so reads and writes don't cost any
+ * system calls. Writes clear bits only (AND semantics) like NOR flash does,
+ * erased memory reads as 0xff.
+ *
+ * To make benchmarks on native reflect the timing of real flash, page program
+ * and sector erase times can be emulated: the calling thread sleeps for the
+ * given time (requires the `xtimer` module). @ref mtd_native_dev_t::erase_count
+ * keeps track of the wear of each sector.
+ */
 typedef struct mtd_native_dev {
-    mtd_dev_t dev;      /**< mtd generic device */
-    const char *fname;  /**< filename to use for memory emulation */
+    mtd_dev_t dev;              /**< mtd generic device */
+    const char *fname;          /**< filename to use for memory emulation */
+    uint32_t page_program_us;   /**< emulated page program time, 0 to disable */
+    uint32_t sector_erase_us;   /**< emulated sector erase time, 0 to disable */
+    uint32_t *erase_count;      /**< erase counter for each sector, may be NULL */
+    uint8_t *mem;               /**< the mapped file, set on init */
 } mtd_native_dev_t;
 
 /**
@@ -105,6 +105,7 @@ extern int (*real_execve)(const char *, char *const[], char *const[]);
 extern int (*real_feof)(FILE *stream);
 extern int (*real_ferror)(FILE *stream);
 extern int (*real_fork)(void);
+extern int (*real_ftruncate)(int fildes, off_t length);
 /* The ... is a hack to save includes: */
 extern int (*real_getaddrinfo)(const char *node, ...);
 extern int (*real_getifaddrs)(struct ifaddrs **ifap);
@@ -125,6 +126,9 @@ extern int (*real_socket)(int domain, int type, int protocol);
 extern int (*real_printf)(const char *format, ...);
 extern int (*real_unlink)(const char *);
 extern long int (*real_random)(void);
+extern off_t (*real_lseek)(int fildes, off_t offset, int whence);
+extern void* (*real_mmap)(void *addr, size_t len, int prot, int flags,
+        int fildes, off_t off);
 extern const char* (*real_gai_strerror)(int errcode);
 extern FILE* (*real_fopen)(const char *path, const char *mode);
 extern int (*real_fclose)(FILE *stream);
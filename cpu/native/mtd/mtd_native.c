@@ -19,36 +19,73 @@
 #include <assert.h>
 #include <inttypes.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/mman.h>
 
 #include "mtd.h"
 #include "mtd_native.h"
+#ifdef MODULE_XTIMER
+#include "xtimer.h"
+#endif
 
 #include "native_internal.h"
 
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
+static inline size_t _mtd_size(const mtd_dev_t *dev)
+{
+    return dev->sector_count * dev->pages_per_sector * dev->page_size;
+}
+
+static void _busy(uint32_t us)
+{
+#ifdef MODULE_XTIMER
+    if (us) {
+        xtimer_usleep(us);
+    }
+#else
+    (void)us;
+#endif
+}
+
 static int _init(mtd_dev_t *dev)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
+    size_t size = _mtd_size(dev);
 
     DEBUG("mtd_native: init, filename=%s\n", _dev->fname);
 
-    FILE *f = real_fopen(_dev->fname, "r");
+    if (_dev->mem) {
+        /* already mapped */
+        return 0;
+    }
 
-    if (!f) {
-        DEBUG("mtd_native: init: creating file %s\n", _dev->fname);
-        f = real_fopen(_dev->fname, "w+");
-        if (!f) {
-            return -EIO;
-        }
-        size_t size = dev->sector_count * dev->pages_per_sector * dev->page_size;
-        for (size_t i = 0; i < size; i++) {
-            real_fputc(0xff, f);
-        }
+    int fd = real_open(_dev->fname, O_RDWR | O_CREAT, 0644);
+    if (fd < 0) {
+        return -EIO;
+    }
+
+    off_t len = real_lseek(fd, 0, SEEK_END);
+    if ((len < 0) ||
+        (((size_t)len < size) && (real_ftruncate(fd, size) < 0))) {
+        real_close(fd);
+        return -EIO;
     }
 
-    real_fclose(f);
+    void *mem = real_mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED,
+                          fd, 0);
+    real_close(fd);
+    if (mem == MAP_FAILED) {
+        return -EIO;
+    }
+    _dev->mem = mem;
+
+    if ((size_t)len < size) {
+        DEBUG("mtd_native: init: erasing new memory of %s\n", _dev->fname);
+        memset(_dev->mem + len, 0xff, size - len);
+    }
 
     return 0;
 }
@@ -56,50 +93,59 @@ static int _init(mtd_dev_t *dev)
 static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: read from page %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _mtd_size(dev)) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r");
-    if (!f) {
+    if (!_dev->mem) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    size = real_fread(buff, 1, size, f);
-    real_fclose(f);
+
+    memcpy(buff, _dev->mem + addr, size);
 
     return size;
 }
 
+static void _and_write(uint8_t *dst, const uint8_t *src, size_t len)
+{
+    /* bits can only be cleared, program word-wise where possible */
+    while (len && ((uintptr_t)dst % sizeof(uintptr_t))) {
+        *dst++ &= *src++;
+        len--;
+    }
+    for (; len >= sizeof(uintptr_t); len -= sizeof(uintptr_t)) {
+        uintptr_t word;
+
+        memcpy(&word, src, sizeof(word));
+        *(uintptr_t *)dst &= word;
+        dst += sizeof(uintptr_t);
+        src += sizeof(uintptr_t);
+    }
+    while (len--) {
+        *dst++ &= *src++;
+    }
+}
+
 static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: write from 0x%" PRIx32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _mtd_size(dev)) {
         return -EOVERFLOW;
     }
     if (((addr % dev->page_size) + size) > dev->page_size) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
+    if (!_dev->mem) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        uint8_t c = real_fgetc(f);
-        real_fseek(f, -1, SEEK_CUR);
-        real_fputc(c & ((uint8_t*)buff)[i], f);
-    }
-    real_fclose(f);
+
+    _and_write(_dev->mem + addr, buff, size);
+    _busy(_dev->page_program_us);
 
     return size;
 }
@@ -107,27 +153,28 @@ static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr, uint32_t size
 static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
 {
     mtd_native_dev_t *_dev = (mtd_native_dev_t*) dev;
-    size_t mtd_size = dev->sector_count * dev->pages_per_sector * dev->page_size;
     size_t sector_size = dev->pages_per_sector * dev->page_size;
 
     DEBUG("mtd_native: erase from sector %" PRIu32 " count %" PRIu32 "\n", addr, size);
 
-    if (addr + size > mtd_size) {
+    if (addr + size > _mtd_size(dev)) {
         return -EOVERFLOW;
     }
     if (((addr % sector_size) != 0) || ((size % sector_size) != 0)) {
         return -EOVERFLOW;
     }
-
-    FILE *f = real_fopen(_dev->fname, "r+");
-    if (!f) {
+    if (!_dev->mem) {
         return -EIO;
     }
-    real_fseek(f, addr, SEEK_SET);
-    for (size_t i = 0; i < size; i++) {
-        real_fputc(0xff, f);
+
+    memset(_dev->mem + addr, 0xff, size);
+    for (uint32_t sector = addr / sector_size;
+         sector < (addr + size) / sector_size; sector++) {
+        if (_dev->erase_count) {
+            _dev->erase_count[sector]++;
+        }
+        _busy(_dev->sector_erase_us);
     }
-    real_fclose(f);
 
     return 0;
 }
@@ -75,6 +75,7 @@ int (*real_creat)(const char *path, ...);
 int (*real_dup2)(int, int);
 int (*real_execve)(const char *, char *const[], char *const[]);
 int (*real_fork)(void);
+int (*real_ftruncate)(int fildes, off_t length);
 int (*real_feof)(FILE *stream);
 int (*real_ferror)(FILE *stream);
 int (*real_listen)(int socket, int backlog);
@@ -90,6 +91,9 @@ int (*real_setsockopt)(int socket, ...);
 int (*real_socket)(int domain, int type, int protocol);
 int (*real_unlink)(const char *);
 long int (*real_random)(void);
+off_t (*real_lseek)(int fildes, off_t offset, int whence);
+void* (*real_mmap)(void *addr, size_t len, int prot, int flags,
+        int fildes, off_t off);
 const char* (*real_gai_strerror)(int errcode);
 FILE* (*real_fopen)(const char *path, const char *mode);
 int (*real_fclose)(FILE *stream);
@@ -460,6 +464,7 @@ void _native_init_syscalls(void)
     *(void **)(&real_fcntl) = dlsym(RTLD_NEXT, "fcntl");
     *(void **)(&real_creat) = dlsym(RTLD_NEXT, "creat");
     *(void **)(&real_fork) = dlsym(RTLD_NEXT, "fork");
+    *(void **)(&real_ftruncate) = dlsym(RTLD_NEXT, "ftruncate");
     *(void **)(&real_dup2) = dlsym(RTLD_NEXT, "dup2");
     *(void **)(&real_select) = dlsym(RTLD_NEXT, "select");
     *(void **)(&real_setitimer) = dlsym(RTLD_NEXT, "setitimer");
@@ -468,6 +473,8 @@ void _native_init_syscalls(void)
     *(void **)(&real_socket) = dlsym(RTLD_NEXT, "socket");
     *(void **)(&real_unlink) = dlsym(RTLD_NEXT, "unlink");
     *(void **)(&real_random) = dlsym(RTLD_NEXT, "random");
+    *(void **)(&real_lseek) = dlsym(RTLD_NEXT, "lseek");
+    *(void **)(&real_mmap) = dlsym(RTLD_NEXT, "mmap");
     *(void **)(&real_execve) = dlsym(RTLD_NEXT, "execve");
     *(void **)(&real_ioctl) = dlsym(RTLD_NEXT, "ioctl");
     *(void **)(&real_listen) = dlsym(RTLD_NEXT, "listen");
@@ -0,0 +1,203 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+"""Render radio duty-cycle, airtime and latency statistics from the timing
+trace dumped by `ifconfig <if> trace bin` (module `netstats_trace`)."""
+
+import argparse
+import re
+import struct
+import sys
+from collections import OrderedDict
+
+EVENTS = [
+    "radio_on",
+    "radio_off",
+    "tx_queued",
+    "tx_start",
+    "tx_end",
+    "tx_noack",
+    "tx_cca_fail",
+    "rx_start",
+    "rx_end",
+    "mac_wakeup",
+    "mac_sleep",
+]
+
+RECORD = struct.Struct("<IHBx")
+HEADER_RE = re.compile(r"netstats_trace (\S+) (\d+) (\d+)\s*$")
+END_RE = re.compile(r"netstats_trace end\s*$")
+RECORD_RE = re.compile(r"\b(\d+) ([0-9a-f]{16})\s*$")
+
+
+def parse(lines):
+    """Returns {iface: [(time_us, event, arg), ...]} from (possibly several,
+    overlapping) dumps in the terminal output `lines`. Records are ordered
+    and deduplicated by the sequence number printed with each of them."""
+    traces = OrderedDict()
+    iface = None
+    for line in lines:
+        match = HEADER_RE.search(line)
+        if match:
+            iface = match.group(1)
+            traces.setdefault(iface, {})
+            continue
+        if iface is None:
+            continue
+        if END_RE.search(line):
+            iface = None
+            continue
+        match = RECORD_RE.search(line)
+        if match:
+            seq = int(match.group(1))
+            time, arg, event = RECORD.unpack(bytes.fromhex(match.group(2)))
+            traces[iface][seq] = (time, event, arg)
+    res = OrderedDict()
+    for name, records in traces.items():
+        res[name] = _unwrap([records[seq] for seq in sorted(records)])
+    return res
+
+
+def _unwrap(records):
+    """Makes the 32 bit microsecond timestamps monotonic"""
+    res = []
+    offset = 0
+    last = None
+    for time, event, arg in records:
+        if (last is not None) and (time < last):
+            offset += 1 << 32
+        last = time
+        res.append((time + offset, event, arg))
+    return res
+
+
+def _intervals(records, start_events, end_events):
+    """Durations from an event in start_events to the next in end_events"""
+    res = []
+    start = None
+    for time, event, _ in records:
+        if event in start_events and start is None:
+            start = time
+        elif event in end_events and start is not None:
+            res.append(time - start)
+            start = None
+    return res
+
+
+def _on_time(records, on_event, off_event):
+    """Returns (on time, observed time) for a pair of on/off events"""
+    on = None
+    first = None
+    total = 0
+    for time, event, _ in records:
+        if event not in (on_event, off_event):
+            continue
+        if first is None:
+            first = time
+            # state before the first event is unknown, assume the opposite
+            if event == off_event:
+                on = time
+        if event == on_event and on is None:
+            on = time
+        elif event == off_event and on is not None:
+            total += time - on
+            on = None
+    if first is None:
+        return 0, 0
+    end = records[-1][0]
+    if on is not None:
+        total += end - on
+    return total, end - first
+
+
+def histogram(values, bins, width=40):
+    """Returns an ASCII histogram of values"""
+    if not values:
+        return ["    (no samples)"]
+    lo, hi = min(values), max(values)
+    bins = min(bins, hi - lo + 1)
+    step = max(1, -(-(hi - lo + 1) // bins))
+    counts = [0] * bins
+    for value in values:
+        counts[min(bins - 1, (value - lo) // step)] += 1
+    peak = max(counts)
+    lines = []
+    for i, count in enumerate(counts):
+        bar = "#" * ((count * width + peak - 1) // peak)
+        lines.append("    {:>8} - {:<8} us |{:<{w}}| {}".format(
+            lo + i * step, lo + (i + 1) * step - 1, bar, count, w=width))
+    return lines
+
+
+def _summary(values):
+    if not values:
+        return "n=0"
+    return "n={} min={} avg={:.0f} max={} us".format(
+        len(values), min(values), sum(values) / len(values), max(values))
+
+
+def render(iface, records, bins, out=sys.stdout):
+    ev = {name: idx for idx, name in enumerate(EVENTS)}
+    counts = [0] * len(EVENTS)
+    for _, event, _ in records:
+        if event < len(counts):
+            counts[event] += 1
+
+    print("Interface {}: {} events over {} us".format(
+        iface, len(records),
+        (records[-1][0] - records[0][0]) if records else 0), file=out)
+
+    for label, on, off in (("radio", "radio_on", "radio_off"),
+                           ("MAC", "mac_wakeup", "mac_sleep")):
+        on_time, total = _on_time(records, ev[on], ev[off])
+        if total:
+            print("  {} duty-cycle: {:.2f} % ({} of {} us)".format(
+                label, 100.0 * on_time / total, on_time, total), file=out)
+
+    tx_air = _intervals(records, {ev["tx_start"]},
+                        {ev["tx_end"], ev["tx_noack"], ev["tx_cca_fail"]})
+    rx_air = _intervals(records, {ev["rx_start"]}, {ev["rx_end"]})
+    print("  TX airtime: {} us total, {}".format(sum(tx_air),
+                                                 _summary(tx_air)), file=out)
+    print("  RX airtime: {} us total, {}".format(sum(rx_air),
+                                                 _summary(rx_air)), file=out)
+    print("  TX: {} sent, {} not acknowledged, {} CCA failures".format(
+        counts[ev["tx_end"]], counts[ev["tx_noack"]],
+        counts[ev["tx_cca_fail"]]), file=out)
+
+    tx_latency = _intervals(records, {ev["tx_queued"]}, {ev["tx_start"]})
+    wakeup = [arg for _, event, arg in records if event == ev["mac_wakeup"]]
+    for label, values in (("TX latency (queued -> start)", tx_latency),
+                          ("MAC wake-up delay", wakeup),
+                          ("TX airtime", tx_air)):
+        print("  {}: {}".format(label, _summary(values)), file=out)
+        for line in histogram(values, bins):
+            print(line, file=out)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__)
+    parser.add_argument("log", nargs="?", type=argparse.FileType("r"),
+                        default=sys.stdin,
+                        help="terminal output containing trace dumps "
+                             "(default: stdin)")
+    parser.add_argument("-b", "--bins", type=int, default=10,
+                        help="number of histogram bins (default: 10)")
+    parser.add_argument("-i", "--iface", help="only render this interface")
+    args = parser.parse_args()
+
+    traces = parse(args.log)
+    if not traces:
+        sys.exit("no trace found, dump it with `ifconfig <if> trace bin`")
+    for iface, records in traces.items():
+        if args.iface in (None, iface):
+            render(iface, records, args.bins)
+
+
+if __name__ == "__main__":
+    main()
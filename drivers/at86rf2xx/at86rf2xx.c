@@ -197,6 +197,7 @@ void at86rf2xx_tx_exec(const at86rf2xx_t *dev)
     /* trigger sending of pre-loaded frame */
     at86rf2xx_reg_write(dev, AT86RF2XX_REG__TRX_STATE,
                         AT86RF2XX_TRX_STATE__TX_START);
+    NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_TX_START, 0);
     if (netdev->event_callback &&
         (dev->flags & AT86RF2XX_OPT_TELL_TX_START)) {
         netdev->event_callback(netdev, NETDEV_EVENT_TX_STARTED);
@@ -528,11 +528,15 @@ uint8_t at86rf2xx_set_state(at86rf2xx_t *dev, uint8_t state)
             gpio_set(dev->params.sleep_pin);
 #endif
             dev->state = state;
+            NETSTATS_TRACE_ADD(&dev->netdev.netdev.trace,
+                               NETSTATS_TRACE_RADIO_OFF, 0);
         }
         else {
             if (old_state == AT86RF2XX_STATE_SLEEP) {
                 DEBUG("at86rf2xx: waking up from sleep mode\n");
                 at86rf2xx_assert_awake(dev);
+                NETSTATS_TRACE_ADD(&dev->netdev.netdev.trace,
+                                   NETSTATS_TRACE_RADIO_ON, 0);
             }
             _set_state(dev, state, state);
         }
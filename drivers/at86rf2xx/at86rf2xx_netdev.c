@@ -654,6 +654,7 @@ static void _isr(netdev_t *netdev)
                   & AT86RF2XX_TRX_STATE_MASK__TRAC;
 
     if (irq_mask & AT86RF2XX_IRQ_STATUS_MASK__RX_START) {
+        NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_RX_START, 0);
         netdev->event_callback(netdev, NETDEV_EVENT_RX_STARTED);
         DEBUG("[at86rf2xx] EVT - RX_START\n");
     }
@@ -662,6 +663,7 @@ static void _isr(netdev_t *netdev)
         if ((state == AT86RF2XX_STATE_RX_AACK_ON)
             || (state == AT86RF2XX_STATE_BUSY_RX_AACK)) {
             DEBUG("[at86rf2xx] EVT - RX_END\n");
+            NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_RX_END, 0);
             if (!(dev->flags & AT86RF2XX_OPT_TELL_RX_END)) {
                 return;
             }
@@ -685,6 +687,23 @@ static void _isr(netdev_t *netdev)
 
             DEBUG("[at86rf2xx] EVT - TX_END\n");
 
+            switch (trac_status) {
+                case AT86RF2XX_TRX_STATE__TRAC_NO_ACK:
+                    NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_TX_NOACK, 0);
+                    break;
+                case AT86RF2XX_TRX_STATE__TRAC_CHANNEL_ACCESS_FAILURE:
+                    NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_TX_CCA_FAIL, 0);
+                    break;
+                default:
+#if AT86RF2XX_HAVE_RETRIES
+                    NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_TX_END,
+                                       dev->tx_retries);
+#else
+                    NETSTATS_TRACE_ADD(&netdev->trace, NETSTATS_TRACE_TX_END, 0);
+#endif
+                    break;
+            }
+
             if (netdev->event_callback && (dev->flags & AT86RF2XX_OPT_TELL_TX_END)) {
                 switch (trac_status) {
 #ifdef MODULE_OPENTHREAD
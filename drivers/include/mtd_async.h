@@ -0,0 +1,223 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_mtd_async Asynchronous MTD requests
+ * @ingroup     drivers_mtd
+ * @brief       Non-blocking, queued access to MTD devices
+ *
+ * Page programs and especially sector erases keep a flash device busy for
+ * milliseconds. With the blocking @ref drivers_mtd functions the calling
+ * thread is stalled for that time. This module instead queues requests and
+ * executes them in a dedicated worker thread, the caller is notified on
+ * completion, either
+ *
+ * - by posting mtd_async_req_t::event to mtd_async_req_t::queue, if the
+ *   queue is set, or
+ * - by setting @ref MTD_ASYNC_THREAD_FLAG on the thread that submitted the
+ *   request. @ref mtd_async_wait() waits for this.
+ *
+ * Requests for the same device are executed in order with two exceptions:
+ *
+ * - A read may be executed before earlier writes and erases as long as their
+ *   address ranges don't overlap, so reads are not held up by erases. At
+ *   most @ref MTD_ASYNC_READ_BYPASS_MAX reads overtake the oldest request.
+ * - Consecutive requests of the same type on adjacent addresses (and, for
+ *   reads and writes, adjacent buffers) are merged into a single call of the
+ *   driver. Writes are only merged within a page.
+ *
+ * All requests are executed by the same thread, so all accesses to a device
+ * should go through this module once it is used for that device.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous MTD request interface
+ */
+
+#ifndef MTD_ASYNC_H
+#define MTD_ASYNC_H
+
+#include <stdint.h>
+
+#include "event.h"
+#include "kernel_types.h"
+#include "mtd.h"
+#include "thread.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Stack size of the worker thread
+ */
+#ifndef MTD_ASYNC_STACKSIZE
+#define MTD_ASYNC_STACKSIZE     (THREAD_STACKSIZE_DEFAULT)
+#endif
+
+/**
+ * @brief   Priority of the worker thread
+ *
+ * Lower than the main thread by default, so the long busy periods of the
+ * device don't hold up the application.
+ */
+#ifndef MTD_ASYNC_PRIO
+#define MTD_ASYNC_PRIO          (THREAD_PRIORITY_MAIN + 1)
+#endif
+
+/**
+ * @brief   Maximum number of reads executed before the oldest request
+ *
+ * Bounds the delay of a write or erase by reads that overtake it, so a
+ * steady stream of reads cannot starve it.
+ */
+#ifndef MTD_ASYNC_READ_BYPASS_MAX
+#define MTD_ASYNC_READ_BYPASS_MAX   (4U)
+#endif
+
+/**
+ * @brief   Thread flag set on the submitting thread when a request without
+ *          event queue completed
+ */
+#ifndef MTD_ASYNC_THREAD_FLAG
+#define MTD_ASYNC_THREAD_FLAG   (1u << 13)
+#endif
+
+/**
+ * @brief   Request types
+ */
+typedef enum {
+    MTD_ASYNC_READ,             /**< see @ref mtd_read() */
+    MTD_ASYNC_WRITE,            /**< see @ref mtd_write() */
+    MTD_ASYNC_ERASE,            /**< see @ref mtd_erase() */
+} mtd_async_op_t;
+
+/**
+ * @brief   Request type forward declaration
+ */
+typedef struct mtd_async_req mtd_async_req_t;
+
+/**
+ * @brief   An asynchronous request
+ *
+ * Must not be touched while the request is pending, except for reading
+ * mtd_async_req_t::res.
+ */
+struct mtd_async_req {
+    /**
+     * @brief   Event posted on completion, the handler must be set by the
+     *          user if mtd_async_req_t::queue is set
+     */
+    event_t event;
+    /**
+     * @brief   Event queue to post mtd_async_req_t::event to on completion.
+     *          If NULL, the submitting thread is notified with
+     *          @ref MTD_ASYNC_THREAD_FLAG instead.
+     */
+    event_queue_t *queue;
+    mtd_async_req_t *next;      /**< next pending request, internal */
+    thread_t *thread;           /**< thread to notify, internal */
+    mtd_dev_t *mtd;             /**< the device */
+    void *buf;                  /**< buffer to read to or write from */
+    uint32_t addr;              /**< address on the device */
+    uint32_t count;             /**< number of bytes */
+    /**
+     * @brief   result as returned by the blocking function,
+     *          -EINPROGRESS while the request is pending
+     */
+    volatile int res;
+    uint8_t op;                 /**< @ref mtd_async_op_t */
+};
+
+/**
+ * @brief   Starts the worker thread
+ *
+ * Called by auto_init.
+ *
+ * @return  PID of the worker thread.
+ * @return  -EEXIST, if the thread was already started.
+ */
+kernel_pid_t mtd_async_init(void);
+
+/**
+ * @brief   Queues a read request
+ *
+ * @param[in] req       The request, mtd_async_req_t::queue and
+ *                      mtd_async_req_t::event need to be set before if
+ *                      notification by event is wanted
+ * @param[in] mtd       The device to read from
+ * @param[out] dest     The buffer to fill in
+ * @param[in] addr      The start address to read from
+ * @param[in] count     The number of bytes to read
+ *
+ * @return  0 on success, the result of the read is available in
+ *          mtd_async_req_t::res on completion.
+ * @return  -ENODEV, if @p mtd is not a valid device.
+ */
+int mtd_async_read(mtd_async_req_t *req, mtd_dev_t *mtd, void *dest,
+                   uint32_t addr, uint32_t count);
+
+/**
+ * @brief   Queues a write request
+ *
+ * @param[in] req       The request, see @ref mtd_async_read()
+ * @param[in] mtd       The device to write to
+ * @param[in] src       The buffer to write, must stay valid until completion
+ * @param[in] addr      The start address to write to
+ * @param[in] count     The number of bytes to write
+ *
+ * @return  0 on success, the result of the write is available in
+ *          mtd_async_req_t::res on completion.
+ * @return  -ENODEV, if @p mtd is not a valid device.
+ */
+int mtd_async_write(mtd_async_req_t *req, mtd_dev_t *mtd, const void *src,
+                    uint32_t addr, uint32_t count);
+
+/**
+ * @brief   Queues an erase request
+ *
+ * @param[in] req       The request, see @ref mtd_async_read()
+ * @param[in] mtd       The device to erase
+ * @param[in] addr      The address of the first sector to erase
+ * @param[in] count     The number of bytes to erase
+ *
+ * @return  0 on success, the result of the erase is available in
+ *          mtd_async_req_t::res on completion.
+ * @return  -ENODEV, if @p mtd is not a valid device.
+ */
+int mtd_async_erase(mtd_async_req_t *req, mtd_dev_t *mtd, uint32_t addr,
+                    uint32_t count);
+
+/**
+ * @brief   Removes a request from the queue if it was not started yet
+ *
+ * @param[in] req       A request
+ *
+ * @return  0 if the request was removed, it will not be notified.
+ * @return  -EBUSY, if the request is already executed or completed.
+ */
+int mtd_async_cancel(mtd_async_req_t *req);
+
+/**
+ * @brief   Waits for a request without event queue to complete
+ *
+ * Must be called by the thread that submitted the request.
+ *
+ * @param[in] req       A request
+ *
+ * @return  mtd_async_req_t::res
+ */
+int mtd_async_wait(mtd_async_req_t *req);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_ASYNC_H */
+/** @} */
@@ -0,0 +1,162 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    drivers_mtd_cache Page cache for MTD devices
+ * @ingroup     drivers_mtd
+ * @brief       Stackable read cache and write-back buffer for MTD devices
+ *
+ * File systems read their metadata in small chunks, again and again. On
+ * devices attached by a slow bus (e.g. SPI NOR flash) every such read is a
+ * full bus transaction. This module is an MTD device on top of another MTD
+ * device that keeps recently used pages in RAM:
+ *
+ * - Reads are served from the cache if possible. On a miss the whole page is
+ *   loaded, unless the read covers the full page anyway; such reads go to the
+ *   device directly so that streaming reads don't evict the cached metadata.
+ * - Writes smaller than a page are collected in the cache and programmed in a
+ *   single write when the page is evicted or flushed. The coalesced range is
+ *   programmed from its first to its last written byte, bytes in between that
+ *   were not written are programmed with their current content.
+ * - As on NOR flash, writing only clears bits: written data is ANDed into the
+ *   cached page, so the cache holds what the device holds after the write
+ *   back. The parent device must have these semantics.
+ * - Erasing a sector drops its pages from the cache, including unwritten
+ *   data, once the parent device erased it.
+ *
+ * Least recently used pages are evicted first. The RAM budget is given by
+ * the buffer passed in mtd_cache_t::mem, each page takes
+ * @ref MTD_CACHE_LINE_SIZE bytes of it.
+ *
+ * @warning Written data is kept in RAM until the page is evicted,
+ *          @ref mtd_cache_flush() is called or the device is powered down with
+ *          @ref mtd_power(). Data not written back is lost on reset.
+ *
+ * Usage:
+ *
+ * ```C
+ * static uint32_t cache_mem[MTD_CACHE_MEM_SIZE(256, 8) / sizeof(uint32_t)];
+ * static mtd_cache_t cache = {
+ *     .base = { .driver = &mtd_cache_driver },
+ *     .parent = MTD_0,
+ *     .mem = cache_mem,
+ *     .mem_size = sizeof(cache_mem),
+ * };
+ * ```
+ *
+ * The cache can then be used in place of the parent device, e.g. by passing
+ * `&cache.base` to a file system.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Interface definition for the MTD page cache
+ */
+
+#ifndef MTD_CACHE_H
+#define MTD_CACHE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "mtd.h"
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Bookkeeping of a cached page
+ */
+typedef struct {
+    uint32_t page;          /**< page number, UINT32_MAX if unused */
+    uint32_t last_used;     /**< value of mtd_cache_t::clock at last access */
+    uint16_t dirty_start;   /**< offset of the first byte not written back */
+    uint16_t dirty_end;     /**< offset behind the last byte not written
+                             *   back, 0 if the page is clean */
+} mtd_cache_line_t;
+
+/**
+ * @brief   RAM needed per cached page
+ *
+ * @param[in] page_size     page size of the parent device
+ */
+#define MTD_CACHE_LINE_SIZE(page_size)  (sizeof(mtd_cache_line_t) + (page_size))
+
+/**
+ * @brief   Size of mtd_cache_t::mem for a given number of pages
+ *
+ * @param[in] page_size     page size of the parent device
+ * @param[in] numof         number of pages to cache
+ */
+#define MTD_CACHE_MEM_SIZE(page_size, numof) \
+    ((numof) * MTD_CACHE_LINE_SIZE(page_size))
+
+/**
+ * @brief   Cache statistics
+ */
+typedef struct {
+    uint32_t hits;          /**< reads and writes served from the cache */
+    uint32_t misses;        /**< reads and writes that accessed the device */
+    uint32_t writebacks;    /**< writes of coalesced data to the device */
+} mtd_cache_stats_t;
+
+/**
+ * @brief   Device descriptor for the MTD page cache
+ *
+ * This is an extension of the @c mtd_dev_t struct. Only mtd_cache_t::base
+ * (driver), mtd_cache_t::parent, mtd_cache_t::mem and mtd_cache_t::mem_size
+ * need to be set, the geometry is taken from the parent on initialization.
+ */
+typedef struct {
+    mtd_dev_t base;             /**< inherit from mtd_dev_t object */
+    mtd_dev_t *parent;          /**< the cached device */
+    /**
+     * @brief   memory for the cache, must be aligned to 4 bytes
+     */
+    void *mem;
+    size_t mem_size;            /**< size of mtd_cache_t::mem in bytes */
+    mtd_cache_line_t *lines;    /**< cached pages, internal */
+    uint8_t *data;              /**< page buffers, internal */
+    unsigned numof;             /**< number of cached pages, internal */
+    uint32_t clock;             /**< access counter for LRU, internal */
+    mutex_t lock;               /**< protects the cache, internal */
+    mtd_cache_stats_t stats;    /**< statistics */
+} mtd_cache_t;
+
+/**
+ * @brief   MTD page cache operations table
+ */
+extern const mtd_desc_t mtd_cache_driver;
+
+/**
+ * @brief   Writes all coalesced data to the parent device
+ *
+ * @param[in] cache     The cache
+ *
+ * @return  0 on success
+ * @return  < 0 on error, as returned by @ref mtd_write()
+ */
+int mtd_cache_flush(mtd_cache_t *cache);
+
+/**
+ * @brief   Drops all cached pages without writing them back
+ *
+ * Needed if the parent device was modified without going through the cache.
+ *
+ * @param[in] cache     The cache
+ */
+void mtd_cache_invalidate(mtd_cache_t *cache);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_CACHE_H */
+/** @} */
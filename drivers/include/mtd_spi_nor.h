@@ -53,6 +53,7 @@ typedef struct {
     uint8_t chip_erase;      /**< Chip erase */
     uint8_t sleep;           /**< Deep power down */
     uint8_t wake;            /**< Release from deep power down */
+    uint8_t rdsfdp;          /**< Read SFDP (serial flash discoverable parameters) */
     /* TODO: enter 4 byte address mode for large memories */
 } mtd_spi_nor_opcode_t;
 
@@ -82,11 +83,33 @@ typedef struct __attribute__((packed)) {
  * @brief   Flag to set when the device support 32KiB block erase (block_erase_32k opcode)
  */
 #define SPI_NOR_F_SECT_32K  (2)
+/**
+ * @brief   Flag to set when block_erase erases 64KiB blocks independent of the
+ *          sector size
+ *
+ * Without this flag, block_erase is assumed to erase one sector.
+ */
+#define SPI_NOR_F_SECT_64K  (4)
+/**
+ * @brief   Flag to set when the device supports the read_fast opcode (one dummy
+ *          byte after the address)
+ *
+ * Fast read is specified for higher clock frequencies than normal read.
+ */
+#define SPI_NOR_F_FAST_READ (8)
+/**
+ * @brief   Flag to set to skip reading the SFDP tables on initialization
+ */
+#define SPI_NOR_F_NO_SFDP   (16)
 
 /**
  * @brief   Device descriptor for serial flash memory devices
  *
  * This is an extension of the @c mtd_dev_t struct
+ *
+ * If mtd_dev_t::sector_count is 0, the geometry is taken from the SFDP
+ * tables of the device: the page size as given there and the smallest erase
+ * size supported by the opcode table as sector size.
  */
 typedef struct {
     mtd_dev_t base;          /**< inherit from mtd_dev_t object */
@@ -95,7 +118,15 @@ typedef struct {
     gpio_t cs;               /**< CS pin GPIO handle */
     spi_mode_t mode;         /**< SPI mode */
     spi_clk_t clk;           /**< SPI clock */
-    uint16_t flag;           /**< Config flags */
+    /**
+     * @brief   Config flags
+     *
+     * The flags are completed from the serial flash discoverable parameters
+     * (SFDP, JESD216) of the device on initialization, unless
+     * @ref SPI_NOR_F_NO_SFDP is set. Erase flags are only set from SFDP if the
+     * device uses the opcodes of mtd_spi_nor_t::opcode for the erase size.
+     */
+    uint16_t flag;
     mtd_jedec_id_t jedec_id; /**< JEDEC ID of the chip */
     /**
      * @brief   bitmask to corresponding to the page address
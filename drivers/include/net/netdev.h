@@ -199,6 +199,7 @@ extern "C" {
 
 #include "iolist.h"
 #include "net/netopt.h"
+#include "net/netstats/trace.h"
 
 #ifdef MODULE_L2FILTER
 #include "net/l2filter.h"
@@ -296,6 +297,9 @@ struct netdev {
 #ifdef MODULE_L2FILTER
     l2filter_t filter[L2FILTER_LISTSIZE];   /**< link layer address filters */
 #endif
+#ifdef MODULE_NETSTATS_TRACE
+    netstats_trace_t trace;                 /**< radio and MAC timing trace */
+#endif
 };
 
 /**
@@ -0,0 +1,289 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd_async
+ * @{
+ *
+ * @file
+ * @brief       Asynchronous MTD request queue
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <inttypes.h>
+#include <stdbool.h>
+
+#include "mutex.h"
+#include "thread_flags.h"
+#include "mtd_async.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+/* wakes the worker thread when new requests were queued */
+#define WORKER_FLAG     (0x1)
+
+static mutex_t _lock = MUTEX_INIT;
+static mtd_async_req_t *_queue;
+static unsigned _bypassed;
+static thread_t *_worker_thread;
+static kernel_pid_t _pid = KERNEL_PID_UNDEF;
+static char _stack[MTD_ASYNC_STACKSIZE];
+
+static inline bool _overlap(const mtd_async_req_t *a, const mtd_async_req_t *b)
+{
+    return (a->mtd == b->mtd) &&
+           (a->addr < (b->addr + b->count)) && (b->addr < (a->addr + a->count));
+}
+
+/* a read must not overtake an older write or erase of the same memory */
+static bool _blocked(const mtd_async_req_t *req)
+{
+    for (const mtd_async_req_t *r = _queue; r != req; r = r->next) {
+        if ((r->op != MTD_ASYNC_READ) && _overlap(r, req)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/* prefer the oldest read that may be executed now, so reads don't wait for
+ * erases, otherwise or once too many reads overtook it take the oldest
+ * request */
+static mtd_async_req_t **_select(void)
+{
+    if (_bypassed < MTD_ASYNC_READ_BYPASS_MAX) {
+        for (mtd_async_req_t **r = &_queue; *r != NULL; r = &(*r)->next) {
+            if (((*r)->op == MTD_ASYNC_READ) && !_blocked(*r)) {
+                /* count the reads overtaking the oldest request */
+                _bypassed = (r == &_queue) ? 0 : _bypassed + 1;
+                return r;
+            }
+        }
+    }
+    _bypassed = 0;
+    return &_queue;
+}
+
+/* check if @p next can be executed within the same driver call as the batch
+ * from @p first to @p last */
+static bool _mergeable(const mtd_async_req_t *first,
+                       const mtd_async_req_t *last,
+                       const mtd_async_req_t *next)
+{
+    if ((next->mtd != first->mtd) || (next->op != first->op) ||
+        (next->addr != (last->addr + last->count))) {
+        return false;
+    }
+    switch (first->op) {
+        case MTD_ASYNC_READ:
+            return ((uint8_t *)next->buf == ((uint8_t *)last->buf + last->count)) &&
+                   !_blocked(next);
+        case MTD_ASYNC_WRITE: {
+            uint32_t page_size = first->mtd->page_size;
+
+            return ((uint8_t *)next->buf == ((uint8_t *)last->buf + last->count)) &&
+                   ((first->addr / page_size) ==
+                    ((next->addr + next->count - 1) / page_size));
+        }
+        default:
+            return true;
+    }
+}
+
+/* remove the next batch of merged requests from the queue */
+static mtd_async_req_t *_take(uint32_t *count)
+{
+    mtd_async_req_t **prev, *first, *last;
+
+    mutex_lock(&_lock);
+    prev = _select();
+    first = *prev;
+    if (first != NULL) {
+        *count = first->count;
+        for (last = first; (last->next != NULL) &&
+                           _mergeable(first, last, last->next);
+             last = last->next) {
+            *count += last->next->count;
+        }
+        *prev = last->next;
+        last->next = NULL;
+    }
+    mutex_unlock(&_lock);
+    return first;
+}
+
+static int _execute(mtd_async_req_t *req, uint32_t count)
+{
+    switch (req->op) {
+        case MTD_ASYNC_READ: {
+            uint8_t *dest = req->buf;
+            uint32_t addr = req->addr;
+            uint32_t left = count;
+
+            /* drivers may read less (e.g. one page), complete the request */
+            while (left > 0) {
+                int res = mtd_read(req->mtd, dest, addr, left);
+
+                if (res <= 0) {
+                    if (left == count) {
+                        return res;
+                    }
+                    break;
+                }
+                dest += res;
+                addr += res;
+                left -= res;
+            }
+            return count - left;
+        }
+        case MTD_ASYNC_WRITE:
+            return mtd_write(req->mtd, req->buf, req->addr, count);
+        case MTD_ASYNC_ERASE:
+            return mtd_erase(req->mtd, req->addr, count);
+        default:
+            return -EINVAL;
+    }
+}
+
+static void _complete(mtd_async_req_t *req, int res)
+{
+    /* the request may be reused as soon as the result is set */
+    event_queue_t *queue = req->queue;
+    thread_t *thread = req->thread;
+
+    req->res = res;
+    if (queue != NULL) {
+        event_post(queue, &req->event);
+    }
+    else {
+        thread_flags_set(thread, MTD_ASYNC_THREAD_FLAG);
+    }
+}
+
+static void *_worker(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        mtd_async_req_t *req;
+        uint32_t count;
+
+        thread_flags_wait_any(WORKER_FLAG);
+        while ((req = _take(&count)) != NULL) {
+            int res = _execute(req, count);
+
+            DEBUG("mtd_async: op %u at 0x%" PRIx32 " (%" PRIu32 " bytes): %d\n",
+                  (unsigned)req->op, req->addr, count, res);
+            /* split the result of a merged batch among its requests */
+            while (req != NULL) {
+                mtd_async_req_t *next = req->next;
+                int req_res = res;
+
+                if ((res >= 0) && (req->op != MTD_ASYNC_ERASE)) {
+                    req_res = ((uint32_t)res < req->count) ? res : (int)req->count;
+                    res -= req_res;
+                }
+                _complete(req, req_res);
+                req = next;
+            }
+        }
+    }
+    return NULL;
+}
+
+static int _submit(mtd_async_req_t *req, mtd_dev_t *mtd, mtd_async_op_t op,
+                   void *buf, uint32_t addr, uint32_t count)
+{
+    mtd_async_req_t **tail;
+
+    assert(_pid != KERNEL_PID_UNDEF);
+    if (!mtd || !mtd->driver) {
+        return -ENODEV;
+    }
+    req->mtd = mtd;
+    req->op = op;
+    req->buf = buf;
+    req->addr = addr;
+    req->count = count;
+    req->res = -EINPROGRESS;
+    req->thread = (thread_t *)sched_active_thread;
+    req->next = NULL;
+
+    mutex_lock(&_lock);
+    for (tail = &_queue; *tail != NULL; tail = &(*tail)->next) {}
+    *tail = req;
+    mutex_unlock(&_lock);
+
+    thread_flags_set(_worker_thread, WORKER_FLAG);
+    return 0;
+}
+
+kernel_pid_t mtd_async_init(void)
+{
+    if (_pid != KERNEL_PID_UNDEF) {
+        return -EEXIST;
+    }
+    kernel_pid_t pid = thread_create(_stack, sizeof(_stack), MTD_ASYNC_PRIO,
+                                     THREAD_CREATE_STACKTEST, _worker, NULL,
+                                     "mtd_async");
+    if (pid > KERNEL_PID_UNDEF) {
+        _worker_thread = (thread_t *)thread_get(pid);
+        _pid = pid;
+    }
+    return pid;
+}
+
+int mtd_async_read(mtd_async_req_t *req, mtd_dev_t *mtd, void *dest,
+                   uint32_t addr, uint32_t count)
+{
+    return _submit(req, mtd, MTD_ASYNC_READ, dest, addr, count);
+}
+
+int mtd_async_write(mtd_async_req_t *req, mtd_dev_t *mtd, const void *src,
+                    uint32_t addr, uint32_t count)
+{
+    return _submit(req, mtd, MTD_ASYNC_WRITE, (void *)src, addr, count);
+}
+
+int mtd_async_erase(mtd_async_req_t *req, mtd_dev_t *mtd, uint32_t addr,
+                    uint32_t count)
+{
+    return _submit(req, mtd, MTD_ASYNC_ERASE, NULL, addr, count);
+}
+
+int mtd_async_cancel(mtd_async_req_t *req)
+{
+    int res = -EBUSY;
+
+    mutex_lock(&_lock);
+    for (mtd_async_req_t **r = &_queue; *r != NULL; r = &(*r)->next) {
+        if (*r == req) {
+            *r = req->next;
+            req->next = NULL;
+            res = 0;
+            break;
+        }
+    }
+    mutex_unlock(&_lock);
+    return res;
+}
+
+int mtd_async_wait(mtd_async_req_t *req)
+{
+    assert(req->queue == NULL);
+    assert(req->thread == sched_active_thread);
+
+    while (req->res == -EINPROGRESS) {
+        thread_flags_wait_any(MTD_ASYNC_THREAD_FLAG);
+    }
+    return req->res;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     drivers_mtd_cache
+ * @{
+ *
+ * @file
+ * @brief       MTD page cache implementation
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <string.h>
+
+#include "mtd_cache.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define PAGE_UNUSED     (UINT32_MAX)
+
+static inline uint8_t *_data(const mtd_cache_t *cache,
+                             const mtd_cache_line_t *line)
+{
+    return cache->data + (line - cache->lines) * cache->base.page_size;
+}
+
+static inline uint32_t _size(const mtd_cache_t *cache)
+{
+    return cache->base.sector_count * cache->base.pages_per_sector *
+           cache->base.page_size;
+}
+
+static mtd_cache_line_t *_find(mtd_cache_t *cache, uint32_t page)
+{
+    for (unsigned i = 0; i < cache->numof; i++) {
+        if (cache->lines[i].page == page) {
+            cache->lines[i].last_used = ++cache->clock;
+            return &cache->lines[i];
+        }
+    }
+    return NULL;
+}
+
+static int _writeback(mtd_cache_t *cache, mtd_cache_line_t *line)
+{
+    if (line->dirty_end == 0) {
+        return 0;
+    }
+
+    uint32_t addr = line->page * cache->base.page_size + line->dirty_start;
+    uint32_t len = line->dirty_end - line->dirty_start;
+
+    DEBUG("mtd_cache: write back page %" PRIu32 " [%u, %u)\n", line->page,
+          line->dirty_start, line->dirty_end);
+    int res = mtd_write(cache->parent, _data(cache, line) + line->dirty_start,
+                        addr, len);
+    if (res < 0) {
+        return res;
+    }
+    cache->stats.writebacks++;
+    line->dirty_start = 0;
+    line->dirty_end = 0;
+    return 0;
+}
+
+/* get a line for @p page, evicting the least recently used page if needed,
+ * and fill it from the device */
+static int _load(mtd_cache_t *cache, uint32_t page, mtd_cache_line_t **line)
+{
+    mtd_cache_line_t *victim = &cache->lines[0];
+
+    for (unsigned i = 0; i < cache->numof; i++) {
+        mtd_cache_line_t *tmp = &cache->lines[i];
+
+        if (tmp->page == PAGE_UNUSED) {
+            victim = tmp;
+            break;
+        }
+        if ((uint32_t)(cache->clock - tmp->last_used) >
+            (uint32_t)(cache->clock - victim->last_used)) {
+            victim = tmp;
+        }
+    }
+
+    int res = _writeback(cache, victim);
+    if (res < 0) {
+        return res;
+    }
+    victim->page = PAGE_UNUSED;
+
+    uint32_t page_size = cache->base.page_size;
+    uint8_t *data = _data(cache, victim);
+    /* drivers may read less than requested */
+    for (uint32_t pos = 0; pos < page_size; pos += res) {
+        res = mtd_read(cache->parent, data + pos, page * page_size + pos,
+                       page_size - pos);
+        if (res <= 0) {
+            return (res < 0) ? res : -EIO;
+        }
+    }
+    victim->page = page;
+    victim->last_used = ++cache->clock;
+    *line = victim;
+    return 0;
+}
+
+static int _flush(mtd_cache_t *cache)
+{
+    for (unsigned i = 0; i < cache->numof; i++) {
+        int res = _writeback(cache, &cache->lines[i]);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return 0;
+}
+
+static int _init(mtd_dev_t *dev)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    mtd_dev_t *parent = cache->parent;
+
+    int res = mtd_init(parent);
+    if (res < 0) {
+        return res;
+    }
+    if (parent->page_size > UINT16_MAX) {
+        return -ENOTSUP;
+    }
+
+    unsigned numof = cache->mem_size / MTD_CACHE_LINE_SIZE(parent->page_size);
+    if (numof == 0) {
+        return -ENOMEM;
+    }
+
+    dev->sector_count = parent->sector_count;
+    dev->pages_per_sector = parent->pages_per_sector;
+    dev->page_size = parent->page_size;
+
+    mutex_init(&cache->lock);
+    cache->lines = cache->mem;
+    cache->data = (uint8_t *)(cache->lines + numof);
+    cache->numof = numof;
+    cache->clock = 0;
+    for (unsigned i = 0; i < numof; i++) {
+        cache->lines[i].page = PAGE_UNUSED;
+        cache->lines[i].dirty_start = 0;
+        cache->lines[i].dirty_end = 0;
+    }
+    memset(&cache->stats, 0, sizeof(cache->stats));
+    DEBUG("mtd_cache: caching %u pages of %" PRIu32 " bytes\n", numof,
+          dev->page_size);
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t page_size = dev->page_size;
+    uint8_t *dest = buff;
+    uint32_t left = size;
+    int res = 0;
+
+    if ((addr + size) > _size(cache) || (addr + size) < addr) {
+        return -EOVERFLOW;
+    }
+
+    mutex_lock(&cache->lock);
+    while (left > 0) {
+        uint32_t page = addr / page_size;
+        uint32_t offset = addr % page_size;
+        uint32_t len = page_size - offset;
+        mtd_cache_line_t *line;
+
+        if (len > left) {
+            len = left;
+        }
+        if ((line = _find(cache, page)) != NULL) {
+            cache->stats.hits++;
+        }
+        else if (len == page_size) {
+            /* full pages are not worth caching, read them directly */
+            cache->stats.misses++;
+            res = mtd_read(cache->parent, dest, addr, len);
+            if (res <= 0) {
+                break;
+            }
+            len = res;
+        }
+        else {
+            cache->stats.misses++;
+            if ((res = _load(cache, page, &line)) < 0) {
+                break;
+            }
+        }
+        if (line != NULL) {
+            memcpy(dest, _data(cache, line) + offset, len);
+        }
+        dest += len;
+        addr += len;
+        left -= len;
+    }
+    mutex_unlock(&cache->lock);
+
+    if ((res < 0) && (left == size)) {
+        return res;
+    }
+    return size - left;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                  uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t page_size = dev->page_size;
+    uint32_t page = addr / page_size;
+    uint32_t offset = addr % page_size;
+    mtd_cache_line_t *line;
+    int res = size;
+
+    if ((addr + size) > _size(cache) || (addr + size) < addr ||
+        (offset + size) > page_size) {
+        return -EOVERFLOW;
+    }
+    if (size == 0) {
+        return 0;
+    }
+
+    mutex_lock(&cache->lock);
+    if ((line = _find(cache, page)) != NULL) {
+        cache->stats.hits++;
+    }
+    else if (size == page_size) {
+        /* nothing to coalesce with */
+        cache->stats.misses++;
+        res = mtd_write(cache->parent, buff, addr, size);
+        goto out;
+    }
+    else {
+        cache->stats.misses++;
+        if ((res = _load(cache, page, &line)) < 0) {
+            goto out;
+        }
+        res = size;
+    }
+    /* programming only clears bits, keep the cache in line with the device */
+    uint8_t *dst = _data(cache, line) + offset;
+    const uint8_t *src = buff;
+    for (uint32_t i = 0; i < size; i++) {
+        dst[i] &= src[i];
+    }
+    if (line->dirty_end == 0) {
+        line->dirty_start = offset;
+        line->dirty_end = offset + size;
+    }
+    else {
+        if (offset < line->dirty_start) {
+            line->dirty_start = offset;
+        }
+        if ((offset + size) > line->dirty_end) {
+            line->dirty_end = offset + size;
+        }
+    }
+out:
+    mutex_unlock(&cache->lock);
+    return res;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+    uint32_t first = addr / dev->page_size;
+    uint32_t last = (addr + size) / dev->page_size;
+
+    if ((addr + size) > _size(cache) || (addr + size) < addr ||
+        (addr % sector_size) || (size % sector_size)) {
+        return -EOVERFLOW;
+    }
+
+    mutex_lock(&cache->lock);
+    int res = mtd_erase(cache->parent, addr, size);
+    if (res < 0) {
+        /* pending data is kept, the device may not have been erased */
+        goto out;
+    }
+    for (unsigned i = 0; i < cache->numof; i++) {
+        mtd_cache_line_t *line = &cache->lines[i];
+
+        if ((line->page >= first) && (line->page < last)) {
+            line->page = PAGE_UNUSED;
+            line->dirty_end = 0;
+        }
+    }
+out:
+    mutex_unlock(&cache->lock);
+    return res;
+}
+
+static int _power(mtd_dev_t *dev, enum mtd_power_state power)
+{
+    mtd_cache_t *cache = (mtd_cache_t *)dev;
+
+    if (power == MTD_POWER_DOWN) {
+        int res = mtd_cache_flush(cache);
+        if (res < 0) {
+            return res;
+        }
+    }
+    return mtd_power(cache->parent, power);
+}
+
+int mtd_cache_flush(mtd_cache_t *cache)
+{
+    mutex_lock(&cache->lock);
+    int res = _flush(cache);
+    mutex_unlock(&cache->lock);
+    return res;
+}
+
+void mtd_cache_invalidate(mtd_cache_t *cache)
+{
+    mutex_lock(&cache->lock);
+    for (unsigned i = 0; i < cache->numof; i++) {
+        cache->lines[i].page = PAGE_UNUSED;
+        cache->lines[i].dirty_end = 0;
+    }
+    mutex_unlock(&cache->lock);
+}
+
+const mtd_desc_t mtd_cache_driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+    .power = _power,
+};
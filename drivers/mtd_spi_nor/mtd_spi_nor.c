@@ -23,6 +23,7 @@
 
 #include <stdint.h>
 #include <errno.h>
+#include <string.h>
 
 #include "mtd.h"
 #if MODULE_XTIMER
@@ -48,11 +49,28 @@
 #define MTD_SPI_NOR_WRITE_WAIT_US (50 * US_PER_MS)
 #endif
 
+/* page programs complete within a few hundred usec, polling them at the erase
+ * interval would stall every write for much longer than needed */
+#ifndef MTD_SPI_NOR_PROGRAM_WAIT_US
+#define MTD_SPI_NOR_PROGRAM_WAIT_US (250)
+#endif
+
+#define MTD_64K             (65536ul)
+#define MTD_64K_ADDR_MASK   (0xFFFF)
 #define MTD_32K             (32768ul)
 #define MTD_32K_ADDR_MASK   (0x7FFF)
 #define MTD_4K              (4096ul)
 #define MTD_4K_ADDR_MASK    (0xFFF)
 
+/* SFDP header signature "SFDP", little endian */
+#define SFDP_SIGNATURE              (0x50444653ul)
+/* SFDP basic flash parameter table: only the DWORDs up to the page size are
+ * used */
+#define SFDP_BFPT_DWORDS            (11U)
+#define SFDP_BFPT_DW1_4K_MASK       (0x3ul)
+#define SFDP_BFPT_DW1_4K_SUPPORTED  (0x1ul)
+#define SFDP_BFPT_DW2_DENSITY_EXP   (0x80000000ul)
+
 static int mtd_spi_nor_init(mtd_dev_t *mtd);
 static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t size);
 static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uint32_t size);
@@ -74,11 +92,13 @@ const mtd_desc_t mtd_spi_nor_driver = {
  * @param[in]  dev    pointer to device descriptor
  * @param[in]  opcode command opcode
  * @param[in]  addr   address (big endian)
+ * @param[in]  dummy  number of dummy bytes to send after the address
  * @param[out] dest   read buffer
  * @param[in]  count  number of bytes to read after the address has been sent
  */
 static void mtd_spi_cmd_addr_read(const mtd_spi_nor_t *dev, uint8_t opcode,
-                                  be_uint32_t addr, void *dest, uint32_t count)
+                                  be_uint32_t addr, unsigned dummy,
+                                  void *dest, uint32_t count)
 {
     TRACE("mtd_spi_cmd_addr_read: %p, %02x, (%02x %02x %02x %02x), %p, %" PRIu32 "\n",
           (void *)dev, (unsigned int)opcode, addr.u8[0], addr.u8[1], addr.u8[2],
@@ -97,6 +117,10 @@ static void mtd_spi_cmd_addr_read(const mtd_spi_nor_t *dev, uint8_t opcode,
         /* Send opcode followed by address */
         spi_transfer_byte(dev->spi, dev->cs, true, opcode);
         spi_transfer_bytes(dev->spi, dev->cs, true, (char *)addr_buf, NULL, dev->addr_width);
+        /* not every SPI driver accepts a transfer without any buffer */
+        while (dummy--) {
+            spi_transfer_byte(dev->spi, dev->cs, true, 0);
+        }
 
         /* Read data */
         spi_transfer_bytes(dev->spi, dev->cs, false, NULL, dest, count);
@@ -256,7 +280,127 @@ static int mtd_spi_read_jedec_id(const mtd_spi_nor_t *dev, mtd_jedec_id_t *out)
     return status;
 }
 
-static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
+/**
+ * @internal
+ * @brief Read from the SFDP area, always 3 byte address and 1 dummy byte
+ */
+static void mtd_spi_read_sfdp(const mtd_spi_nor_t *dev, uint32_t addr,
+                              void *dest, uint32_t count)
+{
+    uint8_t cmd[] = { dev->opcode->rdsfdp, addr >> 16, addr >> 8, addr, 0 };
+
+    spi_transfer_bytes(dev->spi, dev->cs, true, cmd, NULL, sizeof(cmd));
+    spi_transfer_bytes(dev->spi, dev->cs, false, NULL, dest, count);
+}
+
+static inline uint32_t _sfdp_dword(const uint8_t *buf, unsigned n)
+{
+    buf += (n - 1) * 4;
+    return buf[0] | (buf[1] << 8) | ((uint32_t)buf[2] << 16) |
+           ((uint32_t)buf[3] << 24);
+}
+
+/* map an erase type of the BFPT to the flags if its opcode is the one of the
+ * opcode table */
+static uint16_t _sfdp_erase_flag(const mtd_spi_nor_t *dev, uint8_t size_exp,
+                                 uint8_t opcode)
+{
+    if ((size_exp == 12) && (opcode == dev->opcode->sector_erase)) {
+        return SPI_NOR_F_SECT_4K;
+    }
+    if ((size_exp == 15) && (opcode == dev->opcode->block_erase_32k)) {
+        return SPI_NOR_F_SECT_32K;
+    }
+    if ((size_exp == 16) && (opcode == dev->opcode->block_erase)) {
+        return SPI_NOR_F_SECT_64K;
+    }
+    return 0;
+}
+
+/**
+ * @internal
+ * @brief Read the basic flash parameter table and complete the configuration
+ *
+ * @return 0 if the device has an SFDP table
+ */
+static int mtd_spi_nor_sfdp(mtd_spi_nor_t *dev)
+{
+    uint8_t hdr[16];
+    uint8_t bfpt[SFDP_BFPT_DWORDS * 4];
+
+    /* SFDP header followed by the first parameter header, which is always the
+     * one of the basic flash parameter table */
+    mtd_spi_read_sfdp(dev, 0, hdr, sizeof(hdr));
+    if (_sfdp_dword(hdr, 1) != SFDP_SIGNATURE) {
+        DEBUG("mtd_spi_nor_sfdp: no SFDP\n");
+        return -ENOTSUP;
+    }
+
+    unsigned len = hdr[11];
+    uint32_t ptr = hdr[12] | (hdr[13] << 8) | ((uint32_t)hdr[14] << 16);
+    DEBUG("mtd_spi_nor_sfdp: rev %u.%u, BFPT %u DWORDs at 0x%06" PRIx32 "\n",
+          hdr[5], hdr[4], len, ptr);
+    if (len < 9) {
+        return -ENOTSUP;
+    }
+    if (len > SFDP_BFPT_DWORDS) {
+        len = SFDP_BFPT_DWORDS;
+    }
+    memset(bfpt, 0, sizeof(bfpt));
+    mtd_spi_read_sfdp(dev, ptr, bfpt, len * 4);
+
+    /* fast read (0x0b) is mandatory for SFDP devices */
+    uint16_t flag = SPI_NOR_F_FAST_READ;
+    uint32_t dw = _sfdp_dword(bfpt, 1);
+    if ((dw & SFDP_BFPT_DW1_4K_MASK) == SFDP_BFPT_DW1_4K_SUPPORTED) {
+        flag |= _sfdp_erase_flag(dev, 12, (dw >> 8) & 0xff);
+    }
+    for (unsigned i = 0; i < 4; i++) {
+        dw = _sfdp_dword(bfpt, 8 + i / 2) >> ((i % 2) * 16);
+        flag |= _sfdp_erase_flag(dev, dw & 0xff, (dw >> 8) & 0xff);
+    }
+    dev->flag |= flag;
+    DEBUG("mtd_spi_nor_sfdp: flags 0x%04x\n", dev->flag);
+
+    if (dev->base.sector_count == 0) {
+        mtd_dev_t *mtd = &dev->base;
+        uint32_t page_size = 256;
+        uint32_t sector_size;
+        uint64_t chip_size;
+
+        dw = _sfdp_dword(bfpt, 2);
+        if (dw & SFDP_BFPT_DW2_DENSITY_EXP) {
+            dw &= ~SFDP_BFPT_DW2_DENSITY_EXP;
+            /* density in bits, more than 4 GiB is not addressable anyway */
+            chip_size = (dw < 36) ? ((1ull << dw) / 8) : UINT64_MAX;
+        }
+        else {
+            chip_size = ((uint64_t)dw + 1) / 8;
+        }
+        if (len >= 11) {
+            page_size = 1ul << ((_sfdp_dword(bfpt, 11) >> 4) & 0xf);
+        }
+        if (dev->flag & SPI_NOR_F_SECT_4K) {
+            sector_size = MTD_4K;
+        }
+        else if (dev->flag & SPI_NOR_F_SECT_32K) {
+            sector_size = MTD_32K;
+        }
+        else {
+            sector_size = MTD_64K;
+        }
+        if ((chip_size > UINT32_MAX) || (chip_size < sector_size)) {
+            return -ENOTSUP;
+        }
+        mtd->page_size = page_size;
+        mtd->pages_per_sector = sector_size / page_size;
+        mtd->sector_count = chip_size / sector_size;
+    }
+    return 0;
+}
+
+static inline void wait_for_write_complete(const mtd_spi_nor_t *dev,
+                                           uint32_t poll_us)
 {
     do {
         uint8_t status;
@@ -267,8 +411,9 @@ static inline void wait_for_write_complete(const mtd_spi_nor_t *dev)
             break;
         }
 #if MODULE_XTIMER
-        xtimer_usleep(MTD_SPI_NOR_WRITE_WAIT_US);
+        xtimer_usleep(poll_us);
 #else
+        (void)poll_us;
         thread_yield();
 #endif
     } while (1);
@@ -309,6 +454,15 @@ static int mtd_spi_nor_init(mtd_dev_t *mtd)
     DEBUG("mtd_spi_nor_init: Found chip with ID: (%d, 0x%02x, 0x%02x, 0x%02x)\n",
           dev->jedec_id.bank, dev->jedec_id.manuf, dev->jedec_id.device[0], dev->jedec_id.device[1]);
 
+    if (!(dev->flag & SPI_NOR_F_NO_SFDP)) {
+        mtd_spi_nor_sfdp(dev);
+    }
+    if (mtd->sector_count == 0) {
+        DEBUG("mtd_spi_nor_init: unknown geometry\n");
+        spi_release(dev->spi);
+        return -ENODEV;
+    }
+
     uint8_t status;
     mtd_spi_cmd_read(dev, dev->opcode->rdsr, &status, sizeof(status));
     spi_release(dev->spi);
@@ -359,24 +513,23 @@ static int mtd_spi_nor_read(mtd_dev_t *mtd, void *dest, uint32_t addr, uint32_t
     if (addr > chipsize) {
         return -EOVERFLOW;
     }
-    if (size > mtd->page_size) {
-        size = mtd->page_size;
-    }
     if ((addr + size) > chipsize) {
         size = chipsize - addr;
     }
-    uint32_t page_addr_mask = dev->page_addr_mask;
-    if ((addr & page_addr_mask) != ((addr + size - 1) & page_addr_mask)) {
-        /* Reads across page boundaries must be split */
-        size = mtd->page_size - (addr & ~(page_addr_mask));
-    }
     if (size == 0) {
         return 0;
     }
     be_uint32_t addr_be = byteorder_htonl(addr);
 
+    /* the address counter of the device wraps only at the end of the memory,
+     * so the whole range is read with a single command */
     spi_acquire(dev->spi, dev->cs, dev->mode, dev->clk);
-    mtd_spi_cmd_addr_read(dev, dev->opcode->read, addr_be, dest, size);
+    if (dev->flag & SPI_NOR_F_FAST_READ) {
+        mtd_spi_cmd_addr_read(dev, dev->opcode->read_fast, addr_be, 1, dest, size);
+    }
+    else {
+        mtd_spi_cmd_addr_read(dev, dev->opcode->read, addr_be, 0, dest, size);
+    }
     spi_release(dev->spi);
 
     return size;
@@ -414,7 +567,7 @@ static int mtd_spi_nor_write(mtd_dev_t *mtd, const void *src, uint32_t addr, uin
     mtd_spi_cmd_addr_write(dev, dev->opcode->page_program, addr_be, src, size);
 
     /* waiting for the command to complete before returning */
-    wait_for_write_complete(dev);
+    wait_for_write_complete(dev, MTD_SPI_NOR_PROGRAM_WAIT_US);
 
     spi_release(dev->spi);
     return size;
@@ -454,6 +607,13 @@ static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
             mtd_spi_cmd(dev, dev->opcode->chip_erase);
             size -= total_size;
         }
+        else if ((dev->flag & SPI_NOR_F_SECT_64K) && (size >= MTD_64K) &&
+                 ((addr & MTD_64K_ADDR_MASK) == 0)) {
+            /* 64 KiB blocks can be erased with block erase command */
+            mtd_spi_cmd_addr_write(dev, dev->opcode->block_erase, addr_be, NULL, 0);
+            addr += MTD_64K;
+            size -= MTD_64K;
+        }
         else if ((dev->flag & SPI_NOR_F_SECT_32K) && (size >= MTD_32K) &&
                  ((addr & MTD_32K_ADDR_MASK) == 0)) {
             /* 32 KiB blocks can be erased with block erase command */
@@ -475,7 +635,7 @@ static int mtd_spi_nor_erase(mtd_dev_t *mtd, uint32_t addr, uint32_t size)
         }
 
         /* waiting for the command to complete before continuing */
-        wait_for_write_complete(dev);
+        wait_for_write_complete(dev, MTD_SPI_NOR_WRITE_WAIT_US);
     }
     spi_release(dev->spi);
 
@@ -332,6 +332,17 @@ static sd_init_fsm_state_t _init_sd_fsm_step(sdcard_spi_t *card, sd_init_fsm_sta
     }
 }
 
+/* spin for the first polls, then sleep between polls so that other threads
+   can run while the card is busy. Returns the number of retries to account. */
+static inline int _poll_delay(int tried)
+{
+    if (tried < SD_POLL_SPIN_CNT) {
+        return 1;
+    }
+    xtimer_usleep(SD_POLL_SLEEP_US);
+    return SD_POLL_SLEEP_US;
+}
+
 static inline bool _wait_for_token(sdcard_spi_t *card, uint8_t token, int32_t max_retries)
 {
     int tried = 0;
@@ -348,7 +359,7 @@ static inline bool _wait_for_token(sdcard_spi_t *card, uint8_t token, int32_t ma
             DEBUG("_wait_for_token: [NO MATCH] (0x%02x)\n", read_byte);
         }
 
-        tried++;
+        tried += _poll_delay(tried);
     } while ((max_retries < 0) || (tried <= max_retries));
 
     return false;
@@ -386,7 +397,7 @@ static inline bool _wait_for_not_busy(sdcard_spi_t *card, int32_t max_retries)
             return false;
         }
 
-        tried++;
+        tried += _poll_delay(tried);
     } while ((max_retries < 0) || (tried <= max_retries));
 
     DEBUG("_wait_for_not_busy: [FAILED]\n");
@@ -567,6 +578,19 @@ static inline int _transfer_bytes(sdcard_spi_t *card, const uint8_t *out, uint8_
     unsigned trans_bytes = 0;
     uint8_t in_temp;
 
+    /* move whole buffers at once with HW SPI, this lets the SPI driver use
+       DMA if available */
+    if ((_dyn_spi_rxtx_byte == &_hw_spi_rxtx_byte) && ((out != NULL) || (in != NULL))) {
+        if (out == NULL) {
+            /* the card expects dummy bytes while sending, transmit them from
+               the receive buffer that is overwritten in place */
+            memset(in, SD_CARD_DUMMY_BYTE, length);
+            out = in;
+        }
+        spi_transfer_bytes(card->params.spi_dev, GPIO_UNDEF, true, out, in, length);
+        return length;
+    }
+
     for (trans_bytes = 0; trans_bytes < length; trans_bytes++) {
         if (out != NULL) {
             trans_ret = _dyn_spi_rxtx_byte(card, out[trans_bytes], &in_temp);
@@ -748,6 +772,15 @@ static inline int _write_blocks(sdcard_spi_t *card, uint8_t cmd_idx, int bladdr,
     _select_card_spi(card);
     int written = 0;
 
+    if (cmd_idx == SD_CMD_25) {
+        /* let the card pre-erase the blocks, this is only a hint so a failure
+           is not an error */
+        uint8_t acmd23_r1 = sdcard_spi_send_acmd(card, SD_CMD_23, nbl, 0);
+        if (!R1_VALID(acmd23_r1) || R1_ERROR(acmd23_r1)) {
+            DEBUG("_write_blocks: ACMD23: [FAILED] (ignored)\n");
+        }
+    }
+
     uint32_t addr = card->use_block_addr ? bladdr : (bladdr * SD_HC_BLOCK_SIZE);
     uint8_t cmd_r1_resu = sdcard_spi_send_cmd(card, cmd_idx, addr, SD_BLOCK_WRITE_CMD_RETRIES);
 
@@ -790,9 +823,11 @@ static inline int _write_blocks(sdcard_spi_t *card, uint8_t cmd_idx, int bladdr,
                state */
             _send_dummy_byte(card);
             if (!_wait_for_not_busy(card, SD_WAIT_FOR_NOT_BUSY_CNT)) {
-                _unselect_card_spi(card);
                 *state = SD_RW_TIMEOUT;
             }
+            else {
+                *state = SD_RW_OK;
+            }
         }
         else {
             DEBUG("_write_blocks: write single block: [OK]\n");
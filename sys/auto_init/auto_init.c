@@ -164,6 +164,11 @@ void auto_init(void)
         gcoap_init();
     }
 #endif
+#ifdef MODULE_MTD_ASYNC
+    DEBUG("Auto init mtd_async\n");
+    extern kernel_pid_t mtd_async_init(void);
+    mtd_async_init();
+#endif
 #ifdef MODULE_DEVFS
     DEBUG("Mounting /dev\n");
     extern void auto_init_devfs(void);
@@ -46,6 +46,7 @@ static off_t constfs_lseek(vfs_file_t *filp, off_t off, int whence);
 static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mode, const char *abs_path);
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes);
 static ssize_t constfs_write(vfs_file_t *filp, const void *src, size_t nbytes);
+static ssize_t constfs_read_ptr(vfs_file_t *filp, const void **ptr, size_t nbytes);
 
 /* Directory operations */
 static int constfs_opendir(vfs_DIR *dirp, const char *dirname, const char *abs_path);
@@ -67,6 +68,7 @@ static const vfs_file_ops_t constfs_file_ops = {
     .open  = constfs_open,
     .read  = constfs_read,
     .write = constfs_write,
+    .read_ptr = constfs_read_ptr,
 };
 
 static const vfs_dir_ops_t constfs_dir_ops = {
@@ -230,8 +232,19 @@ static int constfs_open(vfs_file_t *filp, const char *name, int flags, mode_t mo
 
 static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
 {
-    constfs_file_t *fp = filp->private_data.ptr;
     DEBUG("constfs_read: %p, %p, %lu\n", (void *)filp, dest, (unsigned long)nbytes);
+    const void *src;
+    ssize_t res = constfs_read_ptr(filp, &src, nbytes);
+    if (res > 0) {
+        memcpy(dest, src, res);
+    }
+    DEBUG("constfs_read: read %ld bytes\n", (long)res);
+    return res;
+}
+
+static ssize_t constfs_read_ptr(vfs_file_t *filp, const void **ptr, size_t nbytes)
+{
+    constfs_file_t *fp = filp->private_data.ptr;
     if ((size_t)filp->pos >= fp->size) {
         /* Current offset is at or beyond end of file */
         return 0;
@@ -240,8 +253,8 @@ static ssize_t constfs_read(vfs_file_t *filp, void *dest, size_t nbytes)
     if (nbytes > (fp->size - filp->pos)) {
         nbytes = fp->size - filp->pos;
     }
-    memcpy(dest, fp->data + filp->pos, nbytes);
-    DEBUG("constfs_read: read %lu bytes\n", (long unsigned)nbytes);
+    /* the file contents are constant, hand them out directly */
+    *ptr = fp->data + filp->pos;
     filp->pos += nbytes;
     return nbytes;
 }
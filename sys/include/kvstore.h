@@ -0,0 +1,264 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_kvstore Key-value store on MTD
+ * @ingroup     sys
+ * @brief       Transactional key-value store for MTD devices
+ *
+ * Stores small values (e.g. configuration) by string key on a
+ * @ref drivers_mtd device:
+ *
+ * - Changes are collected between @ref kvstore_begin() and
+ *   @ref kvstore_commit() and written as a single record protected by a
+ *   CRC-16, so either all or none of them survive a reset.
+ * - Records are appended to the current sector, nothing is overwritten in
+ *   place. When the last free sector is taken into use, the oldest sector is
+ *   garbage collected: its values that were not changed since are copied to
+ *   the new sector before it is erased. One sector is always kept erased,
+ *   the usable space is one sector less than the region.
+ * - A hash table in RAM (@ref KVSTORE_INDEX_SIZE slots) maps keys to the
+ *   location of their value, so a lookup costs a single read of the key and
+ *   value from flash.
+ * - Mounting reads every record once, in large sequential reads, to fill
+ *   the index. Mount time is bounded by the size of the region and does not
+ *   grow with the number of lookups done later.
+ *
+ * A thread that started a transaction must not call any other function of
+ * the same store before committing or aborting it.
+ *
+ * Usage:
+ *
+ * ```C
+ * static kvstore_t kv = { .sector_count = 4 };
+ *
+ * kv.mtd = MTD_0;
+ * if (kvstore_mount(&kv) < 0) {
+ *     kvstore_format(&kv);
+ * }
+ * kvstore_begin(&kv);
+ * kvstore_put(&kv, "ssid", ssid, strlen(ssid));
+ * kvstore_put(&kv, "psk", psk, strlen(psk));
+ * kvstore_commit(&kv);
+ *
+ * kvstore_get(&kv, "ssid", buf, sizeof(buf));
+ * ```
+ *
+ * @{
+ *
+ * @file
+ * @brief       Key-value store interface
+ */
+
+#ifndef KVSTORE_H
+#define KVSTORE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mtd.h"
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of slots of the RAM index
+ *
+ * One slot is needed per key, one slot is kept free. Must be a power of two.
+ */
+#ifndef KVSTORE_INDEX_SIZE
+#define KVSTORE_INDEX_SIZE      (64U)
+#endif
+
+#if (KVSTORE_INDEX_SIZE & (KVSTORE_INDEX_SIZE - 1)) != 0 || \
+    (KVSTORE_INDEX_SIZE > 65536U)
+#error "KVSTORE_INDEX_SIZE must be a power of two, at most 65536"
+#endif
+
+/**
+ * @brief   Size of the transaction buffer
+ *
+ * Limits the changes of a single transaction, each change takes 4 bytes plus
+ * the length of key and value.
+ */
+#ifndef KVSTORE_BATCH_SIZE
+#define KVSTORE_BATCH_SIZE      (256U)
+#endif
+
+/**
+ * @brief   Maximum length of a key
+ */
+#ifndef KVSTORE_KEY_MAX
+#define KVSTORE_KEY_MAX         (32U)
+#endif
+
+/**
+ * @brief   Slot of the RAM index
+ */
+typedef struct {
+    uint32_t addr;              /**< location of the value, UINT32_MAX if
+                                 *   unused */
+    uint16_t hash;              /**< hash of the key */
+    uint16_t len;               /**< length of the value */
+} kvstore_slot_t;
+
+/**
+ * @brief   Flash access statistics
+ */
+typedef struct {
+    uint32_t writes;            /**< calls to @ref mtd_write() */
+    uint32_t erases;            /**< sectors erased */
+    uint32_t gcs;               /**< sectors garbage collected */
+} kvstore_stats_t;
+
+/**
+ * @brief   Key-value store descriptor
+ *
+ * Only kvstore_t::mtd, kvstore_t::first_sector and kvstore_t::sector_count
+ * are set by the user, the other members are internal.
+ */
+typedef struct {
+    mtd_dev_t *mtd;             /**< the device */
+    uint32_t first_sector;      /**< first sector used by the store */
+    /**
+     * @brief   number of sectors used by the store, at least 2, 0 to use the
+     *          rest of the device
+     */
+    uint32_t sector_count;
+    mutex_t lock;               /**< protects the store */
+    uint32_t numof;             /**< number of sectors in use */
+    uint32_t sector_size;       /**< sector size in bytes */
+    uint32_t active;            /**< sector written to */
+    uint32_t active_seq;        /**< sequence number of the active sector */
+    uint32_t used;              /**< number of sectors holding data */
+    uint32_t erased;            /**< erased sectors following the active one */
+    uint32_t wpos;              /**< write position in the active sector */
+    unsigned keys;              /**< number of keys */
+    bool sealed;                /**< active sector must not be appended to */
+    kvstore_stats_t stats;      /**< flash access statistics */
+    uint16_t batch_len;         /**< bytes used in kvstore_t::batch */
+    uint8_t batch[KVSTORE_BATCH_SIZE];          /**< pending changes */
+    kvstore_slot_t index[KVSTORE_INDEX_SIZE];   /**< the RAM index */
+} kvstore_t;
+
+/**
+ * @brief   Erases the store
+ *
+ * @param[in] kv        The store
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the geometry of the device is not supported
+ * @return  < 0 on other errors
+ */
+int kvstore_format(kvstore_t *kv);
+
+/**
+ * @brief   Opens an existing store and builds the index
+ *
+ * A store without any valid sector is opened as empty store.
+ *
+ * @param[in] kv        The store
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the geometry of the device is not supported
+ * @return  -ENOMEM if there are more keys than slots in the index
+ * @return  < 0 on other errors
+ */
+int kvstore_mount(kvstore_t *kv);
+
+/**
+ * @brief   Gets a value
+ *
+ * @param[in] kv        The store
+ * @param[in] key       The key
+ * @param[out] value    Buffer for the value
+ * @param[in] len       Size of @p value
+ *
+ * @return  length of the value
+ * @return  -ENOENT if there is no value for @p key
+ * @return  -ENOBUFS if the value does not fit into @p value
+ * @return  < 0 on other errors
+ */
+int kvstore_get(kvstore_t *kv, const char *key, void *value, size_t len);
+
+/**
+ * @brief   Starts a transaction
+ *
+ * @param[in] kv        The store
+ */
+void kvstore_begin(kvstore_t *kv);
+
+/**
+ * @brief   Sets a value within a transaction
+ *
+ * @param[in] kv        The store
+ * @param[in] key       The key, 1 to @ref KVSTORE_KEY_MAX characters
+ * @param[in] value     The value
+ * @param[in] len       Length of @p value
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p key is too long or empty
+ * @return  -ENOBUFS if the change does not fit into the transaction
+ */
+int kvstore_put(kvstore_t *kv, const char *key, const void *value,
+                size_t len);
+
+/**
+ * @brief   Removes a value within a transaction
+ *
+ * @param[in] kv        The store
+ * @param[in] key       The key
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p key is too long or empty
+ * @return  -ENOBUFS if the change does not fit into the transaction
+ */
+int kvstore_delete(kvstore_t *kv, const char *key);
+
+/**
+ * @brief   Writes all changes of a transaction and ends it
+ *
+ * @param[in] kv        The store
+ *
+ * @return  0 on success
+ * @return  -ENOMEM if the index has not enough free slots
+ * @return  -ENOSPC if the store is full
+ * @return  < 0 on device errors, none of the changes was made
+ */
+int kvstore_commit(kvstore_t *kv);
+
+/**
+ * @brief   Drops all changes of a transaction and ends it
+ *
+ * @param[in] kv        The store
+ */
+void kvstore_abort(kvstore_t *kv);
+
+/**
+ * @brief   Sets a single value
+ *
+ * Shorthand for a transaction with a single @ref kvstore_put().
+ *
+ * @param[in] kv        The store
+ * @param[in] key       The key
+ * @param[in] value     The value
+ * @param[in] len       Length of @p value
+ *
+ * @return  see @ref kvstore_put() and @ref kvstore_commit()
+ */
+int kvstore_set(kvstore_t *kv, const char *key, const void *value, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* KVSTORE_H */
+/** @} */
@@ -25,6 +25,7 @@
 #ifndef NET_CSMA_SENDER_H
 #define NET_CSMA_SENDER_H
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "net/netdev.h"
@@ -63,13 +64,61 @@ extern "C" {
 #define CSMA_SENDER_BACKOFF_PERIOD_UNIT     (320U)
 #endif
 
+/**
+ * @name    Adaptive CSMA/CA
+ *
+ * With the `csma_sender_adaptive` module the software CSMA/CA procedure
+ * starts with a backoff exponent between the configured minimum and maximum
+ * backoff exponent that adapts to the observed channel conditions: The
+ * busy rate of the clear channel assessments on the current channel and the
+ * rate of transmissions to a neighbor that needed link-layer retries raise
+ * it, idle channels and clean links lower it again.
+ * @{
+ */
+/**
+ * @brief   Number of channels the adaptive mode keeps statistics for
+ */
+#ifndef CSMA_SENDER_ADAPTIVE_CHANNELS_NUMOF
+#define CSMA_SENDER_ADAPTIVE_CHANNELS_NUMOF (2U)
+#endif
+
+/**
+ * @brief   Number of neighbors the adaptive mode keeps statistics for
+ */
+#ifndef CSMA_SENDER_ADAPTIVE_NBRS_NUMOF
+#define CSMA_SENDER_ADAPTIVE_NBRS_NUMOF     (8U)
+#endif
+
+/**
+ * @brief   Maximum link-layer address length of a neighbor
+ */
+#ifndef CSMA_SENDER_ADAPTIVE_L2ADDR_MAX
+#define CSMA_SENDER_ADAPTIVE_L2ADDR_MAX     (8U)
+#endif
+
+/**
+ * @brief   Weight of a new sample in the moving averages of the rates as
+ *          a power of two, i.e. a new sample has a weight of 2^-x
+ */
+#ifndef CSMA_SENDER_ADAPTIVE_EWMA_SHIFT
+#define CSMA_SENDER_ADAPTIVE_EWMA_SHIFT     (3U)
+#endif
+
+/**
+ * @brief   Fixed-point scale of the rates in @ref csma_sender_link_t, i.e.
+ *          the value of a rate of 100%
+ */
+#define CSMA_SENDER_ADAPTIVE_RATE_SCALE     (256U)
+/** @} */
+
 /**
  * @brief   Configuration type for backoff
  */
 typedef struct {
     uint8_t min_be;             /**< minimum backoff exponent */
     uint8_t max_be;             /**< maximum backoff exponent */
-    uint16_t max_backoffs;      /**< maximum number of retries */
+    uint16_t max_backoffs;      /**< maximum number of retries after the
+                                     first clear channel assessment */
     uint32_t backoff_period;    /**< backoff period in microseconds */
 } csma_sender_conf_t;
 
@@ -78,6 +127,60 @@ typedef struct {
  */
 extern const csma_sender_conf_t CSMA_SENDER_CONF_DEFAULT;
 
+/**
+ * @brief   Counters of the adaptive CSMA/CA procedure
+ */
+typedef struct {
+    uint32_t tx_count;          /**< started CSMA/CA procedures */
+    uint32_t cca_count;         /**< performed clear channel assessments */
+    uint32_t cca_busy;          /**< clear channel assessments reporting a
+                                     busy medium */
+    uint32_t access_failed;     /**< procedures that never found the medium
+                                     idle */
+    uint32_t tx_retried;        /**< transmissions that needed link-layer
+                                     retries */
+    uint32_t tx_noack;          /**< transmissions that were never
+                                     acknowledged */
+} csma_sender_counters_t;
+
+/**
+ * @brief   Statistics of the adaptive CSMA/CA procedure for a channel or a
+ *          neighbor on a channel
+ */
+typedef struct {
+    csma_sender_counters_t cnt;     /**< counters */
+    uint32_t last_used;             /**< for replacement of the entry */
+    uint16_t channel;               /**< channel of the entry */
+    uint16_t busy_rate;             /**< moving average of busy CCAs */
+    uint16_t retry_rate;            /**< moving average of retried
+                                     *   transmissions */
+    uint8_t be;                     /**< current initial backoff exponent */
+    uint8_t addr_len;               /**< length of @ref csma_sender_link_t::addr,
+                                     *   0 for channel entries */
+    uint8_t addr[CSMA_SENDER_ADAPTIVE_L2ADDR_MAX];  /**< neighbor address */
+} csma_sender_link_t;
+
+/**
+ * @brief   State of the adaptive CSMA/CA procedure of a device
+ *
+ * Provided via @ref NETOPT_STATS with the context @ref NETSTATS_CSMA by
+ * network interfaces that use the adaptive mode. Zero-initialize before use.
+ */
+typedef struct {
+    /**
+     * @brief   per-channel statistics
+     */
+    csma_sender_link_t channels[CSMA_SENDER_ADAPTIVE_CHANNELS_NUMOF];
+    /**
+     * @brief   per-neighbor statistics
+     */
+    csma_sender_link_t nbrs[CSMA_SENDER_ADAPTIVE_NBRS_NUMOF];
+    csma_sender_link_t *last_channel;   /**< channel of the last transmission */
+    csma_sender_link_t *last_nbr;       /**< neighbor of the last transmission,
+                                         *   NULL for broadcast */
+    uint32_t uses;                      /**< number of entry look-ups */
+} csma_sender_stats_t;
+
 /**
  * @brief   Sends a 802.15.4 frame using the CSMA/CA method
  *
@@ -86,6 +189,9 @@ extern const csma_sender_conf_t CSMA_SENDER_CONF_DEFAULT;
  * If the transceiver can (and is configured to) do hardware-assisted
  * CSMA/CA, this feature is used. Otherwise, a software procedure is used.
  *
+ * The software procedure performs at most
+ * @ref csma_sender_conf_t::max_backoffs + 1 clear channel assessments.
+ *
  * @param[in] dev       netdev device, needs to be already initialized
  * @param[in] iolist    pointer to the data
  * @param[in] conf      configuration for the backoff;
@@ -133,6 +239,47 @@ int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
  */
 int csma_sender_cca_send(netdev_t *dev, iolist_t *iolist);
 
+#if defined(MODULE_CSMA_SENDER_ADAPTIVE) || defined(DOXYGEN)
+/**
+ * @brief   Sends a 802.15.4 frame using the CSMA/CA method with an adaptive
+ *          initial backoff exponent
+ *
+ * @pre `dev != NULL && stats != NULL`
+ *
+ * Same as @ref csma_sender_csma_ca_send(), but the software procedure
+ * starts with a backoff exponent derived from @p stats and updates @p stats
+ * with the outcome of every clear channel assessment. Report the result of
+ * the transmission with @ref csma_sender_tx_done() once it is known.
+ *
+ * @param[in] dev       netdev device, needs to be already initialized
+ * @param[in] iolist    pointer to the data
+ * @param[in] conf      configuration for the backoff;
+ *                      will be set to @ref CSMA_SENDER_CONF_DEFAULT if NULL.
+ * @param[in,out] stats statistics of @p dev
+ * @param[in] dst       link-layer destination, NULL for broadcast frames
+ * @param[in] dst_len   length of @p dst
+ *
+ * @return  see @ref csma_sender_csma_ca_send()
+ */
+int csma_sender_csma_ca_send_adaptive(netdev_t *dev, iolist_t *iolist,
+                                      const csma_sender_conf_t *conf,
+                                      csma_sender_stats_t *stats,
+                                      const uint8_t *dst, size_t dst_len);
+
+/**
+ * @brief   Reports the result of the last transmission started with
+ *          @ref csma_sender_csma_ca_send_adaptive()
+ *
+ * @param[in,out] stats statistics of the device
+ * @param[in] status    0 on success, -EHOSTUNREACH if no acknowledgment was
+ *                      received, -EBUSY if a hardware CSMA/CA procedure
+ *                      never found the medium idle
+ * @param[in] retries   number of link-layer retries the transmission needed
+ */
+void csma_sender_tx_done(csma_sender_stats_t *stats, int status,
+                         unsigned retries);
+#endif /* MODULE_CSMA_SENDER_ADAPTIVE || DOXYGEN */
+
 
 #ifdef __cplusplus
 }
@@ -526,6 +526,55 @@ extern "C" {
  */
 #define GCOAP_MSG_TYPE_INTR     (0x1502)
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Maximum number of blocks sent in reply to a single Q-Block2
+ *          request (RFC 9177)
+ *
+ * A non-confirmable GET carrying a Q-Block2 option with the M bit set is
+ * answered with up to this many consecutive blocks, each in its own
+ * non-confirmable response. A request carrying several Q-Block2 options
+ * without the M bit, as sent by a client to recover missing blocks, is
+ * answered with the listed blocks. Resource handlers see a plain Block2
+ * request for each block and don't need to be aware of Q-Block.
+ *
+ * Costs two additional PDU buffers of @ref GCOAP_PDU_BUF_SIZE. 0 disables
+ * Q-Block2 support, so such requests are handled like any other request.
+ */
+#ifndef GCOAP_QBLOCK_BURST
+#define GCOAP_QBLOCK_BURST          (0)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of responses kept in the response cache
+ *
+ * Successful (2.05) responses to GET requests for resources flagged with
+ * @ref COAP_CACHEABLE are cached, keyed by the request's URI path, query
+ * and Accept option. Until the response's Max-Age (60 s if absent) has
+ * elapsed, matching requests are answered from the cache without invoking
+ * the resource handler; a request carrying the cached ETag is answered with
+ * 2.03 Valid. Requests with Observe or Block2 options bypass the cache.
+ *
+ * Costs @ref GCOAP_PDU_BUF_SIZE plus @ref NANOCOAP_URI_MAX bytes per entry.
+ * 0 disables the cache.
+ */
+#ifndef GCOAP_RESP_CACHE_SIZE
+#define GCOAP_RESP_CACHE_SIZE       (0)
+#endif
+
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of slots in the hashed resource dispatch index
+ *
+ * Set to a power of two larger than the total number of resources of all
+ * registered listeners to dispatch requests by hash instead of searching all
+ * listeners linearly. Costs one pointer per slot. 0 disables the index.
+ */
+#ifndef GCOAP_RESOURCE_INDEX_SIZE
+#define GCOAP_RESOURCE_INDEX_SIZE   (0)
+#endif
+
 /**
  * @ingroup net_gcoap_conf
  * @brief   Maximum number of Observe clients
@@ -542,6 +591,18 @@ extern "C" {
 #define GCOAP_OBS_REGISTRATIONS_MAX     (2)
 #endif
 
+/**
+ * @ingroup net_gcoap_conf
+ * @brief   Number of hash buckets to look up open requests by token and
+ *          Observe registrations by resource
+ *
+ * Must be a power of two. Raise along with @ref GCOAP_REQ_WAITING_MAX and
+ * @ref GCOAP_OBS_REGISTRATIONS_MAX to keep the per-bucket chains short.
+ */
+#ifndef GCOAP_MEMO_INDEX_BUCKETS
+#define GCOAP_MEMO_INDEX_BUCKETS        (4)
+#endif
+
 /**
  * @name    States for the memo used to track Observe registrations
  * @{
@@ -695,16 +756,20 @@ struct gcoap_request_memo {
     void *context;                      /**< ptr to user defined context data */
     xtimer_t response_timer;            /**< Limits wait for response */
     msg_t timeout_msg;                  /**< For response timer */
+    gcoap_request_memo_t *next;         /**< Next memo in the same token hash
+                                             bucket; internal use only */
 };
 
 /**
  * @brief   Memo for Observe registration and notifications
  */
-typedef struct {
+typedef struct gcoap_observe_memo {
     sock_udp_ep_t *observer;            /**< Client endpoint; unused if null */
     const coap_resource_t *resource;    /**< Entity being observed */
     uint8_t token[GCOAP_TOKENLEN_MAX];  /**< Client token for notifications */
     unsigned token_len;                 /**< Actual length of token attribute */
+    struct gcoap_observe_memo *next;    /**< Next memo in the same resource
+                                             hash bucket; internal use only */
 } gcoap_observe_memo_t;
 
 /**
@@ -894,6 +959,18 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 size_t gcoap_obs_send(const uint8_t *buf, size_t len,
                       const coap_resource_t *resource);
 
+/**
+ * @brief   Drops cached responses of a resource from the response cache
+ *
+ * Call this when the representation of a @ref COAP_CACHEABLE resource
+ * changes before its cached responses expire. gcoap_obs_send() and
+ * gcoap_register_listener() invalidate the cache implicitly. Does nothing
+ * if @ref GCOAP_RESP_CACHE_SIZE is 0.
+ *
+ * @param[in] resource  Resource to invalidate; NULL to flush the whole cache
+ */
+void gcoap_resp_cache_invalidate(const coap_resource_t *resource);
+
 /**
  * @brief   Provides important operational statistics
  *
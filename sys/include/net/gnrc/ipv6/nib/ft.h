@@ -42,6 +42,15 @@ typedef struct {
     uint16_t iface;         /**< interface to gnrc_ipv6_nib_ft_t::next_hop */
 } gnrc_ipv6_nib_ft_t;
 
+/**
+ * @brief   Destination of a route for gnrc_ipv6_nib_ft_add_multi()
+ */
+typedef struct {
+    const ipv6_addr_t *dst; /**< destination or prefix */
+    unsigned dst_len;       /**< prefix-length in bits of
+                             *   gnrc_ipv6_nib_ft_dst_t::dst */
+} gnrc_ipv6_nib_ft_dst_t;
+
 /**
  * @brief   Gets the best matching forwarding table entry to a destination
  *
@@ -83,6 +92,38 @@ int gnrc_ipv6_nib_ft_add(const ipv6_addr_t *dst, unsigned dst_len,
                          const ipv6_addr_t *next_hop, unsigned iface,
                          uint16_t lifetime);
 
+/**
+ * @brief   Adds or replaces routes to several destinations via the same next
+ *          hop
+ *
+ * Has the same effect as calling gnrc_ipv6_nib_ft_del() and
+ * gnrc_ipv6_nib_ft_add() for every destination in @p dsts, but the NIB is
+ * only acquired once and a route that already points to @p next_hop is only
+ * refreshed instead of being removed and re-created. This makes it the
+ * preferred way for routing protocols to install many routes at once (e.g.
+ * from all targets of an RPL DAO).
+ *
+ * @note    Only available if @ref GNRC_IPV6_NIB_CONF_ROUTER.
+ *
+ * @param[in] dsts      The destinations of the routes. Default routes are not
+ *                      allowed.
+ * @param[in] numof     Number of entries in @p dsts.
+ * @param[in] next_hop  The next hop to all @p dsts. May be NULL.
+ * @param[in] iface     The interface to @p next_hop. May not be 0.
+ * @param[in] lifetime  Lifetime of the routes in seconds. 0 for infinite
+ *                      lifetime.
+ *
+ * @return  0, on success.
+ * @return  -EINVAL, if a parameter was of invalid value.
+ * @return  -ENOMEM, if there was no space left in forwarding table for at
+ *          least one of the routes. All other routes are still installed.
+ * @return  -ENOTSUP, if the NIB is not compiled with
+ *          @ref GNRC_IPV6_NIB_CONF_ROUTER.
+ */
+int gnrc_ipv6_nib_ft_add_multi(const gnrc_ipv6_nib_ft_dst_t *dsts,
+                               unsigned numof, const ipv6_addr_t *next_hop,
+                               unsigned iface, uint16_t lifetime);
+
 /**
  * @brief   Deletes a route from forwarding table.
  *
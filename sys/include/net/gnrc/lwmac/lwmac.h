@@ -246,16 +246,16 @@ extern "C" {
  * 1. The sender first uses WR stream to locate the receiver's wake-up period (if the
  * sender has already phase-locked the receiver's phase, normally the sender only cost
  * one WR to get the first WA from the receiver) and then sends its first data.
- * 2. After the transmission of the first data, the sender immediately sends a WR to
- * the receiver for starting the second round of transmission of the second data. The
- * receiver should also immediately reply WA for continue receiving data packets. In
- * case the sender doesn't receive WA during @ref GNRC_LWMAC_TIME_BETWEEN_WR_US, it regards the
- * consecutive (burst) transmission failed and quits TX procedure (the data will be queued
- * back to the transmission queue for normal transmission attempt in following cycles).
- * 3. In case the second transmission succeeds, the sender repeats step (2) to send all the
- * following pending packets.
- * In short, in burst transmission mode, the sender doesn't tolerate no-WA event. ALl the
- * pending data packets should be sent with only one WR cost for leading the transmission.
+ * 2. The first data is sent with type @ref GNRC_LWMAC_FRAMETYPE_DATA_PENDING, telling the
+ * receiver to stay awake. As soon as the data is acknowledged, the sender takes the next
+ * packet from the receiver's queue and sends it right away, without another WR/WA
+ * handshake. The receiver waits @ref GNRC_LWMAC_DATA_DELAY_US for each following data.
+ * 3. This is repeated until the queue is empty or this limit is reached, the last data
+ * is then sent with type @ref GNRC_LWMAC_FRAMETYPE_DATA. If a burst data is not
+ * acknowledged, the sender quits the TX procedure and the remaining packets are sent in
+ * following cycles.
+ * In short, all the pending data packets are sent within one rendezvous, with only the
+ * WR stream of the first packet for leading the transmission.
  */
 #ifndef GNRC_LWMAC_MAX_TX_BURST_PKT_NUM
 #define GNRC_LWMAC_MAX_TX_BURST_PKT_NUM      (GNRC_LWMAC_WAKEUP_INTERVAL_US / GNRC_LWMAC_WAKEUP_DURATION_US)
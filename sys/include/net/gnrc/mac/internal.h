@@ -113,6 +113,36 @@ static inline void gnrc_netif_set_tx_feedback(gnrc_netif_t *netif,
  * @return                  true if queued successfully, otherwise false.
  */
 bool gnrc_mac_queue_tx_packet(gnrc_mac_tx_t *tx, uint32_t priority, gnrc_pktsnip_t *pkt);
+
+#if (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN)
+/**
+ * @brief Cost of serving a neighbor now, see @ref gnrc_mac_next_tx_neighbor()
+ *
+ * @param[in] neighbor      a neighbor with queued packets
+ *
+ * @return                  the cost, lower is better
+ */
+typedef uint32_t (*gnrc_mac_tx_neighbor_cost_t)(const gnrc_mac_tx_neighbor_t *neighbor);
+
+/**
+ * @brief Selects the neighbor whose queue should be served next.
+ *        Among all neighbors (including the `broadcast-neighbor`) with queued
+ *        packets the one with the lowest @p cost is chosen, e.g. the one
+ *        that wakes up next. Ties are broken round-robin, starting after
+ *        gnrc_mac_tx_t::last_tx_neighbor_id, so a neighbor with a permanently
+ *        filled queue can't starve the others. The caller is expected to
+ *        update gnrc_mac_tx_t::last_tx_neighbor_id once it actually starts
+ *        serving the selected neighbor.
+ *
+ * @param[in] tx            gnrc_mac transmission management object
+ * @param[in] cost          cost function, NULL for plain round-robin
+ *
+ * @return                  index of the neighbor in gnrc_mac_tx_t::neighbors
+ * @return                  -ENOENT if no packets are queued
+ */
+int gnrc_mac_next_tx_neighbor(gnrc_mac_tx_t *tx,
+                              gnrc_mac_tx_neighbor_cost_t cost);
+#endif /* (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN) */
 #endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) || defined(DOXYGEN) */
 
 #if (GNRC_MAC_RX_QUEUE_SIZE != 0) || defined(DOXYGEN)
@@ -137,6 +167,23 @@ bool gnrc_mac_queue_rx_packet(gnrc_mac_rx_t *rx, uint32_t priority, gnrc_pktsnip
 void gnrc_mac_dispatch(gnrc_mac_rx_t *rx);
 #endif /* (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0) || defined(DOXYGEN) */
 
+#if defined(MODULE_CSMA_SENDER_ADAPTIVE) || defined(DOXYGEN)
+/**
+ * @brief Reports the outcome of a transmission to the adaptive CSMA/CA
+ *        statistics of the device
+ *
+ * This function is intended to be called only in netdev_t::event_callback()
+ * on NETDEV_EVENT_TX_COMPLETE, NETDEV_EVENT_TX_NOACK and
+ * NETDEV_EVENT_TX_MEDIUM_BUSY. Transmissions are only reported while
+ * @ref GNRC_NETIF_MAC_INFO_CSMA_ENABLED is set, i.e. if they were started
+ * with @ref csma_sender_csma_ca_send_adaptive().
+ *
+ * @param[in,out] netif     the network interface
+ * @param[in]     event     the TX event
+ */
+void gnrc_mac_csma_tx_done(gnrc_netif_t *netif, netdev_event_t event);
+#endif /* defined(MODULE_CSMA_SENDER_ADAPTIVE) || defined(DOXYGEN) */
+
 #ifdef __cplusplus
 }
 #endif
@@ -188,6 +188,10 @@ typedef struct {
 
     gnrc_priority_pktqueue_node_t _queue_nodes[GNRC_MAC_TX_QUEUE_SIZE]; /**< Shared buffer for TX queue nodes */
     gnrc_pktsnip_t *packet;                                             /**< currently scheduled packet for sending */
+#if (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN)
+    uint8_t last_tx_neighbor_id;                                        /**< Index of the neighbor served last, see
+                                                                             @ref gnrc_mac_next_tx_neighbor() */
+#endif /* (GNRC_MAC_NEIGHBOR_COUNT != 0) || defined(DOXYGEN) */
 #endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) || defined(DOXYGEN) */
 
 #ifdef MODULE_GNRC_LWMAC
@@ -210,7 +214,6 @@ typedef struct {
     gnrc_gomach_vtdma_t vtdma_para;               /**< Node's vTMDA slots allocation management unit. */
     uint8_t no_ack_counter;                       /**< Counter for recording no-ACK times for data transmission. */
     uint8_t t2u_retry_counter;                    /**< Counter for recording t2u attempt failures. */
-    uint8_t last_tx_neighbor_id;                  /**< Record last TX neighbor's sequence in the neighbor list. */
     uint8_t tx_busy_count;                        /**< Counter recording csma busy feedback times. */
     uint8_t t2u_fail_count;                       /**< Preamble trial failure count. */
 #endif
@@ -225,6 +228,7 @@ typedef struct {
         NULL, \
         { PRIORITY_PKTQUEUE_NODE_INIT(0, NULL) }, \
         NULL, \
+        0, \
 }
 #elif ((GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT == 0)) || defined(DOXYGEN)
 #define GNRC_MAC_TX_INIT { \
@@ -54,6 +54,33 @@
  * USEMODULE += gnrc_netapi_callbacks
  * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
  * @}
+ *
+ * @defgroup    net_gnrc_rx_direct   Run-to-completion receive path
+ * @ingroup     net_gnrc_netapi
+ * @brief       Hands received packets up the stack by function call
+ * @{
+ * @details The submodule `gnrc_rx_direct` makes 6LoWPAN, IPv6 and UDP
+ *          register @ref net_gnrc_netapi_callbacks "callbacks" instead of
+ *          their thread. A received packet then travels from the network
+ *          interface up to the sock or application without a context
+ *          switch per layer, all in the thread of the network interface.
+ *
+ * Sending and control traffic keep going through the layer threads. The
+ * IPv6 layer only handles UDP, TCP and ICMPv6 echo packets directly; neighbor
+ * discovery and packets with extension headers are handed to its thread. A
+ * packet is also handed over whenever the layer's thread is busy, so lower
+ * layers never block on an upper layer.
+ *
+ * The stack of each network interface thread needs to be large enough for
+ * the whole receive path.
+ *
+ * To use, add the module `gnrc_rx_direct` to the `USEMODULE` macro in your
+ * application's Makefile:
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~ {.mk}
+ * USEMODULE += gnrc_rx_direct
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * @}
  */
 
 #ifndef NET_GNRC_NETAPI_H
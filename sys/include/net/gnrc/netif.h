@@ -56,6 +56,9 @@
 #ifdef MODULE_NETSTATS_L2
 #include "net/netstats.h"
 #endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+#include "net/netstats/neighbor.h"
+#endif
 #include "rmutex.h"
 #include "net/netif.h"
 
@@ -79,6 +82,10 @@ typedef struct {
 #ifdef MODULE_NETSTATS_L2
     netstats_t stats;                       /**< transceiver's statistics */
 #endif
+#if defined(MODULE_NETSTATS_NEIGHBOR) || DOXYGEN
+    netstats_nb_table_t neighbors;          /**< link statistics of the
+                                             *   link-layer neighbors */
+#endif
 #if defined(MODULE_GNRC_LORAWAN) || DOXYGEN
     gnrc_netif_lorawan_t lorawan;           /**< LoRaWAN component */
 #endif
@@ -517,6 +524,30 @@ char *gnrc_netif_addr_to_str(const uint8_t *addr, size_t addr_len, char *out);
  */
 size_t gnrc_netif_addr_from_str(const char *str, uint8_t *out);
 
+#if (defined(MODULE_NETSTATS_NEIGHBOR) && defined(MODULE_GNRC_IPV6)) || \
+    defined(DOXYGEN)
+/**
+ * @brief   Gets the link statistics of an IPv6 neighbor
+ *
+ * The link-layer address of the neighbor is derived from the interface
+ * identifier of @p addr, so this works for the link-local addresses used by
+ * routing protocols to identify neighbors (e.g. RPL parents).
+ *
+ * @note    Only available with module `netstats_neighbor`.
+ *
+ * @param[in] netif     The network interface @p addr is reachable over.
+ * @param[in] addr      An IPv6 address of the neighbor.
+ * @param[out] stats    The statistics of the neighbor. May be NULL.
+ *
+ * @return  0 on success.
+ * @return  -ENOENT, if there are no statistics for the neighbor.
+ * @return  -ENOTSUP, if the link-layer address can not be derived from
+ *          @p addr on @p netif.
+ */
+int gnrc_netif_ipv6_nb_stats(gnrc_netif_t *netif, const ipv6_addr_t *addr,
+                             netstats_nb_t *stats);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
@@ -80,6 +80,15 @@ typedef struct {
      */
     csma_sender_conf_t csma_conf;
 
+#if defined(MODULE_CSMA_SENDER_ADAPTIVE) || DOXYGEN
+    /**
+     * @brief device's adaptive software CSMA state and statistics
+     *
+     * @note    Only available with the `csma_sender_adaptive` module.
+     */
+    csma_sender_stats_t csma_stats;
+#endif
+
 #if ((GNRC_MAC_RX_QUEUE_SIZE != 0) || (GNRC_MAC_DISPATCH_BUFFER_SIZE != 0)) || DOXYGEN
     /**
      * @brief MAC internal object which stores reception parameters, queues, and
@@ -72,6 +72,19 @@ typedef enum {
 } gnrc_netreg_type_t;
 #endif
 
+/**
+ * @brief   Number of hash buckets of the registry
+ *
+ * By default the registry keeps one list per @ref gnrc_nettype_t, so a
+ * lookup is linear in the number of entries of that type (e.g. the number of
+ * bound UDP ports). Set to a power of two to hash entries by type and
+ * @ref gnrc_netreg_entry_t::demux_ctx into this many buckets instead. This
+ * adds a gnrc_netreg_entry_t::nettype field to every entry.
+ */
+#ifndef GNRC_NETREG_BUCKETS
+#define GNRC_NETREG_BUCKETS         (0)
+#endif
+
 /**
  * @brief   Demux context value to get all packets of a certain type.
  *
@@ -79,6 +92,18 @@ typedef enum {
  */
 #define GNRC_NETREG_DEMUX_CTX_ALL   (0xffff0000)
 
+/**
+ * @brief   Initializer of gnrc_netreg_entry_t::nettype in the static entry
+ *          initialization macros
+ *
+ * @internal
+ */
+#if GNRC_NETREG_BUCKETS
+#define _GNRC_NETREG_NETTYPE_INIT   , GNRC_NETTYPE_UNDEF
+#else
+#define _GNRC_NETREG_NETTYPE_INIT
+#endif
+
 /**
  * @name    Static entry initialization macros
  * @anchor  net_gnrc_netreg_init_static
@@ -96,9 +121,11 @@ typedef enum {
 #if defined(MODULE_GNRC_NETAPI_MBOX) || defined(MODULE_GNRC_NETAPI_CALLBACKS)
 #define GNRC_NETREG_ENTRY_INIT_PID(demux_ctx, pid)  { NULL, demux_ctx, \
                                                       GNRC_NETREG_TYPE_DEFAULT, \
-                                                      { pid } }
+                                                      { pid } \
+                                                      _GNRC_NETREG_NETTYPE_INIT }
 #else
-#define GNRC_NETREG_ENTRY_INIT_PID(demux_ctx, pid)  { NULL, demux_ctx, { pid } }
+#define GNRC_NETREG_ENTRY_INIT_PID(demux_ctx, pid)  { NULL, demux_ctx, { pid } \
+                                                      _GNRC_NETREG_NETTYPE_INIT }
 #endif
 
 #if defined(MODULE_GNRC_NETAPI_MBOX) || defined(DOXYGEN)
@@ -115,7 +142,8 @@ typedef enum {
  */
 #define GNRC_NETREG_ENTRY_INIT_MBOX(demux_ctx, _mbox) { NULL, demux_ctx, \
                                                        GNRC_NETREG_TYPE_MBOX, \
-                                                       { .mbox = _mbox } }
+                                                       { .mbox = _mbox } \
+                                                       _GNRC_NETREG_NETTYPE_INIT }
 #endif
 
 #if defined(MODULE_GNRC_NETAPI_CALLBACKS) || defined(DOXYGEN)
@@ -132,7 +160,8 @@ typedef enum {
  */
 #define GNRC_NETREG_ENTRY_INIT_CB(demux_ctx, _cbd)   { NULL, demux_ctx, \
                                                       GNRC_NETREG_TYPE_CB, \
-                                                      { .cbd = _cbd } }
+                                                      { .cbd = _cbd } \
+                                                      _GNRC_NETREG_NETTYPE_INIT }
 /** @} */
 
 /**
@@ -210,6 +239,16 @@ typedef struct gnrc_netreg_entry {
         gnrc_netreg_entry_cbd_t *cbd;
 #endif
     } target;                   /**< Target for the registry entry */
+#if GNRC_NETREG_BUCKETS || defined(DOXYGEN)
+    /**
+     * @brief   Type of the protocol the entry is registered for
+     *
+     * @internal
+     * @note    Only available with @ref GNRC_NETREG_BUCKETS > 0. Set by
+     *          gnrc_netreg_register().
+     */
+    gnrc_nettype_t nettype;
+#endif
 } gnrc_netreg_entry_t;
 
 /**
@@ -353,6 +392,9 @@ int gnrc_netreg_num(gnrc_nettype_t type, uint32_t demux_ctx);
  *          gnrc_netreg_entry_t::type and gnrc_netreg_entry_t::demux_ctx as the
  *          given entry.
  *
+ * Entries with the same type and demux context are kept adjacent in the
+ * registry, so this does not search.
+ *
  * @param[in] entry     A registry entry retrieved by gnrc_netreg_lookup() or
  *                      gnrc_netreg_getnext(). Must not be NULL.
  *
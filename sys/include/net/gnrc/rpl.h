@@ -193,12 +193,105 @@ extern "C" {
 /**
  * @brief   Number of implemented Objective Functions
  */
+#ifdef MODULE_GNRC_RPL_MRHOF
+#define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (2)
+#else
 #define GNRC_RPL_IMPLEMENTED_OFS_NUMOF (1)
+#endif
+
+/**
+ * @name    Objective Code Points
+ * @{
+ */
+#define GNRC_RPL_OCP_OF0    (0x0)   /**< Objective Function Zero (RFC 6552) */
+#define GNRC_RPL_OCP_MRHOF  (0x1)   /**< MRHOF (RFC 6719) */
+/** @} */
 
 /**
  * @brief   Default Objective Code Point (OF0)
+ *
+ * Set to @ref GNRC_RPL_OCP_MRHOF to make DODAGs rooted at this node use MRHOF
+ * (requires the `gnrc_rpl_mrhof` module).
+ */
+#ifndef GNRC_RPL_DEFAULT_OCP
+#define GNRC_RPL_DEFAULT_OCP (GNRC_RPL_OCP_OF0)
+#endif
+
+/**
+ * @name    Link metric types of a parent
+ * @see     gnrc_rpl_parent_t::link_metric_type
+ * @{
+ */
+#define GNRC_RPL_LINK_METRIC_NONE   (0) /**< no link metric known */
+#define GNRC_RPL_LINK_METRIC_ETX    (7) /**< ETX (RFC 6551, section 4.3.2) */
+/** @} */
+
+/**
+ * @name    ETX estimation
+ * @see     gnrc_rpl_parent_etx_update()
+ * @{
+ */
+/**
+ * @brief   Divisor of the fixed-point ETX values (RFC 6551, section 4.3.2)
+ */
+#define GNRC_RPL_ETX_DIVISOR        (128U)
+
+/**
+ * @brief   ETX assumed for a link without any transmission statistics
+ *          (multiple of @ref GNRC_RPL_ETX_DIVISOR)
+ */
+#ifndef GNRC_RPL_ETX_INIT
+#define GNRC_RPL_ETX_INIT           (2U * GNRC_RPL_ETX_DIVISOR)
+#endif
+
+/**
+ * @brief   ETX sample (in transmissions) that is used for a transmission
+ *          that was never acknowledged
+ */
+#ifndef GNRC_RPL_ETX_NOACK_PENALTY
+#define GNRC_RPL_ETX_NOACK_PENALTY  (8U)
+#endif
+
+/**
+ * @brief   Weight of the previous ETX estimate in percent
+ *
+ * New samples are weighted with `100 - GNRC_RPL_ETX_ALPHA`.
+ */
+#ifndef GNRC_RPL_ETX_ALPHA
+#define GNRC_RPL_ETX_ALPHA          (90U)
+#endif
+/** @} */
+
+/**
+ * @name    MRHOF parameters
+ * @see <a href="https://tools.ietf.org/html/rfc6719#section-5">
+ *          RFC 6719, section 5
+ *      </a>
+ * @{
+ */
+/**
+ * @brief   Links with a higher ETX (multiple of @ref GNRC_RPL_ETX_DIVISOR)
+ *          are not used to reach a parent
+ */
+#ifndef GNRC_RPL_MRHOF_MAX_LINK_METRIC
+#define GNRC_RPL_MRHOF_MAX_LINK_METRIC          (512U)
+#endif
+
+/**
+ * @brief   Parents with a higher path cost are not considered
  */
-#define GNRC_RPL_DEFAULT_OCP (0)
+#ifndef GNRC_RPL_MRHOF_MAX_PATH_COST
+#define GNRC_RPL_MRHOF_MAX_PATH_COST            (32768U)
+#endif
+
+/**
+ * @brief   Path cost improvement that is needed to switch the preferred
+ *          parent
+ */
+#ifndef GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD
+#define GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD  (192U)
+#endif
+/** @} */
 
 /**
  * @brief   Default Instance ID
@@ -216,7 +309,12 @@ extern "C" {
 #define GNRC_RPL_MOP_STORING_MODE_NO_MC  (0x02)
 #define GNRC_RPL_MOP_STORING_MODE_MC     (0x03)
 
-/** default MOP set on compile time */
+/**
+ * @brief   default MOP set on compile time
+ *
+ * Roots of DODAGs in @ref GNRC_RPL_MOP_NON_STORING_MODE require the
+ * `gnrc_rpl_srh_root` module to route downwards.
+ */
 #ifndef GNRC_RPL_DEFAULT_MOP
 #define GNRC_RPL_DEFAULT_MOP GNRC_RPL_MOP_STORING_MODE_NO_MC
 #endif
@@ -349,6 +447,13 @@ static inline bool GNRC_RPL_COUNTER_GREATER_THAN(uint8_t A, uint8_t B)
  */
 #define GNRC_RPL_DAO_DELAY_JITTER   (1000UL)
 #endif
+#ifndef GNRC_RPL_DAO_TARGETS_BATCH_NUMOF
+/**
+ * @brief Maximum number of DAO targets whose routes are handed to the NIB at
+ *        once (see gnrc_ipv6_nib_ft_add_multi())
+ */
+#define GNRC_RPL_DAO_TARGETS_BATCH_NUMOF    (8U)
+#endif
 /** @} */
 
 /**
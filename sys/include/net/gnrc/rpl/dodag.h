@@ -147,6 +147,25 @@ bool gnrc_rpl_parent_remove(gnrc_rpl_parent_t *parent);
  */
 void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent);
 
+/**
+ * @brief   Feed the result of a transmission to @p parent into its ETX
+ *          estimate.
+ *
+ * The estimate is an exponentially weighted moving average (see
+ * @ref GNRC_RPL_ETX_ALPHA). The preferred parent is re-evaluated afterwards,
+ * so objective functions using the ETX (e.g. MRHOF) react to the change.
+ *
+ * @note    With module `netstats_neighbor` the ETX of the link-layer
+ *          statistics of the parent is used instead, if available. It is
+ *          also taken over whenever a DIO of the parent is received.
+ *
+ * @param[in] parent    Pointer to the parent.
+ * @param[in] attempts  Number of transmission attempts that were needed.
+ * @param[in] success   true, if the transmission was acknowledged.
+ */
+void gnrc_rpl_parent_etx_update(gnrc_rpl_parent_t *parent, unsigned attempts,
+                                bool success);
+
 /**
  * @brief   Start a local repair.
  *
@@ -23,6 +23,10 @@
 #ifndef NET_GNRC_RPL_SRH_H
 #define NET_GNRC_RPL_SRH_H
 
+#include <stdint.h>
+
+#include "kernel_types.h"
+#include "net/gnrc/pkt.h"
 #include "net/ipv6/hdr.h"
 #include "net/ipv6/addr.h"
 
@@ -69,6 +73,116 @@ typedef struct __attribute__((packed)) {
  */
 int gnrc_rpl_srh_process(ipv6_hdr_t *ipv6, gnrc_rpl_srh_t *rh, void **err_ptr);
 
+#if defined(MODULE_GNRC_RPL_SRH_ROOT) || defined(DOXYGEN)
+/**
+ * @name    Non-storing mode root source routing
+ *
+ * With the `gnrc_rpl_srh_root` module a DODAG root in non-storing mode keeps
+ * the DODAG parent graph reported via DAOs in a compact table instead of
+ * installing a forwarding table entry for every node. Only the interface
+ * identifiers of the nodes are stored, the /64 prefix is shared with the
+ * DODAG ID. Source routing headers are built from that graph once per
+ * destination and cached until the graph changes, so downward forwarding
+ * does not need to walk the graph per packet.
+ *
+ * Global addresses of nodes are assumed to be formed from the DODAG prefix
+ * and the interface identifier of their link-local address, as done by
+ * address auto-configuration from the DODAG's prefix information option.
+ * @{
+ */
+/**
+ * @brief   Maximum number of nodes in the parent graph
+ */
+#ifndef GNRC_RPL_SRH_ROOT_NODES_NUMOF
+#define GNRC_RPL_SRH_ROOT_NODES_NUMOF   (64U)
+#endif
+
+/**
+ * @brief   Number of hash buckets to look up nodes by address
+ */
+#ifndef GNRC_RPL_SRH_ROOT_BUCKETS_NUMOF
+#define GNRC_RPL_SRH_ROOT_BUCKETS_NUMOF (32U)
+#endif
+
+/**
+ * @brief   Number of cached source routing headers
+ *
+ * The cache is direct-mapped by node, so the headers for the most recently
+ * used destinations are kept.
+ */
+#ifndef GNRC_RPL_SRH_ROOT_CACHE_NUMOF
+#define GNRC_RPL_SRH_ROOT_CACHE_NUMOF   (8U)
+#endif
+
+/**
+ * @brief   Maximum number of hops of a downward route
+ *
+ * Destinations deeper in the DODAG are not source routed.
+ */
+#ifndef GNRC_RPL_SRH_ROOT_HOPS_MAX
+#define GNRC_RPL_SRH_ROOT_HOPS_MAX      (16U)
+#endif
+
+/**
+ * @brief   Resets the parent graph for the DODAG of @p dodag_id
+ *
+ * @param[in] dodag_id  The DODAG ID of the non-storing mode DODAG this node
+ *                      is root of.
+ * @param[in] iface     The interface of the DODAG.
+ */
+void gnrc_rpl_srh_root_init(const ipv6_addr_t *dodag_id, kernel_pid_t iface);
+
+/**
+ * @brief   Updates the parent of a node in the parent graph
+ *
+ * Children of the root itself are also added to the forwarding table, as
+ * they are the first hop of all source routes.
+ *
+ * @param[in] target    A target address from a DAO.
+ * @param[in] parent    The parent address from the transit information option
+ *                      of @p target.
+ * @param[in] lifetime  Lifetime of the link in seconds. 0 removes @p target.
+ *
+ * @return  0 on success
+ * @return  -ENOTSUP, if @p target is not an address within the DODAG prefix
+ * @return  -EINVAL, if @p parent is not an address within the DODAG prefix
+ * @return  -ENOMEM, if the parent graph is full
+ */
+int gnrc_rpl_srh_root_update(const ipv6_addr_t *target,
+                             const ipv6_addr_t *parent, uint32_t lifetime);
+
+/**
+ * @brief   Builds the source routing header for a packet
+ *
+ * No header is built for packets that already carry extension headers, for
+ * destinations unknown to the parent graph and for children of the root.
+ *
+ * @param[in] ipv6          The IPv6 header snip of a packet to send.
+ * @param[out] first_hop    The first hop of the source route.
+ *
+ * @return  The source routing header for the packet, to be inserted with
+ *          @ref gnrc_rpl_srh_root_insert().
+ * @return  NULL, if the packet is not source routed.
+ */
+gnrc_pktsnip_t *gnrc_rpl_srh_root_build(const gnrc_pktsnip_t *ipv6,
+                                        ipv6_addr_t *first_hop);
+
+/**
+ * @brief   Inserts a source routing header into a packet
+ *
+ * @pre The IPv6 header of @p ipv6 is complete, i.e. upper layer checksums
+ *      were calculated with the final destination.
+ *
+ * @param[in,out] ipv6      The IPv6 header snip of the packet.
+ * @param[in] srh           A source routing header from
+ *                          @ref gnrc_rpl_srh_root_build().
+ * @param[in] first_hop     The first hop from @ref gnrc_rpl_srh_root_build().
+ */
+void gnrc_rpl_srh_root_insert(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *srh,
+                              const ipv6_addr_t *first_hop);
+/** @} */
+#endif /* MODULE_GNRC_RPL_SRH_ROOT || DOXYGEN */
+
 #ifdef __cplusplus
 }
 #endif
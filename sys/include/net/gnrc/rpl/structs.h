@@ -243,8 +243,11 @@ struct gnrc_rpl_parent {
     uint8_t dtsn;                   /**< last seen dtsn of this parent */
     uint16_t rank;                  /**< rank of the parent */
     gnrc_rpl_dodag_t *dodag;        /**< DODAG the parent belongs to */
-    double link_metric;             /**< metric of the link */
-    uint8_t link_metric_type;       /**< type of the metric */
+    uint16_t link_metric;           /**< metric of the link, 0 if unknown
+                                         (ETX is a multiple of
+                                         @ref GNRC_RPL_ETX_DIVISOR) */
+    uint8_t link_metric_type;       /**< type of the metric
+                                         (see @ref GNRC_RPL_LINK_METRIC_ETX) */
     /**
      * @brief Parent timeout events (see @ref GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT)
      */
@@ -312,6 +315,8 @@ typedef struct {
 struct gnrc_rpl_dodag {
     ipv6_addr_t dodag_id;           /**< id of the DODAG */
     gnrc_rpl_parent_t *parents;     /**< pointer to the parents list of this DODAG */
+    gnrc_rpl_parent_t *preferred;   /**< preferred parent, NULL while none
+                                         is selected */
     gnrc_rpl_instance_t *instance;  /**< pointer to the instance that this dodag is part of */
     uint8_t dtsn;                   /**< DAO Trigger Sequence Number */
     uint8_t prf;                    /**< preferred flag */
@@ -36,6 +36,9 @@
  *  - https://tools.ietf.org/html/rfc2349
  *     (RFC2349 TFTP Timeout Interval and Transfer Size Options)
  *
+ *  - https://tools.ietf.org/html/rfc7440
+ *     (RFC7440 TFTP Windowsize Option)
+ *
  * @author      Nick van IJzendoorn <nijzendoorn@engineering-spirit.nl>
  */
 
@@ -76,11 +79,27 @@ extern "C" {
 
 /**
  * @brief The maximum allowed data bytes in the data packet
+ *
+ * This is the upper bound of the block size negotiated with the blksize
+ * option, which is further limited by the MTU of the link. It must not be
+ * smaller than 512, the block size of transfers without options.
  */
 #ifndef GNRC_TFTP_MAX_TRANSFER_UNIT
 #define GNRC_TFTP_MAX_TRANSFER_UNIT         (512)
 #endif
 
+/**
+ * @brief The maximum number of data blocks sent without waiting for an ACK
+ *
+ * Clients request this window size with the windowsize option, servers accept
+ * at most this window size. Every block in flight occupies its own packet
+ * buffer, so larger windows need a larger @ref GNRC_PKTBUF_SIZE. A value of 1
+ * disables the option and results in lock-step transfers.
+ */
+#ifndef GNRC_TFTP_MAX_WINDOW_SIZE
+#define GNRC_TFTP_MAX_WINDOW_SIZE           (4)
+#endif
+
 /**
  * @brief The number of retries that must be made before stopping a transfer
  */
@@ -137,6 +156,19 @@ typedef bool (*tftp_start_cb_t)(tftp_action_t action, tftp_mode_t mode,
 
 /**
  * @brief   callback define which is called to get or set data from/to the user application
+ *
+ * @p data points directly into the packet buffer: received blocks are passed
+ * without copying and blocks to send are written in place. It is only valid
+ * during the call.
+ *
+ * @param [in] offset       The offset of the block within the transferred data
+ * @param [in/out] data     The block
+ * @param [in] data_len     When writing, the length of the received block.
+ *                          When reading, the maximum length of the block.
+ *
+ * @return  When reading, the number of bytes written to @p data. A block
+ *          shorter than @p data_len ends the transfer.
+ * @return  When writing, a negative value aborts the transfer.
  */
 typedef int (*tftp_data_cb_t)(uint32_t offset, void *data, size_t data_len);
 
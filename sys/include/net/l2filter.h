@@ -21,6 +21,16 @@
  * The actual memory for the filter lists should be allocated for every network
  * device. This is done centrally in netdev_t type.
  *
+ * By default the filter list is searched linearly, which is fine for the
+ * default of a handful of entries. For large lists include the module
+ * `l2filter_hashed`: the list is then used as an open addressing hash table
+ * with linear probing, so adding, removing and checking an address takes
+ * constant time on average regardless of @ref L2FILTER_LISTSIZE. Every entry
+ * additionally stores a hash fingerprint, so probing past colliding entries
+ * rarely needs to compare the full address. To keep the probe sequences
+ * short, @ref L2FILTER_LISTSIZE should be a power of two and about twice the
+ * number of addresses to be stored.
+ *
  * @{
  * @file
  * @brief       Link layer address filter interface definition
@@ -49,11 +59,19 @@ extern "C" {
 
 /**
  * @brief   Number of slots in each filter list (filter entries per device)
+ *
+ * With `l2filter_hashed` this must be a power of two and one slot always
+ * stays empty.
  */
 #ifndef L2FILTER_LISTSIZE
 #define L2FILTER_LISTSIZE               (8U)
 #endif
 
+#if defined(MODULE_L2FILTER_HASHED) && \
+    ((L2FILTER_LISTSIZE < 2) || (L2FILTER_LISTSIZE & (L2FILTER_LISTSIZE - 1)))
+#error "L2FILTER_LISTSIZE must be a power of two >= 2 with l2filter_hashed"
+#endif
+
 /**
  * @brief   Filter list entries
  *
@@ -63,7 +81,17 @@ extern "C" {
  */
 typedef struct {
     uint8_t addr[L2FILTER_ADDR_MAXLEN];     /**< link layer address */
+#if defined(MODULE_L2FILTER_HASHED) || defined(DOXYGEN)
+    uint8_t addr_len;                       /**< address length in byte */
+    /**
+     * @brief   Fingerprint of the address' hash
+     *
+     * @note    Only available with module `l2filter_hashed`
+     */
+    uint8_t fingerprint;
+#else
     size_t addr_len;                        /**< address length in byte */
+#endif
 } l2filter_t;
 
 /**
@@ -107,6 +107,8 @@ extern "C" {
 #define COAP_FETCH              (0x10)
 #define COAP_PATCH              (0x20)
 #define COAP_IPATCH             (0x40)
+#define COAP_CACHEABLE          (0x4000) /**< GET responses may be served
+                                              from the gcoap response cache */
 #define COAP_MATCH_SUBTREE      (0x8000) /**< Path is considered as a prefix
                                               when matching */
 /** @} */
@@ -142,6 +144,17 @@ extern "C" {
 #define NANOCOAP_BLOCK_SIZE_EXP_MAX  (6)
 #endif
 
+/**
+ * @brief    Number of slots in the hashed resource dispatch index used by
+ *           coap_handle_req()
+ *
+ * Must be 0 (disabled, linear search) or a power of two larger than the
+ * number of entries in @ref coap_resources.
+ */
+#ifndef NANOCOAP_RESOURCE_INDEX_SIZE
+#define NANOCOAP_RESOURCE_INDEX_SIZE (0)
+#endif
+
 #if defined(MODULE_GCOAP) || defined(DOXYGEN)
 /** @brief   Maximum length of a query string written to a message */
 #ifndef NANOCOAP_QS_MAX
@@ -237,6 +250,23 @@ typedef struct {
     uint8_t *opt;                   /**< Pointer to the placed option       */
 } coap_block_slicer_t;
 
+/**
+ * @brief   Hashed dispatch index over CoAP resource paths
+ *
+ * Open addressing hash table with linear probing, keyed by the resource path.
+ * Resources with the same path are kept in insertion order along a probe
+ * sequence, so the first added resource matching a request method is found.
+ * Resources flagged with @ref COAP_MATCH_SUBTREE can't be looked up by hash
+ * and are counted in coap_resource_index_t::unindexed instead.
+ */
+typedef struct {
+    const coap_resource_t **slots;  /**< Slot storage, NULL for empty slot */
+    uint16_t size;                  /**< Number of slots, a power of two   */
+    uint16_t numof;                 /**< Number of indexed resources       */
+    uint16_t unindexed;             /**< Number of resources that could not
+                                         be indexed                        */
+} coap_resource_index_t;
+
 /**
  * @brief   Global CoAP resource list
  */
@@ -1456,6 +1486,62 @@ extern ssize_t coap_well_known_core_default_handler(coap_pkt_t *pkt, \
  */
 int coap_match_path(const coap_resource_t *resource, uint8_t *uri);
 
+/**
+ * @brief   Initializes a hashed resource dispatch index
+ *
+ * @note This function is not intended for application use.
+ * @internal
+ *
+ * @param[out] idx      Index to initialize
+ * @param[in] slots     Slot storage of @p size entries
+ * @param[in] size      Number of slots; must be a power of two
+ */
+void coap_resource_index_init(coap_resource_index_t *idx,
+                              const coap_resource_t **slots, unsigned size);
+
+/**
+ * @brief   Adds a resource to a hashed resource dispatch index
+ *
+ * @note This function is not intended for application use.
+ * @internal
+ *
+ * @param[in,out] idx       Index to add @p resource to
+ * @param[in] resource      Resource to add
+ *
+ * @return  0 on success
+ * @return  -ENOTSUP if @p resource matches a subtree
+ * @return  -ENOSPC if @p idx is full
+ */
+int coap_resource_index_add(coap_resource_index_t *idx,
+                            const coap_resource_t *resource);
+
+/**
+ * @brief   Looks up the resource for a URI and method in a hashed resource
+ *          dispatch index
+ *
+ * Only resources actually added to @p idx are considered. If
+ * coap_resource_index_t::unindexed of @p idx is non-zero, a miss must be
+ * resolved by a linear search with coap_match_path(). A hit must then be
+ * confirmed by a linear search up to the found resource, as an unindexed
+ * resource in front of it takes precedence.
+ *
+ * @note This function is not intended for application use.
+ * @internal
+ *
+ * @param[in] idx           Index to search
+ * @param[in] uri           Null-terminated string URI to look up
+ * @param[in] method_flag   Request method as @ref coap_method_flags_t
+ * @param[out] resource     The matching resource
+ *
+ * @return  0 if a resource was found
+ * @return  -ENOENT if no resource with path @p uri is indexed
+ * @return  -EPERM if only resources not allowing @p method_flag are indexed
+ *          for @p uri
+ */
+int coap_resource_index_find(const coap_resource_index_t *idx,
+                             const uint8_t *uri, coap_method_flags_t method_flag,
+                             const coap_resource_t **resource);
+
 #if defined(MODULE_GCOAP) || defined(DOXYGEN)
 /**
  * @name    Functions -- gcoap specific
@@ -0,0 +1,260 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_neighbor Per-neighbor link statistics
+ * @ingroup     net
+ * @brief       Link quality (ETX, RSSI, LQI) of link-layer neighbors
+ *
+ * This module keeps a compact table of the link-layer neighbors of an
+ * interface. The table is fed by the interface: the destination of every
+ * frame is recorded with @ref netstats_nb_record() before the frame is handed
+ * to the device, every outcome reported by the device
+ * (`NETDEV_EVENT_TX_COMPLETE`, `NETDEV_EVENT_TX_NOACK`, ...) is then
+ * accounted with @ref netstats_nb_update_tx(). Received frames update the
+ * RSSI and LQI of their sender with @ref netstats_nb_update_rx().
+ *
+ * Devices report the outcomes in the order the frames were sent, so every
+ * neighbor marks which of the frames with a pending outcome were sent to it
+ * and the oldest outcome is accounted to the neighbor that marked the oldest
+ * frame. This stays correct if the outcome of a frame is only reported after
+ * the next frames were recorded.
+ *
+ * Routing protocols and next-hop selection can query the resulting estimates
+ * with @ref netstats_nb_get() or @ref netstats_nb_etx(). All functions are
+ * thread-safe; the table lock is never held while calling into other
+ * modules, so they can be called with other locks (e.g. the NIB's) held.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Per-neighbor link statistics definitions
+ */
+#ifndef NET_NETSTATS_NEIGHBOR_H
+#define NET_NETSTATS_NEIGHBOR_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of neighbors tracked per interface
+ *
+ * If the table is full the least recently updated neighbor is replaced.
+ */
+#ifndef NETSTATS_NB_SIZE
+#define NETSTATS_NB_SIZE                (8U)
+#endif
+
+/**
+ * @brief   Maximum length of a link-layer address tracked in the table
+ *
+ * Frames to or from neighbors with longer addresses are not accounted.
+ */
+#ifndef NETSTATS_NB_L2ADDR_MAX
+#define NETSTATS_NB_L2ADDR_MAX          (8U)
+#endif
+
+/**
+ * @brief   Fixed point divisor of netstats_nb_t::etx
+ *
+ * An ETX of 1.0 corresponds to a value of @ref NETSTATS_NB_ETX_DIVISOR. This
+ * is the same scale as @ref GNRC_RPL_ETX_DIVISOR so RPL can use the values
+ * without conversion.
+ */
+#define NETSTATS_NB_ETX_DIVISOR         (128U)
+
+/**
+ * @brief   Number of transmissions a lost frame is accounted with
+ */
+#ifndef NETSTATS_NB_ETX_NOACK_PENALTY
+#define NETSTATS_NB_ETX_NOACK_PENALTY   (8U)
+#endif
+
+/**
+ * @brief   Weight (in percent) of the old estimate in the ETX moving average
+ */
+#ifndef NETSTATS_NB_ETX_ALPHA
+#define NETSTATS_NB_ETX_ALPHA           (90U)
+#endif
+
+/**
+ * @brief   Weight (in percent) of the old estimate in the RSSI and LQI moving
+ *          averages
+ */
+#ifndef NETSTATS_NB_RX_ALPHA
+#define NETSTATS_NB_RX_ALPHA            (80U)
+#endif
+
+/**
+ * @brief   Maximum number of frames with a pending outcome
+ *
+ * If more frames are recorded, the outcomes of the oldest ones are assumed
+ * to be lost and are not accounted. At most 8.
+ */
+#ifndef NETSTATS_NB_TX_PENDING_MAX
+#define NETSTATS_NB_TX_PENDING_MAX      (8U)
+#endif
+
+/**
+ * @brief   Time in seconds after which the statistics of a neighbor that was
+ *          not heard from or sent to are considered stale
+ *
+ * Stale entries are not reported by @ref netstats_nb_get().
+ */
+#ifndef NETSTATS_NB_TIMEOUT
+#define NETSTATS_NB_TIMEOUT             (600U)
+#endif
+
+/**
+ * @brief   Statistics of a single link-layer neighbor
+ */
+typedef struct {
+    uint8_t l2_addr[NETSTATS_NB_L2ADDR_MAX];    /**< link-layer address */
+    uint8_t l2_addr_len;    /**< length of netstats_nb_t::l2_addr,
+                             *   0 if the entry is unused */
+    uint8_t lqi;            /**< averaged LQI of received frames */
+    int16_t rssi;           /**< averaged RSSI of received frames in dBm */
+    uint16_t etx;           /**< averaged ETX (multiple of
+                             *   @ref NETSTATS_NB_ETX_DIVISOR),
+                             *   0 if nothing was sent yet */
+    uint16_t tx_count;      /**< unicast frames sent to the neighbor */
+    uint16_t tx_failed;     /**< frames that were not acknowledged */
+    uint16_t rx_count;      /**< frames received from the neighbor */
+    uint8_t tx_pending;     /**< frames to the neighbor with a pending
+                             *   outcome, bit i stands for the i-th oldest
+                             *   pending frame of the table */
+    uint32_t last_updated;  /**< time of the last update in seconds */
+} netstats_nb_t;
+
+/**
+ * @brief   Neighbor statistics table of an interface
+ */
+typedef struct {
+    netstats_nb_t entries[NETSTATS_NB_SIZE];    /**< the neighbors */
+    mutex_t lock;                               /**< protects the table */
+    uint8_t tx_pending;     /**< number of frames with a pending
+                             *   outcome */
+} netstats_nb_table_t;
+
+/**
+ * @brief   Initializes a neighbor statistics table
+ *
+ * @param[out] table    The table to initialize
+ */
+void netstats_nb_init(netstats_nb_table_t *table);
+
+/**
+ * @brief   Records the destination of a frame about to be sent
+ *
+ * Each recorded frame expects its outcome to be reported with
+ * @ref netstats_nb_update_tx(), or to be withdrawn with
+ * @ref netstats_nb_cancel_tx() if it was not sent.
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in] l2_addr   Link-layer destination address. May be NULL for
+ *                      multicast frames, which do not update any neighbor.
+ * @param[in] len       Length of @p l2_addr
+ */
+void netstats_nb_record(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                        uint8_t len);
+
+/**
+ * @brief   Accounts the outcome of the oldest recorded frame with a pending
+ *          outcome
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in] attempts  Number of transmissions the frame needed (retries + 1),
+ *                      0 if it was not transmitted at all, e.g. because the
+ *                      medium was busy. Such frames tell nothing about the
+ *                      link and are not accounted.
+ * @param[in] success   true, if the frame was acknowledged
+ */
+void netstats_nb_update_tx(netstats_nb_table_t *table, unsigned attempts,
+                           bool success);
+
+/**
+ * @brief   Withdraws the last recorded frame
+ *
+ * Use if the frame recorded last could not be handed to the device, so its
+ * outcome will never be reported.
+ *
+ * @param[in] table     A neighbor statistics table
+ */
+void netstats_nb_cancel_tx(netstats_nb_table_t *table);
+
+/**
+ * @brief   Accounts a received frame
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in] l2_addr   Link-layer source address of the frame
+ * @param[in] len       Length of @p l2_addr
+ * @param[in] rssi      RSSI of the frame in dBm
+ * @param[in] lqi       LQI of the frame
+ */
+void netstats_nb_update_rx(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                           uint8_t len, int16_t rssi, uint8_t lqi);
+
+/**
+ * @brief   Gets the statistics of a neighbor
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in] l2_addr   Link-layer address of the neighbor
+ * @param[in] len       Length of @p l2_addr
+ * @param[out] stats    The statistics of the neighbor. May be NULL.
+ *
+ * @return  0 on success.
+ * @return  -ENOENT, if there are no (fresh) statistics for the neighbor.
+ */
+int netstats_nb_get(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                    uint8_t len, netstats_nb_t *stats);
+
+/**
+ * @brief   Gets the ETX estimate of a neighbor
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in] l2_addr   Link-layer address of the neighbor
+ * @param[in] len       Length of @p l2_addr
+ *
+ * @return  ETX as multiple of @ref NETSTATS_NB_ETX_DIVISOR.
+ * @return  0, if the ETX of the neighbor is unknown.
+ */
+uint16_t netstats_nb_etx(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                         uint8_t len);
+
+/**
+ * @brief   Iterates over the (fresh) entries of a table
+ *
+ * @param[in] table     A neighbor statistics table
+ * @param[in,out] state Iteration state. Must be 0 for the first call.
+ * @param[out] stats    The next entry
+ *
+ * @return  true, if @p stats was set.
+ * @return  false, if there are no more entries.
+ */
+bool netstats_nb_iter(netstats_nb_table_t *table, unsigned *state,
+                      netstats_nb_t *stats);
+
+/**
+ * @brief   Removes all entries from a table
+ *
+ * @param[in] table     A neighbor statistics table
+ */
+void netstats_nb_reset(netstats_nb_table_t *table);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_NEIGHBOR_H */
+/** @} */
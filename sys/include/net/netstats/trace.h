@@ -0,0 +1,191 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    net_netstats_trace Radio and MAC timing trace
+ * @ingroup     net
+ * @brief       Ring buffer of timestamped radio and MAC events
+ *
+ * Packet counters (see @ref net_netstats) don't tell how long the radio was
+ * on, how much airtime was spent in TX and RX or how late a duty-cycled MAC
+ * woke up. For that, every network device carries a small ring buffer of
+ * timestamped events (netdev_t::trace) when this module is used. Drivers
+ * record radio state changes and the begin and end of frames, MAC protocols
+ * record their wake-ups and sleep periods. Once the buffer is full the
+ * oldest events are overwritten.
+ *
+ * Events are added with @ref NETSTATS_TRACE_ADD(), which compiles to nothing
+ * if the module is not used, so instrumented code needs no `#ifdef`s.
+ * Adding an event is safe from interrupt context.
+ *
+ * The buffer can be dumped as text or as hex encoded records
+ * (see @ref netstats_trace_record_t) with the `ifconfig <if> trace` shell
+ * command. `dist/tools/netstats_trace/trace_render.py` renders duty-cycle,
+ * airtime and latency histograms from the latter.
+ *
+ * @{
+ *
+ * @file
+ * @brief       Radio and MAC timing trace definitions
+ */
+#ifndef NET_NETSTATS_TRACE_H
+#define NET_NETSTATS_TRACE_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Number of events kept per device
+ *
+ * @note    Must be a power of two
+ */
+#ifndef NETSTATS_TRACE_SIZE
+#define NETSTATS_TRACE_SIZE         (64U)
+#endif
+
+#if (NETSTATS_TRACE_SIZE & (NETSTATS_TRACE_SIZE - 1)) != 0
+#error "NETSTATS_TRACE_SIZE must be a power of two"
+#endif
+
+/**
+ * @brief   Event types
+ *
+ * The meaning of netstats_trace_entry_t::arg depends on the event.
+ */
+typedef enum {
+    NETSTATS_TRACE_RADIO_ON = 0,    /**< radio left sleep mode */
+    NETSTATS_TRACE_RADIO_OFF,       /**< radio entered sleep mode */
+    NETSTATS_TRACE_TX_QUEUED,       /**< frame handed to the link layer,
+                                     *   arg: length */
+    NETSTATS_TRACE_TX_START,        /**< frame transmission started */
+    NETSTATS_TRACE_TX_END,          /**< frame was sent (and acknowledged),
+                                     *   arg: retransmissions */
+    NETSTATS_TRACE_TX_NOACK,        /**< frame was not acknowledged */
+    NETSTATS_TRACE_TX_CCA_FAIL,     /**< channel access failure */
+    NETSTATS_TRACE_RX_START,        /**< frame reception started */
+    NETSTATS_TRACE_RX_END,          /**< frame was received */
+    NETSTATS_TRACE_MAC_WAKEUP,      /**< MAC woke up for a listen period,
+                                     *   arg: delay behind schedule in usec */
+    NETSTATS_TRACE_MAC_SLEEP,       /**< MAC went to sleep */
+    NETSTATS_TRACE_NUMOF,           /**< number of event types */
+} netstats_trace_event_t;
+
+/**
+ * @brief   A single event
+ */
+typedef struct {
+    uint32_t time;                  /**< time of the event in usec */
+    uint16_t arg;                   /**< event specific argument */
+    uint8_t event;                  /**< @ref netstats_trace_event_t */
+} netstats_trace_entry_t;
+
+/**
+ * @brief   Event ring buffer of a device
+ */
+typedef struct {
+    netstats_trace_entry_t entries[NETSTATS_TRACE_SIZE];    /**< the events */
+    uint32_t count;                 /**< number of events added so far */
+} netstats_trace_t;
+
+/**
+ * @brief   Length of an exported event record
+ *
+ * Exported records are 8 bytes in little endian byte order: the time
+ * (4 bytes), the argument (2 bytes), the event type (1 byte) and a reserved
+ * byte that is 0.
+ */
+#define NETSTATS_TRACE_RECORD_LEN   (8U)
+
+/**
+ * @brief   Exported event record
+ */
+typedef uint8_t netstats_trace_record_t[NETSTATS_TRACE_RECORD_LEN];
+
+/**
+ * @brief   Adds an event to a trace if the `netstats_trace` module is used
+ *
+ * @param[in] trace     A trace
+ * @param[in] event     A @ref netstats_trace_event_t
+ * @param[in] arg       Event specific argument
+ */
+#if defined(MODULE_NETSTATS_TRACE) || defined(DOXYGEN)
+#define NETSTATS_TRACE_ADD(trace, event, arg) \
+    netstats_trace_add(trace, event, arg)
+#else
+#define NETSTATS_TRACE_ADD(trace, event, arg)   (void)0
+#endif
+
+/**
+ * @brief   Initializes (clears) a trace
+ *
+ * @param[out] trace    The trace to initialize
+ */
+void netstats_trace_init(netstats_trace_t *trace);
+
+/**
+ * @brief   Adds an event to a trace
+ *
+ * @param[in] trace     A trace
+ * @param[in] event     The event type
+ * @param[in] arg       Event specific argument
+ */
+void netstats_trace_add(netstats_trace_t *trace, netstats_trace_event_t event,
+                        uint16_t arg);
+
+/**
+ * @brief   Gets the sequence number of the oldest event still in the trace
+ *
+ * The events in the trace have the sequence numbers from the returned value
+ * to netstats_trace_t::count - 1.
+ *
+ * @param[in] trace     A trace
+ *
+ * @return  sequence number of the oldest event
+ */
+uint32_t netstats_trace_first(const netstats_trace_t *trace);
+
+/**
+ * @brief   Gets an event of a trace
+ *
+ * @param[in] trace     A trace
+ * @param[in] seq       Sequence number of the event
+ * @param[out] entry    The event
+ *
+ * @return  0 on success.
+ * @return  -ENOENT, if the event was already overwritten or not added yet.
+ */
+int netstats_trace_get(netstats_trace_t *trace, uint32_t seq,
+                       netstats_trace_entry_t *entry);
+
+/**
+ * @brief   Encodes an event as record for export
+ *
+ * @param[in] entry     An event
+ * @param[out] record   The record
+ */
+void netstats_trace_export(const netstats_trace_entry_t *entry,
+                           netstats_trace_record_t record);
+
+/**
+ * @brief   Gets the name of an event type
+ *
+ * @param[in] event     An event type
+ *
+ * @return  the name, "unknown" for invalid types
+ */
+const char *netstats_trace_event_str(unsigned event);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* NET_NETSTATS_TRACE_H */
+/** @} */
@@ -273,6 +273,8 @@
 #include <stdlib.h>
 #include <sys/types.h>
 
+#include "iolist.h"
+
 /* net/sock/async/types.h included by net/sock.h needs to re-typedef the
  * `sock_ip_t` to prevent cyclic includes */
 #if defined (__clang__)
@@ -413,6 +415,61 @@ int sock_udp_get_remote(sock_udp_t *sock, sock_udp_ep_t *ep);
 ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
                       uint32_t timeout, sock_udp_ep_t *remote);
 
+/**
+ * @brief   Provides stack-internal buffer space containing a UDP message from
+ *          a remote end point
+ *
+ * Instead of copying the payload into an application-provided buffer, the
+ * data stays in the network stack's packet buffer and @p data is pointed to
+ * it. @p buf_ctx is set to an opaque handle to that buffer. Call this
+ * function again with the same @p buf_ctx to release the buffer: the stack
+ * then returns 0, sets @p data and @p buf_ctx to `NULL` and hands the space
+ * back to the packet buffer. The buffer can be held across other sock calls,
+ * but it occupies packet buffer space until it is released.
+ *
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ * void *data, *ctx = NULL;
+ * ssize_t res = sock_udp_recv_buf(&sock, &data, &ctx, SOCK_NO_TIMEOUT, NULL);
+ *
+ * if (res > 0) {
+ *     handle(data, res);
+ *     sock_udp_recv_buf(&sock, &data, &ctx, 0, NULL);    // release
+ * }
+ * ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
+ *
+ * @pre `(sock != NULL) && (data != NULL) && (buf_ctx != NULL)`
+ *
+ * @param[in] sock      A UDP sock object.
+ * @param[out] data     Pointer to the stack-internal buffer space containing
+ *                      the received data. `NULL` when the buffer referred to
+ *                      by @p buf_ctx was released.
+ * @param[in,out] buf_ctx   Stack-internal buffer context. If it points to a
+ *                      `NULL` pointer, a new message is received. Otherwise
+ *                      the buffer it refers to is released.
+ * @param[in] timeout   Timeout for receive in microseconds.
+ *                      If 0 and no data is available, the function returns
+ *                      immediately.
+ *                      May be @ref SOCK_NO_TIMEOUT for no timeout (wait until
+ *                      data is available).
+ * @param[out] remote   Remote end point of the received data.
+ *                      May be `NULL`, if it is not required by the application.
+ *
+ * @note    Function blocks if no packet is currently waiting.
+ *
+ * @return  The number of bytes received on success.
+ * @return  0, if the buffer referred to by @p buf_ctx was released.
+ * @return  -EADDRNOTAVAIL, if local of @p sock is not given.
+ * @return  -EAGAIN, if @p timeout is `0` and no data is available.
+ * @return  -EINVAL, if @p remote is invalid or @p sock is not properly
+ *          initialized (or closed while sock_udp_recv_buf() blocks).
+ * @return  -ENOMEM, if no memory was available to receive @p data.
+ * @return  -EPROTO, if source address of received packet did not equal
+ *          the remote of @p sock.
+ * @return  -ETIMEDOUT, if @p timeout expired.
+ */
+ssize_t sock_udp_recv_buf(sock_udp_t *sock, void **data, void **buf_ctx,
+                          uint32_t timeout, sock_udp_ep_t *remote);
+
 /**
  * @brief   Sends a UDP message to remote end point
  *
@@ -449,6 +506,33 @@ ssize_t sock_udp_recv(sock_udp_t *sock, void *data, size_t max_len,
 ssize_t sock_udp_send(sock_udp_t *sock, const void *data, size_t len,
                       const sock_udp_ep_t *remote);
 
+/**
+ * @brief   Sends a UDP message gathered from a list of buffers to remote end
+ *          point
+ *
+ * The payload is assembled from all entries of @p snips in order, so e.g.
+ * an application header and a body kept in separate buffers can be sent
+ * without first concatenating them into an intermediate buffer.
+ *
+ * @pre `((sock != NULL || remote != NULL))`
+ *
+ * @param[in] sock      A raw IPv4/IPv6 sock object. May be `NULL`.
+ *                      A sensible local end point should be selected by the
+ *                      implementation in that case.
+ * @param[in] snips     List of payload chunks. May be `NULL` for an empty
+ *                      payload.
+ * @param[in] remote    Remote end point for the sent data.
+ *                      May be `NULL`, if @p sock has a remote end point.
+ *                      sock_udp_ep_t::family may be AF_UNSPEC, if local
+ *                      end point of @p sock provides this information.
+ *                      sock_udp_ep_t::port may not be 0.
+ *
+ * @return  The number of bytes sent on success.
+ * @return  The same error values as @ref sock_udp_send().
+ */
+ssize_t sock_udp_send_iolist(sock_udp_t *sock, const iolist_t *snips,
+                             const sock_udp_ep_t *remote);
+
 #include "sock_types.h"
 
 #ifdef __cplusplus
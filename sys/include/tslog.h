@@ -0,0 +1,240 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @defgroup    sys_tslog Time-series log on MTD
+ * @ingroup     sys
+ * @brief       Append-only ring store for timestamped records on MTD devices
+ *
+ * Sensor data is written once and read back by time range. A general purpose
+ * file system pays for metadata updates on every write and has no notion of
+ * time. This module instead writes records sequentially into a ring of
+ * sectors on a @ref drivers_mtd device:
+ *
+ * - Records are collected in a RAM buffer of @ref TSLOG_BUF_SIZE bytes and
+ *   programmed when it is full or on @ref tslog_flush(), so many small
+ *   appends cost a single page program.
+ * - Sectors are filled in order and the oldest sector is erased when the log
+ *   wraps around, so all sectors wear evenly.
+ * - Every sector starts with a header holding a sequence number and the time
+ *   of its first record. These headers form a sparse time index: a range
+ *   query finds its start sector by binary search over the headers and only
+ *   scans that sector record by record.
+ * - Records and headers are protected by a CRC-16 (see @ref sys_checksum).
+ *   On mount the log is recovered from the headers, the write position is set
+ *   behind the last intact record. If a record was torn by a reset, the rest
+ *   of that sector is left alone and appending continues in the next sector.
+ *
+ * Timestamps are 32 bit values of any unit, they must not decrease between
+ * appends.
+ *
+ * Usage:
+ *
+ * ```C
+ * static tslog_t log = { .mtd = MTD_0 };
+ *
+ * if (tslog_mount(&log) < 0) {
+ *     tslog_format(&log);
+ * }
+ * tslog_append(&log, now, &sample, sizeof(sample));
+ *
+ * tslog_iter_t it;
+ * tslog_iter_init(&log, &it, start, end);
+ * while (tslog_iter_next(&log, &it, &time, &sample, sizeof(sample)) >= 0) {
+ *     ...
+ * }
+ * ```
+ *
+ * @{
+ *
+ * @file
+ * @brief       Time-series log interface
+ */
+
+#ifndef TSLOG_H
+#define TSLOG_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#include "mtd.h"
+#include "mutex.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   Size of the write buffer
+ *
+ * Must divide the sector size of the device. Choosing the page size (or a
+ * multiple of it) makes every flush a whole page program.
+ */
+#ifndef TSLOG_BUF_SIZE
+#define TSLOG_BUF_SIZE          (256U)
+#endif
+
+/**
+ * @brief   Size of the header at the start of every sector
+ */
+#define TSLOG_SECTOR_HDR_SIZE   (16U)
+
+/**
+ * @brief   Size of the header in front of every record
+ */
+#define TSLOG_RECORD_HDR_SIZE   (8U)
+
+/**
+ * @brief   Records are padded to a multiple of this
+ */
+#define TSLOG_ALIGN             (4U)
+
+/**
+ * @brief   Flash access statistics
+ */
+typedef struct {
+    uint32_t writes;            /**< calls to @ref mtd_write() */
+    uint32_t erases;            /**< sectors erased */
+} tslog_stats_t;
+
+/**
+ * @brief   Time-series log descriptor
+ *
+ * Only tslog_t::mtd, tslog_t::first_sector and tslog_t::sector_count are set
+ * by the user, the other members are internal.
+ */
+typedef struct {
+    mtd_dev_t *mtd;             /**< the device */
+    uint32_t first_sector;      /**< first sector used by the log */
+    /**
+     * @brief   number of sectors used by the log, at least 2, 0 to use the
+     *          rest of the device
+     */
+    uint32_t sector_count;
+    mutex_t lock;               /**< protects the log */
+    uint32_t numof;             /**< number of sectors in use */
+    uint32_t sector_size;       /**< sector size in bytes */
+    uint32_t head;              /**< sector written to */
+    uint32_t head_seq;          /**< sequence number of the head sector */
+    uint32_t count;             /**< number of sectors holding data */
+    uint32_t wpos;              /**< write position in the head sector */
+    uint32_t last_time;         /**< time of the last record */
+    uint32_t buf_addr;          /**< offset of the buffer in the head sector */
+    uint16_t buf_fill;          /**< bytes used in the buffer */
+    uint16_t buf_flushed;       /**< bytes of the buffer already programmed */
+    bool sealed;                /**< head sector must not be appended to */
+    tslog_stats_t stats;        /**< flash access statistics */
+    uint8_t buf[TSLOG_BUF_SIZE];    /**< write buffer */
+} tslog_t;
+
+/**
+ * @brief   Iterator for range queries
+ */
+typedef struct {
+    uint32_t sector;            /**< current sector */
+    uint32_t seq;               /**< sequence number of the current sector */
+    uint32_t pos;               /**< position in the current sector */
+    uint32_t from;              /**< first time of the range */
+    uint32_t to;                /**< last time of the range */
+    bool end;                   /**< no more records */
+} tslog_iter_t;
+
+/**
+ * @brief   Erases the log
+ *
+ * @param[in] log       The log
+ *
+ * @return  0 on success
+ * @return  < 0 on error
+ */
+int tslog_format(tslog_t *log);
+
+/**
+ * @brief   Opens an existing log
+ *
+ * Finds the newest sector and the end of the data in it. A log without any
+ * valid sector is opened as empty log.
+ *
+ * @param[in] log       The log
+ *
+ * @return  0 on success
+ * @return  -EINVAL if the geometry of the device is not supported
+ * @return  < 0 on other errors
+ */
+int tslog_mount(tslog_t *log);
+
+/**
+ * @brief   Appends a record
+ *
+ * The record is buffered in RAM, see @ref tslog_flush().
+ *
+ * @param[in] log       The log
+ * @param[in] time      Time of the record, not before the last record
+ * @param[in] data      Payload
+ * @param[in] len       Length of @p data
+ *
+ * @return  0 on success
+ * @return  -EINVAL if @p time is before the last record
+ * @return  -EFBIG if the record does not fit into a sector
+ * @return  < 0 on device errors
+ */
+int tslog_append(tslog_t *log, uint32_t time, const void *data, size_t len);
+
+/**
+ * @brief   Programs all buffered records
+ *
+ * @param[in] log       The log
+ *
+ * @return  0 on success
+ * @return  < 0 on error
+ */
+int tslog_flush(tslog_t *log);
+
+/**
+ * @brief   Starts a range query
+ *
+ * Buffered records are included in the query.
+ *
+ * @param[in] log       The log
+ * @param[out] it       The iterator
+ * @param[in] from      Time of the first record to return
+ * @param[in] to        Time of the last record to return
+ *
+ * @return  0 on success
+ * @return  < 0 on error
+ */
+int tslog_iter_init(tslog_t *log, tslog_iter_t *it, uint32_t from,
+                    uint32_t to);
+
+/**
+ * @brief   Gets the next record of a range query
+ *
+ * Records overwritten since the last call are skipped.
+ *
+ * @param[in] log       The log
+ * @param[in,out] it    The iterator
+ * @param[out] time     Time of the record
+ * @param[out] data     Buffer for the payload
+ * @param[in] len       Size of @p data
+ *
+ * @return  length of the payload
+ * @return  -ENOENT if there are no more records in the range
+ * @return  -ENOBUFS if the payload does not fit into @p data, the iterator
+ *          is not advanced
+ * @return  < 0 on device errors
+ */
+int tslog_iter_next(tslog_t *log, tslog_iter_t *it, uint32_t *time,
+                    void *data, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* TSLOG_H */
+/** @} */
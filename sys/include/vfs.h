@@ -70,6 +70,7 @@ using std::atomic_int;
 
 #include "kernel_types.h"
 #include "clist.h"
+#include "iolist.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -370,6 +371,51 @@ struct vfs_file_ops {
      * @return <0 on error
      */
     ssize_t (*write) (vfs_file_t *filp, const void *src, size_t nbytes);
+
+    /**
+     * @brief Get a pointer to the file contents at the current position
+     *
+     * Optional, only for file systems that keep file contents in directly
+     * addressable memory. Works like read(), but instead of copying the
+     * contents, a pointer to them is returned.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[out] ptr      pointer to the contents at the current position
+     * @param[in]  nbytes   maximum number of bytes to read
+     *
+     * @return number of bytes available at @p *ptr on success, the position
+     *         is advanced by this amount
+     * @return <0 on error
+     */
+    ssize_t (*read_ptr) (vfs_file_t *filp, const void **ptr, size_t nbytes);
+
+    /**
+     * @brief Read bytes from an open file into several buffers
+     *
+     * Optional, the VFS layer calls read() for every buffer if this is not
+     * implemented.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iolist   buffers to fill, in order
+     *
+     * @return number of bytes read on success
+     * @return <0 on error
+     */
+    ssize_t (*readv) (vfs_file_t *filp, const iolist_t *iolist);
+
+    /**
+     * @brief Write bytes from several buffers to an open file
+     *
+     * Optional, the VFS layer calls write() for every buffer if this is not
+     * implemented.
+     *
+     * @param[in]  filp     pointer to open file
+     * @param[in]  iolist   buffers to write, in order
+     *
+     * @return number of bytes written on success
+     * @return <0 on error
+     */
+    ssize_t (*writev) (vfs_file_t *filp, const iolist_t *iolist);
 };
 
 /**
@@ -657,6 +703,102 @@ int vfs_open(const char *name, int flags, mode_t mode);
  */
 ssize_t vfs_read(int fd, void *dest, size_t count);
 
+/**
+ * @brief Read bytes from an open file without copying them
+ *
+ * Works like @ref vfs_read(), but returns a pointer to the file contents
+ * instead of copying them to a buffer. This is only supported by file systems
+ * that keep file contents in directly addressable memory (e.g. ConstFS), use
+ * @ref vfs_read() if -ENOTSUP is returned.
+ *
+ * The contents must not be written to. They stay valid as long as the file
+ * system is mounted and the file is not modified.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[out] ptr      pointer to the contents at the current position
+ * @param[in]  count    maximum number of bytes to read
+ *
+ * @return number of bytes available at @p *ptr on success
+ * @return -ENOTSUP if the file system does not support direct access
+ * @return <0 on error
+ */
+ssize_t vfs_read_ptr(int fd, const void **ptr, size_t count);
+
+/**
+ * @brief Read bytes from an open file into several buffers
+ *
+ * The buffers of @p iolist are filled in order. Reading stops early at the
+ * end of the file.
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iolist   buffers to fill
+ *
+ * @return number of bytes read on success
+ * @return <0 on error
+ */
+ssize_t vfs_readv(int fd, const iolist_t *iolist);
+
+/**
+ * @brief Write bytes from several buffers to an open file
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  iolist   buffers to write
+ *
+ * @return number of bytes written on success
+ * @return <0 on error
+ */
+ssize_t vfs_writev(int fd, const iolist_t *iolist);
+
+/**
+ * @brief Consumer of file contents for @ref vfs_sendfile()
+ *
+ * @param[in]  arg      argument passed to @ref vfs_sendfile()
+ * @param[in]  data     chunk of file contents
+ * @param[in]  len      length of @p data
+ *
+ * @return number of bytes consumed, vfs_sendfile() passes the rest again
+ * @return 0 if nothing more can be consumed, vfs_sendfile() stops
+ * @return <0 on error, vfs_sendfile() stops
+ */
+typedef ssize_t (*vfs_sendfile_cb_t)(void *arg, const void *data, size_t len);
+
+/**
+ * @brief Pass the contents of an open file to a consumer
+ *
+ * Hands up to @p count bytes from the current position of @p fd to @p cb,
+ * e.g. a wrapper around sock_udp_send(), gnrc_tcp_send() or
+ * coap_blockwise_put_bytes(). If the file system supports
+ * @ref vfs_read_ptr(), the contents are passed without being copied and
+ * @p buf may be NULL, otherwise they are read into @p buf. Either way @p cb
+ * gets chunks of at most @p buf_len bytes, unless @p buf_len is 0. It is
+ * called until @p count bytes or the whole file were consumed, or it consumed
+ * nothing. Afterwards the position of @p fd is behind the last consumed byte.
+ *
+ * Example, sending a file in TCP segments:
+ *
+ * @code
+ * static ssize_t _tcp_send(void *arg, const void *data, size_t len)
+ * {
+ *     return gnrc_tcp_send(arg, data, len, GNRC_TCP_CONNECTION_TIMEOUT_DURATION);
+ * }
+ *
+ * vfs_sendfile(fd, SIZE_MAX, _tcp_send, &tcb, buf, sizeof(buf));
+ * @endcode
+ *
+ * @param[in]  fd       fd number obtained from vfs_open
+ * @param[in]  count    maximum number of bytes to pass
+ * @param[in]  cb       consumer of the contents
+ * @param[in]  arg      argument for @p cb
+ * @param[in]  buf      buffer for file systems without direct access
+ * @param[in]  buf_len  size of @p buf, the maximum size of a chunk, 0 for no
+ *                      limit with direct access
+ *
+ * @return number of bytes consumed on success
+ * @return <0 on error
+ */
+ssize_t vfs_sendfile(int fd, size_t count, vfs_sendfile_cb_t cb, void *arg,
+                     void *buf, size_t buf_len);
+
 /**
  * @brief Write bytes to an open file
  *
@@ -0,0 +1,784 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_kvstore
+ * @{
+ *
+ * @file
+ * @brief       Key-value store implementation
+ *
+ * Every sector starts with a header holding a sequence number, followed by
+ * batches. A batch is a header {length, CRC-16} followed by entries
+ * {key length, reserved, value length} + key + value and is padded to four
+ * bytes. A value length of UINT16_MAX marks a deleted key.
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "checksum/crc16_ccitt.h"
+#include "hashes.h"
+#include "kvstore.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define SECTOR_MAGIC    (0x5453564b)    /* "KVST" */
+#define SECTOR_HDR_SIZE (sizeof(_sector_hdr_t))
+#define BATCH_HDR_SIZE  (sizeof(_batch_hdr_t))
+#define ENTRY_HDR_SIZE  (sizeof(_entry_hdr_t))
+#define ALIGN           (4U)
+#define DELETED         (UINT16_MAX)
+#define NO_ADDR         (UINT32_MAX)
+#define INDEX_MASK      (KVSTORE_INDEX_SIZE - 1)
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint16_t reserved;
+    uint16_t crc;
+} _sector_hdr_t;
+
+typedef struct {
+    uint16_t len;
+    uint16_t crc;
+} _batch_hdr_t;
+
+typedef struct {
+    uint8_t key_len;
+    uint8_t reserved;
+    uint16_t val_len;
+} _entry_hdr_t;
+
+static inline uint32_t _align(uint32_t len)
+{
+    return (len + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+/* offset within the region of the store */
+static inline uint32_t _pos(const kvstore_t *kv, uint32_t sector, uint32_t pos)
+{
+    return sector * kv->sector_size + pos;
+}
+
+static inline uint32_t _entry_size(const _entry_hdr_t *e)
+{
+    return ENTRY_HDR_SIZE + e->key_len + ((e->val_len == DELETED) ? 0 : e->val_len);
+}
+
+static inline uint16_t _sector_crc(const _sector_hdr_t *hdr)
+{
+    return crc16_ccitt_calc((const uint8_t *)hdr, offsetof(_sector_hdr_t, crc));
+}
+
+static inline uint16_t _hash(const uint8_t *key, size_t len)
+{
+    return fnv_hash(key, len);
+}
+
+static int _read(kvstore_t *kv, uint32_t off, void *dest, uint32_t len)
+{
+    uint8_t *dst = dest;
+    uint32_t addr = kv->first_sector * kv->sector_size + off;
+
+    for (uint32_t done = 0; done < len;) {
+        int res = mtd_read(kv->mtd, dst + done, addr + done, len - done);
+        if (res <= 0) {
+            return (res < 0) ? res : -EIO;
+        }
+        done += res;
+    }
+    return 0;
+}
+
+static int _program(kvstore_t *kv, uint32_t off, const void *data, uint32_t len)
+{
+    const uint8_t *src = data;
+    uint32_t page_size = kv->mtd->page_size;
+    uint32_t addr = kv->first_sector * kv->sector_size + off;
+
+    while (len > 0) {
+        uint32_t chunk = page_size - (addr % page_size);
+        if (chunk > len) {
+            chunk = len;
+        }
+        int res = mtd_write(kv->mtd, src, addr, chunk);
+        if (res < 0) {
+            return res;
+        }
+        kv->stats.writes++;
+        src += chunk;
+        addr += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int _erase(kvstore_t *kv, uint32_t sector, uint32_t count)
+{
+    int res = mtd_erase(kv->mtd, (kv->first_sector + sector) * kv->sector_size,
+                        count * kv->sector_size);
+    if (res < 0) {
+        return res;
+    }
+    kv->stats.erases += count;
+    return 0;
+}
+
+static int _read_sector_hdr(kvstore_t *kv, uint32_t sector, _sector_hdr_t *hdr)
+{
+    int res = _read(kv, _pos(kv, sector, 0), hdr, sizeof(*hdr));
+    if (res < 0) {
+        return res;
+    }
+    if ((hdr->magic != SECTOR_MAGIC) || (hdr->crc != _sector_crc(hdr))) {
+        return -ENOENT;
+    }
+    return 0;
+}
+
+/* read the header of the batch at pos, returns -ENOENT if the sector ends
+ * there, -EINVAL if the batch is broken */
+static int _read_batch_hdr(kvstore_t *kv, uint32_t sector, uint32_t pos,
+                           _batch_hdr_t *hdr)
+{
+    if ((pos + BATCH_HDR_SIZE) > kv->sector_size) {
+        return -ENOENT;
+    }
+    int res = _read(kv, _pos(kv, sector, pos), hdr, sizeof(*hdr));
+    if (res < 0) {
+        return res;
+    }
+    if ((hdr->len == UINT16_MAX) && (hdr->crc == UINT16_MAX)) {
+        return -ENOENT;
+    }
+    if ((hdr->len == 0) || (hdr->len > (KVSTORE_BATCH_SIZE - BATCH_HDR_SIZE)) ||
+        ((pos + _align(BATCH_HDR_SIZE + hdr->len)) > kv->sector_size)) {
+        return -EINVAL;
+    }
+    return 0;
+}
+
+/* look up a key, on success idx is its slot, on -ENOENT idx is the free slot
+ * to insert it into or KVSTORE_INDEX_SIZE if the index is full */
+static int _find(kvstore_t *kv, const uint8_t *key, size_t key_len,
+                 uint16_t hash, unsigned *idx)
+{
+    unsigned i = hash & INDEX_MASK;
+
+    for (unsigned n = 0; n < KVSTORE_INDEX_SIZE; n++) {
+        kvstore_slot_t *slot = &kv->index[i];
+        if (slot->addr == NO_ADDR) {
+            *idx = i;
+            return -ENOENT;
+        }
+        if (slot->hash == hash) {
+            uint8_t buf[ENTRY_HDR_SIZE + KVSTORE_KEY_MAX];
+            uint32_t len = ENTRY_HDR_SIZE + key_len;
+            uint32_t end = kv->numof * kv->sector_size;
+            /* read header and key at once, stored keys of a different
+             * length are told apart by the header */
+            if ((slot->addr + len) > end) {
+                len = end - slot->addr;
+            }
+            int res = _read(kv, slot->addr, buf, len);
+            if (res < 0) {
+                return res;
+            }
+            if ((buf[0] == key_len) &&
+                !memcmp(buf + ENTRY_HDR_SIZE, key, key_len)) {
+                *idx = i;
+                return 0;
+            }
+        }
+        i = (i + 1) & INDEX_MASK;
+    }
+    *idx = KVSTORE_INDEX_SIZE;
+    return -ENOENT;
+}
+
+/* free a slot and move up entries of the same probe sequence */
+static void _remove(kvstore_t *kv, unsigned i)
+{
+    kv->index[i].addr = NO_ADDR;
+    kv->keys--;
+
+    for (unsigned j = (i + 1) & INDEX_MASK; kv->index[j].addr != NO_ADDR;
+         j = (j + 1) & INDEX_MASK) {
+        unsigned home = kv->index[j].hash & INDEX_MASK;
+        /* the entry stays if its home slot lies cyclically in (i, j] */
+        if (((j - home) & INDEX_MASK) < ((j - i) & INDEX_MASK)) {
+            continue;
+        }
+        kv->index[i] = kv->index[j];
+        kv->index[j].addr = NO_ADDR;
+        i = j;
+    }
+}
+
+static int _apply(kvstore_t *kv, uint32_t addr, const _entry_hdr_t *e,
+                  const uint8_t *key)
+{
+    uint16_t hash = _hash(key, e->key_len);
+    unsigned idx;
+    int res = _find(kv, key, e->key_len, hash, &idx);
+
+    if ((res < 0) && (res != -ENOENT)) {
+        return res;
+    }
+    if (e->val_len == DELETED) {
+        if (res == 0) {
+            _remove(kv, idx);
+        }
+        return 0;
+    }
+    if (res == 0) {
+        kv->index[idx].addr = addr;
+        kv->index[idx].len = e->val_len;
+        return 0;
+    }
+    if (kv->keys >= (KVSTORE_INDEX_SIZE - 1)) {
+        return -ENOMEM;
+    }
+    kv->index[idx].addr = addr;
+    kv->index[idx].hash = hash;
+    kv->index[idx].len = e->val_len;
+    kv->keys++;
+    return 0;
+}
+
+/* apply the entries of a batch in RAM that is stored at off to the index, or
+ * only count the keys it would add if off is NO_ADDR */
+static int _apply_batch(kvstore_t *kv, const uint8_t *batch, uint32_t len,
+                        uint32_t off)
+{
+    int added = 0;
+
+    for (uint32_t pos = BATCH_HDR_SIZE; pos < len;) {
+        _entry_hdr_t e;
+        if ((pos + ENTRY_HDR_SIZE) > len) {
+            return -EINVAL;
+        }
+        memcpy(&e, batch + pos, sizeof(e));
+        if ((e.key_len == 0) || (e.key_len > KVSTORE_KEY_MAX) ||
+            ((pos + _entry_size(&e)) > len)) {
+            return -EINVAL;
+        }
+
+        const uint8_t *key = batch + pos + ENTRY_HDR_SIZE;
+        int res;
+        if (off != NO_ADDR) {
+            res = _apply(kv, off + pos, &e, key);
+        }
+        else if (e.val_len != DELETED) {
+            unsigned idx;
+            res = _find(kv, key, e.key_len, _hash(key, e.key_len), &idx);
+            if (res == -ENOENT) {
+                added++;
+                res = 0;
+            }
+        }
+        else {
+            res = 0;
+        }
+        if (res < 0) {
+            return res;
+        }
+        pos += _entry_size(&e);
+    }
+    return added;
+}
+
+/* walk the live entries of the batch at src: sum up their size and CRC and
+ * copy them behind the batch header at dst unless dst is NO_ADDR */
+static int _gc_batch(kvstore_t *kv, uint32_t src, uint32_t len, uint32_t dst,
+                     uint16_t *crc)
+{
+    uint32_t live = 0;
+
+    for (uint32_t pos = BATCH_HDR_SIZE; pos < (BATCH_HDR_SIZE + len);) {
+        uint8_t buf[ENTRY_HDR_SIZE + KVSTORE_KEY_MAX];
+        _entry_hdr_t e;
+
+        int res = _read(kv, src + pos, &e, sizeof(e));
+        if (res < 0) {
+            return res;
+        }
+        if ((e.key_len == 0) || (e.key_len > KVSTORE_KEY_MAX)) {
+            return -EINVAL;
+        }
+        uint32_t size = _entry_size(&e);
+        uint32_t from = src + pos;
+        pos += size;
+        if (e.val_len == DELETED) {
+            continue;
+        }
+
+        res = _read(kv, from, buf, ENTRY_HDR_SIZE + e.key_len);
+        if (res < 0) {
+            return res;
+        }
+        unsigned idx;
+        res = _find(kv, buf + ENTRY_HDR_SIZE, e.key_len,
+                    _hash(buf + ENTRY_HDR_SIZE, e.key_len), &idx);
+        if (res == -ENOENT) {
+            continue;
+        }
+        if (res < 0) {
+            return res;
+        }
+        if (kv->index[idx].addr != from) {
+            /* overwritten later */
+            continue;
+        }
+
+        uint32_t to = dst + BATCH_HDR_SIZE + live;
+        for (uint32_t done = 0; done < size;) {
+            uint8_t chunk[32];
+            uint32_t n = size - done;
+            if (n > sizeof(chunk)) {
+                n = sizeof(chunk);
+            }
+            res = _read(kv, from + done, chunk, n);
+            if (res < 0) {
+                return res;
+            }
+            *crc = crc16_ccitt_update(*crc, chunk, n);
+            if (dst != NO_ADDR) {
+                res = _program(kv, to + done, chunk, n);
+                if (res < 0) {
+                    return res;
+                }
+            }
+            done += n;
+        }
+        if (dst != NO_ADDR) {
+            kv->index[idx].addr = to;
+        }
+        live += size;
+    }
+    return live;
+}
+
+/* copy the live entries of a sector to the active sector and erase it */
+static int _gc(kvstore_t *kv, uint32_t sector)
+{
+    DEBUG("kvstore: gc sector %" PRIu32 "\n", sector);
+
+    for (uint32_t pos = SECTOR_HDR_SIZE; pos < kv->sector_size;) {
+        uint32_t src = _pos(kv, sector, pos);
+        _batch_hdr_t hdr;
+        int res = _read_batch_hdr(kv, sector, pos, &hdr);
+        if (res == -ENOENT || res == -EINVAL) {
+            break;
+        }
+        if (res < 0) {
+            return res;
+        }
+        /* a torn batch ends the sector, its entries were never indexed */
+        uint16_t crc = crc16_ccitt_calc(NULL, 0);
+        for (uint32_t done = 0; done < hdr.len;) {
+            uint8_t chunk[32];
+            uint32_t n = hdr.len - done;
+            if (n > sizeof(chunk)) {
+                n = sizeof(chunk);
+            }
+            res = _read(kv, src + BATCH_HDR_SIZE + done, chunk, n);
+            if (res < 0) {
+                return res;
+            }
+            crc = crc16_ccitt_update(crc, chunk, n);
+            done += n;
+        }
+        if (crc != hdr.crc) {
+            break;
+        }
+
+        /* the live part of a batch is at most as large as the batch, so it
+         * always fits into the fresh sector */
+        _batch_hdr_t out = { .crc = crc16_ccitt_calc(NULL, 0) };
+        res = _gc_batch(kv, src, hdr.len, NO_ADDR, &out.crc);
+        if (res < 0) {
+            return res;
+        }
+        if (res > 0) {
+            out.len = res;
+            uint32_t dst = _pos(kv, kv->active, kv->wpos);
+            res = _program(kv, dst, &out, sizeof(out));
+            if (res < 0) {
+                return res;
+            }
+            uint16_t crc = 0;
+            res = _gc_batch(kv, src, hdr.len, dst, &crc);
+            if (res < 0) {
+                return res;
+            }
+            kv->wpos += _align(BATCH_HDR_SIZE + out.len);
+        }
+        pos += _align(BATCH_HDR_SIZE + hdr.len);
+    }
+
+    int res = _erase(kv, sector, 1);
+    if (res < 0) {
+        return res;
+    }
+    /* only the sector after the active one is ever garbage collected */
+    kv->erased = 1;
+    kv->used--;
+    kv->stats.gcs++;
+    return 0;
+}
+
+/* start the next sector, it is not erased again if it is known to be blank,
+ * the oldest sector is garbage collected if this takes the last erased one */
+static int _open_sector(kvstore_t *kv)
+{
+    uint32_t next = (kv->active + 1) % kv->numof;
+    if (kv->erased == 0) {
+        int res = _erase(kv, next, 1);
+        if (res < 0) {
+            return res;
+        }
+    }
+    else {
+        kv->erased--;
+    }
+
+    kv->active = next;
+    kv->active_seq++;
+    kv->used++;
+    kv->sealed = false;
+    kv->wpos = SECTOR_HDR_SIZE;
+
+    _sector_hdr_t hdr = {
+        .magic = SECTOR_MAGIC,
+        .seq = kv->active_seq,
+        .reserved = UINT16_MAX,
+    };
+    hdr.crc = _sector_crc(&hdr);
+    DEBUG("kvstore: open sector %" PRIu32 ", seq %" PRIu32 "\n", next, hdr.seq);
+    int res = _program(kv, _pos(kv, next, 0), &hdr, sizeof(hdr));
+    if (res < 0) {
+        return res;
+    }
+
+    if (kv->used == kv->numof) {
+        return _gc(kv, (next + 1) % kv->numof);
+    }
+    return 0;
+}
+
+static int _setup(kvstore_t *kv)
+{
+    mtd_dev_t *mtd = kv->mtd;
+
+    int res = mtd_init(mtd);
+    if (res < 0) {
+        return res;
+    }
+
+    mutex_init(&kv->lock);
+    kv->sector_size = mtd->pages_per_sector * mtd->page_size;
+    kv->numof = kv->sector_count;
+    if (kv->numof == 0) {
+        kv->numof = mtd->sector_count - kv->first_sector;
+    }
+    if ((kv->numof < 2) || (kv->first_sector >= mtd->sector_count) ||
+        (kv->numof > (mtd->sector_count - kv->first_sector)) ||
+        (kv->sector_size < (SECTOR_HDR_SIZE + KVSTORE_BATCH_SIZE))) {
+        return -EINVAL;
+    }
+    memset(&kv->stats, 0, sizeof(kv->stats));
+    for (unsigned i = 0; i < KVSTORE_INDEX_SIZE; i++) {
+        kv->index[i].addr = NO_ADDR;
+    }
+    kv->keys = 0;
+    kv->active = kv->numof - 1;
+    kv->active_seq = 0;
+    kv->used = 0;
+    kv->wpos = kv->sector_size;
+    kv->sealed = true;
+    kv->erased = 0;
+    kv->batch_len = BATCH_HDR_SIZE;
+    return 0;
+}
+
+/* index all batches of a sector, the batch buffer is used for reading */
+static int _scan(kvstore_t *kv, uint32_t sector)
+{
+    uint32_t pos = SECTOR_HDR_SIZE;
+
+    while (1) {
+        uint32_t off = _pos(kv, sector, pos);
+        _batch_hdr_t hdr;
+        int res = _read_batch_hdr(kv, sector, pos, &hdr);
+        if (res == -ENOENT) {
+            break;
+        }
+        if ((res < 0) && (res != -EINVAL)) {
+            return res;
+        }
+        if (res == 0) {
+            res = _read(kv, off, kv->batch, BATCH_HDR_SIZE + hdr.len);
+            if (res < 0) {
+                return res;
+            }
+        }
+        if ((res < 0) ||
+            (crc16_ccitt_calc(kv->batch + BATCH_HDR_SIZE, hdr.len) != hdr.crc)) {
+            /* torn write, don't touch the rest of this sector */
+            DEBUG("kvstore: torn batch at %" PRIu32 "\n", off);
+            kv->sealed = (sector == kv->active);
+            break;
+        }
+        res = _apply_batch(kv, kv->batch, BATCH_HDR_SIZE + hdr.len, off);
+        if (res < 0) {
+            return res;
+        }
+        pos += _align(BATCH_HDR_SIZE + hdr.len);
+    }
+    if (sector == kv->active) {
+        kv->wpos = pos;
+    }
+    return 0;
+}
+
+int kvstore_format(kvstore_t *kv)
+{
+    int res = _setup(kv);
+    if (res < 0) {
+        return res;
+    }
+    res = _erase(kv, 0, kv->numof);
+    if (res < 0) {
+        return res;
+    }
+    kv->erased = kv->numof;
+    return 0;
+}
+
+int kvstore_mount(kvstore_t *kv)
+{
+    int res = _setup(kv);
+    if (res < 0) {
+        return res;
+    }
+
+    _sector_hdr_t hdr;
+    bool found = false;
+    for (uint32_t i = 0; i < kv->numof; i++) {
+        res = _read_sector_hdr(kv, i, &hdr);
+        if (res == -ENOENT) {
+            continue;
+        }
+        if (res < 0) {
+            return res;
+        }
+        if (!found || ((int32_t)(hdr.seq - kv->active_seq) > 0)) {
+            kv->active = i;
+            kv->active_seq = hdr.seq;
+            found = true;
+        }
+    }
+    if (!found) {
+        DEBUG("kvstore: empty\n");
+        return 0;
+    }
+
+    /* older sectors precede the active one with consecutive sequence
+     * numbers */
+    kv->used = 1;
+    for (uint32_t i = 1; i < kv->numof; i++) {
+        uint32_t sector = (kv->active + kv->numof - i) % kv->numof;
+        res = _read_sector_hdr(kv, sector, &hdr);
+        if ((res < 0) && (res != -ENOENT)) {
+            return res;
+        }
+        if ((res == -ENOENT) || (hdr.seq != (kv->active_seq - i))) {
+            break;
+        }
+        kv->used++;
+    }
+
+    if (kv->used == kv->numof) {
+        /* interrupted garbage collection: the active sector only holds
+         * copies of entries still present in the oldest one, start over */
+        DEBUG("kvstore: resume gc\n");
+        res = _erase(kv, kv->active, 1);
+        if (res < 0) {
+            return res;
+        }
+        kv->active = (kv->active + kv->numof - 1) % kv->numof;
+        kv->active_seq--;
+        kv->used--;
+        kv->erased = 1;
+    }
+
+    DEBUG("kvstore: active %" PRIu32 ", seq %" PRIu32 ", %" PRIu32 " sectors\n",
+          kv->active, kv->active_seq, kv->used);
+    kv->sealed = false;
+    for (uint32_t i = kv->used; i > 0; i--) {
+        res = _scan(kv, (kv->active + kv->numof - i + 1) % kv->numof);
+        if (res < 0) {
+            return res;
+        }
+    }
+    kv->batch_len = BATCH_HDR_SIZE;
+    return 0;
+}
+
+int kvstore_get(kvstore_t *kv, const char *key, void *value, size_t len)
+{
+    size_t key_len = strlen(key);
+
+    if ((key_len == 0) || (key_len > KVSTORE_KEY_MAX)) {
+        return -EINVAL;
+    }
+
+    mutex_lock(&kv->lock);
+    unsigned idx;
+    int res = _find(kv, (const uint8_t *)key, key_len,
+                    _hash((const uint8_t *)key, key_len), &idx);
+    if (res == 0) {
+        const kvstore_slot_t *slot = &kv->index[idx];
+        if (slot->len > len) {
+            res = -ENOBUFS;
+        }
+        else {
+            res = _read(kv, slot->addr + ENTRY_HDR_SIZE + key_len, value,
+                        slot->len);
+        }
+        if (res == 0) {
+            res = slot->len;
+        }
+    }
+    mutex_unlock(&kv->lock);
+    return res;
+}
+
+void kvstore_begin(kvstore_t *kv)
+{
+    mutex_lock(&kv->lock);
+    kv->batch_len = BATCH_HDR_SIZE;
+}
+
+static int _add(kvstore_t *kv, const char *key, const void *value,
+                uint16_t len)
+{
+    size_t key_len = strlen(key);
+
+    if ((key_len == 0) || (key_len > KVSTORE_KEY_MAX)) {
+        return -EINVAL;
+    }
+
+    _entry_hdr_t e = {
+        .key_len = key_len,
+        .reserved = UINT8_MAX,
+        .val_len = len,
+    };
+    uint32_t size = _entry_size(&e);
+    if (_align(kv->batch_len + size) > KVSTORE_BATCH_SIZE) {
+        return -ENOBUFS;
+    }
+
+    uint8_t *dst = kv->batch + kv->batch_len;
+    memcpy(dst, &e, sizeof(e));
+    memcpy(dst + ENTRY_HDR_SIZE, key, key_len);
+    if ((len != DELETED) && (len > 0)) {
+        memcpy(dst + ENTRY_HDR_SIZE + key_len, value, len);
+    }
+    kv->batch_len += size;
+    return 0;
+}
+
+int kvstore_put(kvstore_t *kv, const char *key, const void *value, size_t len)
+{
+    if (len >= DELETED) {
+        return -ENOBUFS;
+    }
+    return _add(kv, key, value, len);
+}
+
+int kvstore_delete(kvstore_t *kv, const char *key)
+{
+    return _add(kv, key, NULL, DELETED);
+}
+
+static int _commit(kvstore_t *kv)
+{
+    int res = _apply_batch(kv, kv->batch, kv->batch_len, NO_ADDR);
+    if (res < 0) {
+        return res;
+    }
+    if ((kv->keys + res) > (KVSTORE_INDEX_SIZE - 1)) {
+        return -ENOMEM;
+    }
+
+    uint32_t size = _align(kv->batch_len);
+    for (unsigned tries = 0;
+         kv->sealed || ((kv->wpos + size) > kv->sector_size); tries++) {
+        if (tries == kv->numof) {
+            return -ENOSPC;
+        }
+        res = _open_sector(kv);
+        if (res < 0) {
+            return res;
+        }
+    }
+
+    _batch_hdr_t hdr = {
+        .len = kv->batch_len - BATCH_HDR_SIZE,
+        .crc = crc16_ccitt_calc(kv->batch + BATCH_HDR_SIZE,
+                                kv->batch_len - BATCH_HDR_SIZE),
+    };
+    memcpy(kv->batch, &hdr, sizeof(hdr));
+
+    uint32_t off = _pos(kv, kv->active, kv->wpos);
+    res = _program(kv, off, kv->batch, kv->batch_len);
+    if (res < 0) {
+        /* don't append behind a partially programmed batch */
+        kv->sealed = true;
+        return res;
+    }
+    kv->wpos += size;
+    return _apply_batch(kv, kv->batch, kv->batch_len, off);
+}
+
+int kvstore_commit(kvstore_t *kv)
+{
+    int res = 0;
+
+    if (kv->batch_len > BATCH_HDR_SIZE) {
+        res = _commit(kv);
+    }
+    kv->batch_len = BATCH_HDR_SIZE;
+    mutex_unlock(&kv->lock);
+    return (res < 0) ? res : 0;
+}
+
+void kvstore_abort(kvstore_t *kv)
+{
+    kv->batch_len = BATCH_HDR_SIZE;
+    mutex_unlock(&kv->lock);
+}
+
+int kvstore_set(kvstore_t *kv, const char *key, const void *value, size_t len)
+{
+    kvstore_begin(kv);
+    int res = kvstore_put(kv, key, value, len);
+    if (res < 0) {
+        kvstore_abort(kv);
+        return res;
+    }
+    return kvstore_commit(kv);
+}
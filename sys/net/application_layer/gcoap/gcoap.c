@@ -26,40 +26,45 @@
 #include <string.h>
 
 #include "assert.h"
+#include "hashes.h"
 #include "net/gcoap.h"
 #include "net/sock/util.h"
 #include "mutex.h"
 #include "random.h"
 #include "thread.h"
 
+#include "gcoap_internal.h"
+
 #define ENABLE_DEBUG (0)
 #include "debug.h"
 
-/* Return values used by the _find_resource function. */
-#define GCOAP_RESOURCE_FOUND 0
-#define GCOAP_RESOURCE_WRONG_METHOD -1
-#define GCOAP_RESOURCE_NO_PATH -2
-
 /* Internal functions */
 static void *_event_loop(void *arg);
 static void _listen(sock_udp_t *sock);
 static ssize_t _well_known_core_handler(coap_pkt_t* pdu, uint8_t *buf, size_t len, void *ctx);
-static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
-                                                         sock_udp_ep_t *remote);
 static void _expire_request(gcoap_request_memo_t *memo);
-static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *pdu,
-                           const sock_udp_ep_t *remote);
-static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr);
+#if GCOAP_RESOURCE_INDEX_SIZE
+static void _index_listener(gcoap_listener_t *listener);
+#endif
 static int _find_observer(sock_udp_ep_t **observer, sock_udp_ep_t *remote);
 static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
                                                        coap_pkt_t *pdu);
-static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
-                                   const coap_resource_t *resource);
+#if GCOAP_QBLOCK_BURST
+static void _handle_qblock2_req(sock_udp_t *sock, coap_pkt_t *pdu,
+                                sock_udp_ep_t *remote);
+#endif
+#if GCOAP_RESP_CACHE_SIZE
+static int _cache_key(coap_pkt_t *pdu, char *uri, uint16_t *accept);
+static ssize_t _cache_lookup(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             const char *uri, uint16_t accept);
+static void _cache_store(const coap_resource_t *resource, const char *uri,
+                         uint16_t accept, uint8_t *buf, size_t len);
+#endif
 
 /* Internal variables */
 const coap_resource_t _default_resources[] = {
-    { "/.well-known/core", COAP_GET, _well_known_core_handler, NULL },
+    { "/.well-known/core", COAP_GET | COAP_CACHEABLE,
+      _well_known_core_handler, NULL },
 };
 
 static gcoap_listener_t _default_listener = {
@@ -69,6 +74,20 @@ static gcoap_listener_t _default_listener = {
     NULL
 };
 
+#if GCOAP_RESP_CACHE_SIZE
+/* Response to a GET request kept in the response cache */
+typedef struct {
+    const coap_resource_t *resource;    /* Resource that generated the
+                                           response; NULL if entry is unused */
+    uint32_t expires;                   /* Expiry time, in seconds */
+    uint16_t accept;                    /* Accept option of the request, or
+                                           COAP_FORMAT_NONE if absent */
+    uint16_t len;                       /* Length of the response PDU */
+    char uri[NANOCOAP_URI_MAX];         /* Path and query of the request */
+    uint8_t pdu[GCOAP_PDU_BUF_SIZE];    /* Response PDU */
+} gcoap_cache_entry_t;
+#endif
+
 /* Container for the state of gcoap itself */
 typedef struct {
     mutex_t lock;                       /* Shares state attributes safely */
@@ -83,10 +102,28 @@ typedef struct {
                                            observe memos */
     gcoap_observe_memo_t observe_memos[GCOAP_OBS_REGISTRATIONS_MAX];
                                         /* Observed resource registrations */
+    gcoap_request_memo_t *req_index[GCOAP_MEMO_INDEX_BUCKETS];
+                                        /* Open requests hashed by token */
+    unsigned open_reqs_numof;           /* Number of open requests in
+                                           req_index */
+    gcoap_observe_memo_t *obs_index[GCOAP_MEMO_INDEX_BUCKETS];
+                                        /* Observe registrations hashed by
+                                           resource */
     uint8_t resend_bufs[GCOAP_RESEND_BUFS_MAX][GCOAP_PDU_BUF_SIZE];
                                         /* Buffers for PDU for request resends;
                                            if first byte of an entry is zero,
                                            the entry is available */
+#if GCOAP_RESOURCE_INDEX_SIZE
+    coap_resource_index_t resource_index;
+                                        /* Hashed dispatch index over the
+                                           resources of all listeners */
+    const coap_resource_t *resource_slots[GCOAP_RESOURCE_INDEX_SIZE];
+                                        /* Slot storage for resource_index */
+#endif
+#if GCOAP_RESP_CACHE_SIZE
+    gcoap_cache_entry_t resp_cache[GCOAP_RESP_CACHE_SIZE];
+                                        /* Cached responses to GET requests */
+#endif
 } gcoap_state_t;
 
 static gcoap_state_t _coap_state = {
@@ -98,6 +135,10 @@ static char _msg_stack[GCOAP_STACK_SIZE];
 static msg_t _msg_queue[GCOAP_MSG_QUEUE_SIZE];
 static uint8_t _listen_buf[GCOAP_PDU_BUF_SIZE];
 static sock_udp_t _sock;
+#if GCOAP_QBLOCK_BURST
+static uint8_t _qblock_req_buf[GCOAP_PDU_BUF_SIZE];
+static uint8_t _qblock_resp_buf[GCOAP_PDU_BUF_SIZE];
+#endif
 
 
 /* Event/Message loop for gcoap _pid thread. */
@@ -215,8 +256,15 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_REQ:
         if (coap_get_type(&pdu) == COAP_TYPE_NON
                 || coap_get_type(&pdu) == COAP_TYPE_CON) {
-            size_t pdu_len = _handle_req(&pdu, _listen_buf, sizeof(_listen_buf),
-                                         &remote);
+#if GCOAP_QBLOCK_BURST
+            uint8_t *qblock2;
+            if (coap_opt_get_opaque(&pdu, COAP_OPT_Q_BLOCK2, &qblock2) >= 0) {
+                _handle_qblock2_req(sock, &pdu, &remote);
+                break;
+            }
+#endif
+            size_t pdu_len = _gcoap_handle_req(&pdu, _listen_buf,
+                                               sizeof(_listen_buf), &remote);
             if (pdu_len > 0) {
                 ssize_t bytes = sock_udp_send(sock, _listen_buf, pdu_len,
                                               &remote);
@@ -234,12 +282,13 @@ static void _listen(sock_udp_t *sock)
     case COAP_CLASS_SUCCESS:
     case COAP_CLASS_CLIENT_FAILURE:
     case COAP_CLASS_SERVER_FAILURE:
-        _find_req_memo(&memo, &pdu, &remote);
+        _gcoap_find_req_memo(&memo, &pdu, &remote);
         if (memo) {
             switch (coap_get_type(&pdu)) {
             case COAP_TYPE_NON:
             case COAP_TYPE_ACK:
                 xtimer_remove(&memo->response_timer);
+                _gcoap_req_memo_unlink(memo);
                 memo->state = GCOAP_MEMO_RESP;
                 if (memo->resp_handler) {
                     memo->resp_handler(memo, &pdu, &remote);
@@ -274,26 +323,38 @@ static void _listen(sock_udp_t *sock)
  *
  * return length of response pdu, or < 0 if can't handle
  */
-static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
-                                                         sock_udp_ep_t *remote)
+size_t _gcoap_handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         sock_udp_ep_t *remote)
 {
     const coap_resource_t *resource     = NULL;
-    gcoap_listener_t *listener          = NULL;
     sock_udp_ep_t *observer             = NULL;
     gcoap_observe_memo_t *memo          = NULL;
     gcoap_observe_memo_t *resource_memo = NULL;
 
-    switch (_find_resource(pdu, &resource, &listener)) {
+    switch (_gcoap_find_resource(pdu, &resource)) {
         case GCOAP_RESOURCE_WRONG_METHOD:
             return gcoap_response(pdu, buf, len, COAP_CODE_METHOD_NOT_ALLOWED);
         case GCOAP_RESOURCE_NO_PATH:
             return gcoap_response(pdu, buf, len, COAP_CODE_PATH_NOT_FOUND);
         case GCOAP_RESOURCE_FOUND:
             /* find observe registration for resource */
-            _find_obs_memo_resource(&resource_memo, resource);
+            _gcoap_find_obs_memo_resource(&resource_memo, resource);
             break;
     }
 
+#if GCOAP_RESP_CACHE_SIZE
+    char uri[NANOCOAP_URI_MAX];
+    uint16_t accept;
+    bool cacheable = (resource->methods & COAP_CACHEABLE)
+                     && (_cache_key(pdu, uri, &accept) == 0);
+    if (cacheable) {
+        ssize_t pdu_len = _cache_lookup(pdu, buf, len, uri, accept);
+        if (pdu_len > 0) {
+            return pdu_len;
+        }
+    }
+#endif
+
     if (coap_get_observe(pdu) == COAP_OBS_REGISTER) {
         /* lookup remote+token */
         int empty_slot = _find_obs_memo(&memo, remote, pdu);
@@ -339,8 +400,11 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         }
         /* finish registration */
         if (memo != NULL) {
-            /* resource may be assigned here if it is not already registered */
+            /* resource may be assigned here if it is not already registered;
+             * re-index in case it changed */
+            _gcoap_obs_memo_unlink(memo);
             memo->resource = resource;
+            _gcoap_obs_memo_link(memo);
             memo->token_len = coap_get_token_len(pdu);
             if (memo->token_len) {
                 memcpy(&memo->token[0], pdu->token, memo->token_len);
@@ -353,6 +417,7 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         /* clear memo, and clear observer if no other memos */
         if (memo != NULL) {
             DEBUG("gcoap: Deregistering observer for: %s\n", memo->resource->path);
+            _gcoap_obs_memo_unlink(memo);
             memo->observer = NULL;
             memo           = NULL;
             _find_obs_memo(&memo, remote, NULL);
@@ -376,21 +441,441 @@ static size_t _handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
         pdu_len = gcoap_response(pdu, buf, len,
                                  COAP_CODE_INTERNAL_SERVER_ERROR);
     }
+#if GCOAP_RESP_CACHE_SIZE
+    else if (cacheable) {
+        _cache_store(resource, uri, accept, buf, pdu_len);
+    }
+#endif
+    return pdu_len;
+}
+
+#if GCOAP_RESP_CACHE_SIZE
+/*
+ * Reads an unsigned integer option.
+ *
+ * return value of the option, or dflt if the option is absent or invalid
+ */
+static uint32_t _opt_get_uint(coap_pkt_t *pdu, unsigned onum, uint32_t dflt)
+{
+    uint8_t *value;
+    ssize_t len = coap_opt_get_opaque(pdu, onum, &value);
+    if ((len < 0) || (len > 4)) {
+        return dflt;
+    }
+
+    uint32_t res = 0;
+    while (len--) {
+        res = (res << 8) | *value++;
+    }
+    return res;
+}
+
+/* Current time for cache expiry, in seconds */
+static uint32_t _cache_now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+/*
+ * Writes the cache key of a request: its Uri-Path and Uri-Query joined into
+ * uri, and its Accept option.
+ *
+ * uri[out] -- Buffer of NANOCOAP_URI_MAX bytes
+ * accept[out] -- Accept option, or COAP_FORMAT_NONE if absent
+ *
+ * return 0 on success, or -1 if the request must not be served from cache
+ */
+static int _cache_key(coap_pkt_t *pdu, char *uri, uint16_t *accept)
+{
+    uint8_t *value;
+
+    if ((coap_get_code_detail(pdu) != COAP_METHOD_GET)
+            || coap_has_observe(pdu)
+            || (coap_opt_get_opaque(pdu, COAP_OPT_BLOCK2, &value) >= 0)
+            || (coap_opt_get_opaque(pdu, COAP_OPT_Q_BLOCK2, &value) >= 0)) {
+        return -1;
+    }
+
+    ssize_t path_len = coap_get_uri_path(pdu, (uint8_t *)uri);
+    if ((path_len < 0) || (path_len > NANOCOAP_URI_MAX - 2)) {
+        return -1;
+    }
+    /* append query in place of the terminating '\0' of the path */
+    if (coap_opt_get_string(pdu, COAP_OPT_URI_QUERY,
+                            (uint8_t *)uri + path_len - 1,
+                            NANOCOAP_URI_MAX - path_len + 1, '&') < 0) {
+        return -1;
+    }
+
+    *accept = _opt_get_uint(pdu, COAP_OPT_ACCEPT, COAP_FORMAT_NONE);
+    return 0;
+}
+
+/*
+ * Finds a fresh cache entry for a key; lock must be held.
+ */
+static gcoap_cache_entry_t *_cache_find(const char *uri, uint16_t accept)
+{
+    uint32_t now = _cache_now();
+
+    for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+        gcoap_cache_entry_t *entry = &_coap_state.resp_cache[i];
+        if (entry->resource == NULL) {
+            continue;
+        }
+        if ((int32_t)(entry->expires - now) <= 0) {
+            entry->resource = NULL;
+            continue;
+        }
+        if ((entry->accept == accept) && (strcmp(entry->uri, uri) == 0)) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/*
+ * Tests if the request carries an ETag option matching the given value.
+ */
+static bool _cache_etag_match(coap_pkt_t *pdu, const uint8_t *etag,
+                              size_t etag_len)
+{
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t len;
+    bool init = true;
+
+    while ((len = coap_opt_get_next(pdu, &opt, &value, init)) >= 0) {
+        init = false;
+        if (opt.opt_num > COAP_OPT_ETAG) {
+            break;
+        }
+        if ((opt.opt_num == COAP_OPT_ETAG) && ((size_t)len == etag_len)
+                && (memcmp(value, etag, etag_len) == 0)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/*
+ * Writes a response to a request from a cached response, if one is fresh.
+ *
+ * The request header and token are kept, the options of the cached response
+ * are copied with Max-Age set to the remaining freshness. If the request
+ * carries the ETag of the cached response, 2.03 Valid is sent without
+ * payload.
+ *
+ * return length of response pdu, or 0 on cache miss
+ */
+static ssize_t _cache_lookup(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                             const char *uri, uint16_t accept)
+{
+    ssize_t pdu_len = 0;
+    coap_pkt_t cached;
+
+    mutex_lock(&_coap_state.lock);
+    gcoap_cache_entry_t *entry = _cache_find(uri, accept);
+    if ((entry == NULL) || (coap_parse(&cached, entry->pdu, entry->len) < 0)) {
+        goto out;
+    }
+    /* The request is overwritten from here on, so make sure the response
+     * fits: it differs from the cached one in token length and in the
+     * Max-Age option, which takes at most 6 bytes. */
+    size_t req_hdr_len = coap_get_total_hdr_len(pdu);
+    if (req_hdr_len + entry->len - coap_get_total_hdr_len(&cached) + 6 > len) {
+        goto out;
+    }
+    uint32_t max_age = entry->expires - _cache_now();
+
+    uint8_t *etag;
+    ssize_t etag_len = coap_opt_get_opaque(&cached, COAP_OPT_ETAG, &etag);
+    bool valid = (etag_len >= 0) && _cache_etag_match(pdu, etag, etag_len);
+
+    if (coap_get_type(pdu) == COAP_TYPE_CON) {
+        coap_hdr_set_type(pdu->hdr, COAP_TYPE_ACK);
+    }
+    coap_hdr_set_code(pdu->hdr,
+                      valid ? COAP_CODE_VALID : coap_get_code_raw(&cached));
+
+    coap_pkt_t resp;
+    coap_pkt_init(&resp, buf, len, req_hdr_len);
+
+    coap_optpos_t opt;
+    uint8_t *value;
+    ssize_t opt_len;
+    bool init = true;
+    bool age_added = false;
+    while ((opt_len = coap_opt_get_next(&cached, &opt, &value, init)) >= 0) {
+        init = false;
+        if (!age_added && (opt.opt_num >= COAP_OPT_MAX_AGE)) {
+            coap_opt_add_uint(&resp, COAP_OPT_MAX_AGE, max_age);
+            age_added = true;
+        }
+        /* a 2.03 response only updates ETag and Max-Age */
+        if ((opt.opt_num != COAP_OPT_MAX_AGE)
+                && (!valid || (opt.opt_num == COAP_OPT_ETAG))) {
+            coap_opt_add_opaque(&resp, opt.opt_num, value, opt_len);
+        }
+    }
+    if (!age_added) {
+        coap_opt_add_uint(&resp, COAP_OPT_MAX_AGE, max_age);
+    }
+
+    if (!valid && cached.payload_len) {
+        coap_opt_finish(&resp, COAP_OPT_FINISH_PAYLOAD);
+        memcpy(resp.payload, cached.payload, cached.payload_len);
+        pdu_len = (resp.payload - buf) + cached.payload_len;
+    }
+    else {
+        pdu_len = coap_opt_finish(&resp, COAP_OPT_FINISH_NONE);
+    }
+    DEBUG("gcoap: response for %s served from cache\n", uri);
+
+out:
+    mutex_unlock(&_coap_state.lock);
     return pdu_len;
 }
 
 /*
- * Searches listener registrations for the resource matching the path in a PDU.
+ * Keeps a response to a cacheable request, if it is a 2.05 response
+ * without Block2 option and with non-zero Max-Age.
+ */
+static void _cache_store(const coap_resource_t *resource, const char *uri,
+                         uint16_t accept, uint8_t *buf, size_t len)
+{
+    coap_pkt_t resp;
+    uint8_t *value;
+
+    if ((len > GCOAP_PDU_BUF_SIZE) || (coap_parse(&resp, buf, len) < 0)
+            || (coap_get_code_raw(&resp) != COAP_CODE_CONTENT)
+            || (coap_opt_get_opaque(&resp, COAP_OPT_BLOCK2, &value) >= 0)) {
+        return;
+    }
+    /* RFC 7252, sec. 5.10.5: default Max-Age is 60 seconds */
+    uint32_t max_age = _opt_get_uint(&resp, COAP_OPT_MAX_AGE, 60);
+    bool has_age = coap_opt_get_opaque(&resp, COAP_OPT_MAX_AGE, &value) >= 0;
+    /* a Max-Age option is added when serving from cache */
+    if ((max_age == 0)
+            || (!has_age && (resp.options_len >= NANOCOAP_NOPTS_MAX))) {
+        return;
+    }
+
+    mutex_lock(&_coap_state.lock);
+    /* replace the entry for this key, else an unused or expired entry, else
+     * the entry closest to expiry */
+    gcoap_cache_entry_t *entry = _cache_find(uri, accept);
+    for (unsigned i = 0; (entry == NULL) && (i < GCOAP_RESP_CACHE_SIZE); i++) {
+        if (_coap_state.resp_cache[i].resource == NULL) {
+            entry = &_coap_state.resp_cache[i];
+        }
+    }
+    if (entry == NULL) {
+        uint32_t now = _cache_now();
+        entry = &_coap_state.resp_cache[0];
+        for (unsigned i = 1; i < GCOAP_RESP_CACHE_SIZE; i++) {
+            gcoap_cache_entry_t *cur = &_coap_state.resp_cache[i];
+            if ((cur->expires - now) < (entry->expires - now)) {
+                entry = cur;
+            }
+        }
+    }
+
+    entry->resource = resource;
+    entry->expires  = _cache_now() + max_age;
+    entry->accept   = accept;
+    entry->len      = len;
+    strcpy(entry->uri, uri);
+    memcpy(entry->pdu, buf, len);
+    mutex_unlock(&_coap_state.lock);
+}
+#endif
+
+#if GCOAP_QBLOCK_BURST
+/*
+ * Copies a PDU to a buffer, dropping all Block2 and Q-Block2 options and
+ * adding a single option in their place.
+ *
+ * src[in] -- PDU to copy
+ * buf[out] -- Buffer for the copy
+ * len[in] -- Length of buf
+ * onum[in] -- Option number of the added block option
+ * val[in] -- Value of the added block option
+ *
+ * return length of the copy, or -ENOSPC if buf is too small
+ */
+static ssize_t _qblock_copy_pdu(coap_pkt_t *src, uint8_t *buf, size_t len,
+                                uint16_t onum, uint32_t val)
+{
+    size_t hdr_len = coap_get_total_hdr_len(src);
+    uint8_t *pos = buf + hdr_len;
+    uint8_t *end = buf + len;
+    uint16_t lastonum = 0;
+    bool added = false;
+    coap_optpos_t opt;
+    uint8_t *value;
+
+    /* an option header takes at most 5 bytes, a block value at most 3 */
+    if ((hdr_len + 8) > len) {
+        return -ENOSPC;
+    }
+    memcpy(buf, src->hdr, hdr_len);
+    for (ssize_t optlen = coap_opt_get_next(src, &opt, &value, true);
+         optlen >= 0; optlen = coap_opt_get_next(src, &opt, &value, false)) {
+        if (!added && (opt.opt_num > onum)) {
+            pos += coap_opt_put_uint(pos, lastonum, onum, val);
+            lastonum = onum;
+            added = true;
+        }
+        if ((opt.opt_num == COAP_OPT_BLOCK2) ||
+            (opt.opt_num == COAP_OPT_Q_BLOCK2)) {
+            continue;
+        }
+        if ((pos + 5 + optlen + ((added) ? 0 : 8)) > end) {
+            return -ENOSPC;
+        }
+        pos += coap_put_option(pos, lastonum, opt.opt_num, value, optlen);
+        lastonum = opt.opt_num;
+    }
+    if (!added) {
+        pos += coap_opt_put_uint(pos, lastonum, onum, val);
+    }
+    if (src->payload_len) {
+        if ((pos + 1 + src->payload_len) > end) {
+            return -ENOSPC;
+        }
+        *pos++ = 0xFF;
+        memcpy(pos, src->payload, src->payload_len);
+        pos += src->payload_len;
+    }
+    return pos - buf;
+}
+
+unsigned _gcoap_qblock2_nums(coap_pkt_t *req, uint32_t *nums, unsigned *szx)
+{
+    unsigned count = 0;
+    coap_optpos_t opt;
+    uint8_t *value;
+
+    for (ssize_t optlen = coap_opt_get_next(req, &opt, &value, true);
+         (optlen >= 0) && (count < GCOAP_QBLOCK_BURST);
+         optlen = coap_opt_get_next(req, &opt, &value, false)) {
+        if ((opt.opt_num != COAP_OPT_Q_BLOCK2) || (optlen > 3)) {
+            continue;
+        }
+        uint32_t blkopt = 0;
+        for (ssize_t i = 0; i < optlen; i++) {
+            blkopt = (blkopt << 8) | value[i];
+        }
+        *szx = blkopt & COAP_BLOCKWISE_SZX_MASK;
+        nums[count++] = blkopt >> COAP_BLOCKWISE_NUM_OFF;
+        if ((blkopt & 0x8) && (count == 1)) {
+            /* M bit: send a burst of the following blocks */
+            if (coap_get_type(req) == COAP_TYPE_NON) {
+                for (; count < GCOAP_QBLOCK_BURST; count++) {
+                    nums[count] = nums[0] + count;
+                }
+            }
+            break;
+        }
+    }
+    return count;
+}
+
+ssize_t _gcoap_qblock2_resp(coap_pkt_t *req, unsigned idx, uint32_t num,
+                            unsigned szx, sock_udp_ep_t *remote,
+                            uint8_t **out, bool *last)
+{
+    coap_pkt_t pdu;
+    coap_pkt_t resp;
+    uint32_t blknum;
+    unsigned resp_szx;
+
+    ssize_t len = _qblock_copy_pdu(req, _listen_buf, sizeof(_listen_buf),
+                                   COAP_OPT_BLOCK2,
+                                   (num << COAP_BLOCKWISE_NUM_OFF) | szx);
+    if ((len < 0) || (coap_parse(&pdu, _listen_buf, len) < 0)) {
+        DEBUG("gcoap: can't build Block2 request: %d\n", (int)len);
+        return -1;
+    }
+    len = (ssize_t)_gcoap_handle_req(&pdu, _listen_buf, sizeof(_listen_buf),
+                                     remote);
+    if ((len <= 0) || (coap_parse(&resp, _listen_buf, len) < 0)) {
+        return -1;
+    }
+    int more = coap_get_blockopt(&resp, COAP_OPT_BLOCK2, &blknum, &resp_szx);
+    /* stop after an error, a non-blockwise resource, or the last block */
+    *last = (coap_get_code_class(&resp) != COAP_CLASS_SUCCESS) || (more < 1);
+    *out = _listen_buf;
+    if (more >= 0) {
+        len = _qblock_copy_pdu(&resp, _qblock_resp_buf,
+                               sizeof(_qblock_resp_buf), COAP_OPT_Q_BLOCK2,
+                               (blknum << COAP_BLOCKWISE_NUM_OFF) |
+                               (more ? 0x8 : 0) | resp_szx);
+        if (len < 0) {
+            DEBUG("gcoap: can't build Q-Block2 response\n");
+            return -1;
+        }
+        *out = _qblock_resp_buf;
+    }
+    if (idx > 0) {
+        /* every response after the first is a new NON message, as the
+         * request can be acknowledged only once (RFC 9177, 4.4) */
+        coap_hdr_t *hdr = (coap_hdr_t *)*out;
+        coap_hdr_set_type(hdr, COAP_TYPE_NON);
+        hdr->id = htons((uint16_t)atomic_fetch_add(&_coap_state.next_message_id,
+                                                   1));
+    }
+    return len;
+}
+
+/*
+ * Handles a request carrying Q-Block2 options (RFC 9177). Each requested
+ * block is served by running the resource handler on a copy of the request
+ * that carries a Block2 option instead, then converting the Block2 option of
+ * the response back to Q-Block2.
  *
- * param[out] resource_ptr -- found resource
- * param[out] listener_ptr -- listener for found resource
- * return `GCOAP_RESOURCE_FOUND` if the resource was found,
- *        `GCOAP_RESOURCE_WRONG_METHOD` if a resource was found but the method
- *        code didn't match and `GCOAP_RESOURCE_NO_PATH` if no matching
- *        resource was found.
+ * sock[in] -- Socket to send the responses
+ * pdu[in] -- Received request, parsed from _listen_buf
+ * remote[in] -- Requesting endpoint
  */
-static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
-                                            gcoap_listener_t **listener_ptr)
+static void _handle_qblock2_req(sock_udp_t *sock, coap_pkt_t *pdu,
+                                sock_udp_ep_t *remote)
+{
+    uint32_t nums[GCOAP_QBLOCK_BURST];
+    unsigned szx = 0;
+    coap_pkt_t req;
+
+    /* keep the request, _listen_buf is overwritten by every response */
+    size_t req_len = (pdu->payload - (uint8_t *)pdu->hdr) + pdu->payload_len;
+    memcpy(_qblock_req_buf, pdu->hdr, req_len);
+    if (coap_parse(&req, _qblock_req_buf, req_len) < 0) {
+        return;
+    }
+
+    unsigned count = _gcoap_qblock2_nums(&req, nums, &szx);
+    for (unsigned i = 0; i < count; i++) {
+        uint8_t *out;
+        bool last;
+
+        ssize_t len = _gcoap_qblock2_resp(&req, i, nums[i], szx, remote,
+                                          &out, &last);
+        if (len <= 0) {
+            return;
+        }
+        ssize_t bytes = sock_udp_send(sock, out, len, remote);
+        if (bytes <= 0) {
+            DEBUG("gcoap: send response failed: %d\n", (int)bytes);
+            return;
+        }
+        if (last) {
+            return;
+        }
+    }
+}
+#endif /* GCOAP_QBLOCK_BURST */
+
+int _gcoap_find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr)
 {
     int ret = GCOAP_RESOURCE_NO_PATH;
     coap_method_flags_t method_flag = coap_method2flag(coap_get_code_detail(pdu));
@@ -403,12 +888,48 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
         return GCOAP_RESOURCE_NO_PATH;
     }
 
+    const coap_resource_t *found = NULL;
+#if GCOAP_RESOURCE_INDEX_SIZE
+    /* gcoap_register_listener() may add to the index concurrently */
+    mutex_lock(&_coap_state.lock);
+    if (_coap_state.resource_index.slots == NULL) {
+        _index_listener(&_default_listener);
+    }
+    switch (coap_resource_index_find(&_coap_state.resource_index, uri,
+                                     method_flag, &found)) {
+        case 0:
+            break;
+        case -EPERM:
+            ret = GCOAP_RESOURCE_WRONG_METHOD;
+            /* fall through */
+        default:
+            found = NULL;
+            break;
+    }
+    bool all_indexed = (_coap_state.resource_index.unindexed == 0);
+    mutex_unlock(&_coap_state.lock);
+    if (all_indexed) {
+        /* all resources indexed, so the index answer is final */
+        if (found) {
+            *resource_ptr = found;
+            return GCOAP_RESOURCE_FOUND;
+        }
+        return ret;
+    }
+#endif
+
+    /* an unindexed resource of an earlier listener, or earlier in the same
+     * listener, takes precedence over the indexed hit */
     while (listener) {
         const coap_resource_t *resource = listener->resources;
         for (size_t i = 0; i < listener->resources_len; i++) {
             if (i) {
                 resource++;
             }
+            if (resource == found) {
+                *resource_ptr = found;
+                return GCOAP_RESOURCE_FOUND;
+            }
 
             int res = coap_match_path(resource, uri);
             if (res > 0) {
@@ -425,16 +946,133 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
                 }
 
                 *resource_ptr = resource;
-                *listener_ptr = listener;
                 return GCOAP_RESOURCE_FOUND;
             }
         }
         listener = listener->next;
     }
 
+    if (found) {
+        /* hit in a listener not sorted alphabetically */
+        *resource_ptr = found;
+        return GCOAP_RESOURCE_FOUND;
+    }
     return ret;
 }
 
+#if GCOAP_RESOURCE_INDEX_SIZE
+/*
+ * Adds the resources of a listener to the dispatch index, initializing the
+ * index with the default listener first if necessary. Expects
+ * _coap_state.lock held.
+ */
+static void _index_listener(gcoap_listener_t *listener)
+{
+    coap_resource_index_t *idx = &_coap_state.resource_index;
+
+    if (idx->slots == NULL) {
+        coap_resource_index_init(idx, _coap_state.resource_slots,
+                                 GCOAP_RESOURCE_INDEX_SIZE);
+        if (listener != &_default_listener) {
+            _index_listener(&_default_listener);
+        }
+    }
+    for (size_t i = 0; i < listener->resources_len; i++) {
+        if (coap_resource_index_add(idx, &listener->resources[i]) == -ENOSPC) {
+            DEBUG("gcoap: resource index full, using linear search for %s\n",
+                  listener->resources[i].path);
+        }
+    }
+}
+#endif
+
+/* Returns the header of the request PDU kept by a request memo. */
+static coap_hdr_t *_memo_hdr(const gcoap_request_memo_t *memo)
+{
+    if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
+        return (coap_hdr_t *)&memo->msg.hdr_buf[0];
+    }
+    else {
+        return (coap_hdr_t *)memo->msg.data.pdu_buf;
+    }
+}
+
+/* Returns the memo index bucket for a token. */
+static unsigned _token_bucket(const uint8_t *token, unsigned token_len)
+{
+    return djb2_hash(token, token_len) & (GCOAP_MEMO_INDEX_BUCKETS - 1);
+}
+
+/* Returns the memo index bucket for an observed resource. */
+static unsigned _resource_bucket(const coap_resource_t *resource)
+{
+    return djb2_hash((const uint8_t *)&resource, sizeof(resource))
+           & (GCOAP_MEMO_INDEX_BUCKETS - 1);
+}
+
+/*
+ * Adds a request memo to the token index. Expects _coap_state.lock held and
+ * the request PDU already copied to the memo.
+ */
+void _gcoap_req_memo_link(gcoap_request_memo_t *memo)
+{
+    coap_pkt_t memo_pdu;
+    memo_pdu.hdr = _memo_hdr(memo);
+
+    gcoap_request_memo_t **bucket = &_coap_state.req_index[
+        _token_bucket(coap_hdr_data_ptr(memo_pdu.hdr),
+                      coap_get_token_len(&memo_pdu))];
+    memo->next = *bucket;
+    *bucket = memo;
+    _coap_state.open_reqs_numof++;
+}
+
+/*
+ * Removes a request memo from the token index. Does nothing if the memo is
+ * not indexed, so it is safe to call from both the response and the timeout
+ * path.
+ */
+void _gcoap_req_memo_unlink(gcoap_request_memo_t *memo)
+{
+    coap_pkt_t memo_pdu;
+    memo_pdu.hdr = _memo_hdr(memo);
+
+    mutex_lock(&_coap_state.lock);
+    for (gcoap_request_memo_t **ptr = &_coap_state.req_index[
+             _token_bucket(coap_hdr_data_ptr(memo_pdu.hdr),
+                           coap_get_token_len(&memo_pdu))];
+         *ptr != NULL; ptr = &(*ptr)->next) {
+        if (*ptr == memo) {
+            *ptr = memo->next;
+            _coap_state.open_reqs_numof--;
+            break;
+        }
+    }
+    mutex_unlock(&_coap_state.lock);
+}
+
+/* Adds an Observe memo to the resource index. */
+void _gcoap_obs_memo_link(gcoap_observe_memo_t *memo)
+{
+    gcoap_observe_memo_t **bucket =
+        &_coap_state.obs_index[_resource_bucket(memo->resource)];
+    memo->next = *bucket;
+    *bucket = memo;
+}
+
+/* Removes an Observe memo from the resource index, if it is indexed. */
+void _gcoap_obs_memo_unlink(gcoap_observe_memo_t *memo)
+{
+    for (gcoap_observe_memo_t **ptr =
+             &_coap_state.obs_index[_resource_bucket(memo->resource)];
+         *ptr != NULL; ptr = &(*ptr)->next) {
+        if (*ptr == memo) {
+            *ptr = memo->next;
+            break;
+        }
+    }
+}
+
 /*
  * Finds the memo for an outstanding request within the _coap_state.open_reqs
  * array. Matches on remote endpoint and token.
@@ -443,8 +1081,8 @@ static int _find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr,
  * src_pdu[in] -- PDU for token to match
  * remote[in] -- Remote endpoint to match
  */
-static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
-                           const sock_udp_ep_t *remote)
+void _gcoap_find_req_memo(gcoap_request_memo_t **memo_ptr,
+                          coap_pkt_t *src_pdu, const sock_udp_ep_t *remote)
 {
     *memo_ptr = NULL;
     /* no need to initialize struct; we only care about buffer contents below */
@@ -452,17 +1090,11 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
     coap_pkt_t *memo_pdu = &memo_pdu_data;
     unsigned cmplen      = coap_get_token_len(src_pdu);
 
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state == GCOAP_MEMO_UNUSED)
-            continue;
-
-        gcoap_request_memo_t *memo = &_coap_state.open_reqs[i];
-        if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-            memo_pdu->hdr = (coap_hdr_t *) &memo->msg.hdr_buf[0];
-        }
-        else {
-            memo_pdu->hdr = (coap_hdr_t *) memo->msg.data.pdu_buf;
-        }
+    mutex_lock(&_coap_state.lock);
+    for (gcoap_request_memo_t *memo = _coap_state.req_index[
+             _token_bucket(src_pdu->token, cmplen)];
+         memo != NULL; memo = memo->next) {
+        memo_pdu->hdr = _memo_hdr(memo);
 
         if (coap_get_token_len(memo_pdu) == cmplen) {
             memo_pdu->token = coap_hdr_data_ptr(memo_pdu->hdr);
@@ -473,6 +1105,7 @@ static void _find_req_memo(gcoap_request_memo_t **memo_ptr, coap_pkt_t *src_pdu,
             }
         }
     }
+    mutex_unlock(&_coap_state.lock);
 }
 
 /* Calls handler callback on receipt of a timeout message. */
@@ -480,16 +1113,12 @@ static void _expire_request(gcoap_request_memo_t *memo)
 {
     DEBUG("coap: received timeout message\n");
     if (memo->state == GCOAP_MEMO_WAIT) {
+        _gcoap_req_memo_unlink(memo);
         memo->state = GCOAP_MEMO_TIMEOUT;
         /* Pass response to handler */
         if (memo->resp_handler) {
             coap_pkt_t req;
-            if (memo->send_limit == GCOAP_SEND_LIMIT_NON) {
-                req.hdr = (coap_hdr_t *)&memo->msg.hdr_buf[0];   /* for reference */
-            }
-            else {
-                req.hdr = (coap_hdr_t *)memo->msg.data.pdu_buf;
-            }
+            req.hdr = _memo_hdr(memo);  /* for reference */
             memo->resp_handler(memo, &req, NULL);
         }
         if (memo->send_limit != GCOAP_SEND_LIMIT_NON) {
@@ -598,14 +1227,14 @@ static int _find_obs_memo(gcoap_observe_memo_t **memo, sock_udp_ep_t *remote,
  * memo[out] -- Registered observe memo, or NULL if not found
  * resource[in] -- Resource to match
  */
-static void _find_obs_memo_resource(gcoap_observe_memo_t **memo,
+void _gcoap_find_obs_memo_resource(gcoap_observe_memo_t **memo,
                                    const coap_resource_t *resource)
 {
     *memo = NULL;
-    for (int i = 0; i < GCOAP_OBS_REGISTRATIONS_MAX; i++) {
-        if (_coap_state.observe_memos[i].observer != NULL
-                && _coap_state.observe_memos[i].resource == resource) {
-            *memo = &_coap_state.observe_memos[i];
+    for (gcoap_observe_memo_t *ptr = _coap_state.obs_index[_resource_bucket(resource)];
+         ptr != NULL; ptr = ptr->next) {
+        if (ptr->resource == resource) {
+            *memo = ptr;
             break;
         }
     }
@@ -629,6 +1258,9 @@ kernel_pid_t gcoap_init(void)
     memset(&_coap_state.observers[0], 0, sizeof(_coap_state.observers));
     memset(&_coap_state.observe_memos[0], 0, sizeof(_coap_state.observe_memos));
     memset(&_coap_state.resend_bufs[0], 0, sizeof(_coap_state.resend_bufs));
+    memset(&_coap_state.req_index[0], 0, sizeof(_coap_state.req_index));
+    memset(&_coap_state.obs_index[0], 0, sizeof(_coap_state.obs_index));
+    _coap_state.open_reqs_numof = 0;
     /* randomize initial value */
     atomic_init(&_coap_state.next_message_id, (unsigned)random_uint32());
 
@@ -648,6 +1280,13 @@ void gcoap_register_listener(gcoap_listener_t *listener)
         listener->link_encoder = gcoap_encode_link;
     }
     _last->next = listener;
+#if GCOAP_RESOURCE_INDEX_SIZE
+    mutex_lock(&_coap_state.lock);
+    _index_listener(listener);
+    mutex_unlock(&_coap_state.lock);
+#endif
+    /* resource list of /.well-known/core changed */
+    gcoap_resp_cache_invalidate(NULL);
 }
 
 int gcoap_req_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
@@ -789,6 +1428,9 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
             DEBUG("gcoap: illegal msg type %u\n", msg_type);
             break;
         }
+        if (memo->state != GCOAP_MEMO_UNUSED) {
+            _gcoap_req_memo_link(memo);
+        }
         mutex_unlock(&_coap_state.lock);
         if (memo->state == GCOAP_MEMO_UNUSED) {
             return 0;
@@ -824,6 +1466,7 @@ size_t gcoap_req_send(const uint8_t *buf, size_t len,
     }
     if (res <= 0) {
         if (memo != NULL) {
+            _gcoap_req_memo_unlink(memo);
             if (msg_type == COAP_TYPE_CON) {
                 *memo->msg.data.pdu_buf = 0;    /* clear resend buffer */
             }
@@ -862,7 +1505,7 @@ int gcoap_obs_init(coap_pkt_t *pdu, uint8_t *buf, size_t len,
 {
     gcoap_observe_memo_t *memo = NULL;
 
-    _find_obs_memo_resource(&memo, resource);
+    _gcoap_find_obs_memo_resource(&memo, resource);
     if (memo == NULL) {
         /* Unique return value to specify there is not an observer */
         return GCOAP_OBS_INIT_UNUSED;
@@ -893,7 +1536,10 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
 {
     gcoap_observe_memo_t *memo = NULL;
 
-    _find_obs_memo_resource(&memo, resource);
+    /* a notification implies the resource representation changed */
+    gcoap_resp_cache_invalidate(resource);
+
+    _gcoap_find_obs_memo_resource(&memo, resource);
 
     if (memo) {
         ssize_t bytes = sock_udp_send(&_sock, buf, len, memo->observer);
@@ -904,15 +1550,27 @@ size_t gcoap_obs_send(const uint8_t *buf, size_t len,
     }
 }
 
-uint8_t gcoap_op_state(void)
+void gcoap_resp_cache_invalidate(const coap_resource_t *resource)
 {
-    uint8_t count = 0;
-    for (int i = 0; i < GCOAP_REQ_WAITING_MAX; i++) {
-        if (_coap_state.open_reqs[i].state != GCOAP_MEMO_UNUSED) {
-            count++;
+#if GCOAP_RESP_CACHE_SIZE
+    mutex_lock(&_coap_state.lock);
+    for (unsigned i = 0; i < GCOAP_RESP_CACHE_SIZE; i++) {
+        gcoap_cache_entry_t *entry = &_coap_state.resp_cache[i];
+        if ((resource == NULL) || (entry->resource == resource)) {
+            entry->resource = NULL;
         }
     }
-    return count;
+    mutex_unlock(&_coap_state.lock);
+#else
+    (void)resource;
+#endif
+}
+
+uint8_t gcoap_op_state(void)
+{
+    /* open requests are kept in the token index from send until the
+     * response or timeout is processed */
+    return (uint8_t)_coap_state.open_reqs_numof;
 }
 
 int gcoap_get_resource_list(void *buf, size_t maxlen, uint8_t cf)
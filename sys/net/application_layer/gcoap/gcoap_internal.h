@@ -0,0 +1,160 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  net_gcoap
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       Internal functions of gcoap, exposed for unit tests
+ */
+#ifndef GCOAP_INTERNAL_H
+#define GCOAP_INTERNAL_H
+
+#include "net/gcoap.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @name    Return values of _gcoap_find_resource()
+ * @{
+ */
+#define GCOAP_RESOURCE_FOUND        (0)
+#define GCOAP_RESOURCE_WRONG_METHOD (-1)
+#define GCOAP_RESOURCE_NO_PATH      (-2)
+/** @} */
+
+/**
+ * @brief   Searches listener registrations for the resource matching the
+ *          path and method of a request
+ *
+ * @param[in] pdu           The request
+ * @param[out] resource_ptr The resource found
+ *
+ * @return  GCOAP_RESOURCE_FOUND if the resource was found
+ * @return  GCOAP_RESOURCE_WRONG_METHOD if only resources for other methods
+ *          match the path
+ * @return  GCOAP_RESOURCE_NO_PATH if no resource matches the path
+ */
+int _gcoap_find_resource(coap_pkt_t *pdu, const coap_resource_t **resource_ptr);
+
+/**
+ * @brief   Generates the response to a request, from the response cache or
+ *          by the resource handler
+ *
+ * @param[in,out] pdu   The request, overwritten by the response
+ * @param[out] buf      Buffer for the response, holding the request
+ * @param[in] len       Length of @p buf
+ * @param[in] remote    Requesting endpoint
+ *
+ * @return  Length of the response
+ */
+size_t _gcoap_handle_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         sock_udp_ep_t *remote);
+
+/**
+ * @brief   Adds a request memo to the token index
+ *
+ * Expects the gcoap state lock held and the request PDU already copied to
+ * @p memo.
+ *
+ * @param[in] memo  The memo to add
+ */
+void _gcoap_req_memo_link(gcoap_request_memo_t *memo);
+
+/**
+ * @brief   Removes a request memo from the token index
+ *
+ * Does nothing if @p memo is not indexed.
+ *
+ * @param[in] memo  The memo to remove
+ */
+void _gcoap_req_memo_unlink(gcoap_request_memo_t *memo);
+
+/**
+ * @brief   Finds the indexed request memo for the token of a response
+ *
+ * @param[out] memo_ptr The memo found, NULL if not found
+ * @param[in] src_pdu   PDU with the token to match
+ * @param[in] remote    Remote endpoint to match
+ */
+void _gcoap_find_req_memo(gcoap_request_memo_t **memo_ptr,
+                          coap_pkt_t *src_pdu, const sock_udp_ep_t *remote);
+
+/**
+ * @brief   Adds an Observe memo to the resource index
+ *
+ * @param[in] memo  The memo to add
+ */
+void _gcoap_obs_memo_link(gcoap_observe_memo_t *memo);
+
+/**
+ * @brief   Removes an Observe memo from the resource index
+ *
+ * Does nothing if @p memo is not indexed.
+ *
+ * @param[in] memo  The memo to remove
+ */
+void _gcoap_obs_memo_unlink(gcoap_observe_memo_t *memo);
+
+/**
+ * @brief   Finds the indexed Observe memo for a resource
+ *
+ * @param[out] memo     The memo found, NULL if not found
+ * @param[in] resource  Resource to match
+ */
+void _gcoap_find_obs_memo_resource(gcoap_observe_memo_t **memo,
+                                   const coap_resource_t *resource);
+
+#if GCOAP_QBLOCK_BURST || defined(DOXYGEN)
+/**
+ * @brief   Collects the block numbers requested by the Q-Block2 options of
+ *          a request
+ *
+ * A NON request with the M bit set in its first Q-Block2 option asks for a
+ * burst of up to @ref GCOAP_QBLOCK_BURST blocks.
+ *
+ * @param[in] req   The request
+ * @param[out] nums Block numbers, with room for @ref GCOAP_QBLOCK_BURST
+ * @param[out] szx  Requested block size exponent
+ *
+ * @return  Number of blocks requested
+ */
+unsigned _gcoap_qblock2_nums(coap_pkt_t *req, uint32_t *nums, unsigned *szx);
+
+/**
+ * @brief   Builds the response for one block requested with Q-Block2
+ *
+ * Every response after the first (@p idx > 0) is a NON message with a new
+ * message ID.
+ *
+ * @param[in] req       The request, not in the gcoap listen buffer
+ * @param[in] idx       Index of the block among the requested ones
+ * @param[in] num       Block number
+ * @param[in] szx       Block size exponent
+ * @param[in] remote    Requesting endpoint
+ * @param[out] out      The response, in a gcoap internal buffer
+ * @param[out] last     True if no further blocks are to be sent
+ *
+ * @return  Length of the response
+ * @return  -1 if no response is to be sent
+ */
+ssize_t _gcoap_qblock2_resp(coap_pkt_t *req, unsigned idx, uint32_t num,
+                            unsigned szx, sock_udp_ep_t *remote,
+                            uint8_t **out, bool *last);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GCOAP_INTERNAL_H */
+/** @} */
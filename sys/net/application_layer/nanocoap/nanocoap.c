@@ -27,6 +27,7 @@
 #include <string.h>
 
 #include "bitarithm.h"
+#include "hashes.h"
 #include "net/nanocoap.h"
 
 #define ENABLE_DEBUG (0)
@@ -46,6 +47,11 @@ int coap_get_option_uint(coap_pkt_t *pkt, unsigned opt_num, uint32_t *target);
 static uint32_t _decode_uint(uint8_t *pkt_pos, unsigned nbytes);
 static size_t _encode_uint(uint32_t *val);
 
+#if NANOCOAP_RESOURCE_INDEX_SIZE
+static const coap_resource_t *_resource_slots[NANOCOAP_RESOURCE_INDEX_SIZE];
+static coap_resource_index_t _resource_index;
+#endif
+
 /* http://tools.ietf.org/html/rfc7252#section-3
  *  0                   1                   2                   3
  *  0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
@@ -163,6 +169,68 @@ int coap_match_path(const coap_resource_t *resource, uint8_t *uri)
     return res;
 }
 
+static unsigned _index_slot(const coap_resource_index_t *idx, const char *path)
+{
+    return djb2_hash((const uint8_t *)path, strlen(path)) & (idx->size - 1);
+}
+
+void coap_resource_index_init(coap_resource_index_t *idx,
+                              const coap_resource_t **slots, unsigned size)
+{
+    /* size must be a power of two to mask the hash */
+    assert(idx && slots && (size > 1) && !(size & (size - 1)));
+    memset(slots, 0, size * sizeof(*slots));
+    idx->slots = slots;
+    idx->size = size;
+    idx->numof = 0;
+    idx->unindexed = 0;
+}
+
+int coap_resource_index_add(coap_resource_index_t *idx,
+                            const coap_resource_t *resource)
+{
+    assert(idx && idx->slots && resource);
+    if (resource->methods & COAP_MATCH_SUBTREE) {
+        idx->unindexed++;
+        return -ENOTSUP;
+    }
+    /* keep at least one slot empty so every probe sequence terminates */
+    if (idx->numof >= (idx->size - 1)) {
+        idx->unindexed++;
+        return -ENOSPC;
+    }
+    unsigned i = _index_slot(idx, resource->path);
+    while (idx->slots[i] != NULL) {
+        i = (i + 1) & (idx->size - 1);
+    }
+    idx->slots[i] = resource;
+    idx->numof++;
+    return 0;
+}
+
+int coap_resource_index_find(const coap_resource_index_t *idx,
+                             const uint8_t *uri, coap_method_flags_t method_flag,
+                             const coap_resource_t **resource)
+{
+    assert(idx && idx->slots && uri && resource);
+    int res = -ENOENT;
+
+    for (unsigned i = _index_slot(idx, (const char *)uri);
+         idx->slots[i] != NULL; i = (i + 1) & (idx->size - 1)) {
+        const coap_resource_t *candidate = idx->slots[i];
+
+        if (strcmp((const char *)uri, candidate->path) != 0) {
+            continue;
+        }
+        if (candidate->methods & method_flag) {
+            *resource = candidate;
+            return 0;
+        }
+        res = -EPERM;
+    }
+    return res;
+}
+
 uint8_t *coap_find_option(const coap_pkt_t *pkt, unsigned opt_num)
 {
     const coap_optpos_t *optpos = pkt->options;
@@ -393,8 +461,34 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
     }
     DEBUG("nanocoap: URI path: \"%s\"\n", uri);
 
+    const coap_resource_t *found = NULL;
+#if NANOCOAP_RESOURCE_INDEX_SIZE
+    if (_resource_index.slots == NULL) {
+        /* build index on first request, coap_resources is constant */
+        coap_resource_index_init(&_resource_index, _resource_slots,
+                                 NANOCOAP_RESOURCE_INDEX_SIZE);
+        for (unsigned i = 0; i < coap_resources_numof; i++) {
+            coap_resource_index_add(&_resource_index, &coap_resources[i]);
+        }
+    }
+    if (coap_resource_index_find(&_resource_index, uri, method_flag,
+                                 &found) != 0) {
+        found = NULL;
+    }
+    if (_resource_index.unindexed == 0) {
+        if (found) {
+            return found->handler(pkt, resp_buf, resp_buf_len, found->context);
+        }
+        return coap_build_reply(pkt, COAP_CODE_404, resp_buf, resp_buf_len, 0);
+    }
+#endif
+
+    /* an unindexed resource before the indexed hit takes precedence */
     for (unsigned i = 0; i < coap_resources_numof; i++) {
         const coap_resource_t *resource = &coap_resources[i];
+        if (resource == found) {
+            return found->handler(pkt, resp_buf, resp_buf_len, found->context);
+        }
         if (!(resource->methods & method_flag)) {
             continue;
         }
@@ -411,6 +505,10 @@ ssize_t coap_handle_req(coap_pkt_t *pkt, uint8_t *resp_buf, unsigned resp_buf_le
         }
     }
 
+    if (found) {
+        /* hit in a resource list not sorted alphabetically */
+        return found->handler(pkt, resp_buf, resp_buf_len, found->context);
+    }
     return coap_build_reply(pkt, COAP_CODE_404, resp_buf, resp_buf_len, 0);
 }
 
@@ -28,6 +28,8 @@
 #include "net/gnrc/ipv6.h"
 #include "random.h"
 
+#include "gnrc_tftp_internal.h"
+
 #define ENABLE_DEBUG                (0)
 #include "debug.h"
 
@@ -57,6 +59,8 @@ static kernel_pid_t _tftp_kernel_pid;
 #define TFTP_TIMEOUT_MSG            0x4000
 #define TFTP_STOP_SERVER_MSG        0x4001
 #define TFTP_MIN_PACKET_LEN         4
+#define TFTP_DEFAULT_BLOCK_SIZE     (512U)  /* see RFC 1350 */
+#define TFTP_MIN_BLOCK_SIZE         (8U)    /* see RFC 2348 */
 #define TFTP_DEFAULT_DATA_SIZE      (GNRC_TFTP_MAX_TRANSFER_UNIT    \
                                      + sizeof(tftp_packet_data_t))
 
@@ -118,6 +122,7 @@ typedef enum {
     TOPT_BLKSIZE,
     TOPT_TIMEOUT,
     TOPT_TSIZE,
+    TOPT_WINDOWSIZE,
 } tftp_options_t;
 
 /* ordered as @see tftp_options_t */
@@ -125,19 +130,9 @@ tftp_opt_t _tftp_options[] = {
     [TOPT_BLKSIZE] = MODE(blksize),
     [TOPT_TIMEOUT] = MODE(timeout),
     [TOPT_TSIZE]   = MODE(tsize),
+    [TOPT_WINDOWSIZE] = MODE(windowsize),
 };
 
-/**
- * @brief The TFTP state
- */
-typedef enum {
-    TS_APP_FAILED  = -3,
-    TS_DUP         = -2,
-    TS_FAILED      = -1,
-    TS_BUSY        = 0,
-    TS_FINISHED    = 1
-} tftp_state;
-
 /**
  * @brief The type of the context used
  */
@@ -168,6 +163,8 @@ typedef struct {
     /* transfer parameters */
     uint16_t block_nr;
     uint16_t block_size;
+    uint16_t ack_nr;            /* last block acknowledged by the receiver */
+    tftp_window_t window;
     size_t transfer_size;
     uint32_t block_timeout;
     uint32_t retries;
@@ -232,6 +229,9 @@ static tftp_state _tftp_send_start(tftp_context_t *ctxt, gnrc_pktsnip_t *buf);
 /* send data or and ack depending if we are reading or writing */
 static tftp_state _tftp_send_dack(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_opcodes_t op);
 
+/* send the window of data blocks following the last acknowledged block */
+static tftp_state _tftp_send_window(tftp_context_t *ctxt, gnrc_pktsnip_t *buf);
+
 /* send and TFTP error to the client */
 static tftp_state _tftp_send_error(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_err_codes_t err, const char *err_msg);
 
@@ -256,16 +256,25 @@ static int _tftp_decode_error(uint8_t *buf, tftp_err_codes_t *err, const char *
 /* TFTP super loop server */
 static int _tftp_server(tftp_context_t *ctxt);
 
+/* check if we are the side of the transfer sending the data blocks */
+static inline bool _tftp_is_sender(tftp_context_t *ctxt)
+{
+    return (ctxt->ct == CT_CLIENT) ? (ctxt->op == TO_WRQ) : (ctxt->op == TO_RRQ);
+}
+
 /* get the maximum allowed transfer unit to avoid 6Lo fragmentation */
 static uint16_t _tftp_get_maximum_block_size(void)
 {
+    const size_t hdr_len = sizeof(ipv6_hdr_t) + sizeof(udp_hdr_t) +
+                           sizeof(tftp_packet_data_t);
     uint16_t tmp;
     gnrc_netif_t *netif = gnrc_netif_iter(NULL);
 
     if ((netif != NULL) && gnrc_netapi_get(netif->pid, NETOPT_MAX_PDU_SIZE,
-                                           0, &tmp, sizeof(uint16_t)) >= 0) {
-        /* TODO calculate proper block size */
-        return tmp - sizeof(udp_hdr_t) - sizeof(ipv6_hdr_t) - 10;
+                                           0, &tmp, sizeof(uint16_t)) >= 0 &&
+        (tmp > hdr_len)) {
+        /* a DATA packet must fit into the link MTU */
+        return MIN(tmp - hdr_len, GNRC_TFTP_MAX_TRANSFER_UNIT);
     }
     return GNRC_TFTP_MAX_TRANSFER_UNIT;
 }
@@ -366,7 +375,8 @@ int _tftp_init_ctxt(ipv6_addr_t *addr, const char *file_name,
     ctxt->enable_options = enable_options;
 
     /* transport layer parameters */
-    ctxt->block_size = GNRC_TFTP_MAX_TRANSFER_UNIT;
+    ctxt->block_size = TFTP_DEFAULT_BLOCK_SIZE;
+    ctxt->window.size = 1;
     ctxt->block_timeout = GNRC_TFTP_DEFAULT_TIMEOUT;
     ctxt->write_finished = false;
 
@@ -380,7 +390,8 @@ int _tftp_init_ctxt(ipv6_addr_t *addr, const char *file_name,
 
 void _tftp_set_default_options(tftp_context_t *ctxt)
 {
-    ctxt->block_size = GNRC_TFTP_MAX_TRANSFER_UNIT;
+    ctxt->block_size = TFTP_DEFAULT_BLOCK_SIZE;
+    ctxt->window.size = 1;
     ctxt->timeout = GNRC_TFTP_DEFAULT_TIMEOUT;
     ctxt->block_timeout = GNRC_TFTP_DEFAULT_TIMEOUT;
     ctxt->transfer_size = 0;
@@ -394,6 +405,7 @@ int _tftp_set_opts(tftp_context_t *ctxt, size_t blksize, uint32_t timeout, size_
     }
 
     ctxt->block_size = blksize;
+    ctxt->window.size = GNRC_TFTP_MAX_WINDOW_SIZE;
     ctxt->timeout = timeout;
     ctxt->block_timeout = timeout;
     ctxt->transfer_size = total_size;
@@ -593,11 +605,15 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             /* we are still negotiating resent, start */
             return _tftp_send_start(ctxt, outbuf);
         }
+        else if (_tftp_is_sender(ctxt)) {
+            DEBUG("tftp: window not acknowledged, resending\n");
+            /* resend all blocks following the last ACK */
+            return _tftp_send_window(ctxt, outbuf);
+        }
         else {
-            DEBUG("tftp: last data or ack packet lost, resending\n");
-            /* we are sending / receiving data */
-            /* if we are reading resent the ACK, if writing the DATA */
-            return _tftp_send_dack(ctxt, outbuf, (ctxt->op == TO_RRQ) ? TO_ACK : TO_DATA);
+            DEBUG("tftp: last ack packet lost, resending\n");
+            _tftp_window_timeout(&ctxt->window);
+            return _tftp_send_dack(ctxt, outbuf, TO_ACK);
         }
     }
     else if (m->type != GNRC_NETAPI_MSG_TYPE_RCV) {
@@ -716,14 +732,24 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
                 DEBUG("tftp: duplicated data received, acking...\n");
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
                 DEBUG("tftp: client's port is %" PRIu16 "\n", ctxt->dst_port);
-                _tftp_send_dack(ctxt, outbuf, TO_ACK);
+            }
+
+            if ((proc == TS_DUP) || (proc == TS_GAP)) {
+                /* acknowledge the last block received in order, so the
+                 * sender restarts the window from there */
+                if (_tftp_window_recv(&ctxt->window, proc, false)) {
+                    DEBUG("tftp: acking last block in order\n");
+                    _tftp_send_dack(ctxt, outbuf, TO_ACK);
+                }
+                else {
+                    gnrc_pktbuf_release(outbuf);
+                }
                 return TS_BUSY;
             }
 
-            /* check if this is the first block */
+            /* check if this is the first block and no OACK was received */
             if (!ctxt->block_nr
-                && ctxt->dst_port == GNRC_TFTP_DEFAULT_DST_PORT
-                && !ctxt->use_options) {
+                && ctxt->dst_port == GNRC_TFTP_DEFAULT_DST_PORT) {
                 /* no OACK received, restore default TFTP parameters */
                 _tftp_set_default_options(ctxt);
                 DEBUG("tftp: restore default TFTP parameters\n");
@@ -732,10 +758,18 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
             }
 
-            /* wait for the next data block */
-            DEBUG("tftp: wait for the next data block\n");
             ++(ctxt->block_nr);
-            _tftp_send_dack(ctxt, outbuf, TO_ACK);
+
+            /* acknowledge the window once it is complete or on the last block */
+            if (_tftp_window_recv(&ctxt->window, TS_BUSY,
+                                  proc < (int)ctxt->block_size)) {
+                DEBUG("tftp: wait for the next window\n");
+                _tftp_send_dack(ctxt, outbuf, TO_ACK);
+            }
+            else {
+                DEBUG("tftp: wait for the next data block\n");
+                gnrc_pktbuf_release(outbuf);
+            }
 
             /* check if the data transfer has finished */
             if (proc < (int)ctxt->block_size) {
@@ -760,8 +794,10 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
                 return TS_BUSY;
             }
 
+            uint16_t ack_nr = byteorder_ntohs(((tftp_packet_data_t *)data)->block_nr);
+
             /* check if the write action is finished */
-            if (ctxt->write_finished) {
+            if (ctxt->write_finished && (ack_nr == ctxt->block_nr)) {
                 gnrc_pktbuf_release(outbuf);
 
                 if (ctxt->stop_cb) {
@@ -780,10 +816,11 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
             }
 
-            /* send the next data block */
-            ++(ctxt->block_nr);
+            /* send the next window, the receiver may only have acknowledged
+             * a part of the last one */
+            ctxt->ack_nr = ack_nr;
 
-            return _tftp_send_dack(ctxt, outbuf, TO_DATA);
+            return _tftp_send_window(ctxt, outbuf);
         } break;
 
         case TO_ERROR: {
@@ -808,22 +845,26 @@ tftp_state _tftp_state_processes(tftp_context_t *ctxt, msg_t *m)
             if (ctxt->dst_port != byteorder_ntohs(udp->src_port)) {
                 DEBUG("tftp: TO_OACK received\n");
 
+                /* options missing in the OACK were declined by the server */
+                ctxt->block_size = TFTP_DEFAULT_BLOCK_SIZE;
+                ctxt->window.size = 1;
+
                 /* decode the options */
                 _tftp_decode_options(ctxt, pkt, 0);
 
                 /* take the new source port */
                 ctxt->dst_port = byteorder_ntohs(udp->src_port);
-
-                /* we must send block one to finish the negotiation in send mode */
-                if (ctxt->op == TO_WRQ) {
-                    ++(ctxt->block_nr);
-                }
             }
             else {
                 DEBUG("tftp: dropping double TO_OACK\n");
             }
 
-            return _tftp_send_dack(ctxt, outbuf, (ctxt->op == TO_WRQ) ? TO_DATA : TO_ACK);
+            /* we must send the first window to finish the negotiation in
+             * send mode */
+            if (ctxt->op == TO_WRQ) {
+                return _tftp_send_window(ctxt, outbuf);
+            }
+            return _tftp_send_dack(ctxt, outbuf, TO_ACK);
         } break;
     }
 
@@ -852,6 +893,11 @@ uint32_t _tftp_append_options(tftp_context_t *ctxt, tftp_header_t *hdr, uint32_t
     offset += _tftp_add_option(hdr->data + offset, _tftp_options + TOPT_BLKSIZE, ctxt->block_size);
     offset += _tftp_add_option(hdr->data + offset, _tftp_options + TOPT_TIMEOUT, (ctxt->timeout / US_PER_SEC));
 
+    /* lock-step transfers don't need the window size option */
+    if (ctxt->window.size > 1) {
+        offset += _tftp_add_option(hdr->data + offset, _tftp_options + TOPT_WINDOWSIZE, ctxt->window.size);
+    }
+
     /**
      * Only set the transfer option if we are sending.
      * Or when we are reading in bin mode.
@@ -926,6 +972,38 @@ tftp_state _tftp_send_dack(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_opcod
     return _tftp_send(buf, ctxt, sizeof(tftp_packet_data_t) + len);
 }
 
+tftp_state _tftp_send_window(tftp_context_t *ctxt, gnrc_pktsnip_t *buf)
+{
+    tftp_state ret = TS_BUSY;
+
+    /* (re)start the window after the last acknowledged block */
+    ctxt->block_nr = ctxt->ack_nr;
+    ctxt->write_finished = false;
+
+    for (unsigned i = 0; i < ctxt->window.size; i++) {
+        if (buf == NULL) {
+            buf = gnrc_pktbuf_add(NULL, NULL, TFTP_DEFAULT_DATA_SIZE,
+                                  GNRC_NETTYPE_UNDEF);
+            if (buf == NULL) {
+                /* the blocks not sent are sent again on timeout */
+                DEBUG("tftp: packet buffer full, window truncated\n");
+                break;
+            }
+        }
+
+        ++(ctxt->block_nr);
+        ret = _tftp_send_dack(ctxt, buf, TO_DATA);
+        buf = NULL;
+
+        /* stop after the last block of the transfer */
+        if ((ret != TS_BUSY) || ctxt->write_finished) {
+            break;
+        }
+    }
+
+    return ret;
+}
+
 tftp_state _tftp_send_error(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, tftp_err_codes_t err, const char *err_msg)
 {
     int strl = err_msg ? strlen(err_msg) + 1 : 0;
@@ -1051,7 +1129,61 @@ bool _tftp_validate_ack(tftp_context_t *ctxt, uint8_t *buf)
 {
     tftp_packet_data_t *pkt = (tftp_packet_data_t *) buf;
 
-    return ctxt->block_nr == byteorder_ntohs(pkt->block_nr);
+    return _tftp_window_ack_valid(ctxt->ack_nr, ctxt->block_nr,
+                                  byteorder_ntohs(pkt->block_nr));
+}
+
+bool _tftp_window_ack_valid(uint16_t ack_nr, uint16_t block_nr, uint16_t ack)
+{
+    uint16_t acked = ack - ack_nr;
+    uint16_t in_flight = block_nr - ack_nr;
+
+    /* accept ACKs for any block of the current window, but drop duplicated
+     * ACKs of the previous window (see RFC 7440) */
+    return (acked <= in_flight) && ((acked > 0) || (in_flight == 0));
+}
+
+tftp_state _tftp_data_order(uint16_t block_nr, uint16_t recv_nr)
+{
+    int16_t diff = (int16_t)(uint16_t)(recv_nr - (uint16_t)(block_nr + 1));
+
+    if (diff > 0) {
+        return TS_GAP;
+    }
+    if (diff < 0) {
+        return TS_DUP;
+    }
+    return TS_BUSY;
+}
+
+bool _tftp_window_recv(tftp_window_t *win, tftp_state order, bool last)
+{
+    switch (order) {
+        case TS_DUP:
+            /* the sender restarts its window after this ACK */
+            win->recv = 0;
+            return true;
+        case TS_GAP:
+            /* a block of the window got lost, acknowledge it only once */
+            if (win->gap_acked) {
+                return false;
+            }
+            win->gap_acked = true;
+            win->recv = 0;
+            return true;
+        default:
+            win->gap_acked = false;
+            if (last || (++(win->recv) >= win->size)) {
+                win->recv = 0;
+                return true;
+            }
+            return false;
+    }
+}
+
+void _tftp_window_timeout(tftp_window_t *win)
+{
+    win->recv = 0;
 }
 
 int _tftp_decode_start(tftp_context_t *ctxt, gnrc_pktsnip_t *inpkt, gnrc_pktsnip_t *outbuf)
@@ -1113,10 +1245,25 @@ int _tftp_decode_options(tftp_context_t *ctxt, gnrc_pktsnip_t *buf, uint32_t sta
             if (memcmp(name, _tftp_options[idx].name, _tftp_options[idx].len) == 0) {
                 /* set the option value of the known options */
                 switch (idx) {
-                    case TOPT_BLKSIZE:
-                        ctxt->block_size = atoi(value);
+                    case TOPT_BLKSIZE: {
+                        int blksize = atoi(value);
+                        int max = _tftp_get_maximum_block_size();
+
+                        /* never use blocks exceeding our buffers or the link MTU */
+                        if (blksize >= (int)TFTP_MIN_BLOCK_SIZE) {
+                            ctxt->block_size = MIN(blksize, max);
+                        }
                         DEBUG("tftp: got option TOPT_BLKSIZE = %" PRIu16 "\n", ctxt->block_size);
-                        break;
+                    } break;
+
+                    case TOPT_WINDOWSIZE: {
+                        int windowsize = atoi(value);
+
+                        if (windowsize > 0) {
+                            ctxt->window.size = MIN(windowsize, GNRC_TFTP_MAX_WINDOW_SIZE);
+                        }
+                        DEBUG("tftp: got option TOPT_WINDOWSIZE = %" PRIu16 "\n", ctxt->window.size);
+                    } break;
 
                     case TOPT_TSIZE:
                         ctxt->transfer_size = atoi(value);
@@ -1149,17 +1296,13 @@ int _tftp_process_data(tftp_context_t *ctxt, gnrc_pktsnip_t *buf)
     DEBUG("tftp: processing data\n");
 
     uint16_t block_nr = byteorder_ntohs(pkt->block_nr);
+    tftp_state order = _tftp_data_order(ctxt->block_nr, block_nr);
 
     /* check if this is the packet we are waiting for */
-    if (block_nr > (ctxt->block_nr + 1)) {
-        DEBUG("tftp: incorrect block_nr %d received from server, expected %d\n",
-               block_nr, (ctxt->block_nr + 1));
-        return TS_FAILED;
-    }
-    if (block_nr < (ctxt->block_nr + 1)) {
+    if (order != TS_BUSY) {
         DEBUG("tftp: not the packet we were waiting for, expected %d, received %d\n",
               (uint16_t)(ctxt->block_nr + 1), block_nr);
-        return TS_DUP;
+        return order;
     }
 
     /* send the user data trough to the user application */
@@ -0,0 +1,109 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  net_gnrc_tftp
+ * @internal
+ * @{
+ *
+ * @file
+ * @brief       Internal window handling of gnrc_tftp, exposed for unit tests
+ */
+#ifndef GNRC_TFTP_INTERNAL_H
+#define GNRC_TFTP_INTERNAL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief The TFTP state
+ */
+typedef enum {
+    TS_GAP         = -4,
+    TS_APP_FAILED  = -3,
+    TS_DUP         = -2,
+    TS_FAILED      = -1,
+    TS_BUSY        = 0,
+    TS_FINISHED    = 1
+} tftp_state;
+
+/**
+ * @brief The window of a TFTP transfer (see RFC 7440)
+ */
+typedef struct {
+    uint16_t size;              /**< blocks sent before waiting for an ACK */
+    uint16_t recv;              /**< blocks received since the last ACK */
+    bool gap_acked;             /**< ACK for a gap in the window was sent */
+} tftp_window_t;
+
+/**
+ * @brief   Checks if an ACK acknowledges a block of the window in flight
+ *
+ * Duplicated ACKs of the previous window are not valid.
+ *
+ * @param[in] ack_nr    Last block acknowledged by the receiver
+ * @param[in] block_nr  Last block sent
+ * @param[in] ack       Block number of the ACK
+ *
+ * @return  true if the ACK is valid
+ */
+bool _tftp_window_ack_valid(uint16_t ack_nr, uint16_t block_nr, uint16_t ack);
+
+/**
+ * @brief   Orders a received data block relative to the last block received
+ *          in order
+ *
+ * Block numbers are compared in serial number arithmetic, so the order is
+ * kept when they wrap around.
+ *
+ * @param[in] block_nr  Last block received in order
+ * @param[in] recv_nr   Block number of the received data
+ *
+ * @return  TS_BUSY if the block is the next one expected
+ * @return  TS_GAP if blocks before it are missing
+ * @return  TS_DUP if the block was already received
+ */
+tftp_state _tftp_data_order(uint16_t block_nr, uint16_t recv_nr);
+
+/**
+ * @brief   Updates the receive window with a data block and decides whether
+ *          to acknowledge the last block received in order
+ *
+ * A duplicated block is always acknowledged, since the sender restarts its
+ * window after it. A gap is acknowledged only once until the next block is
+ * received in order.
+ *
+ * @param[in,out] win   The receive window
+ * @param[in] order     Order of the block as of _tftp_data_order()
+ * @param[in] last      The block is the last one of the transfer
+ *
+ * @return  true if an ACK is to be sent
+ */
+bool _tftp_window_recv(tftp_window_t *win, tftp_state order, bool last);
+
+/**
+ * @brief   Updates the receive window when the last ACK is sent again after
+ *          a timeout
+ *
+ * The sender restarts its window after the ACK, so the blocks are counted
+ * from there.
+ *
+ * @param[in,out] win   The receive window
+ */
+void _tftp_window_timeout(tftp_window_t *win);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* GNRC_TFTP_INTERNAL_H */
+/** @} */
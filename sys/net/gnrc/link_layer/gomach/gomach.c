@@ -190,6 +190,13 @@ static void _gomach_rtt_handler(uint32_t event, gnrc_netif_t *netif)
                 gnrc_gomach_set_enter_new_cycle(netif, true);
             }
 
+#ifdef MODULE_NETSTATS_TRACE
+            uint32_t late = RTT_TICKS_TO_US(rtt_get_counter() -
+                                            netif->mac.prot.gomach.last_wakeup);
+            NETSTATS_TRACE_ADD(&netif->dev->trace, NETSTATS_TRACE_MAC_WAKEUP,
+                               (late > UINT16_MAX) ? UINT16_MAX : late);
+#endif
+
             netif->mac.prot.gomach.last_wakeup_phase_us = xtimer_now_usec64();
 
             /* Set next cycle's starting time. */
@@ -2074,6 +2081,9 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
             }
             case NETDEV_EVENT_TX_COMPLETE: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_SUCCESS);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_gomach_set_tx_finish(netif, true);
                 gnrc_gomach_set_netdev_state(netif, NETOPT_STATE_IDLE);
                 gnrc_gomach_set_update(netif, true);
@@ -2081,6 +2091,9 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
             }
             case NETDEV_EVENT_TX_NOACK: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_NOACK);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_gomach_set_tx_finish(netif, true);
                 gnrc_gomach_set_netdev_state(netif, NETOPT_STATE_IDLE);
                 gnrc_gomach_set_update(netif, true);
@@ -2088,6 +2101,9 @@ static void _gomach_event_cb(netdev_t *dev, netdev_event_t event)
             }
             case NETDEV_EVENT_TX_MEDIUM_BUSY: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_BUSY);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_gomach_set_tx_finish(netif, true);
                 gnrc_gomach_set_netdev_state(netif, NETOPT_STATE_IDLE);
                 gnrc_gomach_set_update(netif, true);
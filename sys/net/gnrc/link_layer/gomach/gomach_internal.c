@@ -111,7 +111,17 @@ int _gnrc_gomach_transmit(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 #endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+        bool bcast = netif_hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                                         GNRC_NETIF_HDR_FLAGS_MULTICAST);
+
+        res = csma_sender_csma_ca_send_adaptive(dev, &iolist,
+                                                &netif->mac.csma_conf,
+                                                &netif->mac.csma_stats,
+                                                (bcast) ? NULL : dst, dst_len);
+#else
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
+#endif
     }
     else {
         res = dev->driver->send(dev, &iolist);
@@ -303,6 +313,10 @@ void gnrc_gomach_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
                             &devstate,
                             sizeof(devstate));
 
+    if (devstate == NETOPT_STATE_SLEEP) {
+        NETSTATS_TRACE_ADD(&netif->dev->trace, NETSTATS_TRACE_MAC_SLEEP, 0);
+    }
+
 #if (GNRC_GOMACH_ENABLE_DUTYCYLE_RECORD == 1)
     if (devstate == NETOPT_STATE_IDLE) {
         if (!(netif->mac.prot.gomach.gomach_info & GNRC_GOMACH_INTERNAL_INFO_RADIO_IS_ON)) {
@@ -332,6 +346,16 @@ int gnrc_gomach_send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt, netopt_enable_t c
     /* Enable/disable CSMA according to the input. */
     netif->dev->driver->set(netif->dev, NETOPT_CSMA, &csma_enable,
                             sizeof(netopt_enable_t));
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+    /* pass frames sent with CSMA through the adaptive sender, it leaves the
+     * procedure to the device but keeps the statistics */
+    if (csma_enable == NETOPT_ENABLE) {
+        netif->mac.mac_info |= GNRC_NETIF_MAC_INFO_CSMA_ENABLED;
+    }
+    else {
+        netif->mac.mac_info &= ~GNRC_NETIF_MAC_INFO_CSMA_ENABLED;
+    }
+#endif
 
     gnrc_gomach_set_tx_finish(netif, false);
     gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_UNDEF);
@@ -1160,28 +1184,12 @@ bool gnrc_gomach_find_next_tx_neighbor(gnrc_netif_t *netif)
         next = 0;
     }
     else {
-        /* Find the next neighbor to send data packet to. */
-
-        /* Don't always start checking with ID 0, take turns to check every neighbor's queue,
+        /* Find the next neighbor to send data packet to. Don't always start
+         * checking with ID 0, take turns to check every neighbor's queue,
          * thus to be more fair. */
-        uint8_t j = netif->mac.tx.last_tx_neighbor_id + 1;
-
-        if (j >= GNRC_MAC_NEIGHBOR_COUNT) {
-            j = 1;
-        }
-
-        for (uint8_t i = 1; i < GNRC_MAC_NEIGHBOR_COUNT; i++) {
-            if (gnrc_priority_pktqueue_length(&netif->mac.tx.neighbors[j].queue) > 0) {
-                netif->mac.tx.last_tx_neighbor_id = j;
-                next = (int) j;
-                break;
-            }
-            else {
-                j++;
-                if (j >= GNRC_MAC_NEIGHBOR_COUNT) {
-                    j = 1;
-                }
-            }
+        next = gnrc_mac_next_tx_neighbor(&netif->mac.tx, NULL);
+        if (next >= 0) {
+            netif->mac.tx.last_tx_neighbor_id = next;
         }
     }
 
@@ -80,6 +80,16 @@ extern "C" {
  */
 #define GNRC_LWMAC_QUIT_RX              (0x0040U)
 
+/**
+ * @brief Flag to track if the receiver is in a burst reception.
+ *
+ * A sender announces further packets with @ref GNRC_LWMAC_FRAMETYPE_DATA_PENDING
+ * and sends them right after the previous one without a new WR/WA handshake.
+ * The receiver sets this flag to keep waiting for data, and a missing follow-up
+ * packet then ends the reception successfully instead of as a failure.
+ */
+#define GNRC_LWMAC_RX_BURST             (0x0080U)
+
 /**
  * @brief Type to pass information about parsing.
  */
@@ -217,6 +227,36 @@ static inline bool gnrc_lwmac_get_quit_rx(gnrc_netif_t *netif)
     return (netif->mac.mac_info & GNRC_LWMAC_QUIT_RX);
 }
 
+/**
+ * @brief set the @ref GNRC_LWMAC_RX_BURST flag of the device
+ *
+ * @param[in] netif        ptr to the network interface
+ * @param[in] rx_burst     value for LWMAC @ref GNRC_LWMAC_RX_BURST flag
+ *
+ */
+static inline void gnrc_lwmac_set_rx_burst(gnrc_netif_t *netif, bool rx_burst)
+{
+    if (rx_burst) {
+        netif->mac.mac_info |= GNRC_LWMAC_RX_BURST;
+    }
+    else {
+        netif->mac.mac_info &= ~GNRC_LWMAC_RX_BURST;
+    }
+}
+
+/**
+ * @brief get the @ref GNRC_LWMAC_RX_BURST flag of the device
+ *
+ * @param[in] netif        ptr to the network interface
+ *
+ * @return                 true if in burst reception
+ * @return                 false if not in burst reception
+ */
+static inline bool gnrc_lwmac_get_rx_burst(gnrc_netif_t *netif)
+{
+    return (netif->mac.mac_info & GNRC_LWMAC_RX_BURST);
+}
+
 /**
  * @brief set the @ref GNRC_LWMAC_DUTYCYCLE_ACTIVE flag of LWMAC
  *
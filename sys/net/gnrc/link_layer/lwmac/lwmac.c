@@ -197,27 +197,23 @@ static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif)
     return pkt;
 }
 
+/* Unknown destinations are initialized with their phase at the end of the
+ * local interval, so known destinations that still wakeup in this interval
+ * will be preferred. */
+static uint32_t _tx_neighbor_cost(const gnrc_mac_tx_neighbor_t *neighbor)
+{
+    return _gnrc_lwmac_ticks_until_phase(neighbor->phase);
+}
+
 static gnrc_mac_tx_neighbor_t *_next_tx_neighbor(gnrc_netif_t *netif)
 {
-    gnrc_mac_tx_neighbor_t *next = NULL;
-    uint32_t phase_nearest = GNRC_LWMAC_PHASE_MAX;
-
-    for (unsigned i = 0; i < GNRC_MAC_NEIGHBOR_COUNT; i++) {
-        if (gnrc_priority_pktqueue_length(&netif->mac.tx.neighbors[i].queue) > 0) {
-            /* Unknown destinations are initialized with their phase at the end
-             * of the local interval, so known destinations that still wakeup
-             * in this interval will be preferred. */
-            uint32_t phase_check = _gnrc_lwmac_ticks_until_phase(netif->mac.tx.neighbors[i].phase);
-
-            if (phase_check <= phase_nearest) {
-                next = &(netif->mac.tx.neighbors[i]);
-                phase_nearest = phase_check;
-                DEBUG("[LWMAC-int] Advancing queue #%u\n", i);
-            }
-        }
-    }
+    int next = gnrc_mac_next_tx_neighbor(&netif->mac.tx, _tx_neighbor_cost);
 
-    return next;
+    if (next < 0) {
+        return NULL;
+    }
+    DEBUG("[LWMAC-int] Advancing queue #%d\n", next);
+    return &(netif->mac.tx.neighbors[next]);
 }
 
 static uint32_t _next_inphase_event(uint32_t last, uint32_t interval)
@@ -693,6 +689,12 @@ void rtt_handler(uint32_t event, gnrc_netif_t *netif)
         case GNRC_LWMAC_EVENT_RTT_WAKEUP_PENDING: {
             /* A new cycle starts, set sleep timing and initialize related MAC-info flags. */
             netif->mac.prot.lwmac.last_wakeup = rtt_get_alarm();
+#ifdef MODULE_NETSTATS_TRACE
+            uint32_t late = RTT_TICKS_TO_US(rtt_get_counter() -
+                                            netif->mac.prot.lwmac.last_wakeup);
+            NETSTATS_TRACE_ADD(&netif->dev->trace, NETSTATS_TRACE_MAC_WAKEUP,
+                               (late > UINT16_MAX) ? UINT16_MAX : late);
+#endif
             alarm = _next_inphase_event(netif->mac.prot.lwmac.last_wakeup,
                                         RTT_US_TO_TICKS(GNRC_LWMAC_WAKEUP_DURATION_US));
             rtt_set_alarm(alarm, rtt_cb, (void *) GNRC_LWMAC_EVENT_RTT_SLEEP_PENDING);
@@ -806,18 +808,27 @@ static void _lwmac_event_cb(netdev_t *dev, netdev_event_t event)
             }
             case NETDEV_EVENT_TX_COMPLETE: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_SUCCESS);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_netif_set_rx_started(netif, false);
                 lwmac_schedule_update(netif);
                 break;
             }
             case NETDEV_EVENT_TX_NOACK: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_NOACK);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_netif_set_rx_started(netif, false);
                 lwmac_schedule_update(netif);
                 break;
             }
             case NETDEV_EVENT_TX_MEDIUM_BUSY: {
                 gnrc_netif_set_tx_feedback(netif, TX_FEEDBACK_BUSY);
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+                gnrc_mac_csma_tx_done(netif, event);
+#endif
                 gnrc_netif_set_rx_started(netif, false);
                 lwmac_schedule_update(netif);
                 break;
@@ -98,7 +98,17 @@ int _gnrc_lwmac_transmit(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 #endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+        bool bcast = netif_hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                                         GNRC_NETIF_HDR_FLAGS_MULTICAST);
+
+        res = csma_sender_csma_ca_send_adaptive(dev, &iolist,
+                                                &netif->mac.csma_conf,
+                                                &netif->mac.csma_stats,
+                                                (bcast) ? NULL : dst, dst_len);
+#else
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
+#endif
     }
     else {
         res = dev->driver->send(dev, &iolist);
@@ -191,6 +201,10 @@ void _gnrc_lwmac_set_netdev_state(gnrc_netif_t *netif, netopt_state_t devstate)
                             &devstate,
                             sizeof(devstate));
 
+    if (devstate == NETOPT_STATE_SLEEP) {
+        NETSTATS_TRACE_ADD(&netif->dev->trace, NETSTATS_TRACE_MAC_SLEEP, 0);
+    }
+
 #if (GNRC_MAC_ENABLE_DUTYCYCLE_RECORD == 1)
     if (devstate == NETOPT_STATE_IDLE) {
         if (!(netif->mac.prot.lwmac.lwmac_info & GNRC_LWMAC_RADIO_IS_ON)) {
@@ -52,6 +52,11 @@
  */
 #define GNRC_LWMAC_RX_FOUND_DATA              (0x04U)
 
+/**
+ * @brief   Flag indicating that the sender announced further data packets
+ */
+#define GNRC_LWMAC_RX_FOUND_DATA_PENDING      (0x08U)
+
 static uint8_t _packet_process_in_wait_for_wr(gnrc_netif_t *netif)
 {
     uint8_t rx_info = 0;
@@ -264,6 +269,9 @@ static uint8_t _packet_process_in_wait_for_data(gnrc_netif_t *netif)
                 LOG_DEBUG("[LWMAC-rx] Found DATA!\n");
                 gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA);
                 rx_info |= GNRC_LWMAC_RX_FOUND_DATA;
+                if (info.header->type == GNRC_LWMAC_FRAMETYPE_DATA_PENDING) {
+                    rx_info |= GNRC_LWMAC_RX_FOUND_DATA_PENDING;
+                }
                 return rx_info;
             }
             default: {
@@ -290,6 +298,7 @@ void gnrc_lwmac_rx_start(gnrc_netif_t *netif)
     netif->dev->driver->set(netif->dev, NETOPT_CSMA, &csma_disable,
                             sizeof(csma_disable));
 
+    gnrc_lwmac_set_rx_burst(netif, false);
     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_INIT;
 }
 
@@ -300,6 +309,7 @@ void gnrc_lwmac_rx_stop(gnrc_netif_t *netif)
     }
 
     gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA);
+    gnrc_lwmac_set_rx_burst(netif, false);
     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_STOPPED;
     netif->mac.rx.l2_addr.len = 0;
 }
@@ -385,6 +395,7 @@ static bool _lwmac_rx_update(gnrc_netif_t *netif)
             if (rx_info & GNRC_LWMAC_RX_FOUND_WR) {
                 LOG_INFO("[LWMAC-rx] WA probably got lost, reset RX state machine\n");
                 /* Start over again */
+                gnrc_lwmac_set_rx_burst(netif, false);
                 netif->mac.rx.state = GNRC_LWMAC_RX_STATE_INIT;
                 reschedule = true;
                 break;
@@ -395,7 +406,15 @@ static bool _lwmac_rx_update(gnrc_netif_t *netif)
              * machine (see above).
              */
             if (gnrc_lwmac_timeout_is_expired(netif, GNRC_LWMAC_TIMEOUT_DATA)) {
-                if (!gnrc_netif_get_rx_started(netif)) {
+                if (!gnrc_netif_get_rx_started(netif) &&
+                    gnrc_lwmac_get_rx_burst(netif)) {
+                    /* Sender ran out of packets (or burst limit) or lost the
+                     * channel, what we got so far was received fine */
+                    LOG_DEBUG("[LWMAC-rx] Burst ended\n");
+                    netif->mac.rx.state = GNRC_LWMAC_RX_STATE_SUCCESSFUL;
+                    reschedule = true;
+                }
+                else if (!gnrc_netif_get_rx_started(netif)) {
                     LOG_INFO("[LWMAC-rx] DATA timed out\n");
                     netif->mac.rx.rx_bad_exten_count++;
                     netif->mac.rx.state = GNRC_LWMAC_RX_STATE_FAILED;
@@ -413,6 +432,16 @@ static bool _lwmac_rx_update(gnrc_netif_t *netif)
                 break;
             }
 
+            /* The sender has more packets for us and sends them right away,
+             * without WR/WA handshake, so keep listening */
+            if (rx_info & GNRC_LWMAC_RX_FOUND_DATA_PENDING) {
+                LOG_DEBUG("[LWMAC-rx] Wait for burst DATA\n");
+                gnrc_lwmac_set_rx_burst(netif, true);
+                gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_DATA, GNRC_LWMAC_DATA_DELAY_US);
+                reschedule = true;
+                break;
+            }
+
             netif->mac.rx.state = GNRC_LWMAC_RX_STATE_SUCCESSFUL;
             reschedule = true;
             break;
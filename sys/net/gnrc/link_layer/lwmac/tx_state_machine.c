@@ -472,6 +472,27 @@ static bool _send_data(gnrc_netif_t *netif)
     return true;
 }
 
+/* Takes the next packet of a burst to the current neighbor. The receiver keeps
+ * listening after a DATA_PENDING frame, so no WR/WA handshake is needed. */
+static bool _burst_next(gnrc_netif_t *netif)
+{
+    gnrc_pktsnip_t *pkt;
+
+    assert(netif->mac.tx.packet == NULL);
+
+    pkt = gnrc_priority_pktqueue_pop(&netif->mac.tx.current_neighbor->queue);
+    if (pkt == NULL) {
+        return false;
+    }
+
+    netif->mac.tx.packet = pkt;
+    netif->mac.tx.tx_retry_count = 0;
+    /* Receiver waits GNRC_LWMAC_DATA_DELAY_US for the next packet */
+    gnrc_lwmac_clear_timeout(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE);
+    gnrc_lwmac_set_timeout(netif, GNRC_LWMAC_TIMEOUT_NO_RESPONSE, GNRC_LWMAC_DATA_DELAY_US);
+    return true;
+}
+
 void gnrc_lwmac_tx_start(gnrc_netif_t *netif,
                          gnrc_pktsnip_t *pkt,
                          gnrc_mac_tx_neighbor_t *neighbor)
@@ -487,6 +508,7 @@ void gnrc_lwmac_tx_start(gnrc_netif_t *netif,
 
     netif->mac.tx.packet = pkt;
     netif->mac.tx.current_neighbor = neighbor;
+    netif->mac.tx.last_tx_neighbor_id = neighbor - netif->mac.tx.neighbors;
     netif->mac.tx.state = GNRC_LWMAC_TX_STATE_INIT;
     netif->mac.tx.wr_sent = 0;
 
@@ -766,6 +788,14 @@ static bool _lwmac_tx_update(gnrc_netif_t *netif)
                 break;
             }
             else if (gnrc_netif_get_tx_feedback(netif) == TX_FEEDBACK_SUCCESS) {
+                /* Send the pending packets announced to the receiver right
+                 * away, it is still awake */
+                if (gnrc_lwmac_get_tx_continue(netif) && _burst_next(netif)) {
+                    LOG_DEBUG("[LWMAC-tx] Continue burst\n");
+                    netif->mac.tx.state = GNRC_LWMAC_TX_STATE_SEND_DATA;
+                    reschedule = true;
+                    break;
+                }
                 netif->mac.tx.state = GNRC_LWMAC_TX_STATE_SUCCESSFUL;
                 reschedule = true;
                 break;
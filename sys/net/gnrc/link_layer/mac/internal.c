@@ -19,6 +19,7 @@
  * @}
  */
 
+#include <errno.h>
 #include <stdbool.h>
 
 #include "net/gnrc.h"
@@ -118,6 +119,33 @@ void _gnrc_mac_init_neighbor(gnrc_mac_tx_neighbor_t *neighbor, const uint8_t *ad
     neighbor->phase = GNRC_MAC_PHASE_MAX;
     memcpy(&(neighbor->l2_addr), addr, len);
 }
+
+int gnrc_mac_next_tx_neighbor(gnrc_mac_tx_t *tx,
+                              gnrc_mac_tx_neighbor_cost_t cost)
+{
+    assert(tx != NULL);
+
+    const unsigned count = GNRC_MAC_NEIGHBOR_COUNT + 1;
+    uint32_t cost_min = UINT32_MAX;
+    int next = -ENOENT;
+
+    /* Start after the neighbor served last, so on equal cost the one that
+     * waited longest wins */
+    for (unsigned i = 1; i <= count; i++) {
+        unsigned id = (tx->last_tx_neighbor_id + i) % count;
+        gnrc_mac_tx_neighbor_t *neighbor = &tx->neighbors[id];
+
+        if (gnrc_priority_pktqueue_length(&neighbor->queue) == 0) {
+            continue;
+        }
+        uint32_t c = (cost != NULL) ? cost(neighbor) : 0;
+        if ((next < 0) || (c < cost_min)) {
+            cost_min = c;
+            next = (int)id;
+        }
+    }
+    return next;
+}
 #endif /* GNRC_MAC_NEIGHBOR_COUNT != 0 */
 
 bool gnrc_mac_queue_tx_packet(gnrc_mac_tx_t *tx, uint32_t priority, gnrc_pktsnip_t *pkt)
@@ -276,3 +304,33 @@ void gnrc_mac_dispatch(gnrc_mac_rx_t *rx)
     }
 }
 #endif /* GNRC_MAC_DISPATCH_BUFFER_SIZE != 0 */
+
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+void gnrc_mac_csma_tx_done(gnrc_netif_t *netif, netdev_event_t event)
+{
+    uint8_t retries = 0;
+    int status = 0;
+
+    assert(netif != NULL);
+
+    if (!(netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED)) {
+        /* not sent with the adaptive CSMA/CA sender */
+        return;
+    }
+    switch (event) {
+        case NETDEV_EVENT_TX_MEDIUM_BUSY:
+            status = -EBUSY;
+            break;
+        case NETDEV_EVENT_TX_NOACK:
+            status = -EHOSTUNREACH;
+            break;
+        default:
+            break;
+    }
+    if (netif->dev->driver->get(netif->dev, NETOPT_TX_RETRIES_NEEDED,
+                                &retries, sizeof(retries)) < 0) {
+        retries = 0;
+    }
+    csma_sender_tx_done(&netif->mac.csma_stats, status, retries);
+}
+#endif /* MODULE_CSMA_SENDER_ADAPTIVE */
@@ -82,11 +82,17 @@ static inline int _snd_rcv_mbox(mbox_t *mbox, uint16_t type, gnrc_pktsnip_t *pkt
 int gnrc_netapi_dispatch(gnrc_nettype_t type, uint32_t demux_ctx,
                          uint16_t cmd, gnrc_pktsnip_t *pkt)
 {
-    int numof = gnrc_netreg_num(type, demux_ctx);
+    gnrc_netreg_entry_t *sendto = gnrc_netreg_lookup(type, demux_ctx);
+    int numof = 0;
 
-    if (numof != 0) {
-        gnrc_netreg_entry_t *sendto = gnrc_netreg_lookup(type, demux_ctx);
+    /* receivers are adjacent in the registry, so counting them does not
+     * search again */
+    for (gnrc_netreg_entry_t *entry = sendto; entry != NULL;
+         entry = gnrc_netreg_getnext(entry)) {
+        numof++;
+    }
 
+    if (numof != 0) {
         gnrc_pktbuf_hold(pkt, numof - 1);
 
         while (sendto) {
@@ -25,7 +25,7 @@
 #include "net/gnrc/ipv6/nib.h"
 #include "net/gnrc/ipv6.h"
 #endif /* MODULE_GNRC_IPV6_NIB */
-#ifdef MODULE_NETSTATS
+#if defined(MODULE_NETSTATS) || defined(MODULE_CSMA_SENDER_ADAPTIVE)
 #include "net/netstats.h"
 #endif
 #include "fmt.h"
@@ -35,6 +35,9 @@
 
 #include "net/gnrc/netif.h"
 #include "net/gnrc/netif/internal.h"
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+#include "net/gnrc/mac/internal.h"
+#endif
 
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
@@ -45,6 +48,9 @@ static void _update_l2addr_from_dev(gnrc_netif_t *netif);
 static void _configure_netdev(netdev_t *dev);
 static void *_gnrc_netif_thread(void *args);
 static void _event_cb(netdev_t *dev, netdev_event_t event);
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static void _nb_record(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
+#endif
 
 gnrc_netif_t *gnrc_netif_create(char *stack, int stacksize, char priority,
                                 const char *name, netdev_t *netdev,
@@ -133,6 +139,27 @@ int gnrc_netif_get_from_netdev(gnrc_netif_t *netif, gnrc_netapi_opt_t *opt)
                     *((netstats_t **)opt->data) = &netif->stats;
                     res = sizeof(&netif->stats);
                     break;
+#endif
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+                case NETSTATS_CSMA:
+                    assert(opt->data_len == sizeof(csma_sender_stats_t *));
+                    *((csma_sender_stats_t **)opt->data) = &netif->mac.csma_stats;
+                    res = sizeof(&netif->mac.csma_stats);
+                    break;
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                case NETSTATS_NEIGHBOR:
+                    assert(opt->data_len == sizeof(netstats_nb_table_t *));
+                    *((netstats_nb_table_t **)opt->data) = &netif->neighbors;
+                    res = sizeof(&netif->neighbors);
+                    break;
+#endif
+#ifdef MODULE_NETSTATS_TRACE
+                case NETSTATS_TRACE:
+                    assert(opt->data_len == sizeof(netstats_trace_t *));
+                    *((netstats_trace_t **)opt->data) = &netif->dev->trace;
+                    res = sizeof(&netif->dev->trace);
+                    break;
 #endif
                 default:
                     /* take from device */
@@ -1223,7 +1250,8 @@ static void _configure_netdev(netdev_t *dev)
     if (res < 0) {
         DEBUG("gnrc_netif: enable NETOPT_RX_END_IRQ failed: %d\n", res);
     }
-#ifdef MODULE_NETSTATS_L2
+#if defined(MODULE_NETSTATS_L2) || defined(MODULE_NETSTATS_NEIGHBOR) || \
+    defined(MODULE_CSMA_SENDER_ADAPTIVE)
     res = dev->driver->set(dev, NETOPT_TX_END_IRQ, &enable, sizeof(enable));
     if (res < 0) {
         DEBUG("gnrc_netif: enable NETOPT_TX_END_IRQ failed: %d\n", res);
@@ -1370,6 +1398,9 @@ static void *_gnrc_netif_thread(void *args)
     /* register the event callback with the device driver */
     dev->event_callback = _event_cb;
     dev->context = netif;
+#ifdef MODULE_NETSTATS_TRACE
+    netstats_trace_init(&dev->trace);
+#endif
     /* initialize low-level driver */
     res = dev->driver->init(dev);
     if (res < 0) {
@@ -1389,6 +1420,9 @@ static void *_gnrc_netif_thread(void *args)
 #endif
 #ifdef MODULE_NETSTATS_L2
     memset(&netif->stats, 0, sizeof(netstats_t));
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    netstats_nb_init(&netif->neighbors);
 #endif
     /* now let rest of GNRC use the interface */
     gnrc_netif_release(netif);
@@ -1407,10 +1441,18 @@ static void *_gnrc_netif_thread(void *args)
                 break;
             case GNRC_NETAPI_MSG_TYPE_SND:
                 DEBUG("gnrc_netif: GNRC_NETDEV_MSG_TYPE_SND received\n");
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                _nb_record(netif, msg.content.ptr);
+#endif
+                NETSTATS_TRACE_ADD(&dev->trace, NETSTATS_TRACE_TX_QUEUED,
+                                   gnrc_pkt_len(msg.content.ptr));
                 res = netif->ops->send(netif, msg.content.ptr);
                 if (res < 0) {
                     DEBUG("gnrc_netif: error sending packet %p (code: %i)\n",
                           msg.content.ptr, res);
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                    netstats_nb_cancel_tx(&netif->neighbors);
+#endif
                 }
 #ifdef MODULE_NETSTATS_L2
                 else {
@@ -1482,6 +1524,95 @@ static void _pass_on_packet(gnrc_pktsnip_t *pkt)
     }
 }
 
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static void _nb_record(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    gnrc_netif_hdr_t *hdr;
+
+    if ((pkt == NULL) || (pkt->type != GNRC_NETTYPE_NETIF)) {
+        /* the outcome of the frame is reported nevertheless */
+        netstats_nb_record(&netif->neighbors, NULL, 0);
+        return;
+    }
+    hdr = pkt->data;
+    if (hdr->flags &
+        (GNRC_NETIF_HDR_FLAGS_BROADCAST | GNRC_NETIF_HDR_FLAGS_MULTICAST)) {
+        netstats_nb_record(&netif->neighbors, NULL, 0);
+    }
+    else {
+        netstats_nb_record(&netif->neighbors,
+                           gnrc_netif_hdr_get_dst_addr(hdr),
+                           hdr->dst_l2addr_len);
+    }
+}
+
+static void _nb_rx(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *netif_snip = gnrc_pktsnip_search_type(pkt,
+                                                          GNRC_NETTYPE_NETIF);
+    gnrc_netif_hdr_t *hdr;
+
+    if (netif_snip == NULL) {
+        return;
+    }
+    hdr = netif_snip->data;
+    netstats_nb_update_rx(&netif->neighbors, gnrc_netif_hdr_get_src_addr(hdr),
+                          hdr->src_l2addr_len, hdr->rssi, hdr->lqi);
+}
+
+#ifdef MODULE_GNRC_IPV6
+int gnrc_netif_ipv6_nb_stats(gnrc_netif_t *netif, const ipv6_addr_t *addr,
+                             netstats_nb_t *stats)
+{
+    uint8_t l2addr[GNRC_NETIF_L2ADDR_MAXLEN];
+    int res;
+
+    if (!(netif->flags & GNRC_NETIF_FLAGS_HAS_L2ADDR)) {
+        return -ENOTSUP;
+    }
+    res = gnrc_netif_ipv6_iid_to_addr(netif, (const eui64_t *)&addr->u64[1],
+                                      l2addr);
+    if (res < 0) {
+        return res;
+    }
+    return netstats_nb_get(&netif->neighbors, l2addr, res, stats);
+}
+#endif  /* MODULE_GNRC_IPV6 */
+#endif  /* MODULE_NETSTATS_NEIGHBOR */
+
+#if (defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)) || \
+    defined(MODULE_NETSTATS_NEIGHBOR)
+static void _tx_done(gnrc_netif_t *netif, netdev_event_t event)
+{
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+    gnrc_mac_csma_tx_done(netif, event);
+#endif
+#ifdef MODULE_NETSTATS_L2
+    /* we are the only ones supposed to touch this variable, so no acquire
+     * necessary */
+    if (event == NETDEV_EVENT_TX_COMPLETE) {
+        netif->stats.tx_success++;
+    }
+    else if (event == NETDEV_EVENT_TX_MEDIUM_BUSY) {
+        netif->stats.tx_failed++;
+    }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    uint8_t retries = 0;
+
+    if (netif->dev->driver->get(netif->dev, NETOPT_TX_RETRIES_NEEDED,
+                                &retries, sizeof(retries)) < 0) {
+        retries = 0;
+    }
+    /* a busy medium tells nothing about the link to the neighbor */
+    netstats_nb_update_tx(&netif->neighbors,
+                          (event == NETDEV_EVENT_TX_MEDIUM_BUSY) ?
+                          0U : (retries + 1U),
+                          (event == NETDEV_EVENT_TX_COMPLETE));
+#endif
+}
+#endif
+
 static void _event_cb(netdev_t *dev, netdev_event_t event)
 {
     gnrc_netif_t *netif = (gnrc_netif_t *) dev->context;
@@ -1501,10 +1632,20 @@ static void _event_cb(netdev_t *dev, netdev_event_t event)
             case NETDEV_EVENT_RX_COMPLETE:
                 pkt = netif->ops->recv(netif);
                 if (pkt) {
+#ifdef MODULE_NETSTATS_NEIGHBOR
+                    _nb_rx(netif, pkt);
+#endif
                     _pass_on_packet(pkt);
                 }
                 break;
-#ifdef MODULE_NETSTATS_L2
+#if (defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)) || \
+    defined(MODULE_NETSTATS_NEIGHBOR)
+            case NETDEV_EVENT_TX_MEDIUM_BUSY:
+            case NETDEV_EVENT_TX_NOACK:
+            case NETDEV_EVENT_TX_COMPLETE:
+                _tx_done(netif, event);
+                break;
+#elif defined(MODULE_NETSTATS_L2)
             case NETDEV_EVENT_TX_MEDIUM_BUSY:
                 /* we are the only ones supposed to touch this variable,
                  * so no acquire necessary */
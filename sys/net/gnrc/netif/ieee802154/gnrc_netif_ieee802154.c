@@ -30,9 +30,16 @@
 
 static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt);
 static gnrc_pktsnip_t *_recv(gnrc_netif_t *netif);
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+static void _init(gnrc_netif_t *netif);
+#endif
 
 static const gnrc_netif_ops_t ieee802154_ops = {
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+    .init = _init,
+#else
     .init = gnrc_netif_default_init,
+#endif
     .send = _send,
     .recv = _recv,
     .get = gnrc_netif_get_from_netdev,
@@ -47,6 +54,15 @@ gnrc_netif_t *gnrc_netif_ieee802154_create(char *stack, int stacksize,
                              &ieee802154_ops);
 }
 
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+static void _init(gnrc_netif_t *netif)
+{
+    gnrc_netif_default_init(netif);
+    /* send with the adaptive CSMA/CA sender */
+    netif->mac.mac_info |= GNRC_NETIF_MAC_INFO_CSMA_ENABLED;
+}
+#endif
+
 static gnrc_pktsnip_t *_make_netif_hdr(uint8_t *mhr)
 {
     gnrc_netif_hdr_t *hdr;
@@ -288,7 +304,17 @@ static int _send(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 #endif
 #ifdef MODULE_GNRC_MAC
     if (netif->mac.mac_info & GNRC_NETIF_MAC_INFO_CSMA_ENABLED) {
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+        bool bcast = netif_hdr->flags & (GNRC_NETIF_HDR_FLAGS_BROADCAST |
+                                         GNRC_NETIF_HDR_FLAGS_MULTICAST);
+
+        res = csma_sender_csma_ca_send_adaptive(dev, &iolist,
+                                                &netif->mac.csma_conf,
+                                                &netif->mac.csma_stats,
+                                                (bcast) ? NULL : dst, dst_len);
+#else
         res = csma_sender_csma_ca_send(dev, &iolist, &netif->mac.csma_conf);
+#endif
     }
     else {
         res = dev->driver->send(dev, &iolist);
@@ -28,13 +28,51 @@
 
 #define _INVALID_TYPE(type) (((type) < GNRC_NETTYPE_UNDEF) || ((type) >= GNRC_NETTYPE_NUMOF))
 
+#if GNRC_NETREG_BUCKETS
+#if (GNRC_NETREG_BUCKETS & (GNRC_NETREG_BUCKETS - 1))
+#error "GNRC_NETREG_BUCKETS must be a power of two"
+#endif
+/* The registry as hash table by gnrc_nettype_t and demux context */
+static gnrc_netreg_entry_t *netreg[GNRC_NETREG_BUCKETS];
+#else
 /* The registry as lookup table by gnrc_nettype_t */
 static gnrc_netreg_entry_t *netreg[GNRC_NETTYPE_NUMOF];
+#endif
+
+/**
+ * @brief   Returns the list holding the entries for @p type and @p demux_ctx
+ *
+ * Within a list, entries with the same type and demux context are kept
+ * adjacent, so all receivers of a packet are found with a single search.
+ */
+static inline gnrc_netreg_entry_t **_head(gnrc_nettype_t type,
+                                          uint32_t demux_ctx)
+{
+#if GNRC_NETREG_BUCKETS
+    /* fold the upper half in, so GNRC_NETREG_DEMUX_CTX_ALL spreads too */
+    uint32_t hash = demux_ctx ^ (demux_ctx >> 16) ^ ((uint32_t)type * 0x9e5);
+    return &netreg[hash & (GNRC_NETREG_BUCKETS - 1)];
+#else
+    (void)demux_ctx;
+    return &netreg[type];
+#endif
+}
+
+static inline bool _match(const gnrc_netreg_entry_t *entry,
+                          gnrc_nettype_t type, uint32_t demux_ctx)
+{
+#if GNRC_NETREG_BUCKETS
+    return (entry->demux_ctx == demux_ctx) && (entry->nettype == type);
+#else
+    (void)type;
+    return (entry->demux_ctx == demux_ctx);
+#endif
+}
 
 void gnrc_netreg_init(void)
 {
     /* set all pointers in registry to NULL */
-    memset(netreg, 0, GNRC_NETTYPE_NUMOF * sizeof(gnrc_netreg_entry_t *));
+    memset(netreg, 0, sizeof(netreg));
 }
 
 int gnrc_netreg_register(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
@@ -59,7 +97,22 @@ int gnrc_netreg_register(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
         return -EINVAL;
     }
 
-    LL_PREPEND(netreg[type], entry);
+#if GNRC_NETREG_BUCKETS
+    entry->nettype = type;
+#endif
+
+    /* insert in front of the entries with the same demux context, or at the
+     * head if there are none */
+    gnrc_netreg_entry_t **head = _head(type, entry->demux_ctx);
+    gnrc_netreg_entry_t **pos = head;
+    while (*pos && !_match(*pos, type, entry->demux_ctx)) {
+        pos = &(*pos)->next;
+    }
+    if (*pos == NULL) {
+        pos = head;
+    }
+    entry->next = *pos;
+    *pos = entry;
 
     return 0;
 }
@@ -70,54 +123,47 @@ void gnrc_netreg_unregister(gnrc_nettype_t type, gnrc_netreg_entry_t *entry)
         return;
     }
 
-    LL_DELETE(netreg[type], entry);
+    gnrc_netreg_entry_t **head = _head(type, entry->demux_ctx);
+    LL_DELETE(*head, entry);
 }
 
-/**
- * @brief   Searches the next entry in the registry that matches given
- *          parameters, start lookup from beginning or given entry.
- *
- * @param[in] from      A registry entry to lookup from or NULL to start fresh
- * @param[in] type      Type of the protocol.
- * @param[in] demux_ctx The demultiplexing context for the registered thread.
- *                      See gnrc_netreg_entry_t::demux_ctx.
- *
- * @return  The first entry fitting the given parameters on success
- * @return  NULL if no entry can be found.
- */
-static gnrc_netreg_entry_t *_netreg_lookup(gnrc_netreg_entry_t *from,
-                                           gnrc_nettype_t type,
-                                           uint32_t demux_ctx)
+gnrc_netreg_entry_t *gnrc_netreg_lookup(gnrc_nettype_t type, uint32_t demux_ctx)
 {
     gnrc_netreg_entry_t *res = NULL;
 
-    if (from || !_INVALID_TYPE(type)) {
-        gnrc_netreg_entry_t *head = (from) ? from->next : netreg[type];
-        LL_SEARCH_SCALAR(head, res, demux_ctx, demux_ctx);
+    if (!_INVALID_TYPE(type)) {
+        res = *_head(type, demux_ctx);
+        while (res && !_match(res, type, demux_ctx)) {
+            res = res->next;
+        }
     }
 
     return res;
 }
 
-gnrc_netreg_entry_t *gnrc_netreg_lookup(gnrc_nettype_t type, uint32_t demux_ctx)
-{
-    return _netreg_lookup(NULL, type, demux_ctx);
-}
-
 int gnrc_netreg_num(gnrc_nettype_t type, uint32_t demux_ctx)
 {
     int num = 0;
-    gnrc_netreg_entry_t *entry = NULL;
+    gnrc_netreg_entry_t *entry = gnrc_netreg_lookup(type, demux_ctx);
 
-    while((entry = _netreg_lookup(entry, type, demux_ctx)) != NULL) {
+    while (entry) {
         num++;
+        entry = gnrc_netreg_getnext(entry);
     }
     return num;
 }
 
 gnrc_netreg_entry_t *gnrc_netreg_getnext(gnrc_netreg_entry_t *entry)
 {
-    return (entry ? _netreg_lookup(entry, 0, entry->demux_ctx) : NULL);
+    if ((entry == NULL) || (entry->next == NULL)) {
+        return NULL;
+    }
+#if GNRC_NETREG_BUCKETS
+    return _match(entry->next, entry->nettype, entry->demux_ctx)
+           ? entry->next : NULL;
+#else
+    return _match(entry->next, 0, entry->demux_ctx) ? entry->next : NULL;
+#endif
 }
 
 int gnrc_netreg_calc_csum(gnrc_pktsnip_t *hdr, gnrc_pktsnip_t *pseudo_hdr)
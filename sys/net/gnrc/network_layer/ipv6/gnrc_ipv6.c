@@ -19,6 +19,7 @@
 #include "byteorder.h"
 #include "cpu_conf.h"
 #include "kernel_types.h"
+#include "mutex.h"
 #include "net/gnrc.h"
 #include "net/gnrc/icmpv6.h"
 #include "net/gnrc/sixlowpan/ctx.h"
@@ -36,6 +37,10 @@
 #include "net/gnrc/ipv6/ext/frag.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+#include "net/gnrc/rpl/srh.h"
+#endif
+
 #include "net/gnrc/ipv6.h"
 
 #define ENABLE_DEBUG    (0)
@@ -67,6 +72,15 @@ static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
 kernel_pid_t gnrc_ipv6_pid = KERNEL_PID_UNDEF;
 
+#ifdef MODULE_GNRC_RX_DIRECT
+static void _rx_direct(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx);
+
+/* serializes packet handling of the IPv6 thread and of lower layers calling
+ * _receive() directly */
+static mutex_t _rx_lock = MUTEX_INIT;
+static gnrc_netreg_entry_cbd_t _rx_direct_cbd = { .cb = _rx_direct };
+#endif
+
 /* handles GNRC_NETAPI_MSG_TYPE_RCV commands */
 static void _receive(gnrc_pktsnip_t *pkt);
 /* Sends packet over the appropriate interface(s).
@@ -173,8 +187,13 @@ static void _dispatch_next_header(gnrc_pktsnip_t *pkt, unsigned nh,
 static void *_event_loop(void *args)
 {
     msg_t msg, reply, msg_q[CONFIG_GNRC_IPV6_MSG_QUEUE_SIZE];
+#ifdef MODULE_GNRC_RX_DIRECT
+    gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_CB(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                           &_rx_direct_cbd);
+#else
     gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
+#endif
 
     (void)args;
     msg_init_queue(msg_q, CONFIG_GNRC_IPV6_MSG_QUEUE_SIZE);
@@ -193,6 +212,9 @@ static void *_event_loop(void *args)
     while (1) {
         DEBUG("ipv6: waiting for incoming message.\n");
         msg_receive(&msg);
+#ifdef MODULE_GNRC_RX_DIRECT
+        mutex_lock(&_rx_lock);
+#endif
 
         switch (msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV:
@@ -247,11 +269,64 @@ static void *_event_loop(void *args)
             default:
                 break;
         }
+#ifdef MODULE_GNRC_RX_DIRECT
+        mutex_unlock(&_rx_lock);
+#endif
     }
 
     return NULL;
 }
 
+#ifdef MODULE_GNRC_RX_DIRECT
+/* Only data plane packets are handled in the context of the lower layer.
+ * Everything else, in particular neighbor discovery which may reconfigure
+ * the receiving interface with synchronous netapi calls, and packets with
+ * extension headers go through the IPv6 thread. */
+static bool _rx_direct_allowed(gnrc_pktsnip_t *pkt)
+{
+    gnrc_pktsnip_t *ipv6 = gnrc_pktsnip_search_type(pkt, GNRC_NETTYPE_IPV6);
+
+    if ((ipv6 == NULL) || (ipv6->size < sizeof(ipv6_hdr_t))) {
+        return false;
+    }
+    switch (((ipv6_hdr_t *)ipv6->data)->nh) {
+        case PROTNUM_UDP:
+        case PROTNUM_TCP:
+            return true;
+        case PROTNUM_ICMPV6: {
+            const uint8_t *icmpv6 = NULL;
+            if (ipv6->size > sizeof(ipv6_hdr_t)) {
+                icmpv6 = (uint8_t *)ipv6->data + sizeof(ipv6_hdr_t);
+            }
+            else if ((ipv6 != pkt) && (pkt->size > 0)) {
+                /* header already marked */
+                icmpv6 = pkt->data;
+            }
+            return (icmpv6 != NULL) && ((icmpv6[0] == ICMPV6_ECHO_REQ) ||
+                                        (icmpv6[0] == ICMPV6_ECHO_REP));
+        }
+        default:
+            return false;
+    }
+}
+
+static void _rx_direct(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    (void)ctx;
+    /* never block the calling thread: if the IPv6 thread is busy (or is the
+     * caller itself, e.g. on loopback) hand the packet over as usual */
+    if ((cmd == GNRC_NETAPI_MSG_TYPE_RCV) && _rx_direct_allowed(pkt) &&
+        mutex_trylock(&_rx_lock)) {
+        DEBUG("ipv6: direct receive\n");
+        _receive(pkt);
+        mutex_unlock(&_rx_lock);
+    }
+    else if (_gnrc_netapi_send_recv(gnrc_ipv6_pid, pkt, cmd) < 1) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+#endif
+
 static void _send_to_iface(gnrc_netif_t *netif, gnrc_pktsnip_t *pkt)
 {
     const ipv6_hdr_t *hdr = pkt->next->data;
@@ -486,18 +561,38 @@ static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
                           uint8_t netif_hdr_flags)
 {
     gnrc_ipv6_nib_nc_t nce;
+    const ipv6_addr_t *route_dst = &ipv6_hdr->dst;
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+    ipv6_addr_t first_hop;
+    /* the header is only inserted once the upper layer checksum was
+     * calculated for the final destination */
+    gnrc_pktsnip_t *srh = gnrc_rpl_srh_root_build(pkt, &first_hop);
+
+    if (srh != NULL) {
+        route_dst = &first_hop;
+    }
+#endif
 
     DEBUG("ipv6: send unicast\n");
-    if (gnrc_ipv6_nib_get_next_hop_l2addr(&ipv6_hdr->dst, netif, pkt,
+    if (gnrc_ipv6_nib_get_next_hop_l2addr(route_dst, netif, pkt,
                                           &nce) < 0) {
         /* packet is released by NIB */
         DEBUG("ipv6: no link-layer address or interface for next hop to %s\n",
-              ipv6_addr_to_str(addr_str, &ipv6_hdr->dst, sizeof(addr_str)));
+              ipv6_addr_to_str(addr_str, route_dst, sizeof(addr_str)));
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+        gnrc_pktbuf_release(srh);
+#endif
         return;
     }
     netif = gnrc_netif_get_by_pid(gnrc_ipv6_nib_nc_get_iface(&nce));
     assert(netif != NULL);
     if (_safe_fill_ipv6_hdr(netif, pkt, prep_hdr)) {
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+        if (srh != NULL) {
+            DEBUG("ipv6: insert RPL source routing header\n");
+            gnrc_rpl_srh_root_insert(pkt, srh, &first_hop);
+        }
+#endif
         DEBUG("ipv6: add interface header to packet\n");
         if ((pkt = _create_netif_hdr(nce.l2addr, nce.l2addr_len, pkt,
                                      netif_hdr_flags)) == NULL) {
@@ -516,6 +611,11 @@ static void _send_unicast(gnrc_pktsnip_t *pkt, bool prep_hdr,
 #endif
         _send_to_iface(netif, pkt);
     }
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+    else {
+        gnrc_pktbuf_release(srh);
+    }
+#endif
 }
 
 static inline void _send_multicast_over_iface(gnrc_pktsnip_t *pkt,
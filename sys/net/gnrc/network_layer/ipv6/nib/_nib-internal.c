@@ -417,6 +417,29 @@ _nib_dr_entry_t *_nib_drl_get(const ipv6_addr_t *router_addr, unsigned iface)
     return NULL;
 }
 
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static uint16_t _node_etx(const _nib_onl_entry_t *node)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(_nib_onl_get_if(node));
+    netstats_nb_t stats = { .etx = 0 };
+
+    if (netif != NULL) {
+#if GNRC_IPV6_NIB_CONF_ARSM
+        if (node->l2addr_len > 0) {
+            netstats_nb_get(&netif->neighbors, node->l2addr, node->l2addr_len,
+                            &stats);
+        }
+        else
+#endif  /* GNRC_IPV6_NIB_CONF_ARSM */
+        {
+            gnrc_netif_ipv6_nb_stats(netif, &node->ipv6, &stats);
+        }
+    }
+    /* assume a mediocre link to routers we have no statistics for */
+    return (stats.etx == 0) ? (2U * NETSTATS_NB_ETX_DIVISOR) : stats.etx;
+}
+#endif  /* MODULE_NETSTATS_NEIGHBOR */
+
 _nib_dr_entry_t *_nib_drl_get_dr(void)
 {
     _nib_dr_entry_t *ptr = NULL;
@@ -428,6 +451,30 @@ _nib_dr_entry_t *_nib_drl_get_dr(void)
         /* take it */
         return _prime_def_router;
     }
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    /* else take the reachable router with the best link */
+    {
+        _nib_dr_entry_t *best = NULL;
+        uint16_t best_etx = UINT16_MAX;
+
+        while ((ptr = _nib_drl_iter(ptr))) {
+            uint16_t etx;
+
+            if (_node_unreachable(ptr->next_hop)) {
+                continue;
+            }
+            etx = _node_etx(ptr->next_hop);
+            if (etx < best_etx) {
+                best = ptr;
+                best_etx = etx;
+            }
+        }
+        if (best != NULL) {
+            _prime_def_router = best;
+            return _prime_def_router;
+        }
+    }
+#endif  /* MODULE_NETSTATS_NEIGHBOR */
     /* else search next reachable router */
     do {
         ptr = _nib_drl_iter(ptr);
@@ -82,6 +82,79 @@ int gnrc_ipv6_nib_ft_add(const ipv6_addr_t *dst, unsigned dst_len,
     return res;
 }
 
+#if GNRC_IPV6_NIB_CONF_ROUTER
+static int _ft_replace(const ipv6_addr_t *dst, unsigned dst_len,
+                       const ipv6_addr_t *next_hop, unsigned iface,
+                       uint16_t ltime)
+{
+    _nib_offl_entry_t *ptr = NULL;
+
+    dst_len = (dst_len > 128) ? 128 : dst_len;
+    while ((ptr = _nib_offl_iter(ptr))) {
+        if ((ptr->mode & _FT) && (ptr->pfx_len == dst_len) &&
+            (ipv6_addr_match_prefix(&ptr->pfx, dst) >= dst_len)) {
+            break;
+        }
+    }
+    /* only replace the route if it does not point to next_hop already */
+    if ((ptr != NULL) &&
+        ((_nib_onl_get_if(ptr->next_hop) != iface) ||
+         ((next_hop != NULL) &&
+          !ipv6_addr_equal(&ptr->next_hop->ipv6, next_hop)))) {
+        _nib_ft_remove(ptr);
+        ptr = NULL;
+    }
+    if ((ptr == NULL) &&
+        ((ptr = _nib_ft_add(next_hop, iface, dst, dst_len)) == NULL)) {
+        return -ENOMEM;
+    }
+    if (ltime > 0) {
+        _evtimer_add(ptr, GNRC_IPV6_NIB_ROUTE_TIMEOUT,
+                     &ptr->route_timeout, ltime * MS_PER_SEC);
+    }
+    else {
+        evtimer_del((evtimer_t *)&_nib_evtimer,
+                    (evtimer_event_t *)&ptr->route_timeout);
+    }
+    return 0;
+}
+#endif  /* GNRC_IPV6_NIB_CONF_ROUTER */
+
+int gnrc_ipv6_nib_ft_add_multi(const gnrc_ipv6_nib_ft_dst_t *dsts,
+                               unsigned numof, const ipv6_addr_t *next_hop,
+                               unsigned iface, uint16_t ltime)
+{
+#if GNRC_IPV6_NIB_CONF_ROUTER
+    int res = 0;
+
+    if ((iface == 0) || ((dsts == NULL) && (numof > 0))) {
+        return -EINVAL;
+    }
+    for (unsigned i = 0; i < numof; i++) {
+        if ((dsts[i].dst == NULL) || (dsts[i].dst_len == 0) ||
+            ipv6_addr_is_unspecified(dsts[i].dst)) {
+            return -EINVAL;
+        }
+    }
+    _nib_acquire();
+    for (unsigned i = 0; i < numof; i++) {
+        if (_ft_replace(dsts[i].dst, dsts[i].dst_len, next_hop, iface,
+                        ltime) < 0) {
+            res = -ENOMEM;
+        }
+    }
+    _nib_release();
+    return res;
+#else   /* GNRC_IPV6_NIB_CONF_ROUTER */
+    (void)dsts;
+    (void)numof;
+    (void)next_hop;
+    (void)iface;
+    (void)ltime;
+    return -ENOTSUP;
+#endif  /* GNRC_IPV6_NIB_CONF_ROUTER */
+}
+
 void gnrc_ipv6_nib_ft_del(const ipv6_addr_t *dst, unsigned dst_len)
 {
     _nib_acquire();
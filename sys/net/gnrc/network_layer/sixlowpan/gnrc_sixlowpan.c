@@ -13,6 +13,7 @@
  */
 
 #include "kernel_types.h"
+#include "mutex.h"
 #include "net/gnrc.h"
 #include "thread.h"
 #include "utlist.h"
@@ -44,6 +45,15 @@ static void _send(gnrc_pktsnip_t *pkt);
 /* Main event loop for 6LoWPAN */
 static void *_event_loop(void *args);
 
+#ifdef MODULE_GNRC_RX_DIRECT
+static void _rx_direct(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx);
+
+/* serializes packet handling of the 6LoWPAN thread and of lower layers
+ * calling _receive() directly */
+static mutex_t _rx_lock = MUTEX_INIT;
+static gnrc_netreg_entry_cbd_t _rx_direct_cbd = { .cb = _rx_direct };
+#endif
+
 kernel_pid_t gnrc_sixlowpan_init(void)
 {
     if (_pid > KERNEL_PID_UNDEF) {
@@ -309,8 +319,13 @@ static void _send(gnrc_pktsnip_t *pkt)
 static void *_event_loop(void *args)
 {
     msg_t msg, reply, msg_q[GNRC_SIXLOWPAN_MSG_QUEUE_SIZE];
+#ifdef MODULE_GNRC_RX_DIRECT
+    gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_CB(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                           &_rx_direct_cbd);
+#else
     gnrc_netreg_entry_t me_reg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
+#endif
 
     (void)args;
     msg_init_queue(msg_q, GNRC_SIXLOWPAN_MSG_QUEUE_SIZE);
@@ -325,6 +340,9 @@ static void *_event_loop(void *args)
     while (1) {
         DEBUG("6lo: waiting for incoming message.\n");
         msg_receive(&msg);
+#ifdef MODULE_GNRC_RX_DIRECT
+        mutex_lock(&_rx_lock);
+#endif
 
         switch (msg.type) {
             case GNRC_NETAPI_MSG_TYPE_RCV:
@@ -365,9 +383,29 @@ static void *_event_loop(void *args)
                 DEBUG("6lo: operation not supported\n");
                 break;
         }
+#ifdef MODULE_GNRC_RX_DIRECT
+        mutex_unlock(&_rx_lock);
+#endif
     }
 
     return NULL;
 }
 
+#ifdef MODULE_GNRC_RX_DIRECT
+static void _rx_direct(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    (void)ctx;
+    /* never block the calling thread: if the 6LoWPAN thread is busy hand the
+     * packet over as usual */
+    if ((cmd == GNRC_NETAPI_MSG_TYPE_RCV) && mutex_trylock(&_rx_lock)) {
+        DEBUG("6lo: direct receive\n");
+        _receive(pkt);
+        mutex_unlock(&_rx_lock);
+    }
+    else if (_gnrc_netapi_send_recv(_pid, pkt, cmd) < 1) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+#endif
+
 /** @} */
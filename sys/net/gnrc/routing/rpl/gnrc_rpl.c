@@ -361,7 +361,17 @@ void _dao_handle_send(gnrc_rpl_dodag_t *dodag)
         evtimer_add_msg(&gnrc_rpl_evtimer, &dodag->dao_event, gnrc_rpl_pid);
     }
     else if (dodag->dao_ack_received == false) {
+        uint8_t attempts = dodag->dao_counter;
+
         gnrc_rpl_long_delay_dao(dodag);
+        /* in storing mode DAOs go to the preferred parent directly, so the
+         * missing DAO-ACK says something about that link. This may switch
+         * the preferred parent and schedule a DAO to the new one. */
+        if (((dodag->instance->mop == GNRC_RPL_MOP_STORING_MODE_NO_MC) ||
+             (dodag->instance->mop == GNRC_RPL_MOP_STORING_MODE_MC)) &&
+            (dodag->parents != NULL)) {
+            gnrc_rpl_parent_etx_update(dodag->parents, attempts, false);
+        }
     }
 }
 
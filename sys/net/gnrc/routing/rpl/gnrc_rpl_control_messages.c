@@ -43,6 +43,10 @@
 #include "net/gnrc/rpl/p2p.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+#include "net/gnrc/rpl/srh.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
@@ -496,12 +500,116 @@ static inline uint32_t _sec_to_ms(uint32_t sec)
     }
 }
 
+/* transit information option of the targets starting at opt, if there is
+ * one */
+static gnrc_rpl_opt_transit_t *_dao_targets_transit(gnrc_rpl_opt_t *opt,
+                                                    uint16_t len)
+{
+    uint16_t l = 0;
+
+    while (l < len) {
+        if (opt->type == GNRC_RPL_OPT_TRANSIT) {
+            return (gnrc_rpl_opt_transit_t *)opt;
+        }
+        if (opt->type == GNRC_RPL_OPT_PAD1) {
+            l += 1;
+            opt = (gnrc_rpl_opt_t *) (((uint8_t *) opt) + 1);
+            continue;
+        }
+        l += opt->length + sizeof(gnrc_rpl_opt_t);
+        opt = (gnrc_rpl_opt_t *) (((uint8_t *) (opt + 1)) + opt->length);
+    }
+    return NULL;
+}
+
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+static void _dao_targets_add_to_graph(gnrc_rpl_dodag_t *dodag,
+                                      const gnrc_ipv6_nib_ft_dst_t *targets,
+                                      unsigned numof,
+                                      const gnrc_rpl_opt_transit_t *transit)
+{
+    ipv6_addr_t parent;
+
+    if ((transit == NULL) ||
+        (transit->length < (GNRC_RPL_OPT_TRANSIT_INFO_LEN + sizeof(parent)))) {
+        DEBUG("RPL: targets without parent address in non-storing mode\n");
+        return;
+    }
+    /* option is not necessarily aligned */
+    memcpy(&parent, transit + 1, sizeof(parent));
+    for (unsigned i = 0; i < numof; i++) {
+        if ((targets[i].dst_len != IPV6_ADDR_BIT_LEN) ||
+            (gnrc_rpl_srh_root_update(targets[i].dst, &parent,
+                                      transit->path_lifetime *
+                                      dodag->lifetime_unit) < 0)) {
+            DEBUG("RPL: could not add %s to the parent graph\n",
+                  ipv6_addr_to_str(addr_str, targets[i].dst,
+                                   sizeof(addr_str)));
+        }
+    }
+}
+#else
+/* checks if the parent address of a transit information option is one of
+ * this node's addresses */
+static bool _dao_transit_parent_is_me(const gnrc_rpl_opt_transit_t *transit)
+{
+    ipv6_addr_t parent;
+
+    if ((transit == NULL) ||
+        (transit->length < (GNRC_RPL_OPT_TRANSIT_INFO_LEN + sizeof(parent)))) {
+        return false;
+    }
+    /* option is not necessarily aligned */
+    memcpy(&parent, transit + 1, sizeof(parent));
+    return gnrc_netif_get_by_ipv6_addr(&parent) != NULL;
+}
+#endif
+
+static void _dao_targets_install(gnrc_rpl_instance_t *inst, ipv6_addr_t *src,
+                                 const gnrc_ipv6_nib_ft_dst_t *targets,
+                                 unsigned numof,
+                                 const gnrc_rpl_opt_transit_t *transit)
+{
+    gnrc_rpl_dodag_t *dodag = &inst->dodag;
+    uint8_t lifetime = (transit != NULL) ? transit->path_lifetime
+                                         : dodag->default_lifetime;
+
+    if (numof == 0) {
+        return;
+    }
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+    /* the root of a non-storing mode DODAG source routes to the targets
+     * instead of keeping a route for each of them */
+    if (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        _dao_targets_add_to_graph(dodag, targets, numof, transit);
+        return;
+    }
+#else
+    /* without a parent graph, the root of a non-storing mode DODAG can only
+     * route to its children, which are neighbors, directly */
+    if ((inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+        !_dao_transit_parent_is_me(transit)) {
+        DEBUG("RPL: ignoring targets not adjacent to the root, use "
+              "gnrc_rpl_srh_root to source route to them\n");
+        return;
+    }
+#endif
+    DEBUG("RPL: adding %u FT entries via %s\n", numof,
+          ipv6_addr_to_str(addr_str, src, sizeof(addr_str)));
+    if (gnrc_ipv6_nib_ft_add_multi(targets, numof, src, dodag->iface,
+                                   lifetime * dodag->lifetime_unit) < 0) {
+        DEBUG("RPL: could not add all FT entries\n");
+    }
+}
+
 /** @todo allow target prefixes in target options to be of variable length */
 bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt, uint16_t len,
                     ipv6_addr_t *src, uint32_t *included_opts)
 {
     uint16_t l = 0;
     gnrc_rpl_opt_target_t *first_target = NULL;
+    gnrc_ipv6_nib_ft_dst_t targets[GNRC_RPL_DAO_TARGETS_BATCH_NUMOF];
+    unsigned targets_numof = 0;
     gnrc_rpl_dodag_t *dodag = &inst->dodag;
     eui64_t iid;
     *included_opts = 0;
@@ -620,14 +728,19 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     first_target = target;
                 }
 
-                DEBUG("RPL: adding FT entry %s/%d\n",
+                DEBUG("RPL: queueing FT entry %s/%d\n",
                       ipv6_addr_to_str(addr_str, &(target->target), (unsigned)sizeof(addr_str)),
                       target->prefix_length);
 
-                gnrc_ipv6_nib_ft_del(&(target->target), target->prefix_length);
-                gnrc_ipv6_nib_ft_add(&(target->target), target->prefix_length, src,
-                                     dodag->iface,
-                                     dodag->default_lifetime * dodag->lifetime_unit);
+                /* routes are installed in batches once the lifetime from the
+                 * following transit information option is known */
+                targets[targets_numof].dst = &target->target;
+                targets[targets_numof].dst_len = target->prefix_length;
+                if (++targets_numof == GNRC_RPL_DAO_TARGETS_BATCH_NUMOF) {
+                    _dao_targets_install(inst, src, targets, targets_numof,
+                                         _dao_targets_transit(opt, len - l));
+                    targets_numof = 0;
+                }
                 break;
 
             case (GNRC_RPL_OPT_TRANSIT):
@@ -640,23 +753,9 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
                     break;
                 }
 
-                do {
-                    DEBUG("RPL: updating FT entry %s/%d\n",
-                          ipv6_addr_to_str(addr_str, &(first_target->target), sizeof(addr_str)),
-                          first_target->prefix_length);
-
-                    gnrc_ipv6_nib_ft_del(&(first_target->target),
-                                         first_target->prefix_length);
-                    gnrc_ipv6_nib_ft_add(&(first_target->target),
-                                         first_target->prefix_length, src,
-                                         dodag->iface,
-                                         transit->path_lifetime * dodag->lifetime_unit);
-
-                    first_target = (gnrc_rpl_opt_target_t *) (((uint8_t *) (first_target)) +
-                                   sizeof(gnrc_rpl_opt_t) + first_target->length);
-                }
-                while (first_target->type == GNRC_RPL_OPT_TARGET);
-
+                _dao_targets_install(inst, src, targets, targets_numof,
+                                     transit);
+                targets_numof = 0;
                 first_target = NULL;
                 break;
 
@@ -669,6 +768,8 @@ bool _parse_options(int msg_type, gnrc_rpl_instance_t *inst, gnrc_rpl_opt_t *opt
         l += opt->length + sizeof(gnrc_rpl_opt_t);
         opt = (gnrc_rpl_opt_t *) (((uint8_t *) (opt + 1)) + opt->length);
     }
+    /* targets without transit information option */
+    _dao_targets_install(inst, src, targets, targets_numof, NULL);
     return true;
 }
 
@@ -936,11 +1037,13 @@ gnrc_pktsnip_t *_dao_target_build(gnrc_pktsnip_t *pkt, ipv6_addr_t *addr, uint8_
     return opt_snip;
 }
 
-gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external)
+gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool external,
+                                   const ipv6_addr_t *parent)
 {
     gnrc_rpl_opt_transit_t *transit;
     gnrc_pktsnip_t *opt_snip;
-    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t),
+    size_t parent_len = (parent != NULL) ? sizeof(ipv6_addr_t) : 0;
+    if ((opt_snip = gnrc_pktbuf_add(pkt, NULL, sizeof(gnrc_rpl_opt_transit_t) + parent_len,
                                GNRC_NETTYPE_UNDEF)) == NULL) {
         DEBUG("RPL: Send DAO - no space left in packet buffer\n");
         gnrc_pktbuf_release(pkt);
@@ -954,6 +1057,10 @@ gnrc_pktsnip_t *_dao_transit_build(gnrc_pktsnip_t *pkt, uint8_t lifetime, bool e
     transit->path_control = 0;
     transit->path_sequence = 0;
     transit->path_lifetime = lifetime;
+    if (parent != NULL) {
+        transit->length += parent_len;
+        memcpy(transit + 1, parent, parent_len);
+    }
     return opt_snip;
 }
 
@@ -972,6 +1079,9 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
         return;
     }
 
+    /* in non-storing mode DAOs are sent to the root directly */
+    bool non_storing = (inst->mop == GNRC_RPL_MOP_NON_STORING_MODE);
+
 #ifdef MODULE_GNRC_RPL_P2P
     if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
         return;
@@ -984,7 +1094,7 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
             return;
         }
 
-        destination = &(dodag->parents->addr);
+        destination = (non_storing) ? &dodag->dodag_id : &(dodag->parents->addr);
     }
 
     gnrc_pktsnip_t *pkt = NULL, *tmp = NULL;
@@ -1006,10 +1116,10 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
     /* TODO: nib: dropped support for external transit options for now */
     void *ft_state = NULL;
     gnrc_ipv6_nib_ft_t fte;
-    while(gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
+    while(!non_storing && gnrc_ipv6_nib_ft_iter(NULL, dodag->iface, &ft_state, &fte)) {
         DEBUG("RPL: Send DAO - building transit option\n");
 
-        if ((pkt = _dao_transit_build(pkt, lifetime, false)) == NULL) {
+        if ((pkt = _dao_transit_build(pkt, lifetime, false, NULL)) == NULL) {
             DEBUG("RPL: Send DAO - no space left in packet buffer\n");
             return;
         }
@@ -1025,6 +1135,25 @@ void gnrc_rpl_send_DAO(gnrc_rpl_instance_t *inst, ipv6_addr_t *destination, uint
         }
     }
 
+    if (non_storing) {
+        ipv6_addr_t parent;
+
+        if (dodag->parents == NULL) {
+            DEBUG("RPL: dodag has no preferred parent\n");
+            return;
+        }
+        /* the global address of the parent is assumed to be formed from the
+         * DODAG prefix, just as our own */
+        ipv6_addr_init_prefix(&parent, &dodag->dodag_id, 64);
+        ipv6_addr_init_iid(&parent, &dodag->parents->addr.u8[8], 64);
+        DEBUG("RPL: Send DAO - building transit option with parent %s\n",
+              ipv6_addr_to_str(addr_str, &parent, sizeof(addr_str)));
+        if ((pkt = _dao_transit_build(pkt, lifetime, false, &parent)) == NULL) {
+            DEBUG("RPL: Send DAO - no space left in packet buffer\n");
+            return;
+        }
+    }
+
     /* add own address */
     DEBUG("RPL: Send DAO - building target %s/128\n",
           ipv6_addr_to_str(addr_str, me, sizeof(addr_str)));
@@ -1180,6 +1309,12 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
         return;
     }
 
+    /* in non-storing mode DAOs are addressed to the root only */
+    if ((inst->mop == GNRC_RPL_MOP_NON_STORING_MODE) &&
+        (dodag->node_status != GNRC_RPL_ROOT_NODE)) {
+        return;
+    }
+
 #ifdef MODULE_GNRC_RPL_P2P
     if (dodag->instance->mop == GNRC_RPL_P2P_MOP) {
         return;
@@ -1197,14 +1332,17 @@ void gnrc_rpl_recv_DAO(gnrc_rpl_dao_t *dao, kernel_pid_t iface, ipv6_addr_t *src
         gnrc_rpl_send_DAO_ACK(inst, src, dao->dao_sequence);
     }
 
-    gnrc_rpl_delay_dao(dodag);
+    /* the root does not send DAOs, so there is no need to reschedule them
+     * for every DAO it receives */
+    if (dodag->node_status != GNRC_RPL_ROOT_NODE) {
+        gnrc_rpl_delay_dao(dodag);
+    }
 }
 
 void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6_addr_t *src,
                            ipv6_addr_t *dst, uint16_t len)
 {
     (void)iface;
-    (void)src;
     (void)dst;
     (void)len;
 
@@ -1243,6 +1381,16 @@ void gnrc_rpl_recv_DAO_ACK(gnrc_rpl_dao_ack_t *dao_ack, kernel_pid_t iface, ipv6
         return;
     }
 
+    /* in storing mode the DAO-ACK comes from the preferred parent, so the
+     * number of DAO transmissions it took is a sample of the link's ETX */
+    if (!dodag->dao_ack_received && (dodag->dao_counter > 0) &&
+        ((inst->mop == GNRC_RPL_MOP_STORING_MODE_NO_MC) ||
+         (inst->mop == GNRC_RPL_MOP_STORING_MODE_MC)) &&
+        (dodag->parents != NULL) &&
+        ipv6_addr_equal(src, &dodag->parents->addr)) {
+        gnrc_rpl_parent_etx_update(dodag->parents, dodag->dao_counter, true);
+    }
+
     dodag->dao_ack_received = true;
     gnrc_rpl_long_delay_dao(dodag);
 }
@@ -33,12 +33,38 @@
 #include "net/gnrc/rpl/p2p_dodag.h"
 #endif
 
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+#include "net/gnrc/rpl/srh.h"
+#endif
+
 #define ENABLE_DEBUG    (0)
 #include "debug.h"
 
 static char addr_str[IPV6_ADDR_MAX_STR_LEN];
 
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag);
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *changed);
+static gnrc_rpl_parent_t *_best_parent(gnrc_rpl_dodag_t *dodag);
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+/* take the ETX of the link to parent from the link-layer statistics, which
+ * account every frame sent to the parent */
+static bool _parent_etx_from_l2(gnrc_rpl_parent_t *parent)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(parent->dodag->iface);
+    netstats_nb_t stats;
+
+    if ((netif == NULL) ||
+        (gnrc_netif_ipv6_nb_stats(netif, &parent->addr, &stats) < 0) ||
+        (stats.etx == 0)) {
+        return false;
+    }
+    parent->link_metric = ((uint32_t)stats.etx * GNRC_RPL_ETX_DIVISOR) /
+                          NETSTATS_NB_ETX_DIVISOR;
+    parent->link_metric_type = GNRC_RPL_LINK_METRIC_ETX;
+    return true;
+}
+#endif
 
 static void _rpl_trickle_send_dio(void *args)
 {
@@ -90,6 +116,7 @@ bool gnrc_rpl_instance_add(uint8_t instance_id, gnrc_rpl_instance_t **inst)
         (*inst)->max_rank_inc = GNRC_RPL_DEFAULT_MAX_RANK_INCREASE;
         (*inst)->min_hop_rank_inc = GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE;
         (*inst)->dodag.parents = NULL;
+        (*inst)->dodag.preferred = NULL;
         (*inst)->cleanup_event.msg.content.ptr = (*inst);
         return true;
     }
@@ -211,6 +238,7 @@ bool gnrc_rpl_parent_add_by_addr(gnrc_rpl_dodag_t *dodag, ipv6_addr_t *addr,
         (*parent)->state = GNRC_RPL_PARENT_ACTIVE;
         (*parent)->addr = *addr;
         (*parent)->rank = GNRC_RPL_INFINITE_RANK;
+        (*parent)->link_metric = 0;
         evtimer_del((evtimer_t *)(&gnrc_rpl_evtimer), (evtimer_event_t *)(&(*parent)->timeout_event));
         ((evtimer_event_t *)(&(*parent)->timeout_event))->next = NULL;
         (*parent)->timeout_event.msg.type = GNRC_RPL_MSG_TYPE_PARENT_TIMEOUT;
@@ -229,18 +257,28 @@ bool gnrc_rpl_parent_remove(gnrc_rpl_parent_t *parent)
     assert(parent != NULL);
 
     gnrc_rpl_dodag_t *dodag = parent->dodag;
+    bool preferred = (parent == dodag->parents);
 
-    if (parent == dodag->parents) {
+    LL_DELETE(dodag->parents, parent);
+    if (preferred) {
         gnrc_ipv6_nib_ft_del(NULL, 0);
-
-        /* set the default route to the next parent for now */
-        if (parent->next) {
+        /* no hysteresis in favor of whichever parent is the list head now */
+        dodag->preferred = NULL;
+
+        /* set the default route to the best of the remaining parents for now */
+        if (dodag->parents) {
+            gnrc_rpl_parent_t *best = _best_parent(dodag);
+
+            if (best != dodag->parents) {
+                LL_DELETE(dodag->parents, best);
+                LL_PREPEND(dodag->parents, best);
+            }
+            dodag->preferred = best;
             gnrc_ipv6_nib_ft_add(NULL, 0,
-                                 &parent->next->addr, dodag->iface,
+                                 &best->addr, dodag->iface,
                                  dodag->default_lifetime * dodag->lifetime_unit * MS_PER_SEC);
         }
     }
-    LL_DELETE(dodag->parents, parent);
     evtimer_del((evtimer_t *)(&gnrc_rpl_evtimer), (evtimer_event_t *)&parent->timeout_event);
     memset(parent, 0, sizeof(gnrc_rpl_parent_t));
     return true;
@@ -286,26 +324,99 @@ void gnrc_rpl_parent_update(gnrc_rpl_dodag_t *dodag, gnrc_rpl_parent_t *parent)
         }
 #ifdef MODULE_GNRC_RPL_P2P
         }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+        _parent_etx_from_l2(parent);
 #endif
     }
 
-    if (_gnrc_rpl_find_preferred_parent(dodag) == NULL) {
+    if (_gnrc_rpl_find_preferred_parent(dodag, parent) == NULL) {
         gnrc_rpl_local_repair(dodag);
     }
 }
 
+void gnrc_rpl_parent_etx_update(gnrc_rpl_parent_t *parent, unsigned attempts,
+                                bool success)
+{
+    uint32_t sample;
+
+    assert(parent != NULL);
+    if (parent->state == GNRC_RPL_PARENT_UNUSED) {
+        return;
+    }
+#ifdef MODULE_NETSTATS_NEIGHBOR
+    /* per-frame link-layer statistics are more accurate than end-to-end
+     * samples, only fall back to the latter without them */
+    if (_parent_etx_from_l2(parent)) {
+        goto out;
+    }
+#endif
+    if (!success || (attempts > GNRC_RPL_ETX_NOACK_PENALTY)) {
+        attempts = GNRC_RPL_ETX_NOACK_PENALTY;
+    }
+    sample = attempts * GNRC_RPL_ETX_DIVISOR;
+    if (sample < GNRC_RPL_ETX_DIVISOR) {
+        sample = GNRC_RPL_ETX_DIVISOR;
+    }
+    if (parent->link_metric == 0) {
+        parent->link_metric = sample;
+    }
+    else {
+        parent->link_metric = ((parent->link_metric * GNRC_RPL_ETX_ALPHA) +
+                               (sample * (100U - GNRC_RPL_ETX_ALPHA))) / 100U;
+    }
+    parent->link_metric_type = GNRC_RPL_LINK_METRIC_ETX;
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+out:
+#endif
+    if (_gnrc_rpl_find_preferred_parent(parent->dodag, parent) == NULL) {
+        gnrc_rpl_local_repair(parent->dodag);
+    }
+}
+
+/**
+ * @brief   Find the best parent of a DODAG according to its objective function
+ *
+ * The current preferred parent is the initial candidate, so objective
+ * functions with hysteresis keep it unless another parent is sufficiently
+ * better.
+ *
+ * @param[in] dodag     Pointer to the DODAG. Must have at least one parent.
+ *
+ * @return  Pointer to the best parent.
+ */
+static gnrc_rpl_parent_t *_best_parent(gnrc_rpl_dodag_t *dodag)
+{
+    gnrc_rpl_parent_t *best = dodag->parents;
+    gnrc_rpl_parent_t *elt = NULL;
+
+    LL_FOREACH(dodag->parents->next, elt) {
+        if (dodag->instance->of->parent_cmp(elt, best) < 0) {
+            best = elt;
+        }
+    }
+    return best;
+}
+
 /**
- * @brief   Find the parent with the lowest rank and update the DODAG's preferred parent
+ * @brief   Update the DODAG's preferred parent after a parent changed
+ *
+ * The head of the parent list is always the preferred parent. The rest of the
+ * list is unordered, so only the parent that changed needs to be compared to
+ * the preferred parent, unless the preferred parent itself changed.
  *
  * @param[in] dodag     Pointer to the DODAG
+ * @param[in] changed   Parent that changed. NULL, if unknown.
  *
  * @return  Pointer to the preferred parent, on success.
  * @return  NULL, otherwise.
  */
-static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag)
+static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *dodag,
+                                                          gnrc_rpl_parent_t *changed)
 {
     gnrc_rpl_parent_t *old_best = dodag->parents;
-    gnrc_rpl_parent_t *new_best;
+    gnrc_rpl_parent_t *new_best = old_best;
     uint16_t old_rank = dodag->my_rank;
     gnrc_rpl_parent_t *elt = NULL;
     gnrc_rpl_parent_t *tmp = NULL;
@@ -314,8 +425,22 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
         return NULL;
     }
 
-    LL_SORT(dodag->parents, dodag->instance->of->parent_cmp);
-    new_best = dodag->parents;
+    /* the head is not the preferred parent yet if none was selected since
+     * the preferred parent was removed */
+    if ((changed == NULL) || (changed == old_best) ||
+        (old_best != dodag->preferred)) {
+        new_best = _best_parent(dodag);
+    }
+    else if ((changed->state != GNRC_RPL_PARENT_UNUSED) &&
+             (dodag->instance->of->parent_cmp(changed, old_best) < 0)) {
+        new_best = changed;
+    }
+
+    if (new_best != old_best) {
+        LL_DELETE(dodag->parents, new_best);
+        LL_PREPEND(dodag->parents, new_best);
+    }
+    dodag->preferred = new_best;
 
     if (new_best->rank == GNRC_RPL_INFINITE_RANK) {
         return NULL;
@@ -342,16 +467,30 @@ static gnrc_rpl_parent_t *_gnrc_rpl_find_preferred_parent(gnrc_rpl_dodag_t *doda
     }
 
     dodag->my_rank = dodag->instance->of->calc_rank(dodag, 0);
+    if (dodag->my_rank == GNRC_RPL_INFINITE_RANK) {
+        return NULL;
+    }
     if (dodag->my_rank != old_rank) {
         trickle_reset_timer(&dodag->trickle);
     }
 
-    LL_FOREACH_SAFE(dodag->parents, elt, tmp) {
-        if (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc)
-            <= DAGRANK(elt->rank, dodag->instance->min_hop_rank_inc)) {
-            gnrc_rpl_parent_remove(elt);
+    /* parents that are not ranked lower than this node anymore can only have
+     * appeared if this node's rank or preferred parent changed; otherwise
+     * only the changed parent needs to be checked */
+    if ((dodag->my_rank != old_rank) || (new_best != old_best)) {
+        LL_FOREACH_SAFE(dodag->parents, elt, tmp) {
+            if (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc)
+                <= DAGRANK(elt->rank, dodag->instance->min_hop_rank_inc)) {
+                gnrc_rpl_parent_remove(elt);
+            }
         }
     }
+    else if ((changed != NULL) && (changed != dodag->parents) &&
+             (changed->state != GNRC_RPL_PARENT_UNUSED) &&
+             (DAGRANK(dodag->my_rank, dodag->instance->min_hop_rank_inc)
+              <= DAGRANK(changed->rank, dodag->instance->min_hop_rank_inc))) {
+        gnrc_rpl_parent_remove(changed);
+    }
 
     return dodag->parents;
 }
@@ -404,6 +543,12 @@ gnrc_rpl_instance_t *gnrc_rpl_root_instance_init(uint8_t instance_id, ipv6_addr_
     dodag = &inst->dodag;
     dodag->instance = inst;
 
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+    if (mop == GNRC_RPL_MOP_NON_STORING_MODE) {
+        gnrc_rpl_srh_root_init(dodag_id, netif->pid);
+    }
+#endif
+
     return inst;
 }
 
@@ -0,0 +1,384 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ * @brief   Parent graph and source routing header cache of a non-storing
+ *          mode DODAG root
+ */
+
+#ifdef MODULE_GNRC_RPL_SRH_ROOT
+
+#include <errno.h>
+#include <string.h>
+
+#include "byteorder.h"
+#include "mutex.h"
+#include "net/eui64.h"
+#include "net/gnrc/ipv6/nib/ft.h"
+#include "net/gnrc/netif/internal.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/protnum.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+static char addr_str[IPV6_ADDR_MAX_STR_LEN];
+
+#if GNRC_RPL_SRH_ROOT_NODES_NUMOF >= (UINT16_MAX - 1)
+#error "GNRC_RPL_SRH_ROOT_NODES_NUMOF must be smaller than UINT16_MAX - 1"
+#endif
+
+#if (GNRC_RPL_SRH_ROOT_HOPS_MAX < 2) || (GNRC_RPL_SRH_ROOT_HOPS_MAX > 31)
+#error "GNRC_RPL_SRH_ROOT_HOPS_MAX must be between 2 and 31"
+#endif
+
+#define _PFX_LEN        (8U)    /* the DODAG prefix is a /64 */
+#define _IID_LEN        (sizeof(ipv6_addr_t) - _PFX_LEN)
+#define _IDX_NONE       (UINT16_MAX)
+#define _IDX_ROOT       (UINT16_MAX - 1)
+/* at least the prefix is elided from every address */
+#define _SRH_MAX_LEN    (sizeof(gnrc_rpl_srh_t) + \
+                         ((GNRC_RPL_SRH_ROOT_HOPS_MAX - 1) * _IID_LEN))
+
+typedef struct {
+    uint8_t iid[_IID_LEN];  /* the prefix is the one of the DODAG ID */
+    uint32_t expires;       /* in seconds, 0 for unused entries */
+    uint16_t parent;        /* parent index, _IDX_ROOT, or _IDX_NONE */
+    uint16_t next;          /* next entry in the same hash bucket */
+} _node_t;
+
+typedef struct {
+    uint32_t expires;       /* earliest expiry of a node on the path */
+    uint16_t node;          /* destination node, _IDX_NONE for empty */
+    uint16_t gen;           /* generation of the graph the entry was built for */
+    uint8_t first_hop[_IID_LEN];
+    uint8_t len;
+    uint8_t hdr[_SRH_MAX_LEN];
+} _cache_t;
+
+static mutex_t _mutex = MUTEX_INIT;
+static ipv6_addr_t _dodag_id;
+static eui64_t _root_iid;
+static kernel_pid_t _iface = KERNEL_PID_UNDEF;
+/* increased whenever a link in the graph changes to invalidate the cache */
+static uint16_t _gen;
+static _node_t _nodes[GNRC_RPL_SRH_ROOT_NODES_NUMOF];
+static uint16_t _buckets[GNRC_RPL_SRH_ROOT_BUCKETS_NUMOF];
+static _cache_t _cache[GNRC_RPL_SRH_ROOT_CACHE_NUMOF];
+
+static inline uint32_t _now(void)
+{
+    /* offset by one so 0 never denotes a valid expiry */
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC) + 1;
+}
+
+static inline bool _in_prefix(const ipv6_addr_t *addr)
+{
+    return memcmp(addr, &_dodag_id, _PFX_LEN) == 0;
+}
+
+static inline unsigned _hash(const uint8_t *iid)
+{
+    unsigned h = 0;
+
+    for (unsigned i = 0; i < _IID_LEN; i++) {
+        h = (h * 31) + iid[i];
+    }
+    return h % GNRC_RPL_SRH_ROOT_BUCKETS_NUMOF;
+}
+
+static void _addr_from_iid(ipv6_addr_t *addr, const uint8_t *iid, bool ll)
+{
+    if (ll) {
+        ipv6_addr_set_link_local_prefix(addr);
+    }
+    else {
+        memcpy(addr, &_dodag_id, _PFX_LEN);
+    }
+    memcpy(&addr->u8[_PFX_LEN], iid, _IID_LEN);
+}
+
+static uint16_t _find(const uint8_t *iid)
+{
+    for (uint16_t i = _buckets[_hash(iid)]; i != _IDX_NONE;
+         i = _nodes[i].next) {
+        if (memcmp(_nodes[i].iid, iid, _IID_LEN) == 0) {
+            return i;
+        }
+    }
+    return _IDX_NONE;
+}
+
+static void _remove(uint16_t idx)
+{
+    _node_t *node = &_nodes[idx];
+    uint16_t *ptr = &_buckets[_hash(node->iid)];
+
+    DEBUG("RPL SRH root: removing node %u\n", (unsigned)idx);
+    while (*ptr != idx) {
+        ptr = &_nodes[*ptr].next;
+    }
+    *ptr = node->next;
+    if (node->parent == _IDX_ROOT) {
+        ipv6_addr_t addr;
+
+        _addr_from_iid(&addr, node->iid, false);
+        gnrc_ipv6_nib_ft_del(&addr, IPV6_ADDR_BIT_LEN);
+    }
+    node->expires = 0;
+    /* orphaned children become unreachable until they report a new parent */
+    for (unsigned i = 0; i < GNRC_RPL_SRH_ROOT_NODES_NUMOF; i++) {
+        if ((_nodes[i].expires != 0) && (_nodes[i].parent == idx)) {
+            _nodes[i].parent = _IDX_NONE;
+        }
+    }
+    _gen++;
+}
+
+static uint16_t _get_or_add(const uint8_t *iid, uint32_t expires)
+{
+    uint32_t now = _now();
+    uint16_t idx = _find(iid);
+
+    if (idx != _IDX_NONE) {
+        return idx;
+    }
+    for (idx = 0; idx < GNRC_RPL_SRH_ROOT_NODES_NUMOF; idx++) {
+        if ((_nodes[idx].expires != 0) && (_nodes[idx].expires <= now)) {
+            _remove(idx);
+        }
+        if (_nodes[idx].expires == 0) {
+            _node_t *node = &_nodes[idx];
+            unsigned bucket = _hash(iid);
+
+            memcpy(node->iid, iid, _IID_LEN);
+            node->expires = expires;
+            node->parent = _IDX_NONE;
+            node->next = _buckets[bucket];
+            _buckets[bucket] = idx;
+            return idx;
+        }
+    }
+    return _IDX_NONE;
+}
+
+static bool _is_root(const ipv6_addr_t *addr)
+{
+    return ipv6_addr_equal(addr, &_dodag_id) ||
+           (_in_prefix(addr) &&
+            (memcmp(&addr->u8[_PFX_LEN], _root_iid.uint8, _IID_LEN) == 0));
+}
+
+/* walks the graph from the destination to the root once to fill a cache
+ * entry */
+static bool _cache_fill(_cache_t *entry, uint16_t dst)
+{
+    uint16_t path[GNRC_RPL_SRH_ROOT_HOPS_MAX];
+    uint32_t now = _now(), expires = UINT32_MAX;
+    unsigned hops = 0, cmpr = _IID_LEN, addr_len, pad;
+    gnrc_rpl_srh_t *rh = (gnrc_rpl_srh_t *)entry->hdr;
+    uint8_t *addr_vec = (uint8_t *)(rh + 1);
+
+    for (uint16_t i = dst; i != _IDX_ROOT; i = _nodes[i].parent) {
+        if ((i == _IDX_NONE) || (hops == GNRC_RPL_SRH_ROOT_HOPS_MAX)) {
+            DEBUG("RPL SRH root: no complete path to node %u\n",
+                  (unsigned)dst);
+            return false;
+        }
+        if (_nodes[i].expires <= now) {
+            _remove(i);
+            return false;
+        }
+        if (_nodes[i].expires < expires) {
+            expires = _nodes[i].expires;
+        }
+        path[hops++] = i;
+    }
+    /* elide the octets of the interface identifiers all addresses on the
+     * path share, as every one of them becomes destination address once */
+    for (unsigned i = 1; i < hops; i++) {
+        unsigned j = 0;
+
+        while ((j < cmpr) &&
+               (_nodes[path[i]].iid[j] == _nodes[path[0]].iid[j])) {
+            j++;
+        }
+        cmpr = j;
+    }
+    addr_len = _IID_LEN - cmpr;
+    pad = (8 - (((hops - 1) * addr_len) % 8)) % 8;
+    rh->nh = PROTNUM_RESERVED;
+    rh->len = (((hops - 1) * addr_len) + pad) / 8;
+    rh->type = IPV6_EXT_RH_TYPE_RPL_SRH;
+    rh->seg_left = hops - 1;
+    rh->compr = ((_PFX_LEN + cmpr) << 4) | (_PFX_LEN + cmpr);
+    rh->pad_resv = pad << 4;
+    rh->resv = 0;
+    /* path is ordered from the destination upwards, the SRH from the second
+     * hop downwards */
+    for (unsigned i = 0; i < (hops - 1); i++) {
+        memcpy(&addr_vec[i * addr_len], &_nodes[path[hops - 2 - i]].iid[cmpr],
+               addr_len);
+    }
+    memset(&addr_vec[(hops - 1) * addr_len], 0, pad);
+    memcpy(entry->first_hop, _nodes[path[hops - 1]].iid, _IID_LEN);
+    entry->len = sizeof(gnrc_rpl_srh_t) + (rh->len * 8);
+    entry->expires = expires;
+    entry->node = dst;
+    entry->gen = _gen;
+    return true;
+}
+
+void gnrc_rpl_srh_root_init(const ipv6_addr_t *dodag_id, kernel_pid_t iface)
+{
+    gnrc_netif_t *netif = gnrc_netif_get_by_pid(iface);
+
+    mutex_lock(&_mutex);
+    memset(_nodes, 0, sizeof(_nodes));
+    memset(_buckets, 0xff, sizeof(_buckets));
+    for (unsigned i = 0; i < GNRC_RPL_SRH_ROOT_CACHE_NUMOF; i++) {
+        _cache[i].node = _IDX_NONE;
+    }
+    memcpy(&_dodag_id, dodag_id, sizeof(_dodag_id));
+    if ((netif == NULL) || (gnrc_netif_ipv6_get_iid(netif, &_root_iid) < 0)) {
+        memcpy(_root_iid.uint8, &dodag_id->u8[_PFX_LEN], _IID_LEN);
+    }
+    _iface = iface;
+    _gen = 0;
+    mutex_unlock(&_mutex);
+}
+
+int gnrc_rpl_srh_root_update(const ipv6_addr_t *target,
+                             const ipv6_addr_t *parent, uint32_t lifetime)
+{
+    uint16_t idx, parent_idx = _IDX_ROOT;
+    uint32_t expires;
+    int res = 0;
+
+    if (!_in_prefix(target)) {
+        return -ENOTSUP;
+    }
+    if (!_in_prefix(parent)) {
+        return -EINVAL;
+    }
+    DEBUG("RPL SRH root: %s ", ipv6_addr_to_str(addr_str, target,
+                                                sizeof(addr_str)));
+    DEBUG("has parent %s (lifetime %lu)\n",
+          ipv6_addr_to_str(addr_str, parent, sizeof(addr_str)),
+          (unsigned long)lifetime);
+    mutex_lock(&_mutex);
+    if (lifetime == 0) {
+        if ((idx = _find(&target->u8[_PFX_LEN])) != _IDX_NONE) {
+            _remove(idx);
+        }
+        goto out;
+    }
+    expires = _now() + lifetime;
+    if ((idx = _get_or_add(&target->u8[_PFX_LEN], expires)) == _IDX_NONE) {
+        DEBUG("RPL SRH root: parent graph is full\n");
+        res = -ENOMEM;
+        goto out;
+    }
+    /* refresh before adding the parent, which may purge expired nodes */
+    _nodes[idx].expires = expires;
+    if (!_is_root(parent) &&
+        ((parent_idx = _get_or_add(&parent->u8[_PFX_LEN],
+                                   expires)) == _IDX_NONE)) {
+        DEBUG("RPL SRH root: parent graph is full\n");
+        res = -ENOMEM;
+        goto out;
+    }
+    if (_nodes[idx].parent != parent_idx) {
+        if (_nodes[idx].parent == _IDX_ROOT) {
+            gnrc_ipv6_nib_ft_del(target, IPV6_ADDR_BIT_LEN);
+        }
+        _nodes[idx].parent = parent_idx;
+        _gen++;
+    }
+    if (parent_idx == _IDX_ROOT) {
+        ipv6_addr_t next_hop;
+
+        /* children of the root are the first hop of every source route, so
+         * the NIB needs to know how to reach them */
+        _addr_from_iid(&next_hop, &target->u8[_PFX_LEN], true);
+        if (gnrc_ipv6_nib_ft_add(target, IPV6_ADDR_BIT_LEN, &next_hop, _iface,
+                                 (lifetime > UINT16_MAX) ? UINT16_MAX
+                                                         : lifetime) < 0) {
+            DEBUG("RPL SRH root: unable to add FT entry for child\n");
+            res = -ENOMEM;
+        }
+    }
+out:
+    mutex_unlock(&_mutex);
+    return res;
+}
+
+gnrc_pktsnip_t *gnrc_rpl_srh_root_build(const gnrc_pktsnip_t *ipv6,
+                                        ipv6_addr_t *first_hop)
+{
+    const ipv6_hdr_t *hdr = ipv6->data;
+    gnrc_pktsnip_t *srh = NULL;
+    _cache_t *entry;
+    uint16_t idx;
+
+    if ((_iface == KERNEL_PID_UNDEF) || !_in_prefix(&hdr->dst) ||
+        (hdr->nh == PROTNUM_IPV6_EXT_HOPOPT) ||
+        (hdr->nh == PROTNUM_IPV6_EXT_RH) ||
+        ((ipv6->next != NULL) && (ipv6->next->type == GNRC_NETTYPE_IPV6_EXT))) {
+        return NULL;
+    }
+    mutex_lock(&_mutex);
+    idx = _find(&hdr->dst.u8[_PFX_LEN]);
+    if ((idx == _IDX_NONE) || (_nodes[idx].parent == _IDX_ROOT)) {
+        goto out;
+    }
+    entry = &_cache[idx % GNRC_RPL_SRH_ROOT_CACHE_NUMOF];
+    if ((entry->node != idx) || (entry->gen != _gen) ||
+        (entry->expires <= _now())) {
+        DEBUG("RPL SRH root: cache miss for %s\n",
+              ipv6_addr_to_str(addr_str, &hdr->dst, sizeof(addr_str)));
+        if (!_cache_fill(entry, idx)) {
+            entry->node = _IDX_NONE;
+            goto out;
+        }
+    }
+    if ((srh = gnrc_pktbuf_add(NULL, entry->hdr, entry->len,
+                               GNRC_NETTYPE_IPV6_EXT)) == NULL) {
+        DEBUG("RPL SRH root: no space left in packet buffer\n");
+        goto out;
+    }
+    _addr_from_iid(first_hop, entry->first_hop, false);
+out:
+    mutex_unlock(&_mutex);
+    return srh;
+}
+
+void gnrc_rpl_srh_root_insert(gnrc_pktsnip_t *ipv6, gnrc_pktsnip_t *srh,
+                              const ipv6_addr_t *first_hop)
+{
+    ipv6_hdr_t *hdr = ipv6->data;
+    gnrc_rpl_srh_t *rh = srh->data;
+
+    rh->nh = hdr->nh;
+    hdr->nh = PROTNUM_IPV6_EXT_RH;
+    hdr->len = byteorder_htons(byteorder_ntohs(hdr->len) + srh->size);
+    memcpy(&hdr->dst, first_hop, sizeof(hdr->dst));
+    srh->next = ipv6->next;
+    ipv6->next = srh;
+}
+#else
+typedef int dont_be_pedantic;
+#endif /* MODULE_GNRC_RPL_SRH_ROOT */
+
+/** @} */
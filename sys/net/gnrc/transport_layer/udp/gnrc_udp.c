@@ -220,13 +220,34 @@ static void _send(gnrc_pktsnip_t *pkt)
     }
 }
 
+#ifdef MODULE_GNRC_RX_DIRECT
+static void _rx_direct(uint16_t cmd, gnrc_pktsnip_t *pkt, void *ctx)
+{
+    (void)ctx;
+    /* receiving keeps no state, so it can run in the context of the network
+     * layer; sending stays in the UDP thread */
+    if (cmd == GNRC_NETAPI_MSG_TYPE_RCV) {
+        _receive(pkt);
+    }
+    else if (_gnrc_netapi_send_recv(_pid, pkt, cmd) < 1) {
+        gnrc_pktbuf_release(pkt);
+    }
+}
+#endif
+
 static void *_event_loop(void *arg)
 {
     (void)arg;
     msg_t msg, reply;
     msg_t msg_queue[GNRC_UDP_MSG_QUEUE_SIZE];
+#ifdef MODULE_GNRC_RX_DIRECT
+    static gnrc_netreg_entry_cbd_t rx_direct_cbd = { .cb = _rx_direct };
+    gnrc_netreg_entry_t netreg = GNRC_NETREG_ENTRY_INIT_CB(GNRC_NETREG_DEMUX_CTX_ALL,
+                                                           &rx_direct_cbd);
+#else
     gnrc_netreg_entry_t netreg = GNRC_NETREG_ENTRY_INIT_PID(GNRC_NETREG_DEMUX_CTX_ALL,
                                                             sched_active_pid);
+#endif
     /* preset reply message */
     reply.type = GNRC_NETAPI_MSG_TYPE_ACK;
     reply.content.value = (uint32_t)-ENOTSUP;
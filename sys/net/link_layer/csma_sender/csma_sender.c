@@ -21,6 +21,7 @@
 #include <assert.h>
 #include <errno.h>
 #include <stdbool.h>
+#include <string.h>
 
 #include "xtimer.h"
 #include "random.h"
@@ -114,24 +115,114 @@ static int send_if_cca(netdev_t *device, iolist_t *iolist)
     return -EBUSY;
 }
 
-/*------------------------- "EXPORTED" FUNCTIONS -------------------------*/
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+/**
+ * @brief Update a moving average rate with a new sample
+ *
+ * The step is rounded away from zero: a truncated step would be 0 once the
+ * average is less than 2^CSMA_SENDER_ADAPTIVE_EWMA_SHIFT away from the
+ * sample, so the average would never reach 0% or 100%.
+ */
+static inline void _rate_update(uint16_t *rate, bool sample)
+{
+    const int round = (1 << CSMA_SENDER_ADAPTIVE_EWMA_SHIFT) - 1;
+    int diff = (sample ? CSMA_SENDER_ADAPTIVE_RATE_SCALE : 0) - *rate;
 
-int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
-                             const csma_sender_conf_t *conf)
+    diff += (diff < 0) ? -round : round;
+    *rate += diff / (1 << CSMA_SENDER_ADAPTIVE_EWMA_SHIFT);
+}
+
+/**
+ * @brief Get the statistics entry of a channel or neighbor, replacing the
+ *        least recently used entry if there is none yet
+ */
+static csma_sender_link_t *_link_get(csma_sender_stats_t *stats,
+                                     csma_sender_link_t *links,
+                                     unsigned numof, uint16_t channel,
+                                     const uint8_t *addr, size_t addr_len)
 {
-    netopt_enable_t hwfeat;
+    csma_sender_link_t *link = &links[0];
+
+    for (unsigned i = 0; i < numof; i++) {
+        if ((links[i].last_used != 0) && (links[i].channel == channel) &&
+            (links[i].addr_len == addr_len) &&
+            ((addr_len == 0) || (memcmp(links[i].addr, addr, addr_len) == 0))) {
+            link = &links[i];
+            goto out;
+        }
+        if (links[i].last_used < link->last_used) {
+            link = &links[i];
+        }
+    }
+    DEBUG("csma: new statistics entry for channel %u\n", (unsigned)channel);
+    memset(link, 0, sizeof(*link));
+    link->channel = channel;
+    if (addr_len > 0) {
+        link->addr_len = addr_len;
+        memcpy(link->addr, addr, addr_len);
+    }
+out:
+    link->last_used = ++stats->uses;
+    return link;
+}
 
-    assert(dev);
-    /* choose default configuration if none is given */
-    if (conf == NULL) {
-        conf = &CSMA_SENDER_CONF_DEFAULT;
+/**
+ * @brief Record the outcome of a CCA
+ */
+static void _cca_done(csma_sender_link_t *chan, csma_sender_link_t *nbr,
+                      bool busy)
+{
+    chan->cnt.cca_count++;
+    chan->cnt.cca_busy += busy;
+    _rate_update(&chan->busy_rate, busy);
+    if (nbr != NULL) {
+        nbr->cnt.cca_count++;
+        nbr->cnt.cca_busy += busy;
+        _rate_update(&nbr->busy_rate, busy);
     }
+}
+
+/**
+ * @brief Choose the initial backoff exponent from the busy rate of the
+ *        channel and the retry rate of the neighbor
+ */
+static int _adapt_be(const csma_sender_conf_t *conf, csma_sender_link_t *chan,
+                     csma_sender_link_t *nbr)
+{
+    unsigned rate = chan->busy_rate;
+
+    if ((nbr != NULL) && (nbr->retry_rate > rate)) {
+        rate = nbr->retry_rate;
+    }
+    chan->be = conf->min_be +
+               ((((conf->max_be - conf->min_be) * rate) +
+                 (CSMA_SENDER_ADAPTIVE_RATE_SCALE / 2)) /
+                CSMA_SENDER_ADAPTIVE_RATE_SCALE);
+    if (nbr != NULL) {
+        nbr->be = chan->be;
+    }
+    return chan->be;
+}
+#else
+#define _cca_done(chan, nbr, busy)  ((void)(chan), (void)(nbr), (void)(busy))
+#endif
+
+/**
+ * @brief Check whether the device does CSMA/CA itself
+ *
+ * @return  1, if the device does CSMA/CA
+ * @return  0, if the device does not do CSMA/CA
+ * @return  -ENODEV or -ECANCELED on error
+ */
+static int hw_csma(netdev_t *dev)
+{
+    netopt_enable_t hwfeat;
+
     /* Does the transceiver do automatic CSMA/CA when sending? */
     int res = dev->driver->get(dev,
                                NETOPT_CSMA,
                                (void *) &hwfeat,
                                sizeof(netopt_enable_t));
-    bool ok = false;
 
     switch (res) {
         case -ENODEV:
@@ -139,36 +230,46 @@ int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
             return -ENODEV;
         case -ENOTSUP:
             /* device doesn't make auto-CSMA/CA */
-            break;
+            return 0;
         case -EOVERFLOW: /* (normally impossible...*/
         case -ECANCELED:
             DEBUG("csma: !!! DEVICE DRIVER FAILURE! TRANSMISSION ABORTED!\n");
             /* internal driver error! */
             return -ECANCELED;
         default:
-            ok = (hwfeat == NETOPT_ENABLE);
+            return (hwfeat == NETOPT_ENABLE);
     }
+}
 
-    if (ok) {
-        /* device does CSMA/CA all by itself: let it do its job */
-        DEBUG("csma: Network device does hardware CSMA/CA\n");
-        return dev->driver->send(dev, iolist);
-    }
+/**
+ * @brief Software CSMA/CA procedure
+ *
+ * @param[in] dev       netdev device, needs to be already initialized
+ * @param[in] iolist    pointer to the data
+ * @param[in] conf      configuration for the backoff
+ * @param[in] be        initial backoff exponent
+ * @param[in] chan      statistics of the channel, may be NULL
+ * @param[in] nbr       statistics of the destination, may be NULL
+ */
+static int sw_csma_ca(netdev_t *dev, iolist_t *iolist,
+                      const csma_sender_conf_t *conf, int be,
+                      csma_sender_link_t *chan, csma_sender_link_t *nbr)
+{
+    int res;
 
-    /* if we arrive here, then we must perform the CSMA/CA procedure
-       ourselves by software */
     random_init(_xtimer_now());
     DEBUG("csma: Starting software CSMA/CA....\n");
 
-    int nb = 0, be = conf->min_be;
-
-    while (nb <= conf->max_be) {
+    for (unsigned nb = 0; nb <= conf->max_backoffs; nb++) {
         /* delay for an adequate random backoff period */
         uint32_t bp = choose_backoff_period(be, conf);
         xtimer_usleep(bp);
 
         /* try to send after a CCA */
         res = send_if_cca(dev, iolist);
+        if (chan && (res != -ECANCELED)) {
+            _cca_done(chan, nbr, (res == -EBUSY));
+        }
         if (res >= 0) {
             /* TX done */
             return res;
@@ -184,7 +285,6 @@ int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
         if (be > conf->max_be) {
             be = conf->max_be;
         }
-        nb++;
         /* ... and try again if we have no exceeded the retry limit */
     }
 
@@ -193,6 +293,114 @@ int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
     return -EBUSY;
 }
 
+/*------------------------- "EXPORTED" FUNCTIONS -------------------------*/
+
+int csma_sender_csma_ca_send(netdev_t *dev, iolist_t *iolist,
+                             const csma_sender_conf_t *conf)
+{
+    assert(dev);
+    /* choose default configuration if none is given */
+    if (conf == NULL) {
+        conf = &CSMA_SENDER_CONF_DEFAULT;
+    }
+
+    int res = hw_csma(dev);
+
+    if (res < 0) {
+        return res;
+    }
+    if (res) {
+        /* device does CSMA/CA all by itself: let it do its job */
+        DEBUG("csma: Network device does hardware CSMA/CA\n");
+        return dev->driver->send(dev, iolist);
+    }
+
+    /* if we arrive here, then we must perform the CSMA/CA procedure
+       ourselves by software */
+    return sw_csma_ca(dev, iolist, conf, conf->min_be, NULL, NULL);
+}
+
+#ifdef MODULE_CSMA_SENDER_ADAPTIVE
+int csma_sender_csma_ca_send_adaptive(netdev_t *dev, iolist_t *iolist,
+                                      const csma_sender_conf_t *conf,
+                                      csma_sender_stats_t *stats,
+                                      const uint8_t *dst, size_t dst_len)
+{
+    csma_sender_link_t *chan, *nbr = NULL;
+    uint16_t channel = 0;
+
+    assert(dev && stats);
+    /* choose default configuration if none is given */
+    if (conf == NULL) {
+        conf = &CSMA_SENDER_CONF_DEFAULT;
+    }
+
+    int res = hw_csma(dev);
+
+    if (res < 0) {
+        return res;
+    }
+    /* channel 0 for devices without channels */
+    dev->driver->get(dev, NETOPT_CHANNEL, &channel, sizeof(channel));
+    chan = _link_get(stats, stats->channels,
+                     CSMA_SENDER_ADAPTIVE_CHANNELS_NUMOF, channel, NULL, 0);
+    if ((dst != NULL) && (dst_len > 0) &&
+        (dst_len <= CSMA_SENDER_ADAPTIVE_L2ADDR_MAX)) {
+        nbr = _link_get(stats, stats->nbrs, CSMA_SENDER_ADAPTIVE_NBRS_NUMOF,
+                        channel, dst, dst_len);
+        nbr->cnt.tx_count++;
+    }
+    chan->cnt.tx_count++;
+    stats->last_channel = chan;
+    stats->last_nbr = nbr;
+    if (res) {
+        /* device does CSMA/CA all by itself, the outcome is only known with
+         * csma_sender_tx_done() */
+        DEBUG("csma: Network device does hardware CSMA/CA\n");
+        return dev->driver->send(dev, iolist);
+    }
+    res = sw_csma_ca(dev, iolist, conf, _adapt_be(conf, chan, nbr), chan, nbr);
+    if (res == -EBUSY) {
+        chan->cnt.access_failed++;
+        if (nbr != NULL) {
+            nbr->cnt.access_failed++;
+        }
+    }
+    return res;
+}
+
+void csma_sender_tx_done(csma_sender_stats_t *stats, int status,
+                         unsigned retries)
+{
+    assert(stats);
+
+    csma_sender_link_t *nbr = stats->last_nbr;
+
+    if (status == -EBUSY) {
+        /* hardware CSMA/CA procedure failed */
+        if (stats->last_channel != NULL) {
+            stats->last_channel->cnt.access_failed++;
+            _rate_update(&stats->last_channel->busy_rate, true);
+        }
+        if (nbr != NULL) {
+            nbr->cnt.access_failed++;
+        }
+        return;
+    }
+    if (nbr == NULL) {
+        return;
+    }
+    if (retries > 0) {
+        nbr->cnt.tx_retried++;
+    }
+    if (status == -EHOSTUNREACH) {
+        nbr->cnt.tx_noack++;
+    }
+    _rate_update(&nbr->retry_rate,
+                 (retries > 0) || (status == -EHOSTUNREACH));
+}
+#endif
+
 
 int csma_sender_cca_send(netdev_t *dev, iolist_t *iolist)
 {
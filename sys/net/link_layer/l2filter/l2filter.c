@@ -21,6 +21,9 @@
 #include <string.h>
 
 #include "assert.h"
+#ifdef MODULE_L2FILTER_HASHED
+#include "hashes.h"
+#endif
 #include "net/l2filter.h"
 
 #define ENABLE_DEBUG    (0)
@@ -42,6 +45,98 @@ void l2filter_init(l2filter_t *list)
     }
 }
 
+#ifdef MODULE_L2FILTER_HASHED
+#define SLOT_MASK       (L2FILTER_LISTSIZE - 1)
+
+static inline uint32_t hash(const void *addr, size_t addr_len)
+{
+    return one_at_a_time_hash(addr, addr_len);
+}
+
+static inline uint8_t fingerprint(uint32_t h)
+{
+    /* the lower bits select the slot, so take the fingerprint from the upper
+     * ones */
+    return (uint8_t)(h >> 24);
+}
+
+static int find(const l2filter_t *list, const void *addr, size_t addr_len)
+{
+    uint32_t h = hash(addr, addr_len);
+    uint8_t fp = fingerprint(h);
+
+    /* terminates since l2filter_add() always leaves one slot empty */
+    for (unsigned i = h & SLOT_MASK; list[i].addr_len != 0;
+         i = (i + 1) & SLOT_MASK) {
+        if ((list[i].fingerprint == fp) && match(&list[i], addr, addr_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len)
+{
+    assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
+
+    uint32_t h = hash(addr, addr_len);
+    unsigned i = h & SLOT_MASK;
+
+    while (list[i].addr_len != 0) {
+        i = (i + 1) & SLOT_MASK;
+    }
+    /* only take slot i if another one stays empty to terminate probing */
+    for (unsigned j = (i + 1) & SLOT_MASK; list[j].addr_len != 0;
+         j = (j + 1) & SLOT_MASK) {
+        if (((j + 1) & SLOT_MASK) == i) {
+            return -ENOMEM;
+        }
+    }
+    list[i].addr_len = addr_len;
+    list[i].fingerprint = fingerprint(h);
+    memcpy(list[i].addr, addr, addr_len);
+    return 0;
+}
+
+int l2filter_rm(l2filter_t *list, const void *addr, size_t addr_len)
+{
+    assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
+
+    int pos = find(list, addr, addr_len);
+    unsigned i;
+
+    if (pos < 0) {
+        return -ENOENT;
+    }
+    i = pos;
+    /* backward shift deletion: move up entries of the probe sequence after
+     * the removed one, so lookups never run into a hole */
+    for (unsigned j = (i + 1) & SLOT_MASK; list[j].addr_len != 0;
+         j = (j + 1) & SLOT_MASK) {
+        unsigned home = hash(list[j].addr, list[j].addr_len) & SLOT_MASK;
+
+        /* entry j can stay if its home slot is cyclically in (i, j] */
+        if ((i <= j) ? ((i < home) && (home <= j))
+                     : ((i < home) || (home <= j))) {
+            continue;
+        }
+        list[i] = list[j];
+        i = j;
+    }
+    list[i].addr_len = 0;
+    return 0;
+}
+#else   /* MODULE_L2FILTER_HASHED */
+static int find(const l2filter_t *list, const void *addr, size_t addr_len)
+{
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
+        if (match(&list[i], addr, addr_len)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
 int l2filter_add(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
@@ -64,43 +159,28 @@ int l2filter_rm(l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
-    int res = -ENOENT;
+    int i = find(list, addr, addr_len);
 
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            list[i].addr_len = 0;
-            res = 0;
-            break;
-        }
+    if (i < 0) {
+        return -ENOENT;
     }
-
-    return res;
+    list[i].addr_len = 0;
+    return 0;
 }
+#endif  /* MODULE_L2FILTER_HASHED */
 
 bool l2filter_pass(const l2filter_t *list, const void *addr, size_t addr_len)
 {
     assert(list && addr && (addr_len <= L2FILTER_ADDR_MAXLEN));
 
 #ifdef MODULE_L2FILTER_WHITELIST
-    bool res = false;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] whitelist: address match -> packet passes\n");
-            res = true;
-            break;
-        }
-    }
-    DEBUG("[l2filter] whitelist: no match -> packet dropped\n");
+    bool res = (find(list, addr, addr_len) >= 0);
+    DEBUG("[l2filter] whitelist: %s -> packet %s\n",
+          res ? "address match" : "no match", res ? "passes" : "dropped");
 #else
-    bool res = true;
-    for (unsigned i = 0; i < L2FILTER_LISTSIZE; i++) {
-        if (match(&list[i], addr, addr_len)) {
-            DEBUG("[l2filter] blacklist: address match -> packet dropped\n");
-            res = false;
-            break;
-        }
-    }
-    DEBUG("[l2fitler] blacklist: no match -> packet passes\n");
+    bool res = (find(list, addr, addr_len) < 0);
+    DEBUG("[l2filter] blacklist: %s -> packet %s\n",
+          res ? "no match" : "address match", res ? "passes" : "dropped");
 #endif
 
     return res;
@@ -0,0 +1,269 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "net/netstats/neighbor.h"
+#include "xtimer.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#if NETSTATS_NB_TX_PENDING_MAX > 8
+#error "NETSTATS_NB_TX_PENDING_MAX must not exceed 8"
+#endif
+
+static uint32_t _now(void)
+{
+    return (uint32_t)(xtimer_now_usec64() / US_PER_SEC);
+}
+
+static inline bool _stale(const netstats_nb_t *nb, uint32_t now)
+{
+    return (now - nb->last_updated) > NETSTATS_NB_TIMEOUT;
+}
+
+static netstats_nb_t *_find(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                            uint8_t len)
+{
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        netstats_nb_t *nb = &table->entries[i];
+
+        if ((nb->l2_addr_len == len) &&
+            (memcmp(nb->l2_addr, l2_addr, len) == 0)) {
+            return nb;
+        }
+    }
+    return NULL;
+}
+
+static netstats_nb_t *_get_or_add(netstats_nb_table_t *table,
+                                  const uint8_t *l2_addr, uint8_t len,
+                                  uint32_t now)
+{
+    netstats_nb_t *nb, *oldest = NULL;
+
+    if ((len == 0) || (len > NETSTATS_NB_L2ADDR_MAX)) {
+        return NULL;
+    }
+    if ((nb = _find(table, l2_addr, len)) != NULL) {
+        if (_stale(nb, now)) {
+            /* start over, old estimates do not reflect the link anymore */
+            goto reset;
+        }
+        return nb;
+    }
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        netstats_nb_t *tmp = &table->entries[i];
+
+        if (tmp->l2_addr_len == 0) {
+            nb = tmp;
+            break;
+        }
+        if ((oldest == NULL) ||
+            ((now - tmp->last_updated) > (now - oldest->last_updated))) {
+            oldest = tmp;
+        }
+    }
+    if (nb == NULL) {
+        /* outcomes of pending frames to it are not accounted anymore */
+        nb = oldest;
+    }
+reset:
+    DEBUG("netstats_nb: tracking new neighbor (slot %u)\n",
+          (unsigned)(nb - table->entries));
+    memset(nb, 0, sizeof(*nb));
+    memcpy(nb->l2_addr, l2_addr, len);
+    nb->l2_addr_len = len;
+    nb->last_updated = now;
+    return nb;
+}
+
+static unsigned _ewma(unsigned alpha, unsigned old, unsigned sample)
+{
+    return ((old * alpha) + (sample * (100U - alpha))) / 100U;
+}
+
+/* removes the oldest pending frame, returns the neighbor it was sent to */
+static netstats_nb_t *_tx_pop(netstats_nb_table_t *table)
+{
+    netstats_nb_t *res = NULL;
+
+    for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+        netstats_nb_t *nb = &table->entries[i];
+
+        if (nb->tx_pending & 0x1) {
+            res = nb;
+        }
+        nb->tx_pending >>= 1;
+    }
+    table->tx_pending--;
+    return res;
+}
+
+void netstats_nb_init(netstats_nb_table_t *table)
+{
+    memset(table, 0, sizeof(*table));
+    mutex_init(&table->lock);
+}
+
+void netstats_nb_record(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                        uint8_t len)
+{
+    netstats_nb_t *nb;
+
+    mutex_lock(&table->lock);
+    if (table->tx_pending == NETSTATS_NB_TX_PENDING_MAX) {
+        DEBUG("netstats_nb: outcome of oldest frame lost\n");
+        _tx_pop(table);
+    }
+    /* multicast frames are pending, but not for any neighbor */
+    if ((l2_addr != NULL) &&
+        ((nb = _get_or_add(table, l2_addr, len, _now())) != NULL)) {
+        nb->tx_pending |= (1U << table->tx_pending);
+    }
+    table->tx_pending++;
+    mutex_unlock(&table->lock);
+}
+
+void netstats_nb_cancel_tx(netstats_nb_table_t *table)
+{
+    mutex_lock(&table->lock);
+    if (table->tx_pending > 0) {
+        table->tx_pending--;
+        for (unsigned i = 0; i < NETSTATS_NB_SIZE; i++) {
+            table->entries[i].tx_pending &= ~(1U << table->tx_pending);
+        }
+    }
+    mutex_unlock(&table->lock);
+}
+
+void netstats_nb_update_tx(netstats_nb_table_t *table, unsigned attempts,
+                           bool success)
+{
+    netstats_nb_t *nb = NULL;
+    unsigned sample;
+
+    mutex_lock(&table->lock);
+    if (table->tx_pending > 0) {
+        nb = _tx_pop(table);
+    }
+    if ((nb == NULL) || (attempts == 0)) {
+        /* multicast, untracked or not transmitted */
+        mutex_unlock(&table->lock);
+        return;
+    }
+    if (!success || (attempts > NETSTATS_NB_ETX_NOACK_PENALTY)) {
+        attempts = NETSTATS_NB_ETX_NOACK_PENALTY;
+    }
+    sample = attempts * NETSTATS_NB_ETX_DIVISOR;
+    nb->etx = (nb->etx == 0) ? sample
+            : _ewma(NETSTATS_NB_ETX_ALPHA, nb->etx, sample);
+    nb->tx_count++;
+    if (!success) {
+        nb->tx_failed++;
+    }
+    nb->last_updated = _now();
+    DEBUG("netstats_nb: %s after %u attempts, ETX now %u/%u\n",
+          success ? "ACK" : "NOACK", attempts, nb->etx,
+          NETSTATS_NB_ETX_DIVISOR);
+    mutex_unlock(&table->lock);
+}
+
+void netstats_nb_update_rx(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                           uint8_t len, int16_t rssi, uint8_t lqi)
+{
+    uint32_t now = _now();
+    netstats_nb_t *nb;
+
+    mutex_lock(&table->lock);
+    if ((nb = _get_or_add(table, l2_addr, len, now)) != NULL) {
+        if (nb->rx_count == 0) {
+            nb->rssi = rssi;
+            nb->lqi = lqi;
+        }
+        else {
+            /* offset RSSI into positive range for the unsigned average */
+            nb->rssi = (int16_t)_ewma(NETSTATS_NB_RX_ALPHA,
+                                      (unsigned)(nb->rssi - INT16_MIN),
+                                      (unsigned)(rssi - INT16_MIN)) +
+                       INT16_MIN;
+            nb->lqi = _ewma(NETSTATS_NB_RX_ALPHA, nb->lqi, lqi);
+        }
+        nb->rx_count++;
+        nb->last_updated = now;
+    }
+    mutex_unlock(&table->lock);
+}
+
+int netstats_nb_get(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                    uint8_t len, netstats_nb_t *stats)
+{
+    netstats_nb_t *nb;
+    int res = -ENOENT;
+
+    if ((len == 0) || (len > NETSTATS_NB_L2ADDR_MAX)) {
+        return res;
+    }
+    mutex_lock(&table->lock);
+    if (((nb = _find(table, l2_addr, len)) != NULL) && !_stale(nb, _now())) {
+        if (stats != NULL) {
+            *stats = *nb;
+        }
+        res = 0;
+    }
+    mutex_unlock(&table->lock);
+    return res;
+}
+
+uint16_t netstats_nb_etx(netstats_nb_table_t *table, const uint8_t *l2_addr,
+                         uint8_t len)
+{
+    netstats_nb_t nb;
+
+    if (netstats_nb_get(table, l2_addr, len, &nb) < 0) {
+        return 0;
+    }
+    return nb.etx;
+}
+
+bool netstats_nb_iter(netstats_nb_table_t *table, unsigned *state,
+                      netstats_nb_t *stats)
+{
+    uint32_t now = _now();
+    bool res = false;
+
+    mutex_lock(&table->lock);
+    while (!res && (*state < NETSTATS_NB_SIZE)) {
+        const netstats_nb_t *nb = &table->entries[(*state)++];
+
+        if ((nb->l2_addr_len > 0) && !_stale(nb, now)) {
+            *stats = *nb;
+            res = true;
+        }
+    }
+    mutex_unlock(&table->lock);
+    return res;
+}
+
+void netstats_nb_reset(netstats_nb_table_t *table)
+{
+    mutex_lock(&table->lock);
+    memset(table->entries, 0, sizeof(table->entries));
+    table->tx_pending = 0;
+    mutex_unlock(&table->lock);
+}
+
+/** @} */
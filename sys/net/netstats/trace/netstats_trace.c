@@ -0,0 +1,103 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+
+#include <errno.h>
+#include <string.h>
+
+#include "irq.h"
+#include "net/netstats/trace.h"
+#include "xtimer.h"
+
+#define MASK    (NETSTATS_TRACE_SIZE - 1)
+
+static const char *_event_str[] = {
+    [NETSTATS_TRACE_RADIO_ON]     = "radio_on",
+    [NETSTATS_TRACE_RADIO_OFF]    = "radio_off",
+    [NETSTATS_TRACE_TX_QUEUED]    = "tx_queued",
+    [NETSTATS_TRACE_TX_START]     = "tx_start",
+    [NETSTATS_TRACE_TX_END]       = "tx_end",
+    [NETSTATS_TRACE_TX_NOACK]     = "tx_noack",
+    [NETSTATS_TRACE_TX_CCA_FAIL]  = "tx_cca_fail",
+    [NETSTATS_TRACE_RX_START]     = "rx_start",
+    [NETSTATS_TRACE_RX_END]       = "rx_end",
+    [NETSTATS_TRACE_MAC_WAKEUP]   = "mac_wakeup",
+    [NETSTATS_TRACE_MAC_SLEEP]    = "mac_sleep",
+};
+
+void netstats_trace_init(netstats_trace_t *trace)
+{
+    unsigned state = irq_disable();
+
+    memset(trace, 0, sizeof(*trace));
+    irq_restore(state);
+}
+
+void netstats_trace_add(netstats_trace_t *trace, netstats_trace_event_t event,
+                        uint16_t arg)
+{
+    uint32_t now = xtimer_now_usec();
+    unsigned state = irq_disable();
+    netstats_trace_entry_t *entry = &trace->entries[trace->count & MASK];
+
+    entry->time = now;
+    entry->arg = arg;
+    entry->event = event;
+    trace->count++;
+    irq_restore(state);
+}
+
+uint32_t netstats_trace_first(const netstats_trace_t *trace)
+{
+    uint32_t count = trace->count;
+
+    return (count > NETSTATS_TRACE_SIZE) ? (count - NETSTATS_TRACE_SIZE) : 0;
+}
+
+int netstats_trace_get(netstats_trace_t *trace, uint32_t seq,
+                       netstats_trace_entry_t *entry)
+{
+    int res = -ENOENT;
+    unsigned state = irq_disable();
+
+    /* unsigned arithmetic, so also correct after the counter wrapped */
+    if ((trace->count - seq - 1) < NETSTATS_TRACE_SIZE) {
+        *entry = trace->entries[seq & MASK];
+        res = 0;
+    }
+    irq_restore(state);
+    return res;
+}
+
+void netstats_trace_export(const netstats_trace_entry_t *entry,
+                           netstats_trace_record_t record)
+{
+    record[0] = entry->time & 0xff;
+    record[1] = (entry->time >> 8) & 0xff;
+    record[2] = (entry->time >> 16) & 0xff;
+    record[3] = (entry->time >> 24) & 0xff;
+    record[4] = entry->arg & 0xff;
+    record[5] = (entry->arg >> 8) & 0xff;
+    record[6] = entry->event;
+    record[7] = 0;
+}
+
+const char *netstats_trace_event_str(unsigned event)
+{
+    if (event >= NETSTATS_TRACE_NUMOF) {
+        return "unknown";
+    }
+    return _event_str[event];
+}
+
+/** @} */
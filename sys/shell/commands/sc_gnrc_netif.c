@@ -18,6 +18,7 @@
  * @author      Oliver Hahm <oliver.hahm@inria.fr>
  */
 
+#include <inttypes.h>
 #include <stdio.h>
 #include <string.h>
 
@@ -30,7 +31,7 @@
 #include "net/loramac.h"
 #include "fmt.h"
 
-#ifdef MODULE_NETSTATS
+#if defined(MODULE_NETSTATS) || defined(MODULE_CSMA_SENDER_ADAPTIVE)
 #include "net/netstats.h"
 #endif
 #ifdef MODULE_L2FILTER
@@ -131,6 +132,159 @@ static int _netif_stats(netif_t *iface, unsigned module, bool reset)
     }
     return res;
 }
+
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+static void _netif_stats_csma_link(const csma_sender_link_t *link)
+{
+    printf("            CSMA/CA %u  CCA %u (busy: %u %u%%)  "
+           "access failed %u\n"
+           "            retried %u (%u%%)  no ACK %u  initial BE %u\n",
+           (unsigned)link->cnt.tx_count, (unsigned)link->cnt.cca_count,
+           (unsigned)link->cnt.cca_busy,
+           (unsigned)((link->busy_rate * 100U) /
+                      CSMA_SENDER_ADAPTIVE_RATE_SCALE),
+           (unsigned)link->cnt.access_failed,
+           (unsigned)link->cnt.tx_retried,
+           (unsigned)((link->retry_rate * 100U) /
+                      CSMA_SENDER_ADAPTIVE_RATE_SCALE),
+           (unsigned)link->cnt.tx_noack, (unsigned)link->be);
+}
+
+static int _netif_stats_csma(netif_t *iface, bool reset)
+{
+    csma_sender_stats_t *stats;
+    char addr_str[CSMA_SENDER_ADAPTIVE_L2ADDR_MAX * 3];
+    int res = netif_get_opt(iface, NETOPT_STATS, NETSTATS_CSMA, &stats,
+                            sizeof(&stats));
+
+    if (res < 0) {
+        puts("           Device doesn't provide CSMA/CA statistics.");
+        return res;
+    }
+    if (reset) {
+        memset(stats, 0, sizeof(csma_sender_stats_t));
+        puts("Reset statistics for module CSMA/CA!");
+        return 0;
+    }
+    puts("          Statistics for CSMA/CA");
+    for (unsigned i = 0; i < CSMA_SENDER_ADAPTIVE_CHANNELS_NUMOF; i++) {
+        const csma_sender_link_t *link = &stats->channels[i];
+
+        if (link->last_used == 0) {
+            continue;
+        }
+        printf("           Channel %u\n", (unsigned)link->channel);
+        _netif_stats_csma_link(link);
+        for (unsigned j = 0; j < CSMA_SENDER_ADAPTIVE_NBRS_NUMOF; j++) {
+            const csma_sender_link_t *nbr = &stats->nbrs[j];
+
+            if ((nbr->last_used == 0) || (nbr->channel != link->channel)) {
+                continue;
+            }
+            printf("           Neighbor %s\n",
+                   gnrc_netif_addr_to_str(nbr->addr, nbr->addr_len,
+                                          addr_str));
+            _netif_stats_csma_link(nbr);
+        }
+    }
+    return 0;
+}
+#endif
+
+#ifdef MODULE_NETSTATS_NEIGHBOR
+static int _netif_stats_nb(netif_t *iface, bool reset)
+{
+    netstats_nb_table_t *table;
+    netstats_nb_t nb;
+    char addr_str[NETSTATS_NB_L2ADDR_MAX * 3];
+    unsigned state = 0;
+    int res = netif_get_opt(iface, NETOPT_STATS, NETSTATS_NEIGHBOR, &table,
+                            sizeof(&table));
+
+    if (res < 0) {
+        puts("           Device doesn't provide neighbor statistics.");
+        return res;
+    }
+    if (reset) {
+        netstats_nb_reset(table);
+        puts("Reset statistics for module Neighbors!");
+        return 0;
+    }
+    puts("          Statistics for Neighbors");
+    while (netstats_nb_iter(table, &state, &nb)) {
+        printf("           %s\n",
+               gnrc_netif_addr_to_str(nb.l2_addr, nb.l2_addr_len, addr_str));
+        printf("            ETX %u.%02u  RSSI %d  LQI %u\n",
+               (unsigned)(nb.etx / NETSTATS_NB_ETX_DIVISOR),
+               (unsigned)(((nb.etx % NETSTATS_NB_ETX_DIVISOR) * 100U) /
+                          NETSTATS_NB_ETX_DIVISOR),
+               (int)nb.rssi, (unsigned)nb.lqi);
+        printf("            TX packets %u (failed: %u)  RX packets %u\n",
+               (unsigned)nb.tx_count, (unsigned)nb.tx_failed,
+               (unsigned)nb.rx_count);
+    }
+    return 0;
+}
+#endif
+
+#ifdef MODULE_NETSTATS_TRACE
+static int _netif_trace(netif_t *iface, const char *mode)
+{
+    netstats_trace_t *trace;
+    netstats_trace_entry_t entry;
+    char name[NETIF_NAMELENMAX];
+    uint32_t first, end, last = 0;
+    int res = netif_get_opt(iface, NETOPT_STATS, NETSTATS_TRACE, &trace,
+                            sizeof(&trace));
+
+    if (res < 0) {
+        puts("           Device doesn't provide a timing trace.");
+        return res;
+    }
+    if ((mode != NULL) && (strcmp(mode, "reset") == 0)) {
+        netstats_trace_init(trace);
+        puts("Reset timing trace!");
+        return 0;
+    }
+    first = netstats_trace_first(trace);
+    end = trace->count;
+    if ((mode != NULL) && (strcmp(mode, "bin") == 0)) {
+        /* one sequence number and hex encoded record per line, for
+         * dist/tools/netstats_trace; events overwritten while dumping are
+         * skipped */
+        netif_get_name(iface, name);
+        printf("netstats_trace %s %" PRIu32 " %" PRIu32 "\n",
+               name, first, end);
+        for (uint32_t seq = first; seq != end; seq++) {
+            netstats_trace_record_t record;
+
+            if (netstats_trace_get(trace, seq, &entry) < 0) {
+                continue;
+            }
+            netstats_trace_export(&entry, record);
+            printf("%" PRIu32 " ", seq);
+            for (unsigned i = 0; i < sizeof(record); i++) {
+                printf("%02x", record[i]);
+            }
+            puts("");
+        }
+        puts("netstats_trace end");
+        return 0;
+    }
+    printf("          Timing trace (%" PRIu32 " events, %" PRIu32
+           " overwritten)\n", end - first, first);
+    for (uint32_t seq = first; seq != end; seq++) {
+        if (netstats_trace_get(trace, seq, &entry) < 0) {
+            continue;
+        }
+        printf("           %10" PRIu32 " us (+%7" PRIu32 ") %-12s %u\n",
+               entry.time, (seq == first) ? 0 : (entry.time - last),
+               netstats_trace_event_str(entry.event), (unsigned)entry.arg);
+        last = entry.time;
+    }
+    return 0;
+}
+#endif
 #endif /* MODULE_NETSTATS */
 
 static void _link_usage(char *cmd_name)
@@ -207,11 +361,25 @@ static void _del_usage(char *cmd_name)
 #ifdef MODULE_NETSTATS
 static void _stats_usage(char *cmd_name)
 {
-    printf("usage: %s <if_id> stats [l2|ipv6] [reset]\n", cmd_name);
+    printf("usage: %s <if_id> stats [l2|ipv6"
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+           "|csma"
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+           "|nb"
+#endif
+           "] [reset]\n", cmd_name);
     puts("       reset can be only used if the module is specified.");
 }
 #endif
 
+#ifdef MODULE_NETSTATS_TRACE
+static void _trace_usage(char *cmd_name)
+{
+    printf("usage: %s <if_id> trace [bin|reset]\n", cmd_name);
+}
+#endif
+
 static void _print_netopt(netopt_t opt)
 {
     switch (opt) {
@@ -1114,6 +1282,9 @@ static void _usage(char *cmd)
 #ifdef MODULE_NETSTATS
     _stats_usage(cmd);
 #endif
+#ifdef MODULE_NETSTATS_TRACE
+    _trace_usage(cmd);
+#endif
 }
 
 static int _netif_set(char *cmd_name, netif_t *iface, char *key, char *value)
@@ -1495,6 +1666,16 @@ int _gnrc_netif_config(int argc, char **argv)
             else if (strcmp(argv[3], "ipv6") == 0) {
                 module = NETSTATS_IPV6;
             }
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+            else if (strcmp(argv[3], "csma") == 0) {
+                module = NETSTATS_CSMA;
+            }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+            else if (strcmp(argv[3], "nb") == 0) {
+                module = NETSTATS_NEIGHBOR;
+            }
+#endif
             else {
                 printf("Module %s doesn't exist or does not provide statistics.\n", argv[3]);
 
@@ -1511,9 +1692,29 @@ int _gnrc_netif_config(int argc, char **argv)
             if (module & NETSTATS_IPV6) {
                 _netif_stats(iface, NETSTATS_IPV6, reset);
             }
+#if defined(MODULE_GNRC_MAC) && defined(MODULE_CSMA_SENDER_ADAPTIVE)
+            if (module & NETSTATS_CSMA) {
+                _netif_stats_csma(iface, reset);
+            }
+#endif
+#ifdef MODULE_NETSTATS_NEIGHBOR
+            if (module & NETSTATS_NEIGHBOR) {
+                _netif_stats_nb(iface, reset);
+            }
+#endif
 
             return 1;
         }
+#endif
+#ifdef MODULE_NETSTATS_TRACE
+        else if (strcmp(argv[2], "trace") == 0) {
+            if ((argc > 3) && (strcmp(argv[3], "bin") != 0) &&
+                (strcmp(argv[3], "reset") != 0)) {
+                _trace_usage(argv[0]);
+                return 1;
+            }
+            return (_netif_trace(iface, (argc > 3) ? argv[3] : NULL) < 0);
+        }
 #endif
         else if (strcmp(argv[2], "help") == 0) {
             _usage(argv[0]);
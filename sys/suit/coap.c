@@ -68,6 +68,19 @@
 #define SUIT_MANIFEST_BUFSIZE   640
 #endif
 
+/**
+ * @brief   Number of blocks requested per round trip using Q-Block2
+ *          (RFC 9177)
+ *
+ * With a value > 1, blocks are fetched in bursts of this size and only
+ * missing blocks are requested again. Needs a server supporting Q-Block2 and
+ * a window of this many blocks on the stack of the calling thread. 0 fetches
+ * one Block2 per round trip.
+ */
+#ifndef SUIT_COAP_QBLOCK_BURST
+#define SUIT_COAP_QBLOCK_BURST  0
+#endif
+
 #define SUIT_MSG_TRIGGER        0x12345
 
 static char _stack[SUIT_COAP_STACKSIZE];
@@ -148,6 +161,153 @@ static inline uint32_t deadline_left(uint32_t deadline)
     return left;
 }
 
+#if SUIT_COAP_QBLOCK_BURST > 1
+static size_t _qblock2_build_req(uint8_t *buf, const uint8_t *token,
+                                 uint16_t id, const char *path,
+                                 coap_blksize_t blksize, uint32_t num,
+                                 uint32_t received, uint32_t last)
+{
+    uint8_t *pktpos = buf;
+    uint16_t lastonum = COAP_OPT_URI_PATH;
+
+    pktpos += coap_build_hdr((coap_hdr_t *)buf, COAP_TYPE_NON, (uint8_t *)token,
+                             sizeof(uint32_t), COAP_METHOD_GET, id);
+    pktpos += coap_opt_put_uri_path(pktpos, 0, path);
+    if (received == 0) {
+        /* nothing of the window arrived yet, ask for a burst from num on */
+        pktpos += coap_opt_put_uint(pktpos, lastonum, COAP_OPT_Q_BLOCK2,
+                                    (num << 4) | 0x8 | blksize);
+        return pktpos - buf;
+    }
+    /* ask for the missing blocks of the window only */
+    for (uint32_t blk = num; (blk < num + SUIT_COAP_QBLOCK_BURST) && (blk <= last);
+         blk++) {
+        if (!(received & (1UL << (blk % SUIT_COAP_QBLOCK_BURST)))) {
+            pktpos += coap_opt_put_uint(pktpos, lastonum, COAP_OPT_Q_BLOCK2,
+                                        (blk << 4) | blksize);
+            lastonum = COAP_OPT_Q_BLOCK2;
+        }
+    }
+    return pktpos - buf;
+}
+
+static int _get_qblock2(sock_udp_t *sock, const char *path,
+                        coap_blksize_t blksize,
+                        coap_blockwise_cb_t callback, void *arg)
+{
+    const size_t blk_len = 0x1 << (blksize + 4);
+    /* request needs room for one Q-Block2 option per window slot */
+    uint8_t buf[64 + SUIT_COAP_QBLOCK_BURST * 4 + blk_len];
+    uint8_t window[SUIT_COAP_QBLOCK_BURST][blk_len];
+    uint16_t window_len[SUIT_COAP_QBLOCK_BURST];
+    uint32_t received = 0;          /* slots of the window holding a block */
+    uint32_t num = 0;               /* first block of the window */
+    uint32_t last = UINT32_MAX;     /* last block of the resource, once known */
+    uint32_t token = xtimer_now_usec();
+    uint16_t id = token;
+    unsigned tries_left = COAP_MAX_RETRANSMIT + 1;
+    coap_pkt_t pkt;
+
+    /* window slots are tracked in a 32 bit map */
+    static_assert(SUIT_COAP_QBLOCK_BURST <= 32, "SUIT_COAP_QBLOCK_BURST > 32");
+
+    while (num <= last) {
+        size_t len = _qblock2_build_req(buf, (uint8_t *)&token, id++, path,
+                                        blksize, num, received, last);
+        ssize_t res = sock_udp_send(sock, buf, len, NULL);
+        if (res <= 0) {
+            DEBUG("nanocoap: error sending coap request, %d\n", (int)res);
+            return -1;
+        }
+
+        /* collect the burst until the window is complete or time is up */
+        bool progress = false;
+        uint32_t deadline = deadline_from_interval(COAP_ACK_TIMEOUT * US_PER_SEC);
+        while (1) {
+            res = sock_udp_recv(sock, buf, sizeof(buf), deadline_left(deadline),
+                                NULL);
+            if (res == -ETIMEDOUT) {
+                break;
+            }
+            if (res <= 0) {
+                DEBUG("nanocoap: error receiving coap response, %d\n", (int)res);
+                return -1;
+            }
+            if ((coap_parse(&pkt, buf, res) < 0) ||
+                (coap_get_token_len(&pkt) != sizeof(token)) ||
+                memcmp(pkt.token, &token, sizeof(token))) {
+                continue;
+            }
+            if (coap_get_code(&pkt) != 205) {
+                DEBUG("code=%i\n", coap_get_code(&pkt));
+                return -1;
+            }
+
+            uint32_t blknum;
+            unsigned szx;
+            int more = coap_get_blockopt(&pkt, COAP_OPT_Q_BLOCK2, &blknum, &szx);
+            if (more < 0) {
+                more = coap_get_blockopt(&pkt, COAP_OPT_BLOCK2, &blknum, &szx);
+            }
+            if ((more < 0) || (szx != blksize) || (pkt.payload_len > blk_len)) {
+                DEBUG("suit: unexpected block option or size\n");
+                return -1;
+            }
+            if (!more) {
+                last = blknum;
+            }
+            unsigned slot = blknum % SUIT_COAP_QBLOCK_BURST;
+            if ((blknum < num) || (blknum >= num + SUIT_COAP_QBLOCK_BURST) ||
+                (received & (1UL << slot))) {
+                continue;
+            }
+            memcpy(window[slot], pkt.payload, pkt.payload_len);
+            window_len[slot] = pkt.payload_len;
+            received |= (1UL << slot);
+            progress = true;
+
+            /* done with this round if every block of the window arrived */
+            uint32_t end = num + SUIT_COAP_QBLOCK_BURST - 1;
+            if (end > last) {
+                end = last;
+            }
+            bool complete = true;
+            for (uint32_t blk = num; blk <= end; blk++) {
+                if (!(received & (1UL << (blk % SUIT_COAP_QBLOCK_BURST)))) {
+                    complete = false;
+                    break;
+                }
+            }
+            if (complete) {
+                break;
+            }
+        }
+
+        if (!progress) {
+            if (--tries_left == 0) {
+                DEBUG("nanocoap: maximum retries reached\n");
+                return -1;
+            }
+            continue;
+        }
+        tries_left = COAP_MAX_RETRANSMIT + 1;
+
+        /* hand out the blocks that arrived in order and slide the window */
+        unsigned slot;
+        while ((num <= last) &&
+               (received & (1UL << (slot = num % SUIT_COAP_QBLOCK_BURST)))) {
+            if (callback(arg, num * blk_len, window[slot], window_len[slot],
+                         num != last)) {
+                DEBUG("callback res != 0, aborting.\n");
+                return -1;
+            }
+            received &= ~(1UL << slot);
+            num++;
+        }
+    }
+    return 0;
+}
+#else /* SUIT_COAP_QBLOCK_BURST > 1 */
 static ssize_t _nanocoap_request(sock_udp_t *sock, coap_pkt_t *pkt, size_t len)
 {
     ssize_t res = -EAGAIN;
@@ -233,32 +393,20 @@ static int _fetch_block(coap_pkt_t *pkt, uint8_t *buf, sock_udp_t *sock, const c
     return 0;
 }
 
-int suit_coap_get_blockwise(sock_udp_ep_t *remote, const char *path,
-                               coap_blksize_t blksize,
-                               coap_blockwise_cb_t callback, void *arg)
+static int _get_block2(sock_udp_t *sock, const char *path,
+                       coap_blksize_t blksize,
+                       coap_blockwise_cb_t callback, void *arg)
 {
     /* mmmmh dynamically sized array */
     uint8_t buf[64 + (0x1 << (blksize + 4))];
-    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
     coap_pkt_t pkt;
 
-    /* HACK: use random local port */
-    local.port = 0x8000 + (xtimer_now_usec() % 0XFFF);
-
-
-    sock_udp_t sock;
-    int res = sock_udp_create(&sock, &local, remote, 0);
-    if (res < 0) {
-        return res;
-    }
-
-
     int more = 1;
     size_t num = 0;
-    res = -1;
+    int res = -1;
     while (more == 1) {
         DEBUG("fetching block %u\n", (unsigned)num);
-        res = _fetch_block(&pkt, buf, &sock, path, blksize, num);
+        res = _fetch_block(&pkt, buf, sock, path, blksize, num);
         DEBUG("res=%i\n", res);
 
         if (!res) {
@@ -268,20 +416,42 @@ int suit_coap_get_blockwise(sock_udp_ep_t *remote, const char *path,
 
             if (callback(arg, block2.offset, pkt.payload, pkt.payload_len, more)) {
                 DEBUG("callback res != 0, aborting.\n");
-                res = -1;
-                goto out;
+                return -1;
             }
         }
         else {
             DEBUG("error fetching block\n");
-            res = -1;
-            goto out;
+            return -1;
         }
 
         num += 1;
     }
+    return res;
+}
+#endif /* SUIT_COAP_QBLOCK_BURST > 1 */
+
+int suit_coap_get_blockwise(sock_udp_ep_t *remote, const char *path,
+                               coap_blksize_t blksize,
+                               coap_blockwise_cb_t callback, void *arg)
+{
+    sock_udp_ep_t local = SOCK_IPV6_EP_ANY;
+
+    /* HACK: use random local port */
+    local.port = 0x8000 + (xtimer_now_usec() % 0XFFF);
+
+
+    sock_udp_t sock;
+    int res = sock_udp_create(&sock, &local, remote, 0);
+    if (res < 0) {
+        return res;
+    }
+
+#if SUIT_COAP_QBLOCK_BURST > 1
+    res = _get_qblock2(&sock, path, blksize, callback, arg);
+#else
+    res = _get_block2(&sock, path, blksize, callback, arg);
+#endif
 
-out:
     sock_udp_close(&sock);
     return res;
 }
@@ -0,0 +1,558 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     sys_tslog
+ * @{
+ *
+ * @file
+ * @brief       Time-series log implementation
+ *
+ * @}
+ */
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stddef.h>
+#include <string.h>
+
+#include "checksum/crc16_ccitt.h"
+#include "tslog.h"
+
+#define ENABLE_DEBUG    (0)
+#include "debug.h"
+
+#define SECTOR_MAGIC    (0x474c5354)    /* "TSLG" */
+
+typedef struct {
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t first_time;
+    uint16_t reserved;
+    uint16_t crc;
+} _sector_hdr_t;
+
+typedef struct {
+    uint32_t time;
+    uint16_t len;
+    uint16_t crc;
+} _record_hdr_t;
+
+static const uint8_t _erased[TSLOG_ALIGN] = { 0xff, 0xff, 0xff, 0xff };
+
+static inline uint32_t _addr(const tslog_t *log, uint32_t sector, uint32_t pos)
+{
+    return (log->first_sector + sector) * log->sector_size + pos;
+}
+
+static inline uint32_t _record_size(size_t len)
+{
+    return (TSLOG_RECORD_HDR_SIZE + len + TSLOG_ALIGN - 1) & ~(TSLOG_ALIGN - 1);
+}
+
+static inline uint16_t _sector_crc(const _sector_hdr_t *hdr)
+{
+    return crc16_ccitt_calc((const uint8_t *)hdr, offsetof(_sector_hdr_t, crc));
+}
+
+static inline uint16_t _record_crc(const _record_hdr_t *hdr, const void *data)
+{
+    uint16_t crc = crc16_ccitt_calc((const uint8_t *)hdr,
+                                    offsetof(_record_hdr_t, crc));
+    return crc16_ccitt_update(crc, data, hdr->len);
+}
+
+static inline bool _is_erased(const _record_hdr_t *hdr)
+{
+    return (hdr->time == UINT32_MAX) && (hdr->len == UINT16_MAX) &&
+           (hdr->crc == UINT16_MAX);
+}
+
+/* read from the device, buffered data that is not programmed yet is taken
+ * from the buffer */
+static int _read(tslog_t *log, uint32_t sector, uint32_t pos, void *dest,
+                 uint32_t len)
+{
+    uint8_t *dst = dest;
+
+    for (uint32_t done = 0; done < len;) {
+        int res = mtd_read(log->mtd, dst + done,
+                           _addr(log, sector, pos + done), len - done);
+        if (res <= 0) {
+            return (res < 0) ? res : -EIO;
+        }
+        done += res;
+    }
+
+    if ((sector == log->head) && (log->buf_fill > 0)) {
+        uint32_t start = (pos > log->buf_addr) ? pos : log->buf_addr;
+        uint32_t end = log->buf_addr + log->buf_fill;
+
+        if ((pos + len) < end) {
+            end = pos + len;
+        }
+        if (start < end) {
+            memcpy(dst + (start - pos), log->buf + (start - log->buf_addr),
+                   end - start);
+        }
+    }
+    return 0;
+}
+
+static int _read_sector_hdr(tslog_t *log, uint32_t sector, _sector_hdr_t *hdr)
+{
+    int res = _read(log, sector, 0, hdr, sizeof(*hdr));
+    if (res < 0) {
+        return res;
+    }
+    if ((hdr->magic != SECTOR_MAGIC) || (hdr->crc != _sector_crc(hdr))) {
+        return -ENOENT;
+    }
+    return 0;
+}
+
+static int _program(tslog_t *log, uint32_t pos, const uint8_t *src,
+                    uint32_t len)
+{
+    uint32_t page_size = log->mtd->page_size;
+    uint32_t addr = _addr(log, log->head, pos);
+
+    while (len > 0) {
+        uint32_t chunk = page_size - (addr % page_size);
+        if (chunk > len) {
+            chunk = len;
+        }
+        int res = mtd_write(log->mtd, src, addr, chunk);
+        if (res < 0) {
+            return res;
+        }
+        log->stats.writes++;
+        src += chunk;
+        addr += chunk;
+        len -= chunk;
+    }
+    return 0;
+}
+
+static int _flush(tslog_t *log)
+{
+    if (log->buf_fill == log->buf_flushed) {
+        return 0;
+    }
+    int res = _program(log, log->buf_addr + log->buf_flushed,
+                       log->buf + log->buf_flushed,
+                       log->buf_fill - log->buf_flushed);
+    if (res < 0) {
+        return res;
+    }
+    log->buf_flushed = log->buf_fill;
+    return 0;
+}
+
+static void _reset_buf(tslog_t *log, uint32_t addr)
+{
+    log->buf_addr = addr;
+    log->buf_fill = 0;
+    log->buf_flushed = 0;
+    memset(log->buf, 0xff, sizeof(log->buf));
+}
+
+/* append to the buffer, a full buffer is programmed right away */
+static int _put(tslog_t *log, const void *data, uint32_t len)
+{
+    const uint8_t *src = data;
+
+    while (len > 0) {
+        uint32_t off = log->wpos - log->buf_addr;
+        uint32_t chunk = sizeof(log->buf) - off;
+        if (chunk > len) {
+            chunk = len;
+        }
+        memcpy(log->buf + off, src, chunk);
+        log->buf_fill = off + chunk;
+        log->wpos += chunk;
+        src += chunk;
+        len -= chunk;
+        if (log->buf_fill == sizeof(log->buf)) {
+            int res = _flush(log);
+            if (res < 0) {
+                return res;
+            }
+            _reset_buf(log, log->buf_addr + sizeof(log->buf));
+        }
+    }
+    return 0;
+}
+
+static void _set_empty(tslog_t *log)
+{
+    log->head = log->numof - 1;
+    log->head_seq = 0;
+    log->count = 0;
+    log->wpos = log->sector_size;
+    log->last_time = 0;
+    log->sealed = true;
+    _reset_buf(log, log->sector_size);
+}
+
+/* start the next sector, overwriting the oldest one if the log is full */
+static int _open_sector(tslog_t *log, uint32_t time)
+{
+    int res = _flush(log);
+    if (res < 0) {
+        return res;
+    }
+
+    uint32_t next = (log->head + 1) % log->numof;
+    res = mtd_erase(log->mtd, _addr(log, next, 0), log->sector_size);
+    if (res < 0) {
+        return res;
+    }
+    log->stats.erases++;
+
+    log->head = next;
+    log->head_seq++;
+    if (log->count < log->numof) {
+        log->count++;
+    }
+    log->sealed = false;
+    log->wpos = 0;
+    _reset_buf(log, 0);
+
+    _sector_hdr_t hdr = {
+        .magic = SECTOR_MAGIC,
+        .seq = log->head_seq,
+        .first_time = time,
+        .reserved = UINT16_MAX,
+    };
+    hdr.crc = _sector_crc(&hdr);
+    DEBUG("tslog: open sector %" PRIu32 ", seq %" PRIu32 "\n", next, hdr.seq);
+    return _put(log, &hdr, sizeof(hdr));
+}
+
+static int _setup(tslog_t *log)
+{
+    mtd_dev_t *mtd = log->mtd;
+
+    int res = mtd_init(mtd);
+    if (res < 0) {
+        return res;
+    }
+
+    mutex_init(&log->lock);
+    log->sector_size = mtd->pages_per_sector * mtd->page_size;
+    log->numof = log->sector_count;
+    if (log->numof == 0) {
+        log->numof = mtd->sector_count - log->first_sector;
+    }
+    if ((log->numof < 2) || (log->first_sector >= mtd->sector_count) ||
+        (log->numof > (mtd->sector_count - log->first_sector)) ||
+        (log->sector_size % TSLOG_BUF_SIZE) ||
+        (log->sector_size < (TSLOG_SECTOR_HDR_SIZE + TSLOG_RECORD_HDR_SIZE))) {
+        return -EINVAL;
+    }
+    memset(&log->stats, 0, sizeof(log->stats));
+    _set_empty(log);
+    return 0;
+}
+
+/* find the end of the data in the head sector */
+static int _scan_head(tslog_t *log, uint32_t first_time)
+{
+    uint32_t pos = TSLOG_SECTOR_HDR_SIZE;
+
+    log->last_time = first_time;
+    log->sealed = false;
+    while ((pos + TSLOG_RECORD_HDR_SIZE) <= log->sector_size) {
+        _record_hdr_t hdr;
+        int res = _read(log, log->head, pos, &hdr, sizeof(hdr));
+        if (res < 0) {
+            return res;
+        }
+        if (_is_erased(&hdr)) {
+            break;
+        }
+
+        uint32_t size = _record_size(hdr.len);
+        uint16_t crc = crc16_ccitt_calc((const uint8_t *)&hdr,
+                                        offsetof(_record_hdr_t, crc));
+        if ((hdr.len == UINT16_MAX) || ((pos + size) > log->sector_size)) {
+            log->sealed = true;
+            break;
+        }
+        for (uint32_t done = 0; done < hdr.len;) {
+            uint8_t chunk[32];
+            uint32_t n = hdr.len - done;
+            if (n > sizeof(chunk)) {
+                n = sizeof(chunk);
+            }
+            res = _read(log, log->head, pos + TSLOG_RECORD_HDR_SIZE + done,
+                        chunk, n);
+            if (res < 0) {
+                return res;
+            }
+            crc = crc16_ccitt_update(crc, chunk, n);
+            done += n;
+        }
+        if (crc != hdr.crc) {
+            /* torn write, don't touch the rest of this sector */
+            DEBUG("tslog: torn record at %" PRIu32 "\n", pos);
+            log->sealed = true;
+            break;
+        }
+        log->last_time = hdr.time;
+        pos += size;
+    }
+    log->wpos = pos;
+
+    /* load the partially written buffer */
+    uint32_t buf_addr = pos - (pos % sizeof(log->buf));
+    _reset_buf(log, buf_addr);
+    int res = _read(log, log->head, buf_addr, log->buf, pos - buf_addr);
+    if (res < 0) {
+        return res;
+    }
+    log->buf_fill = pos - buf_addr;
+    log->buf_flushed = log->buf_fill;
+    return 0;
+}
+
+int tslog_format(tslog_t *log)
+{
+    int res = _setup(log);
+    if (res < 0) {
+        return res;
+    }
+    res = mtd_erase(log->mtd, _addr(log, 0, 0), log->numof * log->sector_size);
+    if (res < 0) {
+        return res;
+    }
+    log->stats.erases += log->numof;
+    return 0;
+}
+
+int tslog_mount(tslog_t *log)
+{
+    int res = _setup(log);
+    if (res < 0) {
+        return res;
+    }
+
+    _sector_hdr_t hdr, head_hdr = { 0 };
+    bool found = false;
+    for (uint32_t i = 0; i < log->numof; i++) {
+        res = _read_sector_hdr(log, i, &hdr);
+        if (res == -ENOENT) {
+            continue;
+        }
+        if (res < 0) {
+            return res;
+        }
+        if (!found || ((int32_t)(hdr.seq - log->head_seq) > 0)) {
+            log->head = i;
+            log->head_seq = hdr.seq;
+            head_hdr = hdr;
+            found = true;
+        }
+    }
+    if (!found) {
+        DEBUG("tslog: empty\n");
+        return 0;
+    }
+
+    /* older sectors precede the head with consecutive sequence numbers */
+    log->count = 1;
+    for (uint32_t i = 1; i < log->numof; i++) {
+        uint32_t sector = (log->head + log->numof - i) % log->numof;
+        res = _read_sector_hdr(log, sector, &hdr);
+        if ((res < 0) && (res != -ENOENT)) {
+            return res;
+        }
+        if ((res == -ENOENT) || (hdr.seq != (log->head_seq - i))) {
+            break;
+        }
+        log->count++;
+    }
+
+    DEBUG("tslog: head %" PRIu32 ", seq %" PRIu32 ", %" PRIu32 " sectors\n",
+          log->head, log->head_seq, log->count);
+    return _scan_head(log, head_hdr.first_time);
+}
+
+int tslog_append(tslog_t *log, uint32_t time, const void *data, size_t len)
+{
+    uint32_t size = _record_size(len);
+
+    if ((len >= UINT16_MAX) ||
+        ((TSLOG_SECTOR_HDR_SIZE + size) > log->sector_size)) {
+        return -EFBIG;
+    }
+
+    mutex_lock(&log->lock);
+    int res = 0;
+    if ((log->count > 0) && (time < log->last_time)) {
+        res = -EINVAL;
+        goto out;
+    }
+    if (log->sealed || ((log->wpos + size) > log->sector_size)) {
+        if ((res = _open_sector(log, time)) < 0) {
+            goto out;
+        }
+    }
+
+    _record_hdr_t hdr = {
+        .time = time,
+        .len = len,
+    };
+    hdr.crc = _record_crc(&hdr, data);
+    if (((res = _put(log, &hdr, sizeof(hdr))) < 0) ||
+        ((res = _put(log, data, len)) < 0) ||
+        ((res = _put(log, _erased, size - sizeof(hdr) - len)) < 0)) {
+        goto out;
+    }
+    log->last_time = time;
+out:
+    mutex_unlock(&log->lock);
+    return res;
+}
+
+int tslog_flush(tslog_t *log)
+{
+    mutex_lock(&log->lock);
+    int res = _flush(log);
+    mutex_unlock(&log->lock);
+    return res;
+}
+
+int tslog_iter_init(tslog_t *log, tslog_iter_t *it, uint32_t from,
+                    uint32_t to)
+{
+    int res = 0;
+
+    it->from = from;
+    it->to = to;
+    it->end = false;
+
+    mutex_lock(&log->lock);
+    if (log->count == 0) {
+        it->end = true;
+        goto out;
+    }
+
+    /* binary search for the last sector starting before from, records at
+     * from may also end the sector before one starting at from */
+    uint32_t oldest = (log->head + log->numof - log->count + 1) % log->numof;
+    uint32_t lo = 0, hi = log->count, k = 0;
+    while (lo < hi) {
+        uint32_t mid = lo + (hi - lo) / 2;
+        _sector_hdr_t hdr;
+        res = _read_sector_hdr(log, (oldest + mid) % log->numof, &hdr);
+        if (res < 0) {
+            goto out;
+        }
+        if (hdr.first_time < from) {
+            k = mid;
+            lo = mid + 1;
+        }
+        else {
+            hi = mid;
+        }
+    }
+    it->sector = (oldest + k) % log->numof;
+    it->seq = log->head_seq - log->count + 1 + k;
+    it->pos = TSLOG_SECTOR_HDR_SIZE;
+out:
+    mutex_unlock(&log->lock);
+    return res;
+}
+
+/* get the header of the record at the iterator position, -ENOENT if there
+ * are no more records in the current sector */
+static int _iter_hdr(tslog_t *log, tslog_iter_t *it, _record_hdr_t *hdr)
+{
+    if ((it->pos + TSLOG_RECORD_HDR_SIZE) > log->sector_size) {
+        return -ENOENT;
+    }
+    int res = _read(log, it->sector, it->pos, hdr, sizeof(*hdr));
+    if (res < 0) {
+        return res;
+    }
+    if (_is_erased(hdr) || (hdr->len == UINT16_MAX) ||
+        ((it->pos + _record_size(hdr->len)) > log->sector_size)) {
+        return -ENOENT;
+    }
+    return 0;
+}
+
+int tslog_iter_next(tslog_t *log, tslog_iter_t *it, uint32_t *time,
+                    void *data, size_t len)
+{
+    int res = -ENOENT;
+
+    mutex_lock(&log->lock);
+    while (!it->end) {
+        uint32_t oldest_seq = log->head_seq - log->count + 1;
+        if ((int32_t)(it->seq - oldest_seq) < 0) {
+            /* overwritten while iterating, continue with the oldest data */
+            it->seq = oldest_seq;
+            it->sector = (log->head + log->numof - log->count + 1) % log->numof;
+            it->pos = TSLOG_SECTOR_HDR_SIZE;
+        }
+        bool at_head = (it->seq == log->head_seq);
+        if (at_head && (it->pos >= log->wpos)) {
+            it->end = true;
+            break;
+        }
+
+        _record_hdr_t hdr;
+        res = _iter_hdr(log, it, &hdr);
+        if (res == 0) {
+            if (hdr.time < it->from) {
+                it->pos += _record_size(hdr.len);
+                continue;
+            }
+            if (hdr.time > it->to) {
+                it->end = true;
+                res = -ENOENT;
+                break;
+            }
+            if (hdr.len > len) {
+                res = -ENOBUFS;
+                break;
+            }
+            res = _read(log, it->sector, it->pos + TSLOG_RECORD_HDR_SIZE,
+                        data, hdr.len);
+            if (res < 0) {
+                break;
+            }
+            if (_record_crc(&hdr, data) == hdr.crc) {
+                it->pos += _record_size(hdr.len);
+                *time = hdr.time;
+                res = hdr.len;
+                break;
+            }
+            DEBUG("tslog: bad record in sector %" PRIu32 " at %" PRIu32 "\n",
+                  it->sector, it->pos);
+        }
+        else if (res != -ENOENT) {
+            break;
+        }
+
+        /* the rest of this sector holds no (intact) records */
+        res = -ENOENT;
+        if (at_head) {
+            it->end = true;
+            break;
+        }
+        it->seq++;
+        it->sector = (it->sector + 1) % log->numof;
+        it->pos = TSLOG_SECTOR_HDR_SIZE;
+    }
+    mutex_unlock(&log->lock);
+    return res;
+}
@@ -15,6 +15,7 @@
  */
 
 #include <errno.h> /* for error codes */
+#include <stdbool.h> /* for bool */
 #include <string.h> /* for strncmp */
 #include <stddef.h> /* for NULL */
 #include <sys/types.h> /* for off_t etc */
@@ -23,6 +24,7 @@
 #include <fcntl.h> /* for O_ACCMODE, ..., fcntl */
 #include <unistd.h> /* for STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO */
 
+#include "bitarithm.h"
 #include "vfs.h"
 #include "mutex.h"
 #include "thread.h"
@@ -59,6 +61,28 @@ static vfs_file_t _vfs_open_files[VFS_MAX_OPEN_FILES];
  */
 static clist_node_t _vfs_mounts_list;
 
+/**
+ * @internal
+ * @brief Number of bits in a word of _vfs_used_fds
+ */
+#define FD_WORD_BITS        (sizeof(unsigned) * 8)
+
+/**
+ * @internal
+ * @brief Bitmap of the used entries of _vfs_open_files
+ *
+ * Bit n is set while fd n is allocated, so a free fd is found without
+ * scanning the open files table.
+ */
+static unsigned _vfs_used_fds[(VFS_MAX_OPEN_FILES + FD_WORD_BITS - 1) / FD_WORD_BITS];
+
+/**
+ * @internal
+ * @brief fds that are not handed out by VFS_ANY_FD allocations
+ */
+#define FD_RESERVED_MASK    ((1u << STDIN_FILENO) | (1u << STDOUT_FILENO) | \
+                             (1u << STDERR_FILENO))
+
 /**
  * @internal
  * @brief Find an unused entry in the _vfs_open_files array and mark it as used
@@ -129,6 +153,12 @@ static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
  */
 static inline int _fd_is_valid(int fd);
 
+/**
+ * @internal
+ * @brief Compare two mounts by mount point length, longest first
+ */
+static int _mount_cmp(clist_node_t *a, clist_node_t *b);
+
 static mutex_t _mount_mutex = MUTEX_INIT;
 static mutex_t _open_mutex = MUTEX_INIT;
 
@@ -310,6 +340,154 @@ ssize_t vfs_read(int fd, void *dest, size_t count)
     return filp->f_op->read(filp, dest, count);
 }
 
+ssize_t vfs_read_ptr(int fd, const void **ptr, size_t count)
+{
+    DEBUG("vfs_read_ptr: %d, %p, %lu\n", fd, (void *)ptr, (unsigned long)count);
+    if (ptr == NULL) {
+        return -EFAULT;
+    }
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_RDONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for reading */
+        return -EBADF;
+    }
+    if (filp->f_op->read_ptr == NULL) {
+        /* file contents are not directly addressable */
+        return -ENOTSUP;
+    }
+    return filp->f_op->read_ptr(filp, ptr, count);
+}
+
+ssize_t vfs_readv(int fd, const iolist_t *iolist)
+{
+    DEBUG("vfs_readv: %d, %p\n", fd, (void *)iolist);
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_RDONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for reading */
+        return -EBADF;
+    }
+    if (filp->f_op->readv != NULL) {
+        return filp->f_op->readv(filp, iolist);
+    }
+    if (filp->f_op->read == NULL) {
+        /* driver does not implement read() */
+        return -EINVAL;
+    }
+    /* emulate with a read() per buffer */
+    ssize_t total = 0;
+    for (; iolist != NULL; iolist = iolist->iol_next) {
+        if (iolist->iol_base == NULL) {
+            return -EFAULT;
+        }
+        ssize_t nbytes = filp->f_op->read(filp, iolist->iol_base, iolist->iol_len);
+        if (nbytes < 0) {
+            /* report the error only if nothing was read */
+            return (total > 0) ? total : nbytes;
+        }
+        total += nbytes;
+        if ((size_t)nbytes < iolist->iol_len) {
+            /* end of file */
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t vfs_writev(int fd, const iolist_t *iolist)
+{
+    DEBUG("vfs_writev: %d, %p\n", fd, (void *)iolist);
+    int res = _fd_is_valid(fd);
+    if (res < 0) {
+        return res;
+    }
+    vfs_file_t *filp = &_vfs_open_files[fd];
+    if (((filp->flags & O_ACCMODE) != O_WRONLY) & ((filp->flags & O_ACCMODE) != O_RDWR)) {
+        /* File not open for writing */
+        return -EBADF;
+    }
+    if (filp->f_op->writev != NULL) {
+        return filp->f_op->writev(filp, iolist);
+    }
+    if (filp->f_op->write == NULL) {
+        /* driver does not implement write() */
+        return -EINVAL;
+    }
+    /* emulate with a write() per buffer */
+    ssize_t total = 0;
+    for (; iolist != NULL; iolist = iolist->iol_next) {
+        if (iolist->iol_base == NULL) {
+            return -EFAULT;
+        }
+        ssize_t nbytes = filp->f_op->write(filp, iolist->iol_base, iolist->iol_len);
+        if (nbytes < 0) {
+            /* report the error only if nothing was written */
+            return (total > 0) ? total : nbytes;
+        }
+        total += nbytes;
+        if ((size_t)nbytes < iolist->iol_len) {
+            /* out of space */
+            break;
+        }
+    }
+    return total;
+}
+
+ssize_t vfs_sendfile(int fd, size_t count, vfs_sendfile_cb_t cb, void *arg,
+                     void *buf, size_t buf_len)
+{
+    DEBUG("vfs_sendfile: %d, %lu, %p, %lu\n", fd, (unsigned long)count, buf,
+          (unsigned long)buf_len);
+    if (cb == NULL) {
+        return -EINVAL;
+    }
+    ssize_t total = 0;
+    bool direct = true;
+    while ((size_t)total < count) {
+        size_t chunk = count - total;
+        const void *data;
+        ssize_t nbytes = -ENOTSUP;
+        if ((buf_len > 0) && (chunk > buf_len)) {
+            chunk = buf_len;
+        }
+        if (direct) {
+            nbytes = vfs_read_ptr(fd, &data, chunk);
+            direct = (nbytes != -ENOTSUP);
+        }
+        if (!direct) {
+            if ((buf == NULL) || (buf_len == 0)) {
+                return -EFAULT;
+            }
+            data = buf;
+            nbytes = vfs_read(fd, buf, chunk);
+        }
+        if (nbytes <= 0) {
+            /* end of file or error, report the error only if nothing was sent */
+            return ((nbytes == 0) || (total > 0)) ? total : nbytes;
+        }
+        /* offer the rest of the chunk until the consumer takes nothing */
+        for (ssize_t done = 0; done < nbytes;) {
+            ssize_t sent = cb(arg, (const uint8_t *)data + done, nbytes - done);
+            if (sent <= 0) {
+                /* give back what was not consumed */
+                vfs_lseek(fd, -(off_t)(nbytes - done), SEEK_CUR);
+                total += done;
+                return ((sent == 0) || (total > 0)) ? total : sent;
+            }
+            done += (sent < nbytes - done) ? sent : nbytes - done;
+        }
+        total += nbytes;
+    }
+    return total;
+}
+
 
 ssize_t vfs_write(int fd, const void *src, size_t count)
 {
@@ -481,8 +659,10 @@ int vfs_mount(vfs_mount_t *mountp)
             }
         }
     }
-    /* insert last in list */
+    /* keep the list sorted by descending mount point length, so the first
+     * matching mount in _find_mount is the longest match */
     clist_rpush(&_vfs_mounts_list, &mountp->list_entry);
+    clist_sort(&_vfs_mounts_list, _mount_cmp);
     mutex_unlock(&_mount_mutex);
     DEBUG("vfs_mount: mount done\n");
     return 0;
@@ -867,18 +1047,23 @@ const vfs_mount_t *vfs_iterate_mounts(const vfs_mount_t *cur)
 static inline int _allocate_fd(int fd)
 {
     if (fd < 0) {
-        for (fd = 0; fd < VFS_MAX_OPEN_FILES; ++fd) {
-            if ((fd == STDIN_FILENO) || (fd == STDOUT_FILENO) || (fd == STDERR_FILENO)) {
+        for (unsigned i = 0; i < ARRAY_SIZE(_vfs_used_fds); ++i) {
+            unsigned free = ~_vfs_used_fds[i];
+            if (i == 0) {
                 /* Do not auto-allocate the stdio file descriptor numbers to
                  * avoid conflicts between normal file system users and stdio
                  * drivers such as stdio_uart, stdio_rtt which need to be able
                  * to bind to these specific file descriptor numbers. */
-                continue;
+                free &= ~FD_RESERVED_MASK;
             }
-            if (_vfs_open_files[fd].pid == KERNEL_PID_UNDEF) {
+            if (free != 0) {
+                fd = i * FD_WORD_BITS + bitarithm_lsb(free);
                 break;
             }
         }
+        if (fd < 0) {
+            fd = VFS_MAX_OPEN_FILES;
+        }
     }
     if (fd >= VFS_MAX_OPEN_FILES) {
         /* The _vfs_open_files array is full */
@@ -895,6 +1080,7 @@ static inline int _allocate_fd(int fd)
         pid = -1;
     }
     _vfs_open_files[fd].pid = pid;
+    _vfs_used_fds[fd / FD_WORD_BITS] |= 1u << (fd % FD_WORD_BITS);
     return fd;
 }
 
@@ -905,6 +1091,9 @@ static inline void _free_fd(int fd)
         atomic_fetch_sub(&_vfs_open_files[fd].mp->open_files, 1);
     }
     _vfs_open_files[fd].pid = KERNEL_PID_UNDEF;
+    mutex_lock(&_open_mutex);
+    _vfs_used_fds[fd / FD_WORD_BITS] &= ~(1u << (fd % FD_WORD_BITS));
+    mutex_unlock(&_open_mutex);
 }
 
 static inline int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *mountp, int flags, void *private_data)
@@ -922,44 +1111,42 @@ static inline int _init_fd(int fd, const vfs_file_ops_t *f_op, vfs_mount_t *moun
     return fd;
 }
 
+static int _mount_cmp(clist_node_t *a, clist_node_t *b)
+{
+    size_t a_len = container_of(a, vfs_mount_t, list_entry)->mount_point_len;
+    size_t b_len = container_of(b, vfs_mount_t, list_entry)->mount_point_len;
+    return (a_len < b_len) - (a_len > b_len);
+}
+
 static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const char **rel_path)
 {
-    size_t longest_match = 0;
     size_t name_len = strlen(name);
     mutex_lock(&_mount_mutex);
 
-    clist_node_t *node = _vfs_mounts_list.next;
-    if (node == NULL) {
-        /* list empty */
-        mutex_unlock(&_mount_mutex);
-        return -ENOENT;
-    }
     vfs_mount_t *mountp = NULL;
-    do {
-        node = node->next;
-        vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
-        size_t len = it->mount_point_len;
-        if (len < longest_match) {
-            /* Already found a longer prefix */
-            continue;
-        }
-        if (len > name_len) {
-            /* path name is shorter than the mount point name */
-            continue;
-        }
-        if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
-            /* name does not have a directory separator where mount point name ends */
-            continue;
-        }
-        if (strncmp(name, it->mount_point, len) == 0) {
-            /* mount_point is a prefix of name */
-            /* special check for mount_point == "/" */
-            if (len > 1) {
-                longest_match = len;
+    clist_node_t *node = _vfs_mounts_list.next;
+    if (node != NULL) {
+        /* The list is sorted by descending mount point length, the first
+         * match is the longest prefix */
+        do {
+            node = node->next;
+            vfs_mount_t *it = container_of(node, vfs_mount_t, list_entry);
+            size_t len = it->mount_point_len;
+            if (len > name_len) {
+                /* path name is shorter than the mount point name */
+                continue;
             }
-            mountp = it;
-        }
-    } while (node != _vfs_mounts_list.next);
+            if ((len > 1) && (name[len] != '/') && (name[len] != '\0')) {
+                /* name does not have a directory separator where mount point name ends */
+                continue;
+            }
+            if (strncmp(name, it->mount_point, len) == 0) {
+                /* mount_point is a prefix of name */
+                mountp = it;
+                break;
+            }
+        } while (node != _vfs_mounts_list.next);
+    }
     if (mountp == NULL) {
         /* not found */
         mutex_unlock(&_mount_mutex);
@@ -970,7 +1157,8 @@ static inline int _find_mount(vfs_mount_t **mountpp, const char *name, const cha
     mutex_unlock(&_mount_mutex);
     *mountpp = mountp;
     if (rel_path != NULL) {
-        *rel_path = name + longest_match;
+        /* special case for mount_point == "/" */
+        *rel_path = name + ((mountp->mount_point_len > 1) ? mountp->mount_point_len : 0);
     }
     return 0;
 }
@@ -0,0 +1,243 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Ping flood latency benchmark for the GNRC receive path
+ *
+ * @}
+ */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "mutex.h"
+#include "net/ethernet.h"
+#include "net/ethertype.h"
+#include "net/gnrc.h"
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/netif/ethernet.h"
+#include "net/icmpv6.h"
+#include "net/inet_csum.h"
+#include "net/ipv6/hdr.h"
+#include "net/netdev_test.h"
+#include "net/protnum.h"
+#include "thread.h"
+#include "xtimer.h"
+
+#ifndef BENCH_PINGS
+#define BENCH_PINGS         (10000U)
+#endif
+
+#define PING_PAYLOAD_LEN    (32U)
+#define PING_ID             (0x2d3bU)
+#define PING_TIMEOUT        (US_PER_SEC)
+
+#define OWN_MAC             { 0xce, 0xab, 0xfe, 0xad, 0xf7, 0x26, }
+#define NBR_MAC             { 0x57, 0x44, 0x33, 0x22, 0x11, 0x00, }
+#define NBR_LINK_LOCAL      { 0xfe, 0x80, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, \
+                              0x55, 0x44, 0x33, 0xff, 0xfe, 0x22, 0x11, 0x00, }
+
+#define ECHO_LEN            (sizeof(icmpv6_echo_t) + PING_PAYLOAD_LEN)
+#define FRAME_LEN           (sizeof(ethernet_hdr_t) + sizeof(ipv6_hdr_t) + \
+                             ECHO_LEN)
+
+static const uint8_t _own_mac[] = OWN_MAC;
+static const uint8_t _nbr_mac[] = NBR_MAC;
+static const ipv6_addr_t _nbr_link_local = { .u8 = NBR_LINK_LOCAL };
+
+static netdev_test_t _netdev;
+static gnrc_netif_t *_netif;
+static char _netif_stack[THREAD_STACKSIZE_DEFAULT];
+
+static uint8_t _frame[FRAME_LEN];
+static mutex_t _reply = MUTEX_INIT_LOCKED;
+static volatile uint16_t _expected_seq;
+
+static int _get_device_type(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = NETDEV_TYPE_ETHERNET;
+    return sizeof(uint16_t);
+}
+
+static int _get_max_packet_size(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len == sizeof(uint16_t));
+    *((uint16_t *)value) = ETHERNET_DATA_LEN;
+    return sizeof(uint16_t);
+}
+
+static int _get_address(netdev_t *dev, void *value, size_t max_len)
+{
+    (void)dev;
+    assert(max_len >= sizeof(_own_mac));
+    memcpy(value, _own_mac, sizeof(_own_mac));
+    return sizeof(_own_mac);
+}
+
+static void _isr(netdev_t *dev)
+{
+    dev->event_callback(dev, NETDEV_EVENT_RX_COMPLETE);
+}
+
+static int _recv(netdev_t *dev, char *buf, int len, void *info)
+{
+    (void)dev;
+    (void)info;
+    if (buf == NULL) {
+        return sizeof(_frame);
+    }
+    if (len < (int)sizeof(_frame)) {
+        return -ENOBUFS;
+    }
+    memcpy(buf, _frame, sizeof(_frame));
+    return sizeof(_frame);
+}
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    static uint8_t outbuf[FRAME_LEN];
+    size_t outbuf_len = 0U;
+    int res = 0;
+
+    (void)dev;
+    for (; iolist; iolist = iolist->iol_next) {
+        size_t len = iolist->iol_len;
+
+        res += len;
+        if (outbuf_len < sizeof(outbuf)) {
+            if (len > (sizeof(outbuf) - outbuf_len)) {
+                len = sizeof(outbuf) - outbuf_len;
+            }
+            memcpy(&outbuf[outbuf_len], iolist->iol_base, len);
+            outbuf_len += len;
+        }
+    }
+    if (outbuf_len == sizeof(outbuf)) {
+        ethernet_hdr_t *eth = (ethernet_hdr_t *)outbuf;
+        ipv6_hdr_t *ipv6 = (ipv6_hdr_t *)(eth + 1);
+        icmpv6_echo_t *echo = (icmpv6_echo_t *)(ipv6 + 1);
+
+        /* ignore anything but the echo reply we are waiting for (e.g. router
+         * solicitations or neighbor discovery) */
+        if ((byteorder_ntohs(eth->type) == ETHERTYPE_IPV6) &&
+            (ipv6->nh == PROTNUM_ICMPV6) &&
+            (echo->type == ICMPV6_ECHO_REP) &&
+            (byteorder_ntohs(echo->seq) == _expected_seq)) {
+            mutex_unlock(&_reply);
+        }
+    }
+    return res;
+}
+
+static void _init_netif(void)
+{
+    netdev_test_setup(&_netdev, 0);
+    netdev_test_set_get_cb(&_netdev, NETOPT_DEVICE_TYPE, _get_device_type);
+    netdev_test_set_get_cb(&_netdev, NETOPT_MAX_PDU_SIZE,
+                           _get_max_packet_size);
+    netdev_test_set_get_cb(&_netdev, NETOPT_ADDRESS, _get_address);
+    netdev_test_set_isr_cb(&_netdev, _isr);
+    netdev_test_set_recv_cb(&_netdev, _recv);
+    netdev_test_set_send_cb(&_netdev, _send);
+    _netif = gnrc_netif_ethernet_create(_netif_stack, sizeof(_netif_stack),
+                                        GNRC_NETIF_PRIO, "bench_eth",
+                                        &_netdev.netdev);
+    assert(_netif != NULL);
+    /* SLAAC is not what we want to measure so just assure the link-local
+     * address is valid */
+    assert(!ipv6_addr_is_unspecified(&_netif->ipv6.addrs[0]));
+    _netif->ipv6.addrs_flags[0] &= ~GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_MASK;
+    _netif->ipv6.addrs_flags[0] |= GNRC_NETIF_IPV6_ADDRS_FLAGS_STATE_VALID;
+}
+
+static void _build_echo_req(uint16_t seq)
+{
+    ethernet_hdr_t *eth = (ethernet_hdr_t *)_frame;
+    ipv6_hdr_t *ipv6 = (ipv6_hdr_t *)(eth + 1);
+    icmpv6_echo_t *echo = (icmpv6_echo_t *)(ipv6 + 1);
+    uint16_t csum;
+
+    memcpy(eth->dst, _own_mac, sizeof(eth->dst));
+    memcpy(eth->src, _nbr_mac, sizeof(eth->src));
+    eth->type = byteorder_htons(ETHERTYPE_IPV6);
+
+    memset(ipv6, 0, sizeof(ipv6_hdr_t));
+    ipv6_hdr_set_version(ipv6);
+    ipv6->len = byteorder_htons(ECHO_LEN);
+    ipv6->nh = PROTNUM_ICMPV6;
+    ipv6->hl = 64;
+    memcpy(&ipv6->src, &_nbr_link_local, sizeof(ipv6->src));
+    memcpy(&ipv6->dst, &_netif->ipv6.addrs[0], sizeof(ipv6->dst));
+
+    echo->type = ICMPV6_ECHO_REQ;
+    echo->code = 0;
+    echo->csum.u16 = 0;
+    echo->id = byteorder_htons(PING_ID);
+    echo->seq = byteorder_htons(seq);
+    memset(echo + 1, seq & 0xff, PING_PAYLOAD_LEN);
+
+    csum = ipv6_hdr_inet_csum(0, ipv6, PROTNUM_ICMPV6, ECHO_LEN);
+    csum = inet_csum(csum, (uint8_t *)echo, ECHO_LEN);
+    echo->csum = byteorder_htons(~csum);
+}
+
+int main(void)
+{
+    uint32_t min = UINT32_MAX, max = 0;
+    uint64_t sum = 0;
+    unsigned lost = 0;
+    int res;
+
+    _init_netif();
+    res = gnrc_ipv6_nib_nc_set(&_nbr_link_local, _netif->pid,
+                               _nbr_mac, sizeof(_nbr_mac));
+    assert(res == 0);
+    (void)res;
+
+    printf("Injecting %u ICMPv6 echo requests\n", (unsigned)BENCH_PINGS);
+    for (unsigned i = 0; i < BENCH_PINGS; i++) {
+        uint32_t start, diff;
+
+        _expected_seq = (uint16_t)i;
+        _build_echo_req((uint16_t)i);
+        start = xtimer_now_usec();
+        _netdev.netdev.event_callback(&_netdev.netdev, NETDEV_EVENT_ISR);
+        if (xtimer_mutex_lock_timeout(&_reply, PING_TIMEOUT) < 0) {
+            lost++;
+            continue;
+        }
+        diff = xtimer_now_usec() - start;
+        sum += diff;
+        if (diff < min) {
+            min = diff;
+        }
+        if (diff > max) {
+            max = diff;
+        }
+    }
+    if (lost == BENCH_PINGS) {
+        min = 0;
+    }
+    printf("{ \"result\" : { \"pings\" : %u, \"lost\" : %u, "
+           "\"min_us\" : %lu, \"avg_us\" : %lu, \"max_us\" : %lu } }\n",
+           (unsigned)BENCH_PINGS, lost, (unsigned long)min,
+           (unsigned long)((lost < BENCH_PINGS)
+                           ? (sum / (BENCH_PINGS - lost)) : 0),
+           (unsigned long)max);
+    return 0;
+}
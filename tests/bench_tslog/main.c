@@ -0,0 +1,89 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @ingroup     tests
+ * @{
+ *
+ * @file
+ * @brief       Measure flash accesses and time of time-series log appends
+ *
+ * @}
+ */
+
+#include <stdio.h>
+#include <inttypes.h>
+
+#include "board.h"
+#include "tslog.h"
+#include "xtimer.h"
+
+#ifndef SAMPLES
+#define SAMPLES         (2000U)
+#endif
+
+#ifndef SECTORS
+#define SECTORS         (16U)
+#endif
+
+typedef struct {
+    int16_t values[8];
+} sample_t;
+
+static tslog_t _log = {
+    .sector_count = SECTORS,
+};
+
+static void _run(const char *mode, bool flush_each)
+{
+    sample_t sample = { 0 };
+
+    tslog_format(&_log);
+    _log.stats.writes = 0;
+    _log.stats.erases = 0;
+
+    uint32_t start = xtimer_now_usec();
+    for (uint32_t t = 0; t < SAMPLES; t++) {
+        sample.values[t % 8] = t;
+        if (tslog_append(&_log, t, &sample, sizeof(sample)) < 0) {
+            puts("append failed");
+            return;
+        }
+        if (flush_each) {
+            tslog_flush(&_log);
+        }
+    }
+    tslog_flush(&_log);
+    uint32_t usec = xtimer_now_usec() - start;
+
+    printf("{ \"mode\" : \"%s\", \"writes\" : %" PRIu32 ", \"erases\" : %"
+           PRIu32 ", \"usec\" : %" PRIu32 " }\n",
+           mode, _log.stats.writes, _log.stats.erases, usec);
+}
+
+int main(void)
+{
+    _log.mtd = MTD_0;
+
+    _run("unbuffered", true);
+    _run("buffered", false);
+
+    /* query the newest tenth of the data */
+    tslog_iter_t it;
+    sample_t sample;
+    uint32_t time, n = 0;
+    uint32_t start = xtimer_now_usec();
+    tslog_iter_init(&_log, &it, SAMPLES - SAMPLES / 10, UINT32_MAX);
+    while (tslog_iter_next(&_log, &it, &time, &sample, sizeof(sample)) >= 0) {
+        n++;
+    }
+    uint32_t usec = xtimer_now_usec() - start;
+    printf("{ \"query\" : %" PRIu32 ", \"usec\" : %" PRIu32 " }\n", n, usec);
+
+    return 0;
+}
@@ -0,0 +1,21 @@
+#!/usr/bin/env python3
+
+# Copyright (C) 2020 Freie Universität Berlin
+#
+# This file is subject to the terms and conditions of the GNU Lesser
+# General Public License v2.1. See the file LICENSE in the top level
+# directory for more details.
+
+import sys
+from testrunner import run
+
+
+def testfunc(child):
+    for mode in ("unbuffered", "buffered"):
+        child.expect(r"{ \"mode\" : \"%s\", \"writes\" : \d+, "
+                     r"\"erases\" : \d+, \"usec\" : \d+ }" % mode)
+    child.expect(r"{ \"query\" : \d+, \"usec\" : \d+ }")
+
+
+if __name__ == "__main__":
+    sys.exit(run(testfunc, timeout=60))
@@ -0,0 +1,149 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @addtogroup  unittests
+ * @{
+ *
+ * @file
+ * @brief       RAM based MTD mock with NOR flash semantics
+ *
+ * Programming only clears bits, erasing sets all bits of whole sectors.
+ * Writes must not cross a page boundary. The driver calls are counted.
+ */
+#ifndef MTD_NOR_MOCK_H
+#define MTD_NOR_MOCK_H
+
+#include <errno.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "mtd.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * @brief   The mock device
+ */
+typedef struct {
+    mtd_dev_t base;             /**< mtd generic device */
+    uint8_t *mem;               /**< the emulated memory */
+    unsigned reads;             /**< number of read calls */
+    unsigned writes;            /**< number of write calls */
+    unsigned erases;            /**< number of sectors erased */
+} mtd_nor_mock_t;
+
+/**
+ * @brief   Initializer for a mock device
+ *
+ * @param[in] _mem              Memory of at least the size of the device
+ * @param[in] _sector_count     Number of sectors
+ * @param[in] _pages_per_sector Pages per sector
+ * @param[in] _page_size        Size of a page
+ */
+#define MTD_NOR_MOCK_INIT(_mem, _sector_count, _pages_per_sector, _page_size) \
+    {                                                                         \
+        .base = {                                                             \
+            .driver = &mtd_nor_mock_driver,                                   \
+            .sector_count = (_sector_count),                                  \
+            .pages_per_sector = (_pages_per_sector),                          \
+            .page_size = (_page_size),                                        \
+        },                                                                    \
+        .mem = (_mem),                                                        \
+    }
+
+static inline uint32_t _mtd_nor_mock_size(const mtd_dev_t *dev)
+{
+    return dev->sector_count * dev->pages_per_sector * dev->page_size;
+}
+
+static inline int _mtd_nor_mock_init(mtd_dev_t *dev)
+{
+    (void)dev;
+    return 0;
+}
+
+static inline int _mtd_nor_mock_read(mtd_dev_t *dev, void *buff,
+                                     uint32_t addr, uint32_t size)
+{
+    mtd_nor_mock_t *mock = (mtd_nor_mock_t *)dev;
+
+    if ((addr > _mtd_nor_mock_size(dev)) ||
+        (size > _mtd_nor_mock_size(dev) - addr)) {
+        return -EOVERFLOW;
+    }
+    memcpy(buff, mock->mem + addr, size);
+    mock->reads++;
+    return size;
+}
+
+static inline int _mtd_nor_mock_write(mtd_dev_t *dev, const void *buff,
+                                      uint32_t addr, uint32_t size)
+{
+    mtd_nor_mock_t *mock = (mtd_nor_mock_t *)dev;
+    const uint8_t *src = buff;
+
+    if ((addr > _mtd_nor_mock_size(dev)) ||
+        (size > _mtd_nor_mock_size(dev) - addr)) {
+        return -EOVERFLOW;
+    }
+    if (((addr % dev->page_size) + size) > dev->page_size) {
+        return -EOVERFLOW;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        mock->mem[addr + i] &= src[i];
+    }
+    mock->writes++;
+    return size;
+}
+
+static inline int _mtd_nor_mock_erase(mtd_dev_t *dev, uint32_t addr,
+                                      uint32_t size)
+{
+    mtd_nor_mock_t *mock = (mtd_nor_mock_t *)dev;
+    uint32_t sector_size = dev->pages_per_sector * dev->page_size;
+
+    if ((addr > _mtd_nor_mock_size(dev)) ||
+        (size > _mtd_nor_mock_size(dev) - addr)) {
+        return -EOVERFLOW;
+    }
+    if ((addr % sector_size) || (size % sector_size)) {
+        return -EOVERFLOW;
+    }
+    memset(mock->mem + addr, 0xff, size);
+    mock->erases += size / sector_size;
+    return 0;
+}
+
+static inline int _mtd_nor_mock_power(mtd_dev_t *dev,
+                                      enum mtd_power_state power)
+{
+    (void)dev;
+    (void)power;
+    return 0;
+}
+
+/**
+ * @brief   Driver of the mock device
+ */
+static const mtd_desc_t mtd_nor_mock_driver = {
+    .init = _mtd_nor_mock_init,
+    .read = _mtd_nor_mock_read,
+    .write = _mtd_nor_mock_write,
+    .erase = _mtd_nor_mock_erase,
+    .power = _mtd_nor_mock_power,
+};
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* MTD_NOR_MOCK_H */
+/** @} */
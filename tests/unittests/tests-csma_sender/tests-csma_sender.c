@@ -0,0 +1,235 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <assert.h>
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/csma_sender.h"
+#include "net/netdev.h"
+
+#include "tests-csma_sender.h"
+
+#define SEND_RES        (10)
+/* enough samples to move a rate from 0% to 100% and back */
+#define SAMPLES_NUMOF   (64U)
+
+static unsigned _ccas;
+static bool _busy;
+static uint16_t _channel;
+static csma_sender_stats_t _stats;
+static netdev_t _dev;
+
+/* backoffs of at most 7 periods and no retries to keep the tests fast */
+static const csma_sender_conf_t _conf = {
+    .min_be = 1,
+    .max_be = 3,
+    .max_backoffs = 0,
+    .backoff_period = CSMA_SENDER_BACKOFF_PERIOD_UNIT,
+};
+
+static int _send(netdev_t *dev, const iolist_t *iolist)
+{
+    (void)dev;
+    (void)iolist;
+    return SEND_RES;
+}
+
+static int _get(netdev_t *dev, netopt_t opt, void *value, size_t max_len)
+{
+    (void)dev;
+    (void)max_len;
+
+    switch (opt) {
+        case NETOPT_IS_CHANNEL_CLR:
+            assert(max_len >= sizeof(netopt_enable_t));
+            _ccas++;
+            *((netopt_enable_t *)value) = _busy ? NETOPT_DISABLE
+                                                : NETOPT_ENABLE;
+            return sizeof(netopt_enable_t);
+        case NETOPT_CHANNEL:
+            assert(max_len >= sizeof(uint16_t));
+            *((uint16_t *)value) = _channel;
+            return sizeof(uint16_t);
+        default:
+            return -ENOTSUP;
+    }
+}
+
+static const netdev_driver_t _driver = {
+    .send = _send,
+    .get = _get,
+};
+
+static void set_up(void)
+{
+    _ccas = 0;
+    _busy = false;
+    _channel = 11;
+    memset(&_stats, 0, sizeof(_stats));
+    _dev.driver = &_driver;
+}
+
+static int _send_adaptive(uint8_t dst)
+{
+    iolist_t iolist = { .iol_base = &dst, .iol_len = sizeof(dst) };
+
+    return csma_sender_csma_ca_send_adaptive(&_dev, &iolist, &_conf, &_stats,
+                                             &dst, sizeof(dst));
+}
+
+static csma_sender_link_t *_nbr_find(uint8_t addr)
+{
+    for (unsigned i = 0; i < CSMA_SENDER_ADAPTIVE_NBRS_NUMOF; i++) {
+        if ((_stats.nbrs[i].addr_len == 1) && (_stats.nbrs[i].addr[0] == addr)) {
+            return &_stats.nbrs[i];
+        }
+    }
+    return NULL;
+}
+
+static void test_csma_sender__max_backoffs(void)
+{
+    const csma_sender_conf_t conf = {
+        .min_be = 1,
+        .max_be = 3,
+        .max_backoffs = 2,
+        .backoff_period = CSMA_SENDER_BACKOFF_PERIOD_UNIT,
+    };
+    iolist_t iolist = { .iol_base = &_ccas, .iol_len = sizeof(_ccas) };
+
+    TEST_ASSERT_EQUAL_INT(SEND_RES,
+                          csma_sender_csma_ca_send(&_dev, &iolist, &conf));
+    TEST_ASSERT_EQUAL_INT(1, _ccas);
+    _ccas = 0;
+    _busy = true;
+    /* bounded by max_backoffs, not by max_be */
+    TEST_ASSERT_EQUAL_INT(-EBUSY,
+                          csma_sender_csma_ca_send(&_dev, &iolist, &conf));
+    TEST_ASSERT_EQUAL_INT(conf.max_backoffs + 1, _ccas);
+}
+
+static void test_csma_sender__adaptive_busy_rate(void)
+{
+    csma_sender_link_t *chan;
+
+    TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+    chan = _stats.last_channel;
+    TEST_ASSERT_NOT_NULL(chan);
+    TEST_ASSERT_EQUAL_INT(_conf.min_be, chan->be);
+    TEST_ASSERT_EQUAL_INT(0, chan->busy_rate);
+
+    _busy = true;
+    for (unsigned i = 0; i < SAMPLES_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(-EBUSY, _send_adaptive(1));
+    }
+    TEST_ASSERT(chan == _stats.last_channel);
+    TEST_ASSERT_EQUAL_INT(CSMA_SENDER_ADAPTIVE_RATE_SCALE, chan->busy_rate);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF + 1, chan->cnt.tx_count);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF + 1, chan->cnt.cca_count);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF, chan->cnt.cca_busy);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF, chan->cnt.access_failed);
+    TEST_ASSERT_EQUAL_INT(_conf.max_be, chan->be);
+
+    _busy = false;
+    for (unsigned i = 0; i < SAMPLES_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+    }
+    TEST_ASSERT_EQUAL_INT(0, chan->busy_rate);
+    TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+    TEST_ASSERT_EQUAL_INT(_conf.min_be, chan->be);
+}
+
+static void test_csma_sender__adaptive_retry_rate(void)
+{
+    csma_sender_link_t *nbr;
+
+    for (unsigned i = 0; i < SAMPLES_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+        csma_sender_tx_done(&_stats, -EHOSTUNREACH, 3);
+        TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(2));
+        csma_sender_tx_done(&_stats, 0, 0);
+    }
+    nbr = _nbr_find(1);
+    TEST_ASSERT_NOT_NULL(nbr);
+    TEST_ASSERT_EQUAL_INT(CSMA_SENDER_ADAPTIVE_RATE_SCALE, nbr->retry_rate);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF, nbr->cnt.tx_retried);
+    TEST_ASSERT_EQUAL_INT(SAMPLES_NUMOF, nbr->cnt.tx_noack);
+    nbr = _nbr_find(2);
+    TEST_ASSERT_NOT_NULL(nbr);
+    TEST_ASSERT_EQUAL_INT(0, nbr->retry_rate);
+    TEST_ASSERT_EQUAL_INT(0, nbr->cnt.tx_retried);
+    TEST_ASSERT_EQUAL_INT(0, _stats.last_channel->busy_rate);
+
+    /* the lossy link backs off longer, the clean one does not */
+    TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+    TEST_ASSERT_EQUAL_INT(_conf.max_be, _stats.last_nbr->be);
+    TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(2));
+    TEST_ASSERT_EQUAL_INT(_conf.min_be, _stats.last_nbr->be);
+
+    /* a medium busy in hardware CSMA/CA counts for the channel */
+    csma_sender_tx_done(&_stats, -EBUSY, 0);
+    TEST_ASSERT_EQUAL_INT(1, _stats.last_channel->cnt.access_failed);
+    TEST_ASSERT_EQUAL_INT(1, _stats.last_nbr->cnt.access_failed);
+    TEST_ASSERT(_stats.last_channel->busy_rate > 0);
+}
+
+static void test_csma_sender__adaptive_replace(void)
+{
+    csma_sender_link_t *chan;
+
+    for (unsigned i = 0; i <= CSMA_SENDER_ADAPTIVE_NBRS_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(i));
+    }
+    /* least recently used neighbor was replaced */
+    TEST_ASSERT_NULL(_nbr_find(0));
+    for (unsigned i = 1; i <= CSMA_SENDER_ADAPTIVE_NBRS_NUMOF; i++) {
+        TEST_ASSERT_NOT_NULL(_nbr_find(i));
+    }
+
+    /* separate statistics per channel */
+    chan = _stats.last_channel;
+    TEST_ASSERT_EQUAL_INT(11, chan->channel);
+    _channel = 26;
+    TEST_ASSERT_EQUAL_INT(SEND_RES, _send_adaptive(1));
+    TEST_ASSERT(chan != _stats.last_channel);
+    TEST_ASSERT_EQUAL_INT(26, _stats.last_channel->channel);
+    TEST_ASSERT_EQUAL_INT(1, _stats.last_channel->cnt.tx_count);
+    TEST_ASSERT_EQUAL_INT(CSMA_SENDER_ADAPTIVE_NBRS_NUMOF + 1,
+                          chan->cnt.tx_count);
+    /* the neighbor on the new channel is a new entry */
+    TEST_ASSERT_EQUAL_INT(1, _stats.last_nbr->cnt.tx_count);
+}
+
+Test *tests_csma_sender_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_csma_sender__max_backoffs),
+        new_TestFixture(test_csma_sender__adaptive_busy_rate),
+        new_TestFixture(test_csma_sender__adaptive_retry_rate),
+        new_TestFixture(test_csma_sender__adaptive_replace),
+    };
+
+    EMB_UNIT_TESTCALLER(csma_sender_tests, set_up, NULL, fixtures);
+
+    return (Test *)&csma_sender_tests;
+}
+
+void tests_csma_sender(void)
+{
+    TESTS_RUN(tests_csma_sender_tests());
+}
+/** @} */
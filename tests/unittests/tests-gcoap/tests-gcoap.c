@@ -18,6 +18,8 @@
 #include "embUnit.h"
 
 #include "net/gcoap.h"
+#include "xtimer.h"
+#include "gcoap_internal.h"
 
 #include "unittests-constants.h"
 #include "tests-gcoap.h"
@@ -49,6 +51,29 @@ static gcoap_listener_t listener_second = {
     .next          = NULL
 };
 
+static const coap_resource_t resources_subtree[] = {
+    { .path = "/prec", .methods = (COAP_GET | COAP_MATCH_SUBTREE) },
+};
+
+static const coap_resource_t resources_exact[] = {
+    { .path = "/prec/exact", .methods = (COAP_GET) },
+    { .path = "/prec/put", .methods = (COAP_PUT) },
+};
+
+static gcoap_listener_t listener_subtree = {
+    .resources     = &resources_subtree[0],
+    .resources_len = ARRAY_SIZE(resources_subtree),
+    .link_encoder  = NULL,
+    .next          = NULL
+};
+
+static gcoap_listener_t listener_exact = {
+    .resources     = &resources_exact[0],
+    .resources_len = ARRAY_SIZE(resources_exact),
+    .link_encoder  = NULL,
+    .next          = NULL
+};
+
 static const char *resource_list_str = "</act/switch>,</sensor/temp>,</test/info/all>,</second/part>";
 
 /*
@@ -392,6 +417,400 @@ static void test_gcoap__server_get_resource_list(void)
     TEST_ASSERT_EQUAL_STRING(resource_list_str, (char *)res);
 }
 
+/*
+ * A subtree resource of an earlier listener takes precedence over an exact
+ * match in a later listener, also with the resource index enabled.
+ */
+static void test_gcoap__server_find_resource_precedence(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    coap_pkt_t pdu;
+    const coap_resource_t *resource = NULL;
+
+    gcoap_register_listener(&listener_subtree);
+    gcoap_register_listener(&listener_exact);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/prec/exact");
+    TEST_ASSERT_EQUAL_INT(0, _gcoap_find_resource(&pdu, &resource));
+    TEST_ASSERT(resource == &resources_subtree[0]);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_PUT, "/prec/put");
+    TEST_ASSERT_EQUAL_INT(0, _gcoap_find_resource(&pdu, &resource));
+    TEST_ASSERT(resource == &resources_exact[1]);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/sensor/temp");
+    TEST_ASSERT_EQUAL_INT(0, _gcoap_find_resource(&pdu, &resource));
+    TEST_ASSERT(resource == &resources[1]);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_PUT, "/sensor/temp");
+    TEST_ASSERT(_gcoap_find_resource(&pdu, &resource) < 0);
+
+    gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, "/none");
+    TEST_ASSERT(_gcoap_find_resource(&pdu, &resource) < 0);
+}
+
+/* Prepares a NON request memo with a two byte token */
+static void _setup_req_memo(gcoap_request_memo_t *memo, uint16_t token,
+                            const sock_udp_ep_t *remote)
+{
+    memset(memo, 0, sizeof(*memo));
+    memo->state = GCOAP_MEMO_WAIT;
+    memo->send_limit = GCOAP_SEND_LIMIT_NON;
+    memo->remote_ep = *remote;
+    coap_build_hdr((coap_hdr_t *)&memo->msg.hdr_buf[0], COAP_TYPE_NON,
+                   (uint8_t *)&token, sizeof(token), COAP_METHOD_GET, token);
+}
+
+/*
+ * Request memos are found by token and remote endpoint, also with more
+ * memos than hash buckets, and unlinking is idempotent.
+ */
+static void test_gcoap__memo_index_req(void)
+{
+    gcoap_request_memo_t memos[3 * GCOAP_MEMO_INDEX_BUCKETS];
+    gcoap_request_memo_t *found;
+    uint8_t buf[GCOAP_HEADER_MAXLEN];
+    coap_pkt_t pdu;
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = 5683 };
+    sock_udp_ep_t other = { .family = AF_INET6, .port = 5684 };
+
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        _setup_req_memo(&memos[i], 0x100 + i, &remote);
+        _gcoap_req_memo_link(&memos[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE(memos), gcoap_op_state());
+
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        uint16_t token = 0x100 + i;
+        pdu.hdr = (coap_hdr_t *)buf;
+        coap_build_hdr(pdu.hdr, COAP_TYPE_NON, (uint8_t *)&token,
+                       sizeof(token), COAP_CODE_CONTENT, 0);
+        pdu.token = coap_hdr_data_ptr(pdu.hdr);
+        _gcoap_find_req_memo(&found, &pdu, &remote);
+        TEST_ASSERT(found == &memos[i]);
+        _gcoap_find_req_memo(&found, &pdu, &other);
+        TEST_ASSERT_NULL(found);
+    }
+
+    /* remove every other memo, twice */
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i += 2) {
+        _gcoap_req_memo_unlink(&memos[i]);
+        _gcoap_req_memo_unlink(&memos[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE(memos) / 2, gcoap_op_state());
+
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        uint16_t token = 0x100 + i;
+        pdu.hdr = (coap_hdr_t *)buf;
+        coap_build_hdr(pdu.hdr, COAP_TYPE_NON, (uint8_t *)&token,
+                       sizeof(token), COAP_CODE_CONTENT, 0);
+        pdu.token = coap_hdr_data_ptr(pdu.hdr);
+        _gcoap_find_req_memo(&found, &pdu, &remote);
+        TEST_ASSERT(found == ((i & 1) ? &memos[i] : NULL));
+    }
+
+    for (unsigned i = 1; i < ARRAY_SIZE(memos); i += 2) {
+        _gcoap_req_memo_unlink(&memos[i]);
+    }
+    TEST_ASSERT_EQUAL_INT(0, gcoap_op_state());
+}
+
+/*
+ * Observe memos are found by resource, also with more memos than hash
+ * buckets.
+ */
+static void test_gcoap__memo_index_obs(void)
+{
+    static const coap_resource_t obs_resources[2 * GCOAP_MEMO_INDEX_BUCKETS];
+    gcoap_observe_memo_t memos[ARRAY_SIZE(obs_resources)];
+    gcoap_observe_memo_t *found;
+
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        memset(&memos[i], 0, sizeof(memos[i]));
+        memos[i].resource = &obs_resources[i];
+        _gcoap_obs_memo_link(&memos[i]);
+    }
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        _gcoap_find_obs_memo_resource(&found, &obs_resources[i]);
+        TEST_ASSERT(found == &memos[i]);
+    }
+    _gcoap_find_obs_memo_resource(&found, &resources[0]);
+    TEST_ASSERT_NULL(found);
+
+    for (unsigned i = 0; i < ARRAY_SIZE(memos); i++) {
+        _gcoap_obs_memo_unlink(&memos[i]);
+        _gcoap_obs_memo_unlink(&memos[i]);
+        _gcoap_find_obs_memo_resource(&found, &obs_resources[i]);
+        TEST_ASSERT_NULL(found);
+        if (i + 1 < ARRAY_SIZE(memos)) {
+            _gcoap_find_obs_memo_resource(&found, &obs_resources[i + 1]);
+            TEST_ASSERT(found == &memos[i + 1]);
+        }
+    }
+}
+
+#if GCOAP_QBLOCK_BURST
+/* Serves 100 bytes, i.e. 7 blocks of 16 bytes */
+static ssize_t _blk_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                            void *ctx)
+{
+    (void)ctx;
+    coap_block_slicer_t slicer;
+    coap_block2_init(pdu, &slicer);
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    coap_opt_add_block2(pdu, &slicer, 1);
+    ssize_t plen = coap_opt_finish(pdu, COAP_OPT_FINISH_PAYLOAD);
+
+    uint8_t *pos = pdu->payload;
+    for (unsigned i = 0; i < 100; i++) {
+        pos += coap_blockwise_put_char(&slicer, pos, (char)i);
+    }
+    coap_block2_finish(&slicer);
+    return plen + (pos - pdu->payload);
+}
+
+static const coap_resource_t resources_blk[] = {
+    { .path = "/blk", .methods = (COAP_GET), .handler = _blk_handler },
+};
+
+static gcoap_listener_t listener_blk = {
+    .resources     = &resources_blk[0],
+    .resources_len = ARRAY_SIZE(resources_blk),
+    .link_encoder  = NULL,
+    .next          = NULL
+};
+
+/* Builds a GET /blk request with Q-Block2 options */
+static void _qblock2_req(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                         unsigned type, const uint32_t *blkopts, unsigned num)
+{
+    coap_pkt_t tmp;
+
+    gcoap_req_init(&tmp, buf, len, COAP_METHOD_GET, "/blk");
+    coap_hdr_set_type(tmp.hdr, type);
+    for (unsigned i = 0; i < num; i++) {
+        coap_opt_add_uint(&tmp, COAP_OPT_Q_BLOCK2, blkopts[i]);
+    }
+    ssize_t plen = coap_opt_finish(&tmp, COAP_OPT_FINISH_NONE);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(pdu, buf, plen));
+}
+
+/*
+ * Checks the response for a block of size 16. Only the first response
+ * answers the request; the others are NON with a new message ID.
+ */
+static void _check_qblock2_resp(coap_pkt_t *req, uint8_t *out,
+                                ssize_t len, bool first, uint32_t blknum)
+{
+    coap_pkt_t resp;
+    uint32_t num;
+    unsigned szx;
+
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&resp, out, len));
+    if (first) {
+        TEST_ASSERT_EQUAL_INT((coap_get_type(req) == COAP_TYPE_CON)
+                              ? COAP_TYPE_ACK : COAP_TYPE_NON,
+                              coap_get_type(&resp));
+        TEST_ASSERT_EQUAL_INT(coap_get_id(req), coap_get_id(&resp));
+    }
+    else {
+        TEST_ASSERT_EQUAL_INT(COAP_TYPE_NON, coap_get_type(&resp));
+        TEST_ASSERT(coap_get_id(req) != coap_get_id(&resp));
+    }
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&resp));
+    int more = coap_get_blockopt(&resp, COAP_OPT_Q_BLOCK2, &num, &szx);
+    TEST_ASSERT_EQUAL_INT(blknum < 6, more);
+    TEST_ASSERT_EQUAL_INT(blknum, num);
+    TEST_ASSERT_EQUAL_INT(0, szx);
+    TEST_ASSERT_EQUAL_INT((blknum < 6) ? 16 : 4, resp.payload_len);
+    TEST_ASSERT_EQUAL_INT(blknum * 16, resp.payload[0]);
+}
+
+/*
+ * A CON request for several blocks is answered by a piggybacked ACK for the
+ * first block, and by NON messages for the others.
+ */
+static void test_gcoap__server_qblock2_con(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    uint32_t nums[GCOAP_QBLOCK_BURST];
+    const uint32_t blkopts[] = { 1 << 4, 3 << 4, 6 << 4 };
+    const uint32_t blkopt_more = (2 << 4) | 0x8;
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = 5683 };
+    coap_pkt_t req;
+    unsigned szx = 7;
+
+    gcoap_register_listener(&listener_blk);
+
+    _qblock2_req(&req, buf, sizeof(buf), COAP_TYPE_CON, blkopts,
+                 ARRAY_SIZE(blkopts));
+    unsigned count = _gcoap_qblock2_nums(&req, nums, &szx);
+    TEST_ASSERT_EQUAL_INT(ARRAY_SIZE(blkopts), count);
+    TEST_ASSERT_EQUAL_INT(0, szx);
+
+    for (unsigned i = 0; i < count; i++) {
+        uint8_t *out;
+        bool last;
+
+        TEST_ASSERT_EQUAL_INT(blkopts[i] >> 4, nums[i]);
+        ssize_t len = _gcoap_qblock2_resp(&req, i, nums[i], szx, &remote,
+                                          &out, &last);
+        _check_qblock2_resp(&req, out, len, (i == 0), nums[i]);
+        TEST_ASSERT_EQUAL_INT((i == count - 1), last);
+    }
+
+    /* the M bit requests no burst in a CON request */
+    _qblock2_req(&req, buf, sizeof(buf), COAP_TYPE_CON, &blkopt_more, 1);
+    TEST_ASSERT_EQUAL_INT(1, _gcoap_qblock2_nums(&req, nums, &szx));
+    TEST_ASSERT_EQUAL_INT(2, nums[0]);
+}
+
+/*
+ * A NON request with the M bit set is answered by a burst of NON messages
+ * that ends with the last block.
+ */
+static void test_gcoap__server_qblock2_non(void)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    uint32_t nums[GCOAP_QBLOCK_BURST];
+    const uint32_t blkopt_more = (4 << 4) | 0x8;
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = 5683 };
+    coap_pkt_t req;
+    uint16_t prev_id = 0;
+    unsigned szx = 7;
+    unsigned sent = 0;
+
+    _qblock2_req(&req, buf, sizeof(buf), COAP_TYPE_NON, &blkopt_more, 1);
+    unsigned count = _gcoap_qblock2_nums(&req, nums, &szx);
+    TEST_ASSERT_EQUAL_INT(GCOAP_QBLOCK_BURST, count);
+
+    for (unsigned i = 0; i < count; i++) {
+        coap_pkt_t resp;
+        uint8_t *out;
+        bool last;
+
+        TEST_ASSERT_EQUAL_INT(4 + i, nums[i]);
+        ssize_t len = _gcoap_qblock2_resp(&req, i, nums[i], szx, &remote,
+                                          &out, &last);
+        _check_qblock2_resp(&req, out, len, (i == 0), nums[i]);
+        coap_parse(&resp, out, len);
+        if (i > 0) {
+            TEST_ASSERT(prev_id != coap_get_id(&resp));
+        }
+        prev_id = coap_get_id(&resp);
+        sent++;
+        if (last) {
+            break;
+        }
+    }
+    /* blocks 4, 5 and the last block 6 */
+    TEST_ASSERT_EQUAL_INT(3, sent);
+}
+#endif
+
+#if GCOAP_RESP_CACHE_SIZE
+static unsigned _cache_handler_calls;
+
+/* Responds with the Max-Age given as context */
+static ssize_t _cache_handler(coap_pkt_t *pdu, uint8_t *buf, size_t len,
+                              void *ctx)
+{
+    _cache_handler_calls++;
+    gcoap_resp_init(pdu, buf, len, COAP_CODE_CONTENT);
+    coap_opt_add_uint(pdu, COAP_OPT_MAX_AGE, *(uint32_t *)ctx);
+    ssize_t plen = coap_opt_finish(pdu, COAP_OPT_FINISH_PAYLOAD);
+    pdu->payload[0] = 'x';
+    return plen + 1;
+}
+
+static uint32_t _max_age_1 = 1;
+static uint32_t _max_age_50 = 50;
+static uint32_t _max_age_100 = 100;
+
+static const coap_resource_t resources_cache[] = {
+    { .path = "/ca", .methods = (COAP_GET | COAP_CACHEABLE),
+      .handler = _cache_handler, .context = &_max_age_100 },
+    { .path = "/cb", .methods = (COAP_GET | COAP_CACHEABLE),
+      .handler = _cache_handler, .context = &_max_age_50 },
+    { .path = "/cc", .methods = (COAP_GET | COAP_CACHEABLE),
+      .handler = _cache_handler, .context = &_max_age_100 },
+    { .path = "/cd", .methods = (COAP_GET | COAP_CACHEABLE),
+      .handler = _cache_handler, .context = &_max_age_1 },
+};
+
+static gcoap_listener_t listener_cache = {
+    .resources     = &resources_cache[0],
+    .resources_len = ARRAY_SIZE(resources_cache),
+    .link_encoder  = NULL,
+    .next          = NULL
+};
+
+/*
+ * Sends a GET request for a path to the server and checks the response,
+ * and whether the resource handler was called for it.
+ */
+static void _cache_get(char *path, bool handled)
+{
+    uint8_t buf[GCOAP_PDU_BUF_SIZE];
+    sock_udp_ep_t remote = { .family = AF_INET6, .port = 5683 };
+    coap_pkt_t pdu;
+    coap_pkt_t resp;
+    unsigned calls = _cache_handler_calls;
+
+    size_t len = gcoap_request(&pdu, buf, sizeof(buf), COAP_METHOD_GET, path);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&pdu, buf, len));
+    len = _gcoap_handle_req(&pdu, buf, sizeof(buf), &remote);
+    TEST_ASSERT(len > 0);
+    TEST_ASSERT_EQUAL_INT(0, coap_parse(&resp, buf, len));
+    TEST_ASSERT_EQUAL_INT(COAP_CODE_CONTENT, coap_get_code_raw(&resp));
+    TEST_ASSERT_EQUAL_INT(1, resp.payload_len);
+    TEST_ASSERT_EQUAL_INT('x', resp.payload[0]);
+    TEST_ASSERT_EQUAL_INT(handled, _cache_handler_calls != calls);
+}
+
+/*
+ * A cached response is served without calling the resource handler until
+ * it expires.
+ */
+static void test_gcoap__server_cache_hit_expiry(void)
+{
+    gcoap_register_listener(&listener_cache);
+
+    _cache_get("/ca", true);
+    _cache_get("/ca", false);
+    _cache_get("/ca", false);
+
+    _cache_get("/cd", true);
+    _cache_get("/cd", false);
+    xtimer_usleep(1100LU * US_PER_MS);
+    _cache_get("/cd", true);
+    _cache_get("/ca", false);
+
+    gcoap_resp_cache_invalidate(&resources_cache[0]);
+    _cache_get("/ca", true);
+}
+
+/*
+ * A full cache evicts the entry closest to expiry.
+ */
+static void test_gcoap__server_cache_eviction(void)
+{
+    gcoap_resp_cache_invalidate(NULL);
+
+    _cache_get("/ca", true);
+    _cache_get("/cb", true);
+    _cache_get("/ca", false);
+    _cache_get("/cb", false);
+
+    /* /cb has the shorter Max-Age */
+    _cache_get("/cc", true);
+    _cache_get("/ca", false);
+    _cache_get("/cc", false);
+    _cache_get("/cb", true);
+}
+#endif
+
 Test *tests_gcoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -405,7 +824,18 @@ Test *tests_gcoap_tests(void)
         new_TestFixture(test_gcoap__server_get_resp),
         new_TestFixture(test_gcoap__server_con_req),
         new_TestFixture(test_gcoap__server_con_resp),
-        new_TestFixture(test_gcoap__server_get_resource_list)
+        new_TestFixture(test_gcoap__server_get_resource_list),
+        new_TestFixture(test_gcoap__server_find_resource_precedence),
+        new_TestFixture(test_gcoap__memo_index_req),
+        new_TestFixture(test_gcoap__memo_index_obs),
+#if GCOAP_RESP_CACHE_SIZE
+        new_TestFixture(test_gcoap__server_cache_hit_expiry),
+        new_TestFixture(test_gcoap__server_cache_eviction),
+#endif
+#if GCOAP_QBLOCK_BURST
+        new_TestFixture(test_gcoap__server_qblock2_con),
+        new_TestFixture(test_gcoap__server_qblock2_non),
+#endif
     };
 
     EMB_UNIT_TESTCALLER(gcoap_tests, NULL, NULL, fixtures);
@@ -521,6 +521,69 @@ static void test_nib_ft_add__success_duplicate(void)
                                                   &next_hop, iface, 0));
 }
 
+/*
+ * Adds three routes via one next hop with gnrc_ipv6_nib_ft_add_multi(), then
+ * adds them again via another next hop.
+ * Expected result: there are only three routes and all of them point to the
+ * second next hop
+ */
+static void test_nib_ft_add_multi__success_replace(void)
+{
+    gnrc_ipv6_nib_ft_t fte;
+    void *iter_state = NULL;
+    ipv6_addr_t dsts[3] = {
+        { .u64 = { { .u8 = GLOBAL_PREFIX }, { .u64 = TEST_UINT64 } } },
+        { .u64 = { { .u8 = GLOBAL_PREFIX }, { .u64 = TEST_UINT64 } } },
+        { .u64 = { { .u8 = GLOBAL_PREFIX }, { .u64 = TEST_UINT64 } } },
+    };
+    gnrc_ipv6_nib_ft_dst_t ft_dsts[3];
+    ipv6_addr_t next_hop = { .u64 = { { .u8 = LINK_LOCAL_PREFIX },
+                                      { .u64 = TEST_UINT64 } } };
+    unsigned count = 0;
+
+    for (unsigned i = 0; i < 3; i++) {
+        dsts[i].u8[15] += i;
+        ft_dsts[i].dst = &dsts[i];
+        ft_dsts[i].dst_len = IPV6_ADDR_BIT_LEN;
+    }
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add_multi(ft_dsts, 3, &next_hop,
+                                                        IFACE, 0));
+    next_hop.u64[1].u64++;
+    TEST_ASSERT_EQUAL_INT(0, gnrc_ipv6_nib_ft_add_multi(ft_dsts, 3, &next_hop,
+                                                        IFACE, 0));
+    while (gnrc_ipv6_nib_ft_iter(NULL, 0, &iter_state, &fte)) {
+        TEST_ASSERT(ipv6_addr_equal(&next_hop, &fte.next_hop));
+        TEST_ASSERT_EQUAL_INT(IPV6_ADDR_BIT_LEN, fte.dst_len);
+        TEST_ASSERT_EQUAL_INT(IFACE, fte.iface);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(3, count);
+}
+
+/*
+ * Tries to add a default route with gnrc_ipv6_nib_ft_add_multi().
+ * Expected result: gnrc_ipv6_nib_ft_add_multi() returns -EINVAL and the
+ * forwarding table stays empty
+ */
+static void test_nib_ft_add_multi__EINVAL_def_route(void)
+{
+    gnrc_ipv6_nib_ft_t fte;
+    void *iter_state = NULL;
+    static const ipv6_addr_t dst = { .u64 = { { .u8 = GLOBAL_PREFIX },
+                                              { .u64 = TEST_UINT64 } } };
+    static const ipv6_addr_t next_hop = { .u64 = { { .u8 = LINK_LOCAL_PREFIX },
+                                                   { .u64 = TEST_UINT64 } } };
+    const gnrc_ipv6_nib_ft_dst_t ft_dsts[] = {
+        { .dst = &dst, .dst_len = IPV6_ADDR_BIT_LEN },
+        { .dst = &ipv6_addr_unspecified, .dst_len = 0 },
+    };
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, gnrc_ipv6_nib_ft_add_multi(ft_dsts, 2,
+                                                              &next_hop,
+                                                              IFACE, 0));
+    TEST_ASSERT(!gnrc_ipv6_nib_ft_iter(NULL, 0, &iter_state, &fte));
+}
+
 /*
  * Creates a route with no next hop address then adds another with equal prefix
  * and interface to the last, but with a next hop address
@@ -746,6 +809,8 @@ Test *tests_gnrc_ipv6_nib_ft_tests(void)
         new_TestFixture(test_nib_ft_add__success_overwrite_unspecified),
         new_TestFixture(test_nib_ft_add__success),
         new_TestFixture(test_nib_ft_add__success_dr),
+        new_TestFixture(test_nib_ft_add_multi__success_replace),
+        new_TestFixture(test_nib_ft_add_multi__EINVAL_def_route),
         new_TestFixture(test_nib_ft_del__unknown),
         new_TestFixture(test_nib_ft_del__success),
         /* most of gnrc_ipv6_nib_ft_iter() is tested during all the tests above */
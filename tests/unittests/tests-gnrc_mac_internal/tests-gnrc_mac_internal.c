@@ -11,6 +11,7 @@
  *
  * @file
  */
+#include <errno.h>
 #include <string.h>
 
 #include "embUnit.h"
@@ -176,6 +177,67 @@ static void test_gnrc_mac_queue_tx_packet(void)
 }
 #endif /* GNRC_MAC_TX_QUEUE_SIZE != 0 */
 
+#if (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)
+static uint32_t _phase_cost(const gnrc_mac_tx_neighbor_t *neighbor)
+{
+    return neighbor->phase;
+}
+
+static gnrc_pktsnip_t *_unicast_pkt(uint8_t addr)
+{
+    uint8_t dst_addr[] = { 0x00, addr };
+    gnrc_pktsnip_t *hdr = gnrc_netif_hdr_build(NULL, 0, dst_addr, sizeof(dst_addr));
+    gnrc_pktsnip_t *pkt = gnrc_pktbuf_add(NULL, TEST_STRING4, sizeof(TEST_STRING4),
+                                          GNRC_NETTYPE_UNDEF);
+
+    LL_APPEND(hdr, pkt);
+    return hdr;
+}
+
+/**
+ * @brief This function tests `gnrc_mac_next_tx_neighbor()`.
+ *
+ *        Two packets are queued for two different neighbors (ids 1 and 2).
+ *        Expected results: without cost function, the neighbors are served
+ *        round-robin starting after `tx::last_tx_neighbor_id`. With a cost
+ *        function, the neighbor with the lowest cost is selected and only ties
+ *        are broken round-robin. Without queued packets -ENOENT is returned.
+ */
+static void test_gnrc_mac_next_tx_neighbor(void)
+{
+    gnrc_mac_tx_t tx = GNRC_MAC_TX_INIT;
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_mac_next_tx_neighbor(&tx, NULL));
+
+    TEST_ASSERT(gnrc_mac_queue_tx_packet(&tx, 0, _unicast_pkt(0x01)));
+    TEST_ASSERT(gnrc_mac_queue_tx_packet(&tx, 0, _unicast_pkt(0x02)));
+
+    TEST_ASSERT_EQUAL_INT(1, gnrc_mac_next_tx_neighbor(&tx, NULL));
+    tx.last_tx_neighbor_id = 1;
+    TEST_ASSERT_EQUAL_INT(2, gnrc_mac_next_tx_neighbor(&tx, NULL));
+    tx.last_tx_neighbor_id = 2;
+    TEST_ASSERT_EQUAL_INT(1, gnrc_mac_next_tx_neighbor(&tx, NULL));
+
+    /* equal cost */
+    tx.neighbors[1].phase = 10;
+    tx.neighbors[2].phase = 10;
+    TEST_ASSERT_EQUAL_INT(1, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+    tx.last_tx_neighbor_id = 1;
+    TEST_ASSERT_EQUAL_INT(2, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+
+    /* cheaper neighbor wins, no matter who was served last */
+    tx.neighbors[1].phase = 5;
+    TEST_ASSERT_EQUAL_INT(1, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+    tx.last_tx_neighbor_id = 0;
+    TEST_ASSERT_EQUAL_INT(1, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+
+    gnrc_pktbuf_release(gnrc_priority_pktqueue_pop(&tx.neighbors[1].queue));
+    TEST_ASSERT_EQUAL_INT(2, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+    gnrc_pktbuf_release(gnrc_priority_pktqueue_pop(&tx.neighbors[2].queue));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, gnrc_mac_next_tx_neighbor(&tx, _phase_cost));
+}
+#endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0) */
+
 #if GNRC_MAC_RX_QUEUE_SIZE != 0
 /**
  * @brief This function test the `gnrc_mac_queue_rx_packet()`, to see whether it can
@@ -264,6 +326,9 @@ Test *tests_gnrc_mac_internal_tests(void)
 #if GNRC_MAC_TX_QUEUE_SIZE != 0
         new_TestFixture(test_gnrc_mac_queue_tx_packet),
 #endif /* GNRC_MAC_TX_QUEUE_SIZE != 0 */
+#if (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0)
+        new_TestFixture(test_gnrc_mac_next_tx_neighbor),
+#endif /* (GNRC_MAC_TX_QUEUE_SIZE != 0) && (GNRC_MAC_NEIGHBOR_COUNT != 0) */
 #if GNRC_MAC_RX_QUEUE_SIZE != 0
         new_TestFixture(test_gnrc_mac_queue_rx_packet),
 #endif /* GNRC_MAC_RX_QUEUE_SIZE != 0 */
@@ -0,0 +1,158 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/rpl.h"
+#include "net/gnrc/rpl/structs.h"
+#include "of0.h"
+#include "mrhof.h"
+
+#include "tests-gnrc_rpl_of.h"
+
+#define MIN_HOP_RANK_INC    (256U)
+
+static gnrc_rpl_instance_t _inst;
+static gnrc_rpl_dodag_t _dodag;
+static gnrc_rpl_parent_t _parents[4];
+
+static void set_up(void)
+{
+    memset(&_inst, 0, sizeof(_inst));
+    memset(&_dodag, 0, sizeof(_dodag));
+    memset(_parents, 0, sizeof(_parents));
+    _inst.min_hop_rank_inc = MIN_HOP_RANK_INC;
+    _dodag.instance = &_inst;
+    for (unsigned i = 0; i < ARRAY_SIZE(_parents); i++) {
+        _parents[i].dodag = &_dodag;
+    }
+}
+
+static void _set_etx(gnrc_rpl_parent_t *parent, uint16_t rank, uint16_t etx)
+{
+    parent->rank = rank;
+    parent->link_metric = etx;
+    parent->link_metric_type = GNRC_RPL_LINK_METRIC_ETX;
+}
+
+static void test_of0__parent_cmp(void)
+{
+    gnrc_rpl_of_t *of = gnrc_rpl_get_of0();
+
+    _parents[0].rank = 512;
+    _parents[1].rank = 768;
+    _parents[2].rank = 512;
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[1]) < 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[1], &_parents[0]) > 0);
+    TEST_ASSERT_EQUAL_INT(0, of->parent_cmp(&_parents[0], &_parents[2]));
+}
+
+static void test_of0__calc_rank(void)
+{
+    gnrc_rpl_of_t *of = gnrc_rpl_get_of0();
+
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, of->calc_rank(&_dodag, 0));
+    TEST_ASSERT_EQUAL_INT(256 + GNRC_RPL_DEFAULT_MIN_HOP_RANK_INCREASE,
+                          of->calc_rank(&_dodag, 256));
+
+    _parents[0].rank = 512;
+    _dodag.parents = &_parents[0];
+    TEST_ASSERT_EQUAL_INT(512 + MIN_HOP_RANK_INC, of->calc_rank(&_dodag, 0));
+    TEST_ASSERT_EQUAL_INT(1024 + MIN_HOP_RANK_INC,
+                          of->calc_rank(&_dodag, 1024));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK,
+                          of->calc_rank(&_dodag, 0xff80));
+}
+
+/*
+ * Path cost is rank + ETX * MIN_HOP_RANK_INC / GNRC_RPL_ETX_DIVISOR, i.e.
+ * rank + 2 * ETX here.
+ */
+static void test_mrhof__parent_cmp(void)
+{
+    gnrc_rpl_of_t *of = gnrc_rpl_get_of_mrhof();
+
+    /* unknown ETX counts as GNRC_RPL_ETX_INIT: cost 768 */
+    _parents[0].rank = 256;
+    /* cost 656, less than GNRC_RPL_MRHOF_PARENT_SWITCH_THRESHOLD cheaper */
+    _set_etx(&_parents[1], 256, 200);
+    /* cost 456 */
+    _set_etx(&_parents[2], 256, 100);
+    /* link metric above GNRC_RPL_MRHOF_MAX_LINK_METRIC: infinite cost */
+    _set_etx(&_parents[3], 256, GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1);
+
+    /* no preferred parent: no hysteresis */
+    TEST_ASSERT(of->parent_cmp(&_parents[1], &_parents[0]) < 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[1]) > 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[3]) < 0);
+
+    /* the preferred parent is kept unless another is sufficiently cheaper */
+    _dodag.preferred = &_parents[0];
+    TEST_ASSERT(of->parent_cmp(&_parents[1], &_parents[0]) > 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[1]) < 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[2], &_parents[0]) < 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[2]) > 0);
+    /* between non-preferred parents there is no hysteresis */
+    TEST_ASSERT(of->parent_cmp(&_parents[2], &_parents[1]) < 0);
+
+    /* the head of the parent list has no influence, e.g. while the
+     * preferred parent is being removed */
+    _dodag.parents = &_parents[0];
+    _dodag.preferred = NULL;
+    TEST_ASSERT(of->parent_cmp(&_parents[1], &_parents[0]) < 0);
+    _dodag.preferred = &_parents[1];
+    TEST_ASSERT(of->parent_cmp(&_parents[0], &_parents[1]) > 0);
+    TEST_ASSERT(of->parent_cmp(&_parents[2], &_parents[1]) < 0);
+}
+
+static void test_mrhof__calc_rank(void)
+{
+    gnrc_rpl_of_t *of = gnrc_rpl_get_of_mrhof();
+
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, of->calc_rank(&_dodag, 0));
+
+    _set_etx(&_parents[0], 256, 100);
+    _dodag.parents = &_parents[0];
+    TEST_ASSERT_EQUAL_INT(256 + 200, of->calc_rank(&_dodag, 0));
+    TEST_ASSERT_EQUAL_INT(1024 + MIN_HOP_RANK_INC,
+                          of->calc_rank(&_dodag, 1024));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK,
+                          of->calc_rank(&_dodag, 0xff80));
+
+    _parents[0].rank = GNRC_RPL_INFINITE_RANK;
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, of->calc_rank(&_dodag, 0));
+    _set_etx(&_parents[0], 256, GNRC_RPL_MRHOF_MAX_LINK_METRIC + 1);
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_INFINITE_RANK, of->calc_rank(&_dodag, 0));
+}
+
+Test *tests_gnrc_rpl_of_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_of0__parent_cmp),
+        new_TestFixture(test_of0__calc_rank),
+        new_TestFixture(test_mrhof__parent_cmp),
+        new_TestFixture(test_mrhof__calc_rank),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_rpl_of_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_rpl_of_tests;
+}
+
+void tests_gnrc_rpl_of(void)
+{
+    TESTS_RUN(tests_gnrc_rpl_of_tests());
+}
+/** @} */
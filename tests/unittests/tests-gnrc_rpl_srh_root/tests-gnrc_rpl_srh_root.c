@@ -0,0 +1,189 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/gnrc/ipv6/nib.h"
+#include "net/gnrc/pktbuf.h"
+#include "net/gnrc/rpl/srh.h"
+#include "net/ipv6/ext/rh.h"
+#include "net/ipv6/hdr.h"
+#include "net/protnum.h"
+
+#include "tests-gnrc_rpl_srh_root.h"
+
+#define IFACE       (6)
+#define LIFETIME    (60)
+
+/* 2001:db8::/64 */
+#define PREFIX      { 0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00 }
+
+static const ipv6_addr_t _root = { .u8 = {
+    0x20, 0x01, 0x0d, 0xb8, 0x00, 0x00, 0x00, 0x00,
+    0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01 } };
+
+/* address in the DODAG prefix with the last two bytes of the IID set to
+ * hi and lo */
+static void _addr(ipv6_addr_t *addr, uint8_t hi, uint8_t lo)
+{
+    static const uint8_t prefix[] = PREFIX;
+
+    memset(addr, 0, sizeof(*addr));
+    memcpy(addr, prefix, sizeof(prefix));
+    addr->u8[8] = 0x02;
+    addr->u8[14] = hi;
+    addr->u8[15] = lo;
+}
+
+static gnrc_pktsnip_t *_build(const ipv6_addr_t *dst, ipv6_addr_t *first_hop)
+{
+    ipv6_hdr_t hdr;
+    gnrc_pktsnip_t ipv6 = { .data = &hdr, .size = sizeof(hdr),
+                            .type = GNRC_NETTYPE_IPV6 };
+
+    memset(&hdr, 0, sizeof(hdr));
+    ipv6_hdr_set_version(&hdr);
+    hdr.nh = PROTNUM_UDP;
+    hdr.dst = *dst;
+    return gnrc_rpl_srh_root_build(&ipv6, first_hop);
+}
+
+static void set_up(void)
+{
+    gnrc_pktbuf_init();
+    gnrc_ipv6_nib_init();
+    gnrc_rpl_srh_root_init(&_root, IFACE);
+}
+
+/*
+ * Graph: root <- a <- b <- c, all IIDs share all but the last two bytes
+ */
+static void test_srh_root__build(void)
+{
+    ipv6_addr_t a, b, c, first_hop;
+    gnrc_pktsnip_t *srh;
+    gnrc_rpl_srh_t *rh;
+    uint8_t *vec;
+
+    _addr(&a, 0x0a, 0x01);
+    _addr(&b, 0x0b, 0x02);
+    _addr(&c, 0x0c, 0x03);
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(&a, &_root, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(&b, &a, LIFETIME));
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(&c, &b, LIFETIME));
+
+    /* children of the root are reached without source route */
+    TEST_ASSERT_NULL(_build(&a, &first_hop));
+
+    /* c: the addresses of b and c, 6 octets of the IID elided each */
+    srh = _build(&c, &first_hop);
+    TEST_ASSERT_NOT_NULL(srh);
+    TEST_ASSERT(ipv6_addr_equal(&a, &first_hop));
+    rh = srh->data;
+    vec = (uint8_t *)(rh + 1);
+    TEST_ASSERT_EQUAL_INT(IPV6_EXT_RH_TYPE_RPL_SRH, rh->type);
+    TEST_ASSERT_EQUAL_INT(2, rh->seg_left);
+    TEST_ASSERT_EQUAL_INT(0xee, rh->compr);
+    /* 2 * 2 octets, padded to 8 */
+    TEST_ASSERT_EQUAL_INT(4 << 4, rh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(1, rh->len);
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) + 8, srh->size);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(vec, &b.u8[14], 2));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(vec + 2, &c.u8[14], 2));
+    gnrc_pktbuf_release(srh);
+
+    /* b: only its own address */
+    srh = _build(&b, &first_hop);
+    TEST_ASSERT_NOT_NULL(srh);
+    rh = srh->data;
+    TEST_ASSERT_EQUAL_INT(1, rh->seg_left);
+    TEST_ASSERT_EQUAL_INT(6 << 4, rh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(1, rh->len);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(rh + 1, &b.u8[14], 2));
+    gnrc_pktbuf_release(srh);
+
+    /* the cached header follows changes of the graph: c moves below a */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(&c, &a, LIFETIME));
+    srh = _build(&c, &first_hop);
+    TEST_ASSERT_NOT_NULL(srh);
+    rh = srh->data;
+    TEST_ASSERT_EQUAL_INT(1, rh->seg_left);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(rh + 1, &c.u8[14], 2));
+    gnrc_pktbuf_release(srh);
+
+    /* removed and unknown nodes are not source routed */
+    TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(&b, &a, 0));
+    TEST_ASSERT_NULL(_build(&b, &first_hop));
+    _addr(&b, 0x0d, 0x04);
+    TEST_ASSERT_NULL(_build(&b, &first_hop));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+/*
+ * Without common octets in the IIDs, the header of the longest route has
+ * GNRC_RPL_SRH_ROOT_HOPS_MAX - 1 full IIDs; longer routes are not source
+ * routed.
+ */
+static void test_srh_root__build_max_len(void)
+{
+    ipv6_addr_t addrs[GNRC_RPL_SRH_ROOT_HOPS_MAX + 1], first_hop;
+    gnrc_pktsnip_t *srh;
+    gnrc_rpl_srh_t *rh;
+
+    for (unsigned i = 0; i < ARRAY_SIZE(addrs); i++) {
+        _addr(&addrs[i], 0x10, i);
+        addrs[i].u8[8] = 0x10 + i;
+        TEST_ASSERT_EQUAL_INT(0, gnrc_rpl_srh_root_update(
+                                    &addrs[i], (i == 0) ? &_root : &addrs[i - 1],
+                                    LIFETIME));
+    }
+
+    srh = _build(&addrs[GNRC_RPL_SRH_ROOT_HOPS_MAX - 1], &first_hop);
+    TEST_ASSERT_NOT_NULL(srh);
+    rh = srh->data;
+    TEST_ASSERT(ipv6_addr_equal(&addrs[0], &first_hop));
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_ROOT_HOPS_MAX - 1, rh->seg_left);
+    TEST_ASSERT_EQUAL_INT(0x88, rh->compr);
+    TEST_ASSERT_EQUAL_INT(0, rh->pad_resv);
+    TEST_ASSERT_EQUAL_INT(GNRC_RPL_SRH_ROOT_HOPS_MAX - 1, rh->len);
+    TEST_ASSERT_EQUAL_INT(sizeof(gnrc_rpl_srh_t) +
+                          ((GNRC_RPL_SRH_ROOT_HOPS_MAX - 1) * 8), srh->size);
+    for (unsigned i = 1; i < GNRC_RPL_SRH_ROOT_HOPS_MAX; i++) {
+        TEST_ASSERT_EQUAL_INT(0, memcmp((uint8_t *)(rh + 1) + ((i - 1) * 8),
+                                        &addrs[i].u8[8], 8));
+    }
+    gnrc_pktbuf_release(srh);
+
+    TEST_ASSERT_NULL(_build(&addrs[GNRC_RPL_SRH_ROOT_HOPS_MAX], &first_hop));
+    TEST_ASSERT(gnrc_pktbuf_is_empty());
+}
+
+Test *tests_gnrc_rpl_srh_root_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_srh_root__build),
+        new_TestFixture(test_srh_root__build_max_len),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_rpl_srh_root_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_rpl_srh_root_tests;
+}
+
+void tests_gnrc_rpl_srh_root(void)
+{
+    TESTS_RUN(tests_gnrc_rpl_srh_root_tests());
+}
+/** @} */
@@ -0,0 +1,176 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <stdbool.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "gnrc_tftp_internal.h"
+
+#include "tests-gnrc_tftp.h"
+
+#define WINDOW_SIZE     (4U)
+
+static tftp_window_t _win;
+
+static void set_up(void)
+{
+    memset(&_win, 0, sizeof(_win));
+    _win.size = WINDOW_SIZE;
+}
+
+/* receives num blocks in order, returns the number of ACKs sent */
+static unsigned _recv_in_order(unsigned num)
+{
+    unsigned acks = 0;
+
+    for (unsigned i = 0; i < num; i++) {
+        acks += _tftp_window_recv(&_win, TS_BUSY, false);
+    }
+    return acks;
+}
+
+static void test_gnrc_tftp__ack_valid(void)
+{
+    /* blocks 11 to 14 in flight */
+    for (uint16_t ack = 11; ack <= 14; ack++) {
+        TEST_ASSERT(_tftp_window_ack_valid(10, 14, ack));
+    }
+    /* duplicated ACK of the previous window */
+    TEST_ASSERT(!_tftp_window_ack_valid(10, 14, 10));
+    TEST_ASSERT(!_tftp_window_ack_valid(10, 14, 9));
+    /* block not sent yet */
+    TEST_ASSERT(!_tftp_window_ack_valid(10, 14, 15));
+
+    /* nothing in flight, e.g. the ACK of a write request */
+    TEST_ASSERT(_tftp_window_ack_valid(0, 0, 0));
+    TEST_ASSERT(!_tftp_window_ack_valid(0, 0, 1));
+}
+
+static void test_gnrc_tftp__ack_valid_wraparound(void)
+{
+    /* blocks 65535, 0, 1 and 2 in flight */
+    TEST_ASSERT(_tftp_window_ack_valid(UINT16_MAX - 1, 2, UINT16_MAX));
+    TEST_ASSERT(_tftp_window_ack_valid(UINT16_MAX - 1, 2, 0));
+    TEST_ASSERT(_tftp_window_ack_valid(UINT16_MAX - 1, 2, 2));
+    TEST_ASSERT(!_tftp_window_ack_valid(UINT16_MAX - 1, 2, UINT16_MAX - 1));
+    TEST_ASSERT(!_tftp_window_ack_valid(UINT16_MAX - 1, 2, 3));
+}
+
+static void test_gnrc_tftp__data_order(void)
+{
+    TEST_ASSERT_EQUAL_INT(TS_BUSY, _tftp_data_order(5, 6));
+    TEST_ASSERT_EQUAL_INT(TS_GAP, _tftp_data_order(5, 7));
+    TEST_ASSERT_EQUAL_INT(TS_GAP, _tftp_data_order(5, 5 + WINDOW_SIZE));
+    TEST_ASSERT_EQUAL_INT(TS_DUP, _tftp_data_order(5, 5));
+    TEST_ASSERT_EQUAL_INT(TS_DUP, _tftp_data_order(5, 1));
+    /* the first block after the request */
+    TEST_ASSERT_EQUAL_INT(TS_BUSY, _tftp_data_order(0, 1));
+
+    /* block numbers wrap around after 65535 */
+    TEST_ASSERT_EQUAL_INT(TS_BUSY, _tftp_data_order(UINT16_MAX, 0));
+    TEST_ASSERT_EQUAL_INT(TS_GAP, _tftp_data_order(UINT16_MAX, 2));
+    TEST_ASSERT_EQUAL_INT(TS_GAP, _tftp_data_order(UINT16_MAX - 1, 0));
+    TEST_ASSERT_EQUAL_INT(TS_DUP, _tftp_data_order(0, UINT16_MAX));
+    TEST_ASSERT_EQUAL_INT(TS_DUP, _tftp_data_order(1, UINT16_MAX - 1));
+}
+
+static void test_gnrc_tftp__window_recv(void)
+{
+    /* one ACK per complete window */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(WINDOW_SIZE - 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_in_order(1));
+    TEST_ASSERT_EQUAL_INT(0, _win.recv);
+    TEST_ASSERT_EQUAL_INT(2, _recv_in_order(2 * WINDOW_SIZE));
+
+    /* the last block is acknowledged before the window is complete */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(1));
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_BUSY, true));
+    TEST_ASSERT_EQUAL_INT(0, _win.recv);
+
+    /* lock-step transfers acknowledge every block */
+    _win.size = 1;
+    TEST_ASSERT_EQUAL_INT(3, _recv_in_order(3));
+}
+
+static void test_gnrc_tftp__window_gap(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(1));
+    /* the second block of the window got lost, only the first block out of
+     * order is acknowledged */
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_GAP, false));
+    TEST_ASSERT(!_tftp_window_recv(&_win, TS_GAP, false));
+    TEST_ASSERT(!_tftp_window_recv(&_win, TS_GAP, false));
+    TEST_ASSERT(_win.gap_acked);
+
+    /* the sender restarted the window after the ACK */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(1));
+    TEST_ASSERT(!_win.gap_acked);
+    /* another gap in the restarted window is acknowledged again */
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_GAP, false));
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(WINDOW_SIZE - 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_in_order(1));
+}
+
+static void test_gnrc_tftp__window_dup(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(2));
+    /* duplicates are always acknowledged, e.g. if the last ACK got lost */
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_DUP, false));
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_DUP, false));
+    /* the window restarts after the ACK */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(WINDOW_SIZE - 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_in_order(1));
+
+    /* a gap acknowledged before the duplicate is not acknowledged again */
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_GAP, false));
+    TEST_ASSERT(_tftp_window_recv(&_win, TS_DUP, false));
+    TEST_ASSERT(!_tftp_window_recv(&_win, TS_GAP, false));
+}
+
+static void test_gnrc_tftp__window_timeout(void)
+{
+    /* the rest of the window got lost, the receiver times out and sends the
+     * ACK of the last block received again */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(2));
+    _tftp_window_timeout(&_win);
+
+    /* the sender restarts its window after that block */
+    TEST_ASSERT_EQUAL_INT(0, _recv_in_order(WINDOW_SIZE - 1));
+    TEST_ASSERT_EQUAL_INT(1, _recv_in_order(1));
+    TEST_ASSERT_EQUAL_INT(0, _win.recv);
+}
+
+Test *tests_gnrc_tftp_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_gnrc_tftp__ack_valid),
+        new_TestFixture(test_gnrc_tftp__ack_valid_wraparound),
+        new_TestFixture(test_gnrc_tftp__data_order),
+        new_TestFixture(test_gnrc_tftp__window_recv),
+        new_TestFixture(test_gnrc_tftp__window_gap),
+        new_TestFixture(test_gnrc_tftp__window_dup),
+        new_TestFixture(test_gnrc_tftp__window_timeout),
+    };
+
+    EMB_UNIT_TESTCALLER(gnrc_tftp_tests, set_up, NULL, fixtures);
+
+    return (Test *)&gnrc_tftp_tests;
+}
+
+void tests_gnrc_tftp(void)
+{
+    TESTS_RUN(tests_gnrc_tftp_tests());
+}
+/** @} */
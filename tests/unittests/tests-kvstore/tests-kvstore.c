@@ -0,0 +1,313 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "checksum/crc16_ccitt.h"
+#include "kvstore.h"
+#include "mtd-nor-mock.h"
+
+#include "tests-kvstore.h"
+
+#define SECTOR_COUNT    (4)
+#define PAGE_PER_SECTOR (4)
+#define PAGE_SIZE       (128)
+#define SECTOR_SIZE     (PAGE_PER_SECTOR * PAGE_SIZE)
+#define SECTOR_HDR_SIZE (12)
+#define KEYS            (8)
+
+static uint8_t _memory[SECTOR_SIZE * SECTOR_COUNT];
+static mtd_nor_mock_t _dev = MTD_NOR_MOCK_INIT(_memory, SECTOR_COUNT,
+                                               PAGE_PER_SECTOR, PAGE_SIZE);
+
+static kvstore_t _kv = { .mtd = &_dev.base };
+
+static void set_up(void)
+{
+    memset(_memory, 0x5a, sizeof(_memory));
+    kvstore_format(&_kv);
+}
+
+static void _check(const char *key, uint32_t value)
+{
+    uint32_t data;
+
+    TEST_ASSERT_EQUAL_INT(sizeof(data),
+                          kvstore_get(&_kv, key, &data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(value, data);
+}
+
+static void _check_missing(const char *key)
+{
+    uint32_t data;
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, kvstore_get(&_kv, key, &data, sizeof(data)));
+}
+
+static void _set(const char *key, uint32_t value)
+{
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kv, key, &value, sizeof(value)));
+}
+
+static void test_kvstore_empty(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(0, _kv.keys);
+    _check_missing("a");
+}
+
+static void test_kvstore_set_get(void)
+{
+    char buf[8];
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kv, "name", "riot", 4));
+    TEST_ASSERT_EQUAL_INT(4, kvstore_get(&_kv, "name", buf, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, "riot", 4));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, kvstore_get(&_kv, "name", buf, 3));
+
+    /* empty values are values */
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kv, "empty", NULL, 0));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_get(&_kv, "empty", buf, sizeof(buf)));
+
+    _set("a", 1);
+    _set("a", 2);
+    _check("a", 2);
+    TEST_ASSERT_EQUAL_INT(3, _kv.keys);
+}
+
+static void test_kvstore_invalid(void)
+{
+    static const char long_key[] = "0123456789abcdef0123456789abcdef0";
+    static uint8_t big[KVSTORE_BATCH_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_set(&_kv, "", "x", 1));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_set(&_kv, long_key, "x", 1));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS, kvstore_set(&_kv, "a", big, sizeof(big)));
+    TEST_ASSERT_EQUAL_INT(-EINVAL, kvstore_get(&_kv, "", big, sizeof(big)));
+    TEST_ASSERT_EQUAL_INT(0, _kv.keys);
+}
+
+static void test_kvstore_transaction(void)
+{
+    uint32_t one = 1, two = 2;
+
+    _set("c", 3);
+    kvstore_begin(&_kv);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_put(&_kv, "a", &one, sizeof(one)));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_put(&_kv, "b", &two, sizeof(two)));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kv, "c"));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kv));
+    _check("a", 1);
+    _check("b", 2);
+    _check_missing("c");
+
+    kvstore_begin(&_kv);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_put(&_kv, "a", &two, sizeof(two)));
+    TEST_ASSERT_EQUAL_INT(0, kvstore_delete(&_kv, "b"));
+    kvstore_abort(&_kv);
+    _check("a", 1);
+    _check("b", 2);
+
+    /* an empty transaction writes nothing */
+    uint32_t writes = _kv.stats.writes;
+    kvstore_begin(&_kv);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kv));
+    TEST_ASSERT_EQUAL_INT(writes, _kv.stats.writes);
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(2, _kv.keys);
+    _check("a", 1);
+    _check("b", 2);
+    _check_missing("c");
+}
+
+static void test_kvstore_torn_batch(void)
+{
+    uint8_t one = 1, two = 2, three = 3, four = 4, data;
+
+    kvstore_begin(&_kv);
+    kvstore_put(&_kv, "a", &one, 1);
+    kvstore_put(&_kv, "b", &two, 1);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kv));
+    kvstore_begin(&_kv);
+    kvstore_put(&_kv, "a", &three, 1);
+    kvstore_put(&_kv, "b", &four, 1);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kv));
+
+    /* the first batch takes 16 bytes, clear a bit in the value of "a" in the
+     * second one */
+    _memory[SECTOR_HDR_SIZE + 16 + 4 + 4 + 1] &= 0xfd;
+
+    /* none of the changes of the second batch survive */
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT(_kv.sealed);
+    TEST_ASSERT_EQUAL_INT(1, kvstore_get(&_kv, "a", &data, 1));
+    TEST_ASSERT_EQUAL_INT(1, data);
+    TEST_ASSERT_EQUAL_INT(1, kvstore_get(&_kv, "b", &data, 1));
+    TEST_ASSERT_EQUAL_INT(2, data);
+
+    /* new batches go to the next sector */
+    TEST_ASSERT_EQUAL_INT(0, kvstore_set(&_kv, "b", &four, 1));
+    TEST_ASSERT_EQUAL_INT(1, _kv.active);
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(1, kvstore_get(&_kv, "a", &data, 1));
+    TEST_ASSERT_EQUAL_INT(1, data);
+    TEST_ASSERT_EQUAL_INT(1, kvstore_get(&_kv, "b", &data, 1));
+    TEST_ASSERT_EQUAL_INT(4, data);
+}
+
+/* overwrite KEYS keys round robin, key i holds the last round it was set */
+static void _churn(uint32_t rounds)
+{
+    char key[8];
+
+    for (uint32_t i = 0; i < rounds; i++) {
+        snprintf(key, sizeof(key), "key%u", (unsigned)(i % KEYS));
+        _set(key, i);
+    }
+}
+
+static void _check_churn(uint32_t rounds)
+{
+    char key[8];
+
+    for (uint32_t i = rounds - KEYS; i < rounds; i++) {
+        snprintf(key, sizeof(key), "key%u", (unsigned)(i % KEYS));
+        _check(key, i);
+    }
+}
+
+static void test_kvstore_gc(void)
+{
+    _set("static", 42);
+    _churn(300);
+    TEST_ASSERT(_kv.stats.gcs > SECTOR_COUNT);
+    TEST_ASSERT(_kv.used < SECTOR_COUNT);
+    TEST_ASSERT_EQUAL_INT(KEYS + 1, _kv.keys);
+    _check("static", 42);
+    _check_churn(300);
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(KEYS + 1, _kv.keys);
+    _check("static", 42);
+    _check_churn(300);
+}
+
+static void test_kvstore_erase_once(void)
+{
+    /* the first sector is still blank from formatting */
+    _dev.erases = 0;
+    _set("static", 42);
+    TEST_ASSERT_EQUAL_INT(0, _dev.erases);
+
+    /* a sector is erased when it is garbage collected, not again when it is
+     * opened afterwards */
+    _churn(300);
+    TEST_ASSERT(_kv.stats.gcs > SECTOR_COUNT);
+    TEST_ASSERT_EQUAL_INT(_kv.stats.gcs, _dev.erases);
+
+    /* after mounting the sector following the active one is not trusted */
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    unsigned erases = _dev.erases;
+    uint32_t gcs = _kv.stats.gcs;
+    _churn(300);
+    TEST_ASSERT_EQUAL_INT(_kv.stats.gcs - gcs + 1, _dev.erases - erases);
+    _check("static", 42);
+    _check_churn(300);
+}
+
+static void test_kvstore_interrupted_gc(void)
+{
+    _set("static", 42);
+    _churn(100);
+    TEST_ASSERT(_kv.stats.gcs > 0);
+
+    /* a reset hit after the last erased sector was opened */
+    uint32_t active = _kv.active;
+    uint32_t next = (active + 1) % SECTOR_COUNT;
+    uint8_t *hdr = _memory + next * SECTOR_SIZE;
+    memcpy(hdr, _memory + active * SECTOR_SIZE, SECTOR_HDR_SIZE);
+    uint32_t seq = _kv.active_seq + 1;
+    memcpy(hdr + 4, &seq, sizeof(seq));
+    uint16_t crc = crc16_ccitt_calc(hdr, SECTOR_HDR_SIZE - 2);
+    memcpy(hdr + SECTOR_HDR_SIZE - 2, &crc, sizeof(crc));
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(1, _kv.stats.erases);
+    TEST_ASSERT_EQUAL_INT(active, _kv.active);
+    _check("static", 42);
+    _check_churn(100);
+
+    _churn(100);
+    _check("static", 42);
+    _check_churn(100);
+}
+
+static void test_kvstore_index_full(void)
+{
+    char key[8];
+
+    for (unsigned i = 0; i < KVSTORE_INDEX_SIZE - 1; i++) {
+        snprintf(key, sizeof(key), "k%u", i);
+        _set(key, i);
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, kvstore_set(&_kv, "new", "x", 1));
+    _check_missing("new");
+
+    /* existing keys can still be changed and removed */
+    _set("k0", 100);
+    _check("k0", 100);
+    kvstore_begin(&_kv);
+    kvstore_delete(&_kv, "k1");
+    TEST_ASSERT_EQUAL_INT(0, kvstore_commit(&_kv));
+    _set("new", 1);
+
+    TEST_ASSERT_EQUAL_INT(0, kvstore_mount(&_kv));
+    TEST_ASSERT_EQUAL_INT(KVSTORE_INDEX_SIZE - 1, _kv.keys);
+    _check("k0", 100);
+    _check_missing("k1");
+    _check("new", 1);
+    for (unsigned i = 2; i < KVSTORE_INDEX_SIZE - 1; i++) {
+        snprintf(key, sizeof(key), "k%u", i);
+        _check(key, i);
+    }
+}
+
+Test *tests_kvstore_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_kvstore_empty),
+        new_TestFixture(test_kvstore_set_get),
+        new_TestFixture(test_kvstore_invalid),
+        new_TestFixture(test_kvstore_transaction),
+        new_TestFixture(test_kvstore_torn_batch),
+        new_TestFixture(test_kvstore_gc),
+        new_TestFixture(test_kvstore_erase_once),
+        new_TestFixture(test_kvstore_interrupted_gc),
+        new_TestFixture(test_kvstore_index_full),
+    };
+
+    EMB_UNIT_TESTCALLER(kvstore_tests, set_up, NULL, fixtures);
+
+    return (Test *)&kvstore_tests;
+}
+
+void tests_kvstore(void)
+{
+    TESTS_RUN(tests_kvstore_tests());
+}
+/** @} */
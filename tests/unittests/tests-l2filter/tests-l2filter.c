@@ -0,0 +1,183 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "hashes.h"
+#include "net/l2filter.h"
+
+#include "tests-l2filter.h"
+
+#define ADDR_LEN        (8U)
+#define SLOT_MASK       (L2FILTER_LISTSIZE - 1)
+
+static l2filter_t _list[L2FILTER_LISTSIZE];
+static uint32_t _next_addr;
+
+static void set_up(void)
+{
+    memset(_list, 0, sizeof(_list));
+    _next_addr = 0;
+}
+
+/* generates a new address whose probe sequence starts at slot */
+static void _addr_for_slot(uint8_t *addr, unsigned slot)
+{
+    memset(addr, 0, ADDR_LEN);
+    do {
+        memcpy(addr, &_next_addr, sizeof(_next_addr));
+        _next_addr++;
+    } while ((one_at_a_time_hash(addr, ADDR_LEN) & SLOT_MASK) != slot);
+}
+
+static void _assert_slot(unsigned slot, const uint8_t *addr)
+{
+    TEST_ASSERT_EQUAL_INT(ADDR_LEN, _list[slot].addr_len);
+    TEST_ASSERT(memcmp(_list[slot].addr, addr, ADDR_LEN) == 0);
+}
+
+static void test_l2filter__add_lookup(void)
+{
+    uint8_t addr[3][ADDR_LEN];
+
+    for (unsigned i = 0; i < 3; i++) {
+        _addr_for_slot(addr[i], i * 3);
+        TEST_ASSERT(l2filter_pass(_list, addr[i], ADDR_LEN));
+        TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr[i], ADDR_LEN));
+    }
+    for (unsigned i = 0; i < 3; i++) {
+        _assert_slot(i * 3, addr[i]);
+        TEST_ASSERT(!l2filter_pass(_list, addr[i], ADDR_LEN));
+    }
+    /* a prefix of a listed address is a different address */
+    TEST_ASSERT(l2filter_pass(_list, addr[0], ADDR_LEN - 2));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, l2filter_rm(_list, addr[0], ADDR_LEN - 2));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, addr[1], ADDR_LEN));
+    TEST_ASSERT(l2filter_pass(_list, addr[1], ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, l2filter_rm(_list, addr[1], ADDR_LEN));
+    TEST_ASSERT(!l2filter_pass(_list, addr[0], ADDR_LEN));
+    TEST_ASSERT(!l2filter_pass(_list, addr[2], ADDR_LEN));
+}
+
+static void test_l2filter__rm_shift(void)
+{
+    uint8_t a[ADDR_LEN], b[ADDR_LEN], c[ADDR_LEN], d[ADDR_LEN];
+
+    /* a, b, c collide on slot 2, d is displaced from slot 3 */
+    _addr_for_slot(a, 2);
+    _addr_for_slot(b, 2);
+    _addr_for_slot(c, 2);
+    _addr_for_slot(d, 3);
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, a, ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, b, ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, c, ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, d, ADDR_LEN));
+    _assert_slot(2, a);
+    _assert_slot(3, b);
+    _assert_slot(4, c);
+    _assert_slot(5, d);
+
+    /* removing b shifts c and d up, leaving no hole in their probe
+     * sequences */
+    TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, b, ADDR_LEN));
+    _assert_slot(2, a);
+    _assert_slot(3, c);
+    _assert_slot(4, d);
+    TEST_ASSERT_EQUAL_INT(0, _list[5].addr_len);
+    TEST_ASSERT(!l2filter_pass(_list, c, ADDR_LEN));
+    TEST_ASSERT(!l2filter_pass(_list, d, ADDR_LEN));
+
+    /* removing a shifts c and d up, d back into its home slot */
+    TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, a, ADDR_LEN));
+    _assert_slot(2, c);
+    _assert_slot(3, d);
+    TEST_ASSERT_EQUAL_INT(0, _list[4].addr_len);
+    TEST_ASSERT(!l2filter_pass(_list, c, ADDR_LEN));
+    TEST_ASSERT(!l2filter_pass(_list, d, ADDR_LEN));
+    TEST_ASSERT(l2filter_pass(_list, a, ADDR_LEN));
+    TEST_ASSERT(l2filter_pass(_list, b, ADDR_LEN));
+}
+
+static void test_l2filter__full(void)
+{
+    uint8_t addr[L2FILTER_LISTSIZE][ADDR_LEN];
+
+    /* one slot always stays empty */
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE - 1; i++) {
+        _addr_for_slot(addr[i], i % 2);
+        TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr[i], ADDR_LEN));
+    }
+    _addr_for_slot(addr[L2FILTER_LISTSIZE - 1], SLOT_MASK);
+    TEST_ASSERT_EQUAL_INT(-ENOMEM, l2filter_add(_list,
+                                                addr[L2FILTER_LISTSIZE - 1],
+                                                ADDR_LEN));
+    /* lookups of unlisted addresses still terminate */
+    TEST_ASSERT(l2filter_pass(_list, addr[L2FILTER_LISTSIZE - 1], ADDR_LEN));
+    for (unsigned i = 0; i < L2FILTER_LISTSIZE - 1; i++) {
+        TEST_ASSERT(!l2filter_pass(_list, addr[i], ADDR_LEN));
+    }
+    TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, addr[0], ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, addr[L2FILTER_LISTSIZE - 1],
+                                          ADDR_LEN));
+    for (unsigned i = 1; i < L2FILTER_LISTSIZE; i++) {
+        TEST_ASSERT(!l2filter_pass(_list, addr[i], ADDR_LEN));
+    }
+}
+
+static void test_l2filter__wraparound(void)
+{
+    uint8_t x[ADDR_LEN], y[ADDR_LEN], z[ADDR_LEN];
+
+    /* x and y collide on the last slot, y wraps around to slot 0 and
+     * displaces z */
+    _addr_for_slot(x, SLOT_MASK);
+    _addr_for_slot(y, SLOT_MASK);
+    _addr_for_slot(z, 0);
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, x, ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, y, ADDR_LEN));
+    TEST_ASSERT_EQUAL_INT(0, l2filter_add(_list, z, ADDR_LEN));
+    _assert_slot(SLOT_MASK, x);
+    _assert_slot(0, y);
+    _assert_slot(1, z);
+
+    TEST_ASSERT_EQUAL_INT(0, l2filter_rm(_list, x, ADDR_LEN));
+    _assert_slot(SLOT_MASK, y);
+    _assert_slot(0, z);
+    TEST_ASSERT_EQUAL_INT(0, _list[1].addr_len);
+    TEST_ASSERT(!l2filter_pass(_list, y, ADDR_LEN));
+    TEST_ASSERT(!l2filter_pass(_list, z, ADDR_LEN));
+    TEST_ASSERT(l2filter_pass(_list, x, ADDR_LEN));
+}
+
+Test *tests_l2filter_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_l2filter__add_lookup),
+        new_TestFixture(test_l2filter__rm_shift),
+        new_TestFixture(test_l2filter__full),
+        new_TestFixture(test_l2filter__wraparound),
+    };
+
+    EMB_UNIT_TESTCALLER(l2filter_tests, set_up, NULL, fixtures);
+
+    return (Test *)&l2filter_tests;
+}
+
+void tests_l2filter(void)
+{
+    TESTS_RUN(tests_l2filter_tests());
+}
+/** @} */
@@ -0,0 +1,215 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "mtd.h"
+#include "mtd_async.h"
+
+#include "tests-mtd_async.h"
+
+#define PAGE_SIZE       (64U)
+#define SECTOR_SIZE     (4 * PAGE_SIZE)
+#define READS_NUMOF     (2 * MTD_ASYNC_READ_BYPASS_MAX + 1)
+#define LOG_SIZE        (READS_NUMOF + 2)
+
+/* driver calls in the order of execution */
+typedef struct {
+    mtd_async_op_t op;
+    uint32_t addr;
+    uint32_t count;
+} call_t;
+
+static call_t _log[LOG_SIZE];
+static unsigned _log_len;
+static uint8_t _buf[READS_NUMOF][PAGE_SIZE];
+static mtd_async_req_t _reqs[READS_NUMOF + 1];
+
+static void _log_call(mtd_async_op_t op, uint32_t addr, uint32_t count)
+{
+    if (_log_len < LOG_SIZE) {
+        _log[_log_len].op = op;
+        _log[_log_len].addr = addr;
+        _log[_log_len].count = count;
+    }
+    _log_len++;
+}
+
+static int _init(mtd_dev_t *dev)
+{
+    (void)dev;
+    return 0;
+}
+
+static int _read(mtd_dev_t *dev, void *buff, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    memset(buff, 0xff, size);
+    _log_call(MTD_ASYNC_READ, addr, size);
+    return size;
+}
+
+static int _write(mtd_dev_t *dev, const void *buff, uint32_t addr,
+                  uint32_t size)
+{
+    (void)dev;
+    (void)buff;
+    _log_call(MTD_ASYNC_WRITE, addr, size);
+    return size;
+}
+
+static int _erase(mtd_dev_t *dev, uint32_t addr, uint32_t size)
+{
+    (void)dev;
+    _log_call(MTD_ASYNC_ERASE, addr, size);
+    return 0;
+}
+
+static const mtd_desc_t _driver = {
+    .init = _init,
+    .read = _read,
+    .write = _write,
+    .erase = _erase,
+};
+
+static mtd_dev_t _dev = {
+    .driver = &_driver,
+    .sector_count = 16,
+    .pages_per_sector = SECTOR_SIZE / PAGE_SIZE,
+    .page_size = PAGE_SIZE,
+};
+
+static void set_up(void)
+{
+    /* the worker thread may already be started by auto_init */
+    mtd_async_init();
+    memset(_reqs, 0, sizeof(_reqs));
+    memset(_log, 0, sizeof(_log));
+    _log_len = 0;
+}
+
+/* the worker runs at a lower priority, so all requests are queued before
+ * the first one is executed */
+static void _wait_all(unsigned num)
+{
+    for (unsigned i = 0; i < num; i++) {
+        TEST_ASSERT(mtd_async_wait(&_reqs[i]) >= 0);
+    }
+}
+
+static void _assert_call(unsigned idx, mtd_async_op_t op, uint32_t addr,
+                         uint32_t count)
+{
+    TEST_ASSERT_EQUAL_INT(op, _log[idx].op);
+    TEST_ASSERT_EQUAL_INT(addr, _log[idx].addr);
+    TEST_ASSERT_EQUAL_INT(count, _log[idx].count);
+}
+
+static void test_mtd_async__read_bypass_bounded(void)
+{
+    unsigned erase_idx = MTD_ASYNC_READ_BYPASS_MAX;
+
+    /* reads of other sectors overtake the erase, non-adjacent so they are
+     * not merged */
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_erase(&_reqs[0], &_dev, 0,
+                                             SECTOR_SIZE));
+    for (unsigned i = 0; i < READS_NUMOF; i++) {
+        TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[i + 1], &_dev, _buf[i],
+                                                SECTOR_SIZE + 2 * i * PAGE_SIZE,
+                                                PAGE_SIZE));
+    }
+    _wait_all(READS_NUMOF + 1);
+
+    TEST_ASSERT_EQUAL_INT(READS_NUMOF + 1, _log_len);
+    for (unsigned i = 0; i < erase_idx; i++) {
+        _assert_call(i, MTD_ASYNC_READ, SECTOR_SIZE + 2 * i * PAGE_SIZE,
+                     PAGE_SIZE);
+    }
+    /* the erase waits for no more than MTD_ASYNC_READ_BYPASS_MAX reads */
+    _assert_call(erase_idx, MTD_ASYNC_ERASE, 0, SECTOR_SIZE);
+    for (unsigned i = erase_idx; i < READS_NUMOF; i++) {
+        _assert_call(i + 1, MTD_ASYNC_READ, SECTOR_SIZE + 2 * i * PAGE_SIZE,
+                     PAGE_SIZE);
+    }
+}
+
+static void test_mtd_async__read_bypass_reset(void)
+{
+    /* the bound applies per waiting request: a read at the head of the queue
+     * is not overtaking anything */
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[0], &_dev, _buf[0],
+                                            SECTOR_SIZE, PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_write(&_reqs[1], &_dev, _buf[1], 0,
+                                             PAGE_SIZE));
+    for (unsigned i = 0; i < MTD_ASYNC_READ_BYPASS_MAX; i++) {
+        TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[i + 2], &_dev,
+                                                _buf[i + 2],
+                                                SECTOR_SIZE + 2 * (i + 1) * PAGE_SIZE,
+                                                PAGE_SIZE));
+    }
+    _wait_all(MTD_ASYNC_READ_BYPASS_MAX + 2);
+
+    TEST_ASSERT_EQUAL_INT(MTD_ASYNC_READ_BYPASS_MAX + 2, _log_len);
+    _assert_call(0, MTD_ASYNC_READ, SECTOR_SIZE, PAGE_SIZE);
+    for (unsigned i = 0; i < MTD_ASYNC_READ_BYPASS_MAX; i++) {
+        _assert_call(i + 1, MTD_ASYNC_READ,
+                     SECTOR_SIZE + 2 * (i + 1) * PAGE_SIZE, PAGE_SIZE);
+    }
+    _assert_call(MTD_ASYNC_READ_BYPASS_MAX + 1, MTD_ASYNC_WRITE, 0, PAGE_SIZE);
+}
+
+static void test_mtd_async__read_overlap_merge(void)
+{
+    /* a read of the erased sector is not reordered */
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_erase(&_reqs[0], &_dev, 0,
+                                             SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[1], &_dev, _buf[0],
+                                            SECTOR_SIZE - PAGE_SIZE,
+                                            PAGE_SIZE));
+    /* adjacent reads into adjacent buffers are merged */
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[2], &_dev, _buf[0],
+                                            SECTOR_SIZE, PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, mtd_async_read(&_reqs[3], &_dev, _buf[1],
+                                            SECTOR_SIZE + PAGE_SIZE,
+                                            PAGE_SIZE));
+    _wait_all(4);
+
+    TEST_ASSERT_EQUAL_INT(3, _log_len);
+    _assert_call(0, MTD_ASYNC_READ, SECTOR_SIZE, 2 * PAGE_SIZE);
+    _assert_call(1, MTD_ASYNC_ERASE, 0, SECTOR_SIZE);
+    _assert_call(2, MTD_ASYNC_READ, SECTOR_SIZE - PAGE_SIZE, PAGE_SIZE);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, _reqs[2].res);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, _reqs[3].res);
+}
+
+Test *tests_mtd_async_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_async__read_bypass_bounded),
+        new_TestFixture(test_mtd_async__read_bypass_reset),
+        new_TestFixture(test_mtd_async__read_overlap_merge),
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_async_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mtd_async_tests;
+}
+
+void tests_mtd_async(void)
+{
+    TESTS_RUN(tests_mtd_async_tests());
+}
+/** @} */
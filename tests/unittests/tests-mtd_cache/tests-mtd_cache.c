@@ -0,0 +1,255 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "mtd-nor-mock.h"
+#include "mtd_cache.h"
+
+#include "tests-mtd_cache.h"
+
+#define SECTOR_COUNT    (4)
+#define PAGE_PER_SECTOR (4)
+#define PAGE_SIZE       (64)
+#define CACHED_PAGES    (2)
+
+static uint8_t _memory[PAGE_PER_SECTOR * PAGE_SIZE * SECTOR_COUNT];
+static mtd_nor_mock_t _parent = MTD_NOR_MOCK_INIT(_memory, SECTOR_COUNT,
+                                                  PAGE_PER_SECTOR, PAGE_SIZE);
+
+static uint32_t _cache_mem[MTD_CACHE_MEM_SIZE(PAGE_SIZE, CACHED_PAGES) /
+                           sizeof(uint32_t)];
+
+static mtd_cache_t _cache = {
+    .base = { .driver = &mtd_cache_driver },
+    .parent = &_parent.base,
+    .mem = _cache_mem,
+    .mem_size = sizeof(_cache_mem),
+};
+
+static mtd_dev_t *dev = &_cache.base;
+
+static void set_up(void)
+{
+    memset(_memory, 0xff, sizeof(_memory));
+    mtd_init(dev);
+    _parent.reads = 0;
+    _parent.writes = 0;
+    _parent.erases = 0;
+}
+
+static void test_mtd_cache_init(void)
+{
+    TEST_ASSERT_EQUAL_INT(CACHED_PAGES, _cache.numof);
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, dev->sector_count);
+    TEST_ASSERT_EQUAL_INT(PAGE_PER_SECTOR, dev->pages_per_sector);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, dev->page_size);
+}
+
+static void test_mtd_cache_read_hit(void)
+{
+    uint8_t buf[8];
+
+    memcpy(_memory + PAGE_SIZE + 4, "abcdefgh", sizeof(buf));
+    TEST_ASSERT_EQUAL_INT(4, mtd_read(dev, buf, PAGE_SIZE + 4, 4));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, PAGE_SIZE + 4,
+                                                sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, "abcdefgh", sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(1, _parent.reads);
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.hits);
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.misses);
+}
+
+static void test_mtd_cache_read_unaligned(void)
+{
+    uint8_t buf[2 * PAGE_SIZE];
+
+    for (unsigned i = 0; i < sizeof(_memory); i++) {
+        _memory[i] = i;
+    }
+    /* partial first page, full second page (bypassed), partial third page */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, PAGE_SIZE / 2,
+                                                sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, _memory + PAGE_SIZE / 2, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(3, _parent.reads);
+    /* first and third page are cached, the second one is not */
+    TEST_ASSERT_EQUAL_INT(1, mtd_read(dev, buf, 0, 1));
+    TEST_ASSERT_EQUAL_INT(1, mtd_read(dev, buf, 2 * PAGE_SIZE, 1));
+    TEST_ASSERT_EQUAL_INT(3, _parent.reads);
+    TEST_ASSERT_EQUAL_INT(1, mtd_read(dev, buf, PAGE_SIZE, 1));
+    TEST_ASSERT_EQUAL_INT(4, _parent.reads);
+}
+
+static void test_mtd_cache_lru(void)
+{
+    uint8_t buf[1];
+
+    mtd_read(dev, buf, 0, 1);
+    mtd_read(dev, buf, PAGE_SIZE, 1);
+    /* page 0 is now more recently used than page 1 */
+    mtd_read(dev, buf, 0, 1);
+    /* evicts page 1 */
+    mtd_read(dev, buf, 2 * PAGE_SIZE, 1);
+    TEST_ASSERT_EQUAL_INT(3, _parent.reads);
+    mtd_read(dev, buf, 0, 1);
+    TEST_ASSERT_EQUAL_INT(3, _parent.reads);
+    mtd_read(dev, buf, PAGE_SIZE, 1);
+    TEST_ASSERT_EQUAL_INT(4, _parent.reads);
+}
+
+static void test_mtd_cache_write_coalesce(void)
+{
+    static const uint8_t data[] = {
+        0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07,
+        0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+    };
+    uint8_t buf[sizeof(data)];
+
+    for (unsigned i = 0; i < sizeof(data); i += 4) {
+        TEST_ASSERT_EQUAL_INT(4, mtd_write(dev, data + i, 8 + i, 4));
+    }
+    TEST_ASSERT_EQUAL_INT(0, _parent.writes);
+    /* the data is visible through the cache before it is written back */
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, 8, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, data, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[8]);
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(1, _cache.stats.writebacks);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory + 8, data, sizeof(data)));
+    TEST_ASSERT_EQUAL_INT(0xff, _memory[7]);
+    /* nothing left to write */
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+}
+
+static void test_mtd_cache_write_twice(void)
+{
+    const uint8_t first[] = { 0xf0, 0x0f, 0xaa };
+    const uint8_t second[] = { 0x3c, 0x3c, 0x55 };
+    const uint8_t exp[] = { 0x30, 0x0c, 0x00 };
+    uint8_t buf[sizeof(exp)];
+
+    /* programming only clears bits, the cache must not hide that */
+    TEST_ASSERT_EQUAL_INT(sizeof(first), mtd_write(dev, first, 4,
+                                                   sizeof(first)));
+    TEST_ASSERT_EQUAL_INT(sizeof(second), mtd_write(dev, second, 4,
+                                                    sizeof(second)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, 4, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, exp, sizeof(exp)));
+
+    /* also when the first write already reached the device */
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(sizeof(first), mtd_write(dev, first, 4,
+                                                   sizeof(first)));
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory + 4, exp, sizeof(exp)));
+    TEST_ASSERT_EQUAL_INT(sizeof(buf), mtd_read(dev, buf, 4, sizeof(buf)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(buf, exp, sizeof(exp)));
+}
+
+static void test_mtd_cache_write_evict(void)
+{
+    uint8_t buf[1];
+
+    TEST_ASSERT_EQUAL_INT(2, mtd_write(dev, "ab", 0, 2));
+    mtd_read(dev, buf, PAGE_SIZE, 1);
+    /* evicts the dirty page 0 */
+    mtd_read(dev, buf, 2 * PAGE_SIZE, 1);
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory, "ab", 2));
+}
+
+static void test_mtd_cache_write_full_page(void)
+{
+    uint8_t page[PAGE_SIZE];
+
+    memset(page, 0x55, sizeof(page));
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_write(dev, page, PAGE_SIZE,
+                                               PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(0, _parent.reads);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory + PAGE_SIZE, page, PAGE_SIZE));
+
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(dev, page, PAGE_SIZE + 1,
+                                                PAGE_SIZE));
+}
+
+static void test_mtd_cache_erase(void)
+{
+    uint8_t buf[2];
+
+    TEST_ASSERT_EQUAL_INT(2, mtd_write(dev, "ab", 0, 2));
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(dev, 0, PAGE_PER_SECTOR * PAGE_SIZE));
+    /* the pending data was dropped */
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(0, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(2, mtd_read(dev, buf, 0, 2));
+    TEST_ASSERT_EQUAL_INT(0xff, buf[0]);
+    TEST_ASSERT_EQUAL_INT(0xff, buf[1]);
+}
+
+static void test_mtd_cache_erase_invalid(void)
+{
+    const uint32_t sector_size = PAGE_PER_SECTOR * PAGE_SIZE;
+
+    TEST_ASSERT_EQUAL_INT(2, mtd_write(dev, "ab", 0, 2));
+    /* rejected erases keep the pending data */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(dev, 0, PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(dev, PAGE_SIZE, sector_size));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(dev, 0, (SECTOR_COUNT + 1) *
+                                                sector_size));
+    TEST_ASSERT_EQUAL_INT(0, _parent.erases);
+    TEST_ASSERT_EQUAL_INT(0, mtd_cache_flush(&_cache));
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory, "ab", 2));
+}
+
+static void test_mtd_cache_power_down(void)
+{
+    TEST_ASSERT_EQUAL_INT(2, mtd_write(dev, "ab", 4, 2));
+    TEST_ASSERT_EQUAL_INT(0, mtd_power(dev, MTD_POWER_DOWN));
+    TEST_ASSERT_EQUAL_INT(1, _parent.writes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(_memory + 4, "ab", 2));
+}
+
+Test *tests_mtd_cache_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_cache_init),
+        new_TestFixture(test_mtd_cache_read_hit),
+        new_TestFixture(test_mtd_cache_read_unaligned),
+        new_TestFixture(test_mtd_cache_lru),
+        new_TestFixture(test_mtd_cache_write_coalesce),
+        new_TestFixture(test_mtd_cache_write_twice),
+        new_TestFixture(test_mtd_cache_write_evict),
+        new_TestFixture(test_mtd_cache_write_full_page),
+        new_TestFixture(test_mtd_cache_erase),
+        new_TestFixture(test_mtd_cache_erase_invalid),
+        new_TestFixture(test_mtd_cache_power_down),
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_cache_tests, set_up, NULL, fixtures);
+
+    return (Test *)&mtd_cache_tests;
+}
+
+void tests_mtd_cache(void)
+{
+    TESTS_RUN(tests_mtd_cache_tests());
+}
+/** @} */
@@ -0,0 +1,256 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "tests-mtd_native.h"
+
+/* mtd_native is only available on native */
+#ifdef MODULE_MTD_NATIVE
+#include <fcntl.h>
+
+#include "mtd.h"
+#include "mtd_native.h"
+#include "native_internal.h"
+
+#define FILENAME        "tests-mtd_native.bin"
+#define SECTOR_COUNT    (4U)
+#define PAGE_PER_SECTOR (4U)
+#define PAGE_SIZE       (64U)
+#define SECTOR_SIZE     (PAGE_PER_SECTOR * PAGE_SIZE)
+#define MEM_SIZE        (SECTOR_COUNT * SECTOR_SIZE)
+
+static uint32_t _erase_count[SECTOR_COUNT];
+static uint8_t _buf[MEM_SIZE];
+static mtd_native_dev_t _dev;
+
+static void _dev_setup(mtd_native_dev_t *dev)
+{
+    memset(dev, 0, sizeof(*dev));
+    dev->dev.driver = &native_flash_driver;
+    dev->dev.sector_count = SECTOR_COUNT;
+    dev->dev.pages_per_sector = PAGE_PER_SECTOR;
+    dev->dev.page_size = PAGE_SIZE;
+    dev->fname = FILENAME;
+    dev->erase_count = _erase_count;
+}
+
+static void set_up(void)
+{
+    real_unlink(FILENAME);
+    memset(_erase_count, 0, sizeof(_erase_count));
+    _dev_setup(&_dev);
+}
+
+static void tear_down(void)
+{
+    real_unlink(FILENAME);
+}
+
+static bool _is_erased(const uint8_t *buf, size_t len)
+{
+    for (size_t i = 0; i < len; i++) {
+        if (buf[i] != 0xff) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static void test_mtd_native__init_new_file(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_NOT_NULL(_dev.mem);
+    TEST_ASSERT_EQUAL_INT(MEM_SIZE, mtd_read(&_dev.dev, _buf, 0, MEM_SIZE));
+    TEST_ASSERT(_is_erased(_buf, MEM_SIZE));
+
+    /* the file was created with the size of the device */
+    int fd = real_open(FILENAME, O_RDONLY);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(MEM_SIZE, real_lseek(fd, 0, SEEK_END));
+    real_close(fd);
+}
+
+static void test_mtd_native__init_short_file(void)
+{
+    const uint8_t data[] = { 0x00, 0x11, 0x22, 0x33, 0x44 };
+
+    int fd = real_open(FILENAME, O_RDWR | O_CREAT, 0644);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(data), real_write(fd, data, sizeof(data)));
+    real_close(fd);
+
+    /* the existing content is kept, the extension reads erased */
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_EQUAL_INT(MEM_SIZE, mtd_read(&_dev.dev, _buf, 0, MEM_SIZE));
+    TEST_ASSERT(memcmp(_buf, data, sizeof(data)) == 0);
+    TEST_ASSERT(_is_erased(_buf + sizeof(data), MEM_SIZE - sizeof(data)));
+}
+
+static void test_mtd_native__shared_mapping(void)
+{
+    const uint8_t data[] = { 0xde, 0xad, 0xbe, 0xef };
+    mtd_native_dev_t other;
+    uint8_t file[sizeof(data)];
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_EQUAL_INT(sizeof(data), mtd_write(&_dev.dev, data, PAGE_SIZE,
+                                                  sizeof(data)));
+
+    /* writes go to the file without any flush */
+    int fd = real_open(FILENAME, O_RDONLY);
+    TEST_ASSERT(fd >= 0);
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, real_lseek(fd, PAGE_SIZE, SEEK_SET));
+    TEST_ASSERT_EQUAL_INT(sizeof(file), real_read(fd, file, sizeof(file)));
+    real_close(fd);
+    TEST_ASSERT(memcmp(file, data, sizeof(data)) == 0);
+
+    /* a second device on the same file sees them as well */
+    _dev_setup(&other);
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&other.dev));
+    TEST_ASSERT(other.mem != _dev.mem);
+    TEST_ASSERT_EQUAL_INT(sizeof(file), mtd_read(&other.dev, file, PAGE_SIZE,
+                                                 sizeof(file)));
+    TEST_ASSERT(memcmp(file, data, sizeof(data)) == 0);
+
+    /* init again keeps the mapping */
+    uint8_t *mem = _dev.mem;
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT(mem == _dev.mem);
+}
+
+static void test_mtd_native__and_write(void)
+{
+    uint8_t exp[PAGE_SIZE];
+    uint8_t data[PAGE_SIZE];
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    for (unsigned i = 0; i < PAGE_SIZE; i++) {
+        data[i] = 0xf0 | (i & 0x0f);
+    }
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_write(&_dev.dev, data, PAGE_SIZE,
+                                               PAGE_SIZE));
+    memcpy(exp, data, sizeof(exp));
+
+    /* a second, unaligned write only clears bits, word-wise in the middle
+     * and byte-wise at the unaligned head and tail */
+    for (unsigned i = 0; i < PAGE_SIZE; i++) {
+        data[i] = 0x3c ^ i;
+    }
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE - 8, mtd_write(&_dev.dev, data + 3,
+                                                   PAGE_SIZE + 3,
+                                                   PAGE_SIZE - 8));
+    for (unsigned i = 3; i < PAGE_SIZE - 5; i++) {
+        exp[i] &= data[i];
+    }
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_read(&_dev.dev, _buf, PAGE_SIZE,
+                                              PAGE_SIZE));
+    TEST_ASSERT(memcmp(_buf, exp, sizeof(exp)) == 0);
+
+    /* writing ones does not set cleared bits */
+    memset(data, 0xff, sizeof(data));
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_write(&_dev.dev, data, PAGE_SIZE,
+                                               PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_read(&_dev.dev, _buf, PAGE_SIZE,
+                                              PAGE_SIZE));
+    TEST_ASSERT(memcmp(_buf, exp, sizeof(exp)) == 0);
+
+    /* the neighboring pages are untouched */
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_read(&_dev.dev, _buf, 0, PAGE_SIZE));
+    TEST_ASSERT(_is_erased(_buf, PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_read(&_dev.dev, _buf, 2 * PAGE_SIZE,
+                                              PAGE_SIZE));
+    TEST_ASSERT(_is_erased(_buf, PAGE_SIZE));
+}
+
+static void test_mtd_native__erase(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    memset(_buf, 0, sizeof(_buf));
+    for (unsigned page = 0; page < MEM_SIZE / PAGE_SIZE; page++) {
+        TEST_ASSERT_EQUAL_INT(PAGE_SIZE, mtd_write(&_dev.dev, _buf,
+                                                   page * PAGE_SIZE,
+                                                   PAGE_SIZE));
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_dev.dev, SECTOR_SIZE,
+                                       2 * SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(MEM_SIZE, mtd_read(&_dev.dev, _buf, 0, MEM_SIZE));
+    TEST_ASSERT(_is_erased(_buf + SECTOR_SIZE, 2 * SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, _buf[SECTOR_SIZE - 1]);
+    TEST_ASSERT_EQUAL_INT(0, _buf[3 * SECTOR_SIZE]);
+
+    /* wear is counted per sector */
+    TEST_ASSERT_EQUAL_INT(0, mtd_erase(&_dev.dev, SECTOR_SIZE, SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(0, _erase_count[0]);
+    TEST_ASSERT_EQUAL_INT(2, _erase_count[1]);
+    TEST_ASSERT_EQUAL_INT(1, _erase_count[2]);
+    TEST_ASSERT_EQUAL_INT(0, _erase_count[3]);
+}
+
+static void test_mtd_native__bounds(void)
+{
+    TEST_ASSERT_EQUAL_INT(0, mtd_init(&_dev.dev));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_read(&_dev.dev, _buf, MEM_SIZE - 1,
+                                               2));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(&_dev.dev, _buf, MEM_SIZE, 1));
+    /* writes must not cross a page boundary */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_write(&_dev.dev, _buf, PAGE_SIZE - 1,
+                                                2));
+    /* erases must be sector aligned */
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(&_dev.dev, PAGE_SIZE,
+                                                SECTOR_SIZE));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(&_dev.dev, 0, PAGE_SIZE));
+    TEST_ASSERT_EQUAL_INT(-EOVERFLOW, mtd_erase(&_dev.dev, 0,
+                                                MEM_SIZE + SECTOR_SIZE));
+    for (unsigned i = 0; i < SECTOR_COUNT; i++) {
+        TEST_ASSERT_EQUAL_INT(0, _erase_count[i]);
+    }
+
+    /* nothing is accessed before init */
+    _dev_setup(&_dev);
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_read(&_dev.dev, _buf, 0, 1));
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_write(&_dev.dev, _buf, 0, 1));
+    TEST_ASSERT_EQUAL_INT(-EIO, mtd_erase(&_dev.dev, 0, SECTOR_SIZE));
+}
+
+Test *tests_mtd_native_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_mtd_native__init_new_file),
+        new_TestFixture(test_mtd_native__init_short_file),
+        new_TestFixture(test_mtd_native__shared_mapping),
+        new_TestFixture(test_mtd_native__and_write),
+        new_TestFixture(test_mtd_native__erase),
+        new_TestFixture(test_mtd_native__bounds),
+    };
+
+    EMB_UNIT_TESTCALLER(mtd_native_tests, set_up, tear_down, fixtures);
+
+    return (Test *)&mtd_native_tests;
+}
+
+void tests_mtd_native(void)
+{
+    TESTS_RUN(tests_mtd_native_tests());
+}
+#else
+void tests_mtd_native(void)
+{
+}
+#endif
+/** @} */
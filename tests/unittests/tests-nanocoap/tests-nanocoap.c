@@ -645,6 +645,59 @@ static void test_nanocoap__options_get_opaque(void)
     TEST_ASSERT_EQUAL_INT(-ENOENT, optlen);
 }
 
+static ssize_t _dummy_handler(coap_pkt_t *pkt, uint8_t *buf, size_t len,
+                              void *ctx)
+{
+    (void)pkt;
+    (void)buf;
+    (void)len;
+    (void)ctx;
+    return 0;
+}
+
+/*
+ * Builds a resource dispatch index and looks up exact paths, methods, and
+ * paths not indexed.
+ */
+static void test_nanocoap__resource_index(void)
+{
+    static const coap_resource_t resources[] = {
+        { "/a", COAP_GET, _dummy_handler, NULL },
+        { "/a", COAP_POST, _dummy_handler, NULL },
+        { "/b", COAP_GET | COAP_PUT, _dummy_handler, NULL },
+        { "/c", COAP_GET | COAP_MATCH_SUBTREE, _dummy_handler, NULL },
+    };
+    const coap_resource_t *slots[4];
+    const coap_resource_t *found = NULL;
+    coap_resource_index_t idx;
+
+    coap_resource_index_init(&idx, slots, ARRAY_SIZE(slots));
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_add(&idx, &resources[0]));
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_add(&idx, &resources[1]));
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_add(&idx, &resources[2]));
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP, coap_resource_index_add(&idx, &resources[3]));
+    /* one slot is always kept empty */
+    TEST_ASSERT_EQUAL_INT(-ENOSPC, coap_resource_index_add(&idx, &resources[0]));
+    TEST_ASSERT_EQUAL_INT(3, idx.numof);
+    TEST_ASSERT_EQUAL_INT(2, idx.unindexed);
+
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_find(&idx, (uint8_t *)"/a",
+                                                      COAP_GET, &found));
+    TEST_ASSERT(found == &resources[0]);
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_find(&idx, (uint8_t *)"/a",
+                                                      COAP_POST, &found));
+    TEST_ASSERT(found == &resources[1]);
+    TEST_ASSERT_EQUAL_INT(0, coap_resource_index_find(&idx, (uint8_t *)"/b",
+                                                      COAP_PUT, &found));
+    TEST_ASSERT(found == &resources[2]);
+    TEST_ASSERT_EQUAL_INT(-EPERM, coap_resource_index_find(&idx, (uint8_t *)"/b",
+                                                           COAP_DELETE, &found));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, coap_resource_index_find(&idx, (uint8_t *)"/c",
+                                                            COAP_GET, &found));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, coap_resource_index_find(&idx, (uint8_t *)"/ab",
+                                                            COAP_GET, &found));
+}
+
 Test *tests_nanocoap_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
@@ -667,6 +720,7 @@ Test *tests_nanocoap_tests(void)
         new_TestFixture(test_nanocoap__server_reply_simple_con),
         new_TestFixture(test_nanocoap__server_option_count_overflow_check),
         new_TestFixture(test_nanocoap__server_option_count_overflow),
+        new_TestFixture(test_nanocoap__resource_index),
     };
 
     EMB_UNIT_TESTCALLER(nanocoap_tests, NULL, NULL, fixtures);
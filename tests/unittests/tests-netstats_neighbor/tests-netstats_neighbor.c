@@ -0,0 +1,229 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/netstats/neighbor.h"
+
+#include "tests-netstats_neighbor.h"
+
+#define ETX(x)          ((x) * NETSTATS_NB_ETX_DIVISOR)
+
+static netstats_nb_table_t _table;
+static const uint8_t _addr_a[] = { 0x02, 0x00, 0x00, 0x0a };
+static const uint8_t _addr_b[] = { 0x02, 0x00, 0x00, 0x0b };
+
+static void set_up(void)
+{
+    netstats_nb_init(&_table);
+}
+
+static void _record(const uint8_t *addr)
+{
+    netstats_nb_record(&_table, addr, (addr == NULL) ? 0 : sizeof(_addr_a));
+}
+
+static void _get(const uint8_t *addr, netstats_nb_t *stats)
+{
+    TEST_ASSERT_EQUAL_INT(0, netstats_nb_get(&_table, addr, sizeof(_addr_a),
+                                             stats));
+}
+
+static void test_netstats_nb__tx_in_order(void)
+{
+    netstats_nb_t stats;
+
+    _record(_addr_a);
+    netstats_nb_update_tx(&_table, 1, true);
+    _record(_addr_b);
+    netstats_nb_update_tx(&_table, 2, false);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(ETX(1), stats.etx);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_failed);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+    _get(_addr_b, &stats);
+    TEST_ASSERT_EQUAL_INT(ETX(NETSTATS_NB_ETX_NOACK_PENALTY), stats.etx);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_failed);
+    TEST_ASSERT_EQUAL_INT(ETX(1), netstats_nb_etx(&_table, _addr_a,
+                                                  sizeof(_addr_a)));
+}
+
+static void test_netstats_nb__tx_interleaved(void)
+{
+    netstats_nb_t stats;
+
+    /* outcomes are reported after the next frames were recorded */
+    _record(_addr_a);
+    _record(_addr_b);
+    _record(_addr_a);
+    netstats_nb_update_tx(&_table, 1, true);
+    _record(NULL);
+    netstats_nb_update_tx(&_table, 1, false);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_pending);
+    netstats_nb_update_tx(&_table, 3, true);
+    /* multicast frame */
+    netstats_nb_update_tx(&_table, 1, true);
+    /* nothing pending anymore */
+    netstats_nb_update_tx(&_table, 1, false);
+
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(2, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_failed);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+    TEST_ASSERT_EQUAL_INT(((ETX(1) * NETSTATS_NB_ETX_ALPHA) +
+                           (ETX(3) * (100U - NETSTATS_NB_ETX_ALPHA))) / 100U,
+                          stats.etx);
+    _get(_addr_b, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_failed);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+}
+
+static void test_netstats_nb__tx_not_sent(void)
+{
+    netstats_nb_t stats;
+
+    /* medium busy */
+    _record(_addr_a);
+    netstats_nb_update_tx(&_table, 0, false);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(0, stats.etx);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+
+    /* frame to B never handed to the device */
+    _record(_addr_a);
+    _record(_addr_b);
+    netstats_nb_cancel_tx(&_table);
+    _get(_addr_b, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+    netstats_nb_update_tx(&_table, 1, true);
+    netstats_nb_update_tx(&_table, 1, false);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(ETX(1), stats.etx);
+    _get(_addr_b, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_count);
+}
+
+static void test_netstats_nb__tx_lost(void)
+{
+    netstats_nb_t stats;
+
+    /* the device never reports the outcome of the frame to A */
+    _record(_addr_a);
+    for (unsigned i = 0; i < NETSTATS_NB_TX_PENDING_MAX; i++) {
+        _record(_addr_b);
+    }
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_pending);
+    _get(_addr_b, &stats);
+    /* all pending frames are to B */
+    TEST_ASSERT_EQUAL_INT((1U << NETSTATS_NB_TX_PENDING_MAX) - 1,
+                          stats.tx_pending);
+    netstats_nb_update_tx(&_table, 2, true);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(0, stats.tx_count);
+    _get(_addr_b, &stats);
+    TEST_ASSERT_EQUAL_INT(1, stats.tx_count);
+    TEST_ASSERT_EQUAL_INT(ETX(2), stats.etx);
+}
+
+static void test_netstats_nb__rx(void)
+{
+    netstats_nb_t stats;
+
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_nb_get(&_table, _addr_a,
+                                                   sizeof(_addr_a), NULL));
+    TEST_ASSERT_EQUAL_INT(0, netstats_nb_etx(&_table, _addr_a,
+                                             sizeof(_addr_a)));
+    netstats_nb_update_rx(&_table, _addr_a, sizeof(_addr_a), -50, 200);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(-50, stats.rssi);
+    TEST_ASSERT_EQUAL_INT(200, stats.lqi);
+    netstats_nb_update_rx(&_table, _addr_a, sizeof(_addr_a), -60, 100);
+    _get(_addr_a, &stats);
+    TEST_ASSERT_EQUAL_INT(2, stats.rx_count);
+    TEST_ASSERT_EQUAL_INT(((-50 * (int)NETSTATS_NB_RX_ALPHA) +
+                           (-60 * (100 - (int)NETSTATS_NB_RX_ALPHA))) / 100,
+                          stats.rssi);
+    TEST_ASSERT_EQUAL_INT(((200U * NETSTATS_NB_RX_ALPHA) +
+                           (100U * (100U - NETSTATS_NB_RX_ALPHA))) / 100U,
+                          stats.lqi);
+    /* no ETX yet */
+    TEST_ASSERT_EQUAL_INT(0, stats.etx);
+}
+
+static void test_netstats_nb__replace_iter_reset(void)
+{
+    netstats_nb_t stats;
+    uint8_t addr[sizeof(_addr_a)];
+    unsigned state = 0, count = 0;
+
+    memcpy(addr, _addr_a, sizeof(addr));
+    for (unsigned i = 0; i <= NETSTATS_NB_SIZE; i++) {
+        addr[sizeof(addr) - 1] = i;
+        netstats_nb_update_rx(&_table, addr, sizeof(addr), -50, 200);
+    }
+    /* least recently updated neighbor was replaced */
+    addr[sizeof(addr) - 1] = 0;
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_nb_get(&_table, addr, sizeof(addr),
+                                                   NULL));
+    addr[sizeof(addr) - 1] = NETSTATS_NB_SIZE;
+    _get(addr, &stats);
+    /* longer addresses are not tracked */
+    netstats_nb_update_rx(&_table, addr, NETSTATS_NB_L2ADDR_MAX + 1, -50, 200);
+
+    while (netstats_nb_iter(&_table, &state, &stats)) {
+        TEST_ASSERT_EQUAL_INT(sizeof(addr), stats.l2_addr_len);
+        count++;
+    }
+    TEST_ASSERT_EQUAL_INT(NETSTATS_NB_SIZE, count);
+
+    _record(_addr_a);
+    netstats_nb_reset(&_table);
+    state = 0;
+    TEST_ASSERT(!netstats_nb_iter(&_table, &state, &stats));
+    /* pending frames are dropped with the entries */
+    netstats_nb_update_tx(&_table, 1, true);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_nb_get(&_table, _addr_a,
+                                                   sizeof(_addr_a), NULL));
+}
+
+Test *tests_netstats_neighbor_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_netstats_nb__tx_in_order),
+        new_TestFixture(test_netstats_nb__tx_interleaved),
+        new_TestFixture(test_netstats_nb__tx_not_sent),
+        new_TestFixture(test_netstats_nb__tx_lost),
+        new_TestFixture(test_netstats_nb__rx),
+        new_TestFixture(test_netstats_nb__replace_iter_reset),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_neighbor_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_neighbor_tests;
+}
+
+void tests_netstats_neighbor(void)
+{
+    TESTS_RUN(tests_netstats_neighbor_tests());
+}
+/** @} */
@@ -0,0 +1,146 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "net/netstats/trace.h"
+
+#include "tests-netstats_trace.h"
+
+static netstats_trace_t _trace;
+
+static void set_up(void)
+{
+    netstats_trace_init(&_trace);
+}
+
+static void _add(unsigned num, uint16_t arg)
+{
+    for (unsigned i = 0; i < num; i++) {
+        NETSTATS_TRACE_ADD(&_trace, NETSTATS_TRACE_TX_QUEUED, arg + i);
+    }
+}
+
+static void _assert_arg(uint32_t seq, uint16_t arg)
+{
+    netstats_trace_entry_t entry;
+
+    TEST_ASSERT_EQUAL_INT(0, netstats_trace_get(&_trace, seq, &entry));
+    TEST_ASSERT_EQUAL_INT(NETSTATS_TRACE_TX_QUEUED, entry.event);
+    TEST_ASSERT_EQUAL_INT(arg, entry.arg);
+}
+
+static void test_netstats_trace__add_get(void)
+{
+    netstats_trace_entry_t entry;
+    uint32_t last = 0;
+
+    TEST_ASSERT_EQUAL_INT(0, netstats_trace_first(&_trace));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace, 0, &entry));
+    _add(3, 100);
+    TEST_ASSERT_EQUAL_INT(3, _trace.count);
+    TEST_ASSERT_EQUAL_INT(0, netstats_trace_first(&_trace));
+    for (uint32_t seq = 0; seq < 3; seq++) {
+        _assert_arg(seq, 100 + seq);
+        netstats_trace_get(&_trace, seq, &entry);
+        /* time stamps are monotonic */
+        TEST_ASSERT(entry.time >= last);
+        last = entry.time;
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace, 3, &entry));
+
+    netstats_trace_init(&_trace);
+    TEST_ASSERT_EQUAL_INT(0, _trace.count);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace, 0, &entry));
+}
+
+static void test_netstats_trace__overwrite(void)
+{
+    netstats_trace_entry_t entry;
+
+    _add(NETSTATS_TRACE_SIZE + 3, 0);
+    TEST_ASSERT_EQUAL_INT(3, netstats_trace_first(&_trace));
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace, 2, &entry));
+    for (uint32_t seq = 3; seq < NETSTATS_TRACE_SIZE + 3; seq++) {
+        _assert_arg(seq, seq);
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace,
+                                                      NETSTATS_TRACE_SIZE + 3,
+                                                      &entry));
+}
+
+static void test_netstats_trace__count_wrap(void)
+{
+    netstats_trace_entry_t entry;
+
+    /* the sequence number of the next event wraps after two events */
+    _trace.count = UINT32_MAX - 1;
+    _add(4, 10);
+    TEST_ASSERT_EQUAL_INT(2, _trace.count);
+    _assert_arg(UINT32_MAX - 1, 10);
+    _assert_arg(UINT32_MAX, 11);
+    _assert_arg(0, 12);
+    _assert_arg(1, 13);
+    TEST_ASSERT_EQUAL_INT(-ENOENT, netstats_trace_get(&_trace, 2, &entry));
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          netstats_trace_get(&_trace,
+                                             UINT32_MAX - NETSTATS_TRACE_SIZE,
+                                             &entry));
+}
+
+static void test_netstats_trace__export(void)
+{
+    const netstats_trace_entry_t entry = {
+        .time = 0x12345678,
+        .arg = 0xabcd,
+        .event = NETSTATS_TRACE_MAC_WAKEUP,
+    };
+    const netstats_trace_record_t exp = {
+        0x78, 0x56, 0x34, 0x12, 0xcd, 0xab, NETSTATS_TRACE_MAC_WAKEUP, 0x00
+    };
+    netstats_trace_record_t record;
+
+    memset(record, 0xff, sizeof(record));
+    netstats_trace_export(&entry, record);
+    TEST_ASSERT(memcmp(exp, record, sizeof(record)) == 0);
+
+    TEST_ASSERT_EQUAL_STRING("radio_on",
+                             netstats_trace_event_str(NETSTATS_TRACE_RADIO_ON));
+    TEST_ASSERT_EQUAL_STRING("mac_sleep",
+                             netstats_trace_event_str(NETSTATS_TRACE_MAC_SLEEP));
+    TEST_ASSERT_EQUAL_STRING("unknown",
+                             netstats_trace_event_str(NETSTATS_TRACE_NUMOF));
+}
+
+Test *tests_netstats_trace_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_netstats_trace__add_get),
+        new_TestFixture(test_netstats_trace__overwrite),
+        new_TestFixture(test_netstats_trace__count_wrap),
+        new_TestFixture(test_netstats_trace__export),
+    };
+
+    EMB_UNIT_TESTCALLER(netstats_trace_tests, set_up, NULL, fixtures);
+
+    return (Test *)&netstats_trace_tests;
+}
+
+void tests_netstats_trace(void)
+{
+    TESTS_RUN(tests_netstats_trace_tests());
+}
+/** @} */
@@ -0,0 +1,244 @@
+/*
+ * Copyright (C) 2020 Freie Universität Berlin
+ *
+ * This file is subject to the terms and conditions of the GNU Lesser
+ * General Public License v2.1. See the file LICENSE in the top level
+ * directory for more details.
+ */
+
+/**
+ * @{
+ *
+ * @file
+ */
+#include <errno.h>
+#include <string.h>
+
+#include "embUnit.h"
+
+#include "mtd-nor-mock.h"
+#include "tslog.h"
+
+#include "tests-tslog.h"
+
+#define SECTOR_COUNT    (4)
+#define PAGE_PER_SECTOR (4)
+#define PAGE_SIZE       (64)
+#define SECTOR_SIZE     (PAGE_PER_SECTOR * PAGE_SIZE)
+/* records with a 4 byte payload per sector */
+#define RECORDS_PER_SECTOR  ((SECTOR_SIZE - TSLOG_SECTOR_HDR_SIZE) / \
+                             (TSLOG_RECORD_HDR_SIZE + 4))
+
+static uint8_t _memory[SECTOR_SIZE * SECTOR_COUNT];
+static mtd_nor_mock_t _dev = MTD_NOR_MOCK_INIT(_memory, SECTOR_COUNT,
+                                               PAGE_PER_SECTOR, PAGE_SIZE);
+
+static tslog_t _log = { .mtd = &_dev.base };
+
+static void set_up(void)
+{
+    memset(_memory, 0x5a, sizeof(_memory));
+    tslog_format(&_log);
+}
+
+/* append records with the times first..last and their time as payload */
+static void _append(uint32_t first, uint32_t last)
+{
+    for (uint32_t t = first; t <= last; t++) {
+        TEST_ASSERT_EQUAL_INT(0, tslog_append(&_log, t, &t, sizeof(t)));
+    }
+}
+
+/* check that a range query returns the records first..last */
+static void _check(uint32_t from, uint32_t to, uint32_t first, uint32_t last)
+{
+    tslog_iter_t it;
+    uint32_t time, data;
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_iter_init(&_log, &it, from, to));
+    for (uint32_t t = first; t <= last; t++) {
+        TEST_ASSERT_EQUAL_INT(sizeof(data),
+                              tslog_iter_next(&_log, &it, &time, &data,
+                                              sizeof(data)));
+        TEST_ASSERT_EQUAL_INT(t, time);
+        TEST_ASSERT_EQUAL_INT(t, data);
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          tslog_iter_next(&_log, &it, &time, &data,
+                                          sizeof(data)));
+}
+
+static void test_tslog_empty(void)
+{
+    tslog_iter_t it;
+    uint32_t time, data;
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_mount(&_log));
+    TEST_ASSERT_EQUAL_INT(0, tslog_iter_init(&_log, &it, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          tslog_iter_next(&_log, &it, &time, &data,
+                                          sizeof(data)));
+}
+
+static void test_tslog_append_buffered(void)
+{
+    _append(1, 10);
+    /* nothing was programmed yet, but the records are found */
+    TEST_ASSERT_EQUAL_INT(0, _log.stats.writes);
+    _check(0, UINT32_MAX, 1, 10);
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_flush(&_log));
+    /* 136 bytes, programmed page by page */
+    TEST_ASSERT_EQUAL_INT(3, _log.stats.writes);
+    _check(0, UINT32_MAX, 1, 10);
+}
+
+static void test_tslog_append_invalid(void)
+{
+    static uint8_t big[SECTOR_SIZE];
+    tslog_iter_t it;
+    uint32_t time;
+    uint8_t small[2];
+
+    _append(5, 5);
+    TEST_ASSERT_EQUAL_INT(-EINVAL, tslog_append(&_log, 4, "x", 1));
+    TEST_ASSERT_EQUAL_INT(-EFBIG, tslog_append(&_log, 6, big, sizeof(big)));
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_iter_init(&_log, &it, 0, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(-ENOBUFS,
+                          tslog_iter_next(&_log, &it, &time, small,
+                                          sizeof(small)));
+}
+
+static void test_tslog_remount(void)
+{
+    _append(1, 30);
+    TEST_ASSERT_EQUAL_INT(0, tslog_flush(&_log));
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_mount(&_log));
+    TEST_ASSERT_EQUAL_INT(2, _log.count);
+    TEST_ASSERT_EQUAL_INT(30, _log.last_time);
+    _check(0, UINT32_MAX, 1, 30);
+
+    /* appending continues behind the last record */
+    _append(31, 35);
+    TEST_ASSERT_EQUAL_INT(2, _log.count);
+    _check(0, UINT32_MAX, 1, 35);
+}
+
+static void test_tslog_wrap(void)
+{
+    uint32_t last = RECORDS_PER_SECTOR * (SECTOR_COUNT + 2) + 3;
+
+    _append(1, last);
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, _log.count);
+    /* the oldest data was overwritten, three full sectors are left */
+    uint32_t first = last - 3 - (SECTOR_COUNT - 1) * RECORDS_PER_SECTOR + 1;
+    _check(0, UINT32_MAX, first, last);
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_flush(&_log));
+    TEST_ASSERT_EQUAL_INT(0, tslog_mount(&_log));
+    TEST_ASSERT_EQUAL_INT(SECTOR_COUNT, _log.count);
+    _check(0, UINT32_MAX, first, last);
+}
+
+static void test_tslog_range(void)
+{
+    _append(1, RECORDS_PER_SECTOR * 3);
+    _check(25, 47, 25, 47);
+    _check(RECORDS_PER_SECTOR * 3, UINT32_MAX,
+           RECORDS_PER_SECTOR * 3, RECORDS_PER_SECTOR * 3);
+    _check(0, 0, 1, 0);
+}
+
+static void test_tslog_equal_time(void)
+{
+    tslog_iter_t it;
+    uint32_t time, data;
+
+    /* the records at time 100 span the boundary of the first two sectors */
+    _append(1, RECORDS_PER_SECTOR - 2);
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_INT(0, tslog_append(&_log, 100, &i, sizeof(i)));
+    }
+    _append(101, 102);
+    TEST_ASSERT_EQUAL_INT(2, _log.count);
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_iter_init(&_log, &it, 100, 100));
+    for (uint32_t i = 0; i < 5; i++) {
+        TEST_ASSERT_EQUAL_INT(sizeof(data),
+                              tslog_iter_next(&_log, &it, &time, &data,
+                                              sizeof(data)));
+        TEST_ASSERT_EQUAL_INT(100, time);
+        TEST_ASSERT_EQUAL_INT(i, data);
+    }
+    TEST_ASSERT_EQUAL_INT(-ENOENT,
+                          tslog_iter_next(&_log, &it, &time, &data,
+                                          sizeof(data)));
+}
+
+static void test_tslog_torn_record(void)
+{
+    _append(1, 10);
+    TEST_ASSERT_EQUAL_INT(0, tslog_flush(&_log));
+
+    /* clear a bit in the payload of the last record */
+    _memory[TSLOG_SECTOR_HDR_SIZE + 9 * 12 + TSLOG_RECORD_HDR_SIZE] &= 0xfd;
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_mount(&_log));
+    TEST_ASSERT_EQUAL_INT(9, _log.last_time);
+    TEST_ASSERT(_log.sealed);
+    _check(0, UINT32_MAX, 1, 9);
+
+    /* new records go to the next sector */
+    _append(11, 12);
+    TEST_ASSERT_EQUAL_INT(1, _log.head);
+    tslog_iter_t it;
+    uint32_t time, data;
+    TEST_ASSERT_EQUAL_INT(0, tslog_iter_init(&_log, &it, 9, UINT32_MAX));
+    TEST_ASSERT_EQUAL_INT(4, tslog_iter_next(&_log, &it, &time, &data, 4));
+    TEST_ASSERT_EQUAL_INT(9, time);
+    TEST_ASSERT_EQUAL_INT(4, tslog_iter_next(&_log, &it, &time, &data, 4));
+    TEST_ASSERT_EQUAL_INT(11, time);
+}
+
+static void test_tslog_torn_sector_header(void)
+{
+    _append(1, RECORDS_PER_SECTOR + 1);
+    TEST_ASSERT_EQUAL_INT(0, tslog_flush(&_log));
+
+    /* the header of the second sector was not written completely */
+    memset(_memory + SECTOR_SIZE + 8, 0xff, 8);
+
+    TEST_ASSERT_EQUAL_INT(0, tslog_mount(&_log));
+    TEST_ASSERT_EQUAL_INT(0, _log.head);
+    _check(0, UINT32_MAX, 1, RECORDS_PER_SECTOR);
+    _append(100, 100);
+    TEST_ASSERT_EQUAL_INT(1, _log.head);
+    _check(RECORDS_PER_SECTOR + 1, UINT32_MAX, 100, 100);
+}
+
+Test *tests_tslog_tests(void)
+{
+    EMB_UNIT_TESTFIXTURES(fixtures) {
+        new_TestFixture(test_tslog_empty),
+        new_TestFixture(test_tslog_append_buffered),
+        new_TestFixture(test_tslog_append_invalid),
+        new_TestFixture(test_tslog_remount),
+        new_TestFixture(test_tslog_wrap),
+        new_TestFixture(test_tslog_range),
+        new_TestFixture(test_tslog_equal_time),
+        new_TestFixture(test_tslog_torn_record),
+        new_TestFixture(test_tslog_torn_sector_header),
+    };
+
+    EMB_UNIT_TESTCALLER(tslog_tests, set_up, NULL, fixtures);
+
+    return (Test *)&tslog_tests;
+}
+
+void tests_tslog(void)
+{
+    TESTS_RUN(tests_tslog_tests());
+}
+/** @} */
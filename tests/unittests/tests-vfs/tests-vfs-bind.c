@@ -98,6 +98,56 @@ static void test_vfs_bind(void)
     TEST_ASSERT_EQUAL_INT(0, res);
 }
 
+static ssize_t _count_sink(void *arg, const void *data, size_t len)
+{
+    (void)arg;
+    (void)data;
+    return len;
+}
+
+static void test_vfs_bind__readv_writev(void)
+{
+    int fd;
+    uint8_t buf[_VFS_TEST_BIND_BUFSIZE];
+    fd = vfs_bind(VFS_ANY_FD, O_RDWR, &_test_bind_ops, &buf[0]);
+    TEST_ASSERT(fd >= 0);
+    if (fd < 0) {
+        return;
+    }
+
+    /* the driver has no writev(), expect a write() per buffer */
+    iolist_t second = { NULL, (void *)&str_data[4], 4 };
+    iolist_t first = { &second, (void *)&str_data[0], 4 };
+    ssize_t nbytes;
+    int ncalls = _mock_write_calls;
+    nbytes = vfs_writev(fd, &first);
+    TEST_ASSERT_EQUAL_INT(_mock_write_calls, ncalls + 2);
+    TEST_ASSERT_EQUAL_INT(8, nbytes);
+    /* the mock driver writes every buffer to the start */
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&str_data[4], &buf[0], 4));
+
+    char strbuf[2][4];
+    second = (iolist_t){ NULL, strbuf[1], sizeof(strbuf[1]) };
+    first = (iolist_t){ &second, strbuf[0], sizeof(strbuf[0]) };
+    ncalls = _mock_read_calls;
+    nbytes = vfs_readv(fd, &first);
+    TEST_ASSERT_EQUAL_INT(_mock_read_calls, ncalls + 2);
+    TEST_ASSERT_EQUAL_INT(8, nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&buf[0], strbuf[0], 4));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&buf[0], strbuf[1], 4));
+
+    /* without direct access, vfs_sendfile() reads through the given buffer */
+    ncalls = _mock_read_calls;
+    nbytes = vfs_sendfile(fd, 20, _count_sink, NULL, strbuf, sizeof(strbuf));
+    TEST_ASSERT_EQUAL_INT(_mock_read_calls, ncalls + 3);
+    TEST_ASSERT_EQUAL_INT(20, nbytes);
+    nbytes = vfs_sendfile(fd, 20, _count_sink, NULL, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(-EFAULT, nbytes);
+
+    int res = vfs_close(fd);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
 static void test_vfs_bind__leak_fds(void)
 {
     /* This test was added after a bug was discovered in the _allocate_fd code to
@@ -128,6 +178,7 @@ Test *tests_vfs_bind_tests(void)
 {
     EMB_UNIT_TESTFIXTURES(fixtures) {
         new_TestFixture(test_vfs_bind),
+        new_TestFixture(test_vfs_bind__readv_writev),
         new_TestFixture(test_vfs_bind__leak_fds),
         new_TestFixture(test_vfs_bind__allocate_invalid_fd),
     };
@@ -140,6 +140,16 @@ static void test_vfs_null_file_ops_read(void)
     TEST_ASSERT_EQUAL_INT(-EFAULT, res);
 }
 
+static void test_vfs_null_file_ops_read_ptr(void)
+{
+    TEST_ASSERT(_test_vfs_file_op_my_fd >= 0);
+    const void *ptr;
+    int res = vfs_read_ptr(_test_vfs_file_op_my_fd, &ptr, 8);
+    TEST_ASSERT_EQUAL_INT(-ENOTSUP, res);
+    res = vfs_read_ptr(_test_vfs_file_op_my_fd, NULL, 8);
+    TEST_ASSERT_EQUAL_INT(-EFAULT, res);
+}
+
 static void test_vfs_null_file_ops_write(void)
 {
     TEST_ASSERT(_test_vfs_file_op_my_fd >= 0);
@@ -158,6 +168,7 @@ Test *tests_vfs_null_file_ops_tests(void)
         new_TestFixture(test_vfs_null_file_ops_lseek),
         new_TestFixture(test_vfs_null_file_ops_fstat),
         new_TestFixture(test_vfs_null_file_ops_read),
+        new_TestFixture(test_vfs_null_file_ops_read_ptr),
         new_TestFixture(test_vfs_null_file_ops_write),
     };
 
@@ -67,6 +67,12 @@ static vfs_mount_t _test_vfs_mount = {
     .private_data = (void *)&fs_data,
 };
 
+static vfs_mount_t _test_vfs_mount_nested = {
+    .mount_point = "/test/sub",
+    .fs = &constfs_file_system,
+    .private_data = (void *)&fs_data,
+};
+
 static void test_vfs_mount_umount(void)
 {
     int res;
@@ -128,6 +134,45 @@ static void test_vfs_constfs_open(void)
     TEST_ASSERT_EQUAL_INT(0, res);
 }
 
+static void test_vfs_constfs_open__nested(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    /* resolved by the outer mount, which has no such file */
+    int fd = vfs_open("/test/sub/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd == -ENOENT);
+
+    /* the longer mount point takes precedence once mounted */
+    res = vfs_mount(&_test_vfs_mount_nested);
+    TEST_ASSERT_EQUAL_INT(0, res);
+    for (unsigned i = 0; i < 2; ++i) {
+        fd = vfs_open("/test/sub/data.bin", O_RDONLY, 0);
+        TEST_ASSERT(fd >= 0);
+        if (fd >= 0) {
+            res = vfs_close(fd);
+            TEST_ASSERT_EQUAL_INT(0, res);
+        }
+    }
+    fd = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT(res == -EBUSY);
+    if (fd >= 0) {
+        res = vfs_close(fd);
+        TEST_ASSERT_EQUAL_INT(0, res);
+    }
+
+    res = vfs_umount(&_test_vfs_mount_nested);
+    TEST_ASSERT_EQUAL_INT(0, res);
+    fd = vfs_open("/test/sub/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd == -ENOENT);
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
 static void test_vfs_constfs_read_lseek(void)
 {
     int res;
@@ -171,6 +216,126 @@ static void test_vfs_constfs_read_lseek(void)
     TEST_ASSERT_EQUAL_INT(0, res);
 }
 
+static void test_vfs_constfs_read_ptr(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    int fd = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+
+    const void *ptr = NULL;
+    ssize_t nbytes;
+    nbytes = vfs_read_ptr(fd, &ptr, 8);
+    TEST_ASSERT_EQUAL_INT(8, nbytes);
+    TEST_ASSERT(ptr == &bin_data[0]);
+    /* the position is advanced like with vfs_read */
+    nbytes = vfs_read_ptr(fd, &ptr, sizeof(bin_data));
+    TEST_ASSERT_EQUAL_INT(sizeof(bin_data) - 8, nbytes);
+    TEST_ASSERT(ptr == &bin_data[8]);
+    nbytes = vfs_read_ptr(fd, &ptr, sizeof(bin_data));
+    TEST_ASSERT_EQUAL_INT(0, nbytes);
+
+    res = vfs_close(fd);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
+static void test_vfs_constfs_readv(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    int fd = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+
+    uint8_t head[4];
+    uint8_t tail[sizeof(bin_data)];
+    iolist_t second = { NULL, tail, sizeof(tail) };
+    iolist_t first = { &second, head, sizeof(head) };
+    ssize_t nbytes = vfs_readv(fd, &first);
+    TEST_ASSERT_EQUAL_INT(sizeof(bin_data), nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&bin_data[0], head, sizeof(head)));
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&bin_data[sizeof(head)], tail,
+                                    sizeof(bin_data) - sizeof(head)));
+
+    res = vfs_close(fd);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
+typedef struct {
+    uint8_t buf[sizeof(bin_data)];
+    size_t len;
+    size_t limit;
+    size_t step;        /* bytes consumed per call at most, 0 for no limit */
+    size_t max_len;     /* longest chunk passed */
+} _sink_t;
+
+static ssize_t _sink(void *arg, const void *data, size_t len)
+{
+    _sink_t *sink = arg;
+    if (len > sink->max_len) {
+        sink->max_len = len;
+    }
+    if (len > sink->limit - sink->len) {
+        len = sink->limit - sink->len;
+    }
+    if ((sink->step > 0) && (len > sink->step)) {
+        len = sink->step;
+    }
+    memcpy(&sink->buf[sink->len], data, len);
+    sink->len += len;
+    return len;
+}
+
+static void test_vfs_constfs_sendfile(void)
+{
+    int res;
+    res = vfs_mount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    int fd = vfs_open("/test/data.bin", O_RDONLY, 0);
+    TEST_ASSERT(fd >= 0);
+
+    /* ConstFS supports direct access, no buffer needed */
+    _sink_t sink = { .limit = 20 };
+    ssize_t nbytes = vfs_sendfile(fd, SIZE_MAX, _sink, &sink, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(20, nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(&bin_data[0], sink.buf, 20));
+    /* the bytes not consumed are left in the file */
+    TEST_ASSERT_EQUAL_INT(20, vfs_lseek(fd, 0, SEEK_CUR));
+
+    sink.limit = sizeof(sink.buf);
+    nbytes = vfs_sendfile(fd, SIZE_MAX, _sink, &sink, NULL, 0);
+    TEST_ASSERT_EQUAL_INT(sizeof(bin_data) - 20, nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(bin_data, sink.buf, sizeof(bin_data)));
+
+    /* chunks are capped at buf_len, partially consumed ones are passed
+     * again */
+    TEST_ASSERT_EQUAL_INT(0, vfs_lseek(fd, 0, SEEK_SET));
+    memset(&sink, 0, sizeof(sink));
+    sink.limit = sizeof(sink.buf);
+    sink.step = 7;
+    nbytes = vfs_sendfile(fd, SIZE_MAX, _sink, &sink, NULL, 16);
+    TEST_ASSERT_EQUAL_INT(sizeof(bin_data), nbytes);
+    TEST_ASSERT_EQUAL_INT(0, memcmp(bin_data, sink.buf, sizeof(bin_data)));
+    TEST_ASSERT_EQUAL_INT(16, sink.max_len);
+    TEST_ASSERT_EQUAL_INT(sizeof(bin_data), vfs_lseek(fd, 0, SEEK_CUR));
+
+    res = vfs_close(fd);
+    TEST_ASSERT_EQUAL_INT(0, res);
+
+    res = vfs_umount(&_test_vfs_mount);
+    TEST_ASSERT_EQUAL_INT(0, res);
+}
+
 #if MODULE_NEWLIB || defined(BOARD_NATIVE)
 static void test_vfs_constfs__posix(void)
 {
@@ -209,7 +374,11 @@ Test *tests_vfs_mount_constfs_tests(void)
         new_TestFixture(test_vfs_mount__invalid),
         new_TestFixture(test_vfs_umount__invalid_mount),
         new_TestFixture(test_vfs_constfs_open),
+        new_TestFixture(test_vfs_constfs_open__nested),
         new_TestFixture(test_vfs_constfs_read_lseek),
+        new_TestFixture(test_vfs_constfs_read_ptr),
+        new_TestFixture(test_vfs_constfs_readv),
+        new_TestFixture(test_vfs_constfs_sendfile),
 #if MODULE_NEWLIB || defined(BOARD_NATIVE)
         new_TestFixture(test_vfs_constfs__posix),
 #endif